@@ -34,6 +34,9 @@
  * SPDX-License-Identifier: BSD-3-Clause-Clear
  */
 
+#include <utils/stage_latency.h>
+#include <sstream>
+
 #include "DisplayConfigAIDL.h"
 
 using ::aidl::android::hardware::common::NativeHandle;
@@ -46,6 +49,10 @@ namespace hardware {
 namespace display {
 namespace config {
 
+// getDebugProperty() names answered with the stage latency report instead of a property value.
+static const char *kStageLatencyQuery = "stage_latency";
+static const char *kStageLatencyResetQuery = "stage_latency_reset";
+
 DisplayConfigAIDL::DisplayConfigAIDL() : hwc_session_(HWCSession::GetInstance()) {}
 
 DisplayConfigAIDL::DisplayConfigAIDL(HWCSession *hwc_session) {
@@ -431,6 +438,17 @@ ScopedAStatus DisplayConfigAIDL::getDebugProperty(const std::string &prop_name,
   int error = -EINVAL;
   char val[64] = {};
 
+  // Not a property, reports the stage latency histograms collected so far.
+  if (prop_name == kStageLatencyQuery || prop_name == kStageLatencyResetQuery) {
+    std::ostringstream os;
+    sdm::StageLatency::Dump(&os);
+    if (prop_name == kStageLatencyResetQuery) {
+      sdm::StageLatency::Reset();
+    }
+    *value = os.str();
+    return ScopedAStatus::ok();
+  }
+
   vendor_prop_name += prop_name.c_str();
   if (sdm::HWCDebugHandler::Get()->GetProperty(vendor_prop_name.c_str(), val) == sdm::kErrorNone) {
     *value = val;
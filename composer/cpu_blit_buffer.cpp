@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <QtiGralloc.h>
+#include <QtiGrallocDefs.h>
+#include <gr_utils.h>
+#include <utils/debug.h>
+#include <utils/formats.h>
+
+#include "cpu_blit_buffer.h"
+
+#define __CLASS__ "CpuBlitBuffer"
+
+namespace sdm {
+
+CpuBlitBuffer::~CpuBlitBuffer() {
+  if (hnd_) {
+    int release_fence = -1;
+    buffer_allocator_->UnmapBuffer(hnd_, &release_fence);
+  }
+}
+
+int CpuBlitBuffer::Map(const native_handle_t *hnd, const shared_ptr<Fence> &acquire_fence,
+                       bool write) {
+  void *buf = const_cast<native_handle_t *>(hnd);
+  int32_t flags = 0;
+  if (buffer_allocator_->GetPrivateFlags(buf, flags) != kErrorNone) {
+    DLOGE("Failed to get the flags of buffer %p", hnd);
+    return -EINVAL;
+  }
+  if (flags & qtigralloc::PRIV_FLAGS_SECURE_BUFFER) {
+    DLOGE("Secure buffer %p can not be accessed by the CPU", hnd);
+    return -ENOTSUP;
+  }
+
+  void *base = nullptr;
+  int error = buffer_allocator_->MapBuffer(hnd, acquire_fence, &base, write);
+  if (error != 0) {
+    DLOGE("Failed to map buffer %p, error = %d", hnd, error);
+    return -EINVAL;
+  }
+  hnd_ = hnd;
+
+  LayerBufferFormat format = kFormatInvalid;
+  AllocatedBufferInfo info = {};
+  uint32_t width = 0, height = 0;
+  if (buffer_allocator_->GetSDMFormat(buf, format) != kErrorNone ||
+      buffer_allocator_->GetUnalignedWidth(buf, width) != kErrorNone ||
+      buffer_allocator_->GetUnalignedHeight(buf, height) != kErrorNone ||
+      buffer_allocator_->GetWidth(buf, info.aligned_width) != kErrorNone ||
+      buffer_allocator_->GetHeight(buf, info.aligned_height) != kErrorNone) {
+    DLOGE("Failed to get the geometry of buffer %p", hnd);
+    return -EINVAL;
+  }
+
+  // UBWC variants are not listed, their layout is not linear.
+  switch (format) {
+    case kFormatRGBA8888:
+      image_.format = kCpuBlitRGBA8888;
+      break;
+    case kFormatRGBX8888:
+      image_.format = kCpuBlitRGBX8888;
+      break;
+    case kFormatBGRA8888:
+      image_.format = kCpuBlitBGRA8888;
+      break;
+    case kFormatRGBA1010102:
+      image_.format = kCpuBlitRGBA1010102;
+      break;
+    case kFormatYCbCr420SemiPlanar:
+    case kFormatYCbCr420SemiPlanarVenus:
+      image_.format = kCpuBlitNV12;
+      break;
+    case kFormatYCbCr420P010:
+    case kFormatYCbCr420P010Venus:
+      image_.format = kCpuBlitP010;
+      break;
+    default:
+      DLOGE("Format %s of buffer %p is not supported", GetFormatString(format), hnd);
+      return -ENOTSUP;
+  }
+
+  uint32_t stride[4] = {};
+  uint32_t offset[4] = {};
+  uint32_t num_planes = 0;
+  info.format = format;
+  if (buffer_allocator_->GetBufferLayout(info, stride, offset, &num_planes) != 0 ||
+      num_planes > 2) {
+    DLOGE("Failed to get the layout of buffer %p", hnd);
+    return -EINVAL;
+  }
+
+  image_.width = width;
+  image_.height = height;
+  for (uint32_t i = 0; i < num_planes; i++) {
+    image_.planes[i].base = static_cast<uint8_t *>(base) + offset[i];
+    image_.planes[i].stride = stride[i];
+  }
+
+  return 0;
+}
+
+CpuBlitMatrix CpuBlitBuffer::GetMatrix(bool *full_range) const {
+  int csc = HAL_CSC_ITU_R_601;
+  void *buf = const_cast<native_handle_t *>(hnd_);
+  if (gralloc::GetMetaDataValue(buf, qtigralloc::MetadataType_ColorSpace.value, &csc) !=
+      gralloc::Error::NONE) {
+    csc = HAL_CSC_ITU_R_601;
+  }
+
+  *full_range = (csc == HAL_CSC_ITU_R_601_FR || csc == HAL_CSC_ITU_R_709_FR ||
+                 csc == HAL_CSC_ITU_R_2020_FR);
+  switch (csc) {
+    case HAL_CSC_ITU_R_709:
+    case HAL_CSC_ITU_R_709_FR:
+      return kCpuBlitBT709;
+    case HAL_CSC_ITU_R_2020:
+    case HAL_CSC_ITU_R_2020_FR:
+      return kCpuBlitBT2020;
+    default:
+      return kCpuBlitBT601;
+  }
+}
+
+}  // namespace sdm
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CPU_BLIT_BUFFER_H__
+#define __CPU_BLIT_BUFFER_H__
+
+#include <utils/cpu_blit.h>
+#include <utils/fence.h>
+
+#include <memory>
+
+#include "hwc_buffer_allocator.h"
+
+namespace sdm {
+
+// Locks a linear, non secure gralloc buffer for CPU access and describes it as a CpuBlitImage.
+// The lock waits on the acquire fence; the buffer is unlocked when the object goes away.
+class CpuBlitBuffer {
+ public:
+  explicit CpuBlitBuffer(HWCBufferAllocator *buffer_allocator)
+    : buffer_allocator_(buffer_allocator) {}
+  ~CpuBlitBuffer();
+
+  int Map(const native_handle_t *hnd, const shared_ptr<Fence> &acquire_fence, bool write);
+  const CpuBlitImage &GetImage() const { return image_; }
+  // Matrix and range of the buffer color space, BT.601 limited range when it has none.
+  CpuBlitMatrix GetMatrix(bool *full_range) const;
+
+ private:
+  HWCBufferAllocator *buffer_allocator_ = nullptr;
+  const native_handle_t *hnd_ = nullptr;
+  CpuBlitImage image_ = {};
+};
+
+}  // namespace sdm
+
+#endif  // __CPU_BLIT_BUFFER_H__
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/debug.h>
+
+#include "cpu_blit_buffer.h"
+#include "cpu_color_convert_impl.h"
+
+#define __CLASS__ "CpuColorConvertImpl"
+
+namespace sdm {
+
+int CpuColorConvertImpl::Init() {
+  // Shared with the other instances, so several displays do not oversubscribe the CPUs.
+  blitter_ = &CpuBlitter::GetShared();
+  DLOGI("Created CPU color convert for target %d with %u threads", target_,
+        blitter_->GetThreadCount());
+
+  return 0;
+}
+
+int CpuColorConvertImpl::Deinit() {
+  blitter_ = nullptr;
+
+  return 0;
+}
+
+int CpuColorConvertImpl::Blit(const native_handle_t *src_hnd, const native_handle_t *dst_hnd,
+                              const GLRect &src_rect, const GLRect &dst_rect,
+                              const shared_ptr<Fence> &src_acquire_fence,
+                              const shared_ptr<Fence> &dst_acquire_fence,
+                              shared_ptr<Fence> *release_fence) {
+  DTRACE_SCOPED();
+  *release_fence = nullptr;
+
+  CpuBlitBuffer src(&buffer_allocator_);
+  CpuBlitBuffer dst(&buffer_allocator_);
+  if (src.Map(src_hnd, src_acquire_fence, false) != 0 ||
+      dst.Map(dst_hnd, dst_acquire_fence, true) != 0) {
+    return -EINVAL;
+  }
+
+  LayerRect src_crop(src_rect.left, src_rect.top, src_rect.right, src_rect.bottom);
+  LayerRect dst_crop(dst_rect.left, dst_rect.top, dst_rect.right, dst_rect.bottom);
+  const CpuBlitImage &dst_image = dst.GetImage();
+  DisplayError error = kErrorNone;
+  if (dst_image.format == kCpuBlitNV12 || dst_image.format == kCpuBlitP010) {
+    bool full_range = false;
+    CpuBlitMatrix matrix = dst.GetMatrix(&full_range);
+    error = blitter_->ConvertToYUV(src.GetImage(), src_crop, dst_image, dst_crop, matrix,
+                                   full_range);
+  } else {
+    error = blitter_->Stitch(src.GetImage(), src_crop, dst_image, dst_crop, LayerRect());
+  }
+
+  if (error != kErrorNone) {
+    DLOGE("Blit to target %d failed, error = %d", target_, error);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+}  // namespace sdm
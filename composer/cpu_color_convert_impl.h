@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CPU_COLOR_CONVERT_IMPL_H__
+#define __CPU_COLOR_CONVERT_IMPL_H__
+
+#include <utils/cpu_blit.h>
+
+#include "gl_color_convert.h"
+#include "hwc_buffer_allocator.h"
+
+namespace sdm {
+
+// GLColorConvert on the CPU, for targets without a usable GPU context. Non secure linear buffers
+// only; the blit is done when Blit() returns, so there is no release fence.
+class CpuColorConvertImpl : public GLColorConvert {
+ public:
+  explicit CpuColorConvertImpl(GLRenderTarget target) : target_(target) {}
+  virtual ~CpuColorConvertImpl() {}
+  virtual int Blit(const native_handle_t *src_hnd, const native_handle_t *dst_hnd,
+                   const GLRect &src_rect, const GLRect &dst_rect,
+                   const shared_ptr<Fence> &src_acquire_fence,
+                   const shared_ptr<Fence> &dst_acquire_fence, shared_ptr<Fence> *release_fence);
+  virtual int Init();
+  virtual int Deinit();
+  virtual void Reset() {}
+
+ private:
+  GLRenderTarget target_ = kTargetRGBA;
+  HWCBufferAllocator buffer_allocator_;
+  CpuBlitter *blitter_ = nullptr;  // CpuBlitter::GetShared()
+};
+
+}  // namespace sdm
+
+#endif  // __CPU_COLOR_CONVERT_IMPL_H__
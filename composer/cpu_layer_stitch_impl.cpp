@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/debug.h>
+
+#include "cpu_blit_buffer.h"
+#include "cpu_layer_stitch_impl.h"
+
+#define __CLASS__ "CpuLayerStitchImpl"
+
+namespace sdm {
+
+int CpuLayerStitchImpl::Init() {
+  blitter_ = &CpuBlitter::GetShared();
+  DLOGI("Created CPU layer stitch with %u threads", blitter_->GetThreadCount());
+
+  return 0;
+}
+
+int CpuLayerStitchImpl::Deinit() {
+  blitter_ = nullptr;
+
+  return 0;
+}
+
+int CpuLayerStitchImpl::Blit(const std::vector<StitchParams> &stitch_params,
+                             shared_ptr<Fence> *release_fence) {
+  DTRACE_SCOPED();
+  *release_fence = nullptr;
+
+  int status = 0;
+  for (auto &info : stitch_params) {
+    CpuBlitBuffer src(&buffer_allocator_);
+    CpuBlitBuffer dst(&buffer_allocator_);
+    if (src.Map(info.src_hnd, info.src_acquire_fence, false) != 0 ||
+        dst.Map(info.dst_hnd, info.dst_acquire_fence, true) != 0) {
+      status = -EINVAL;
+      continue;
+    }
+
+    LayerRect src_rect(info.src_rect.left, info.src_rect.top, info.src_rect.right,
+                       info.src_rect.bottom);
+    LayerRect dst_rect(info.dst_rect.left, info.dst_rect.top, info.dst_rect.right,
+                       info.dst_rect.bottom);
+    LayerRect scissor(info.scissor_rect.left, info.scissor_rect.top, info.scissor_rect.right,
+                      info.scissor_rect.bottom);
+    DisplayError error = blitter_->Stitch(src.GetImage(), src_rect, dst.GetImage(), dst_rect,
+                                          scissor);
+    if (error != kErrorNone) {
+      DLOGE("Stitch failed, error = %d", error);
+      status = -EINVAL;
+    }
+  }
+
+  return status;
+}
+
+}  // namespace sdm
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CPU_LAYER_STITCH_IMPL_H__
+#define __CPU_LAYER_STITCH_IMPL_H__
+
+#include <utils/cpu_blit.h>
+
+#include <vector>
+
+#include "gl_layer_stitch.h"
+#include "hwc_buffer_allocator.h"
+
+namespace sdm {
+
+// GLLayerStitch on the CPU, for targets without a usable GPU context. Non secure linear buffers
+// only; the stitch is done when Blit() returns, so there is no release fence.
+class CpuLayerStitchImpl : public GLLayerStitch {
+ public:
+  CpuLayerStitchImpl() {}
+  virtual ~CpuLayerStitchImpl() {}
+  virtual int Blit(const std::vector<StitchParams> &stitch_params,
+                   shared_ptr<Fence> *release_fence);
+  virtual int Init();
+  virtual int Deinit();
+
+ private:
+  HWCBufferAllocator buffer_allocator_;
+  CpuBlitter *blitter_ = nullptr;  // CpuBlitter::GetShared()
+};
+
+}  // namespace sdm
+
+#endif  // __CPU_LAYER_STITCH_IMPL_H__
@@ -34,39 +34,54 @@
  * SPDX-License-Identifier: BSD-3-Clause-Clear
  */
 
+#include "cpu_color_convert_impl.h"
 #include "gl_color_convert_impl.h"
 #include "gl_color_convert.h"
+#include "hwc_debugger.h"
 
 #define __CLASS__ "GLColorConvert"
 
 namespace sdm {
 
 GLColorConvert *GLColorConvert::GetInstance(GLRenderTarget target, bool secure) {
-  GLColorConvertImpl *color_convert = new GLColorConvertImpl(target, secure);
-  if (color_convert == nullptr) {
-    DLOGE("Failed to create color convert instance for %d target %d secure", target, secure);
-    return nullptr;
+  int use_cpu_blit = 0;
+  HWCDebugHandler::Get()->GetProperty(USE_CPU_BLIT, &use_cpu_blit);
+
+  // The CPU can not access secure buffers, those always need the GPU.
+  if (!use_cpu_blit || secure) {
+    GLColorConvertImpl *color_convert = new GLColorConvertImpl(target, secure);
+    int status = color_convert->Init();
+    if (status == 0) {
+      DLOGI("Created instance successfully");
+      return color_convert;
+    }
+
+    DLOGE("Failed to initialize GL Color convert instance %d", status);
+    delete color_convert;
+    if (secure) {
+      return nullptr;
+    }
   }
 
+  CpuColorConvertImpl *color_convert = new CpuColorConvertImpl(target);
   int status = color_convert->Init();
   if (status != 0) {
-    DLOGE("Failed to initialize GL Color convert instance %d", status);
+    DLOGE("Failed to initialize CPU Color convert instance %d", status);
     delete color_convert;
     return nullptr;
   }
 
-  DLOGI("Created instance successfully");
+  DLOGI("Created CPU instance successfully");
 
   return color_convert;
 }
 
 void GLColorConvert::Destroy(GLColorConvert *intf) {
-  GLColorConvertImpl *color_convert = static_cast<GLColorConvertImpl *>(intf);
-  if (color_convert->Deinit() != 0) {
+  if (intf->Deinit() != 0) {
     DLOGE("De Init failed");
   }
 
-  delete color_convert;
+  delete intf;
 }
 
 }  // namespace sdm
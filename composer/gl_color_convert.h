@@ -57,6 +57,8 @@ class GLColorConvert {
                    const shared_ptr<Fence> &dst_acquire_fence,
                    shared_ptr<Fence> *release_fence) = 0;
   virtual void Reset() = 0;
+  virtual int Init() = 0;
+  virtual int Deinit() = 0;
 
  protected:
   virtual ~GLColorConvert() {}
@@ -133,6 +133,10 @@ int GLColorConvertImpl::CreateContext(GLRenderTarget target, bool secure) {
                                       secure ? EGL_PROTECTED_CONTENT_EXT : EGL_NONE,
                                       secure ? EGL_TRUE : EGL_NONE, EGL_NONE};
   ctx_.egl_context = eglCreateContext(ctx_.egl_display, egl_config, NULL, egl_context_attrib_list);
+  if (ctx_.egl_context == EGL_NO_CONTEXT) {
+    DLOGE("Failed to create EGL context, error = 0x%x", eglGetError());
+    return -1;
+  }
 
   // eglCreatePbufferSurface creates an off-screen pixel buffer surface and returns its handle
   EGLint egl_surface_attrib_list[] = {EGL_WIDTH,
@@ -34,39 +34,54 @@
  * SPDX-License-Identifier: BSD-3-Clause-Clear
  */
 
+#include "cpu_layer_stitch_impl.h"
 #include "gl_layer_stitch_impl.h"
 #include "gl_layer_stitch.h"
+#include "hwc_debugger.h"
 
 #define __CLASS__ "GLLayerStitch"
 
 namespace sdm {
 
 GLLayerStitch *GLLayerStitch::GetInstance(bool secure) {
-  GLLayerStitchImpl *layer_stitch = new GLLayerStitchImpl(secure);
-  if (layer_stitch == nullptr) {
-    DLOGE("Failed to create layer stitch instance. secure: %d", secure);
-    return nullptr;
+  int use_cpu_blit = 0;
+  HWCDebugHandler::Get()->GetProperty(USE_CPU_BLIT, &use_cpu_blit);
+
+  // The CPU can not access secure buffers, those always need the GPU.
+  if (!use_cpu_blit || secure) {
+    GLLayerStitchImpl *layer_stitch = new GLLayerStitchImpl(secure);
+    int status = layer_stitch->Init();
+    if (status == 0) {
+      DLOGI("Created instance successfully");
+      return layer_stitch;
+    }
+
+    DLOGE("Failed to initialize GL layer stitch instance %d", status);
+    delete layer_stitch;
+    if (secure) {
+      return nullptr;
+    }
   }
 
+  CpuLayerStitchImpl *layer_stitch = new CpuLayerStitchImpl();
   int status = layer_stitch->Init();
   if (status != 0) {
-    DLOGE("Failed to initialize GL layer stitch instance %d", status);
+    DLOGE("Failed to initialize CPU layer stitch instance %d", status);
     delete layer_stitch;
     return nullptr;
   }
 
-  DLOGI("Created instance successfully");
+  DLOGI("Created CPU instance successfully");
 
   return layer_stitch;
 }
 
 void GLLayerStitch::Destroy(GLLayerStitch *intf) {
-  GLLayerStitchImpl *layer_stitch = static_cast<GLLayerStitchImpl *>(intf);
-  if (layer_stitch->Deinit() != 0) {
+  if (intf->Deinit() != 0) {
     DLOGE("De Init failed");
   }
 
-  delete layer_stitch;
+  delete intf;
 }
 
 }  // namespace sdm
@@ -762,7 +762,7 @@ int HWCBufferAllocator::GetBufferLayout(const AllocatedBufferInfo &buf_info, uin
 }
 
 int HWCBufferAllocator::MapBuffer(const native_handle_t *handle, shared_ptr<Fence> acquire_fence,
-                                  void **base_ptr) {
+                                  void **base_ptr, bool write) {
   auto err = GetGrallocInstance();
   if (err != 0) {
     DLOGW("Could not get gralloc instance");
@@ -781,7 +781,12 @@ int HWCBufferAllocator::MapBuffer(const native_handle_t *handle, shared_ptr<Fenc
   auto hnd = const_cast<native_handle_t *>(handle);
   *base_ptr = NULL;
   const IMapper::Rect access_region = {.left = 0, .top = 0, .width = 0, .height = 0};
-  mapper_->lock(reinterpret_cast<void *>(hnd), (uint64_t)BufferUsage::CPU_READ_OFTEN, access_region,
+  // Write access makes the unlock clean the CPU caches for the next hardware reader.
+  uint64_t usage = (uint64_t)BufferUsage::CPU_READ_OFTEN;
+  if (write) {
+    usage |= (uint64_t)BufferUsage::CPU_WRITE_OFTEN;
+  }
+  mapper_->lock(reinterpret_cast<void *>(hnd), usage, access_region,
                 acquire_fence_handle, [&](const auto &_error, const auto &_buffer) {
                   if (_error == Error::NONE) {
                     *base_ptr = _buffer;
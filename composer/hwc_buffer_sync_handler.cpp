@@ -36,6 +36,7 @@
 
 #include <errno.h>
 #include <sync/sync.h>
+#include <algorithm>
 #include <utils/constants.h>
 #include <utils/debug.h>
 #include <utils/fence.h>
@@ -114,4 +115,35 @@ void HWCBufferSyncHandler::GetSyncInfo(int fd, std::ostringstream *os) {
   }
 }
 
+int HWCBufferSyncHandler::GetSignalTime(int fd, int64_t *timestamp_ns) {
+  if (fd < 0) {
+    return -EINVAL;
+  }
+
+  struct sync_file_info *file_info = sync_file_info(fd);
+  if (!file_info) {
+    return -errno;
+  }
+
+  int error = 0;
+  int64_t signal_time = 0;
+  struct sync_fence_info *fence_info = sync_get_fence_info(file_info);
+  for (size_t i = 0; fence_info && i < file_info->num_fences; i++) {
+    // Status is 1 once signaled, 0 while pending and negative on error.
+    if (fence_info[i].status != 1) {
+      error = -EAGAIN;
+      break;
+    }
+    signal_time = std::max(signal_time, static_cast<int64_t>(fence_info[i].timestamp_ns));
+  }
+  sync_file_info_free(file_info);
+
+  if (error || !signal_time) {
+    return error ? error : -EAGAIN;
+  }
+
+  *timestamp_ns = signal_time;
+  return 0;
+}
+
 }  // namespace sdm
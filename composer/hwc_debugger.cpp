@@ -37,12 +37,14 @@
 #include <utils/constants.h>
 #include <cutils/properties.h>
 #include <display_properties.h>
+#include <string>
 
 #include "hwc_debugger.h"
 
 namespace sdm {
 
 HWCDebugHandler HWCDebugHandler::debug_handler_;
+HWCDebugHandler::LogcatSink HWCDebugHandler::logcat_sink_;
 
 HWCDebugHandler::HWCDebugHandler() {
   DebugHandler::Set(HWCDebugHandler::Get());
@@ -210,35 +212,77 @@ void HWCDebugHandler::DebugQos(bool enable, int verbose_level) {
   DebugHandler::SetLogMask(debug_handler_.log_mask_);
 }
 
+void HWCDebugHandler::SetLogBackend(int backend) {
+  BinaryLog::Stop();
+
+  int error = 0;
+  if (backend == kLogBackendDeferred) {
+    error = BinaryLog::Start(&logcat_sink_, nullptr);
+  } else if (backend == kLogBackendBinary) {
+    std::string path = std::string(DumpDir()) + "/hwc_log.bin";
+    error = BinaryLog::Start(&logcat_sink_, path.c_str());
+  }
+
+  if (error) {
+    ALOGE("Failed to start log backend %d, error %d. Using logcat.", backend, error);
+  }
+}
+
+void HWCDebugHandler::LogcatSink::Write(LogLevel level, const char *text) {
+  static const android_LogPriority kPriority[] = {ANDROID_LOG_ERROR, ANDROID_LOG_WARN,
+                                                  ANDROID_LOG_INFO, ANDROID_LOG_DEBUG,
+                                                  ANDROID_LOG_VERBOSE};
+  __android_log_write(kPriority[static_cast<uint8_t>(level)], LOG_TAG, text);
+}
+
+// Errors and warnings always go to logcat right away so they are never lost or reordered behind
+// a crash. The rest is handed to the binary log when a deferred backend is active.
 void HWCDebugHandler::Error(const char *fmt, ...) {
   va_list list;
   va_start(list, fmt);
   __android_log_vprint(ANDROID_LOG_ERROR, LOG_TAG, fmt, list);
+  va_end(list);
 }
 
 void HWCDebugHandler::Warning(const char *fmt, ...) {
   va_list list;
   va_start(list, fmt);
   __android_log_vprint(ANDROID_LOG_WARN, LOG_TAG, fmt, list);
+  va_end(list);
 }
 
 void HWCDebugHandler::Info(const char *fmt, ...) {
   va_list list;
   va_start(list, fmt);
-  __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt, list);
+  if (BinaryLog::IsActive()) {
+    BinaryLog::Record(LogLevel::kInfo, fmt, list);
+  } else {
+    __android_log_vprint(ANDROID_LOG_INFO, LOG_TAG, fmt, list);
+  }
+  va_end(list);
 }
 
 void HWCDebugHandler::Debug(const char *fmt, ...) {
   va_list list;
   va_start(list, fmt);
-  __android_log_vprint(ANDROID_LOG_DEBUG, LOG_TAG, fmt, list);
+  if (BinaryLog::IsActive()) {
+    BinaryLog::Record(LogLevel::kDebug, fmt, list);
+  } else {
+    __android_log_vprint(ANDROID_LOG_DEBUG, LOG_TAG, fmt, list);
+  }
+  va_end(list);
 }
 
 void HWCDebugHandler::Verbose(const char *fmt, ...) {
   if (debug_handler_.verbose_level_) {
     va_list list;
     va_start(list, fmt);
-    __android_log_vprint(ANDROID_LOG_VERBOSE, LOG_TAG, fmt, list);
+    if (BinaryLog::IsActive()) {
+      BinaryLog::Record(LogLevel::kVerbose, fmt, list);
+    } else {
+      __android_log_vprint(ANDROID_LOG_VERBOSE, LOG_TAG, fmt, list);
+    }
+    va_end(list);
   }
 }
 
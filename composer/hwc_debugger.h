@@ -41,13 +41,22 @@
 
 #include <core/sdm_types.h>
 #include <debug_handler.h>
+#include <binary_log.h>
 #include <log/log.h>
 #include <utils/Trace.h>
 #include <bitset>
 
 namespace sdm {
 
+using display::BinaryLog;
 using display::DebugHandler;
+using display::LogLevel;
+
+enum LogBackend {
+  kLogBackendLogcat,    // Format and write to logcat on the calling thread
+  kLogBackendDeferred,  // Format and write to logcat on the binary log drain thread
+  kLogBackendBinary,    // Append unformatted records to DumpDir()/hwc_log.bin
+};
 
 class HWCDebugHandler : public DebugHandler {
  public:
@@ -69,6 +78,7 @@ class HWCDebugHandler : public DebugHandler {
   static int GetIdleTimeoutMs();
   static void DebugIWE(bool enable, int verbose_level);
   static void DebugWbUsage(bool enable, int verbose_level);
+  static void SetLogBackend(int backend);
 
   virtual void Error(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
   virtual void Warning(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
@@ -82,7 +92,13 @@ class HWCDebugHandler : public DebugHandler {
   virtual int GetProperty(const char *property_name, char *value);
 
  private:
+  class LogcatSink : public BinaryLog::Sink {
+   public:
+    void Write(LogLevel level, const char *text) override;
+  };
+
   static HWCDebugHandler debug_handler_;
+  static LogcatSink logcat_sink_;
   std::bitset<32> log_mask_;
   int32_t verbose_level_;
 };
@@ -31,10 +31,12 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <utils/constants.h>
+#include <utils/cpu_blit.h>
 #include <utils/debug.h>
 #include <utils/utils.h>
 #include <utils/formats.h>
 #include <utils/rect.h>
+#include <utils/stage_latency.h>
 #include <QtiGralloc.h>
 
 #include <algorithm>
@@ -679,6 +681,7 @@ static bool IsHDRLayerPresent(Layer *layer) {
 }
 
 void HWCDisplay::BuildLayerStack() {
+  ScopedStageLatency stage_latency(sdm_id_, kStageBuildLayerStack);
   layer_stack_ = LayerStack();
   display_rect_ = LayerRect();
   layer_stack_.flags.use_metadata_refresh_rate = false;
@@ -2167,8 +2170,9 @@ void HWCDisplay::DumpOutputBuffer(const BufferInfo &buffer_info, void *base,
     // Need to clear buffer after dumping of current frame to provide empty buffer for next frame.
     // But avoid this in case of virtual display frame dump, else it would provide empty buffer
     // to virtual display client, because it uses client buffer for dumping output.
+    // A 4K output buffer takes a few ms to clear on one core, so it is split across the CPUs.
     if (type_ != kVirtual) {
-      memset(base, 0, buffer_info.alloc_buffer_info.size);
+      CpuBlitter::GetShared().Clear(base, buffer_info.alloc_buffer_info.size);
     }
     DLOGI("Frame Dump of %s is %s", dump_file_name, result ? "Successful" : "Failed");
   }
@@ -2678,6 +2682,11 @@ void HWCDisplay::Dump(std::ostringstream *os) {
     return;
   }
 
+  if (tone_mapper_) {
+    *os << "\n----------Tone Mapper---------\n";
+    tone_mapper_->Dump(os);
+  }
+
   if (color_mode_) {
     *os << "\n----------Color Modes---------\n";
     color_mode_->Dump(os);
@@ -3013,6 +3022,15 @@ std::tuple<int64_t, int64_t> HWCDisplay::EstimateVsyncPeriodChangeTimeline(
     refresh_time = desired_time - refresh_rate_activate_period;
   }
 
+  // Move the refresh to the nearest vsync of the panel, once its phase has been measured.
+  VSyncPrediction prediction;
+  if (display_intf_ &&
+      display_intf_->GetVSyncPrediction(refresh_time - current_vsync_period / 2, 1, &prediction) ==
+          kErrorNone &&
+      prediction.fitted && !prediction.vsyncs_ns.empty()) {
+    refresh_time = prediction.vsyncs_ns[0];
+  }
+
   const auto applied_time = refresh_time + refresh_rate_activate_period;
   return std::make_tuple(refresh_time, applied_time);
 }
@@ -180,6 +180,12 @@ int HWCDisplayBuiltIn::Init() {
     large_comp_hint_threshold_ = value;
   }
 
+  value = 0;
+  if (DebugHandler::Get()->GetProperty(HISTOGRAM_BUCKET_COUNT, &value) == kErrorNone &&
+      !histogram.set_bucket_count(UINT32(value))) {
+    DLOGW("Unsupported histogram bucket count %d, using default", value);
+  }
+
   uint32_t config_index = 0;
   GetActiveDisplayConfig(&config_index);
   DisplayConfigVariableInfo attr = {};
@@ -960,11 +966,8 @@ HWC3::Error HWCDisplayBuiltIn::SetDisplayedContentSamplingEnabled(bool enabled,
   }
 
   auto start = api_sampling_vote || vndservice_sampling_vote;
-  if (start && max_frames == 0) {
-    histogram.start();
-    display_intf_->colorSamplingOn();
-  } else if (start) {
-    histogram.start(max_frames);
+  if (start) {
+    histogram.start(max_frames, component_mask);
     display_intf_->colorSamplingOn();
   } else {
     display_intf_->colorSamplingOff();
@@ -41,8 +41,10 @@
 #include <utils/constants.h>
 #include <utils/debug.h>
 #include <utils/formats.h>
+#include <utils/pattern_crc.h>
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <fstream>
@@ -268,60 +270,17 @@ void HWCDisplayPluggableTest::DumpInputBuffer() {
   }
 }
 
-void HWCDisplayPluggableTest::CalcCRC(uint32_t color_val, std::bitset<16> *crc_data) {
-  std::bitset<16> color = {};
-  std::bitset<16> temp_crc = {};
-
+uint16_t HWCDisplayPluggableTest::GetCRCWord(uint32_t color_val) {
   switch (panel_bpp_) {
     case kDisplayBpp18:
-      color = (color_val & 0xFC) << 8;
-      break;
+      return UINT16((color_val & 0xFC) << 8);
     case kDisplayBpp24:
-      color = color_val << 8;
-      break;
+      return UINT16(color_val << 8);
     case kDisplayBpp30:
-      color = color_val << 6;
-      break;
+      return UINT16(color_val << 6);
     default:
-      return;
+      return 0;
   }
-
-  temp_crc[15] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^
-                 (*crc_data)[4] ^ (*crc_data)[5] ^ (*crc_data)[6] ^ (*crc_data)[7] ^
-                 (*crc_data)[8] ^ (*crc_data)[9] ^ (*crc_data)[10] ^ (*crc_data)[11] ^
-                 (*crc_data)[12] ^ (*crc_data)[14] ^ (*crc_data)[15] ^ color[0] ^ color[1] ^
-                 color[2] ^ color[3] ^ color[4] ^ color[5] ^ color[6] ^ color[7] ^ color[8] ^
-                 color[9] ^ color[10] ^ color[11] ^ color[12] ^ color[14] ^ color[15];
-
-  temp_crc[14] = (*crc_data)[12] ^ (*crc_data)[13] ^ color[12] ^ color[13];
-  temp_crc[13] = (*crc_data)[11] ^ (*crc_data)[12] ^ color[11] ^ color[12];
-  temp_crc[12] = (*crc_data)[10] ^ (*crc_data)[11] ^ color[10] ^ color[11];
-  temp_crc[11] = (*crc_data)[9] ^ (*crc_data)[10] ^ color[9] ^ color[10];
-  temp_crc[10] = (*crc_data)[8] ^ (*crc_data)[9] ^ color[8] ^ color[9];
-  temp_crc[9] = (*crc_data)[7] ^ (*crc_data)[8] ^ color[7] ^ color[8];
-  temp_crc[8] = (*crc_data)[6] ^ (*crc_data)[7] ^ color[6] ^ color[7];
-  temp_crc[7] = (*crc_data)[5] ^ (*crc_data)[6] ^ color[5] ^ color[6];
-  temp_crc[6] = (*crc_data)[4] ^ (*crc_data)[5] ^ color[4] ^ color[5];
-  temp_crc[5] = (*crc_data)[3] ^ (*crc_data)[4] ^ color[3] ^ color[4];
-  temp_crc[4] = (*crc_data)[2] ^ (*crc_data)[3] ^ color[2] ^ color[3];
-  temp_crc[3] = (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[15] ^ color[1] ^ color[2] ^ color[15];
-  temp_crc[2] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[14] ^ color[0] ^ color[1] ^ color[14];
-
-  temp_crc[1] = (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^ (*crc_data)[4] ^ (*crc_data)[5] ^
-                (*crc_data)[6] ^ (*crc_data)[7] ^ (*crc_data)[8] ^ (*crc_data)[9] ^
-                (*crc_data)[10] ^ (*crc_data)[11] ^ (*crc_data)[12] ^ (*crc_data)[13] ^
-                (*crc_data)[14] ^ color[1] ^ color[2] ^ color[3] ^ color[4] ^ color[5] ^ color[6] ^
-                color[7] ^ color[8] ^ color[9] ^ color[10] ^ color[11] ^ color[12] ^ color[13] ^
-                color[14];
-
-  temp_crc[0] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^ (*crc_data)[4] ^
-                (*crc_data)[5] ^ (*crc_data)[6] ^ (*crc_data)[7] ^ (*crc_data)[8] ^ (*crc_data)[9] ^
-                (*crc_data)[10] ^ (*crc_data)[11] ^ (*crc_data)[12] ^ (*crc_data)[13] ^
-                (*crc_data)[15] ^ color[0] ^ color[1] ^ color[2] ^ color[3] ^ color[4] ^ color[5] ^
-                color[6] ^ color[7] ^ color[8] ^ color[9] ^ color[10] ^ color[11] ^ color[12] ^
-                color[13] ^ color[15];
-
-  (*crc_data) = temp_crc;
 }
 
 int HWCDisplayPluggableTest::FillBuffer() {
@@ -373,39 +332,52 @@ int HWCDisplayPluggableTest::GetStride(LayerBufferFormat format, uint32_t width,
   return 0;
 }
 
-void HWCDisplayPluggableTest::PixelCopy(uint32_t red, uint32_t green, uint32_t blue, uint32_t alpha,
-                                        uint8_t **buffer) {
+void HWCDisplayPluggableTest::PackRow(const PatternRow &row, uint8_t *buffer) {
   LayerBufferFormat format = buffer_info_.buffer_config.format;
+  if (!PackPatternRow(format, row.red.data(), row.green.data(), row.blue.data(),
+                      UINT32(row.red.size()), buffer)) {
+    DLOGW("format not supported format = %d", format);
+  }
+}
 
-  switch (format) {
-    case kFormatRGBA8888:
-      *(*buffer)++ = UINT8(red & 0xFF);
-      *(*buffer)++ = UINT8(green & 0xFF);
-      *(*buffer)++ = UINT8(blue & 0xFF);
-      *(*buffer)++ = UINT8(alpha & 0xFF);
-      break;
-    case kFormatRGB888:
-      *(*buffer)++ = UINT8(red & 0xFF);
-      *(*buffer)++ = UINT8(green & 0xFF);
-      *(*buffer)++ = UINT8(blue & 0xFF);
-      break;
-    case kFormatRGBA1010102:
-      // Lower 8 bits of red
-      *(*buffer)++ = UINT8(red & 0xFF);
+void HWCDisplayPluggableTest::WritePatternRow(PatternRow *row, uint8_t *buffer,
+                                              uint32_t row_bytes, PatternCRC *crc) {
+  if (row->dirty) {
+    // Row content changed, pack it and compute its CRC contribution from a zero state.
+    PackRow(*row, buffer);
+    const std::vector<uint32_t> *components[] = {&row->red, &row->green, &row->blue};
+    for (uint32_t c = 0; c < kNumCRCComponents; c++) {
+      for (uint32_t i = 0; i < row->words.size(); i++) {
+        row->words[i] = GetCRCWord((*components[c])[i]);
+      }
+      row->crc[c] = PatternCRC16::Update(0, row->words.data(), UINT32(row->words.size()));
+    }
+    row->packed = buffer;
+    row->dirty = false;
+  } else {
+    memcpy(buffer, row->packed, row_bytes);
+  }
 
-      // Upper 2 bits of Red + Lower 6 bits of green
-      *(*buffer)++ = UINT8(((green & 0x3F) << 2) | ((red >> 0x8) & 0x3));
+  // The CRC is linear, so a repeated row folds in as shift(crc) ^ crc_of_row.
+  for (uint32_t c = 0; c < kNumCRCComponents; c++) {
+    crc->value[c] = crc->row_shift.Apply(crc->value[c]) ^ row->crc[c];
+  }
+}
 
-      // Upper 4 bits of green + Lower 4 bits of blue
-      *(*buffer)++ = UINT8(((blue & 0xF) << 4) | ((green >> 6) & 0xF));
+void HWCDisplayPluggableTest::InitPatternRow(uint32_t width, PatternRow *row, PatternCRC *crc) {
+  row->red.assign(width, 0);
+  row->green.assign(width, 0);
+  row->blue.assign(width, 0);
+  row->words.assign(width, 0);
+  row->dirty = true;
+  crc->row_shift = PatternCRC16::Shift(width);
+  crc->value = {};
+}
 
-      // Upper 6 bits of blue + Lower 2 bits of alpha
-      *(*buffer)++ = UINT8(((alpha & 0x3) << 6) | ((blue >> 4) & 0x3F));
-      break;
-    default:
-      DLOGW("format not supported format = %d", format);
-      break;
-  }
+void HWCDisplayPluggableTest::LogPatternCRC(const PatternCRC &crc) {
+  DLOGI("CRC red %x", crc.value[0]);
+  DLOGI("CRC green %x", crc.value[1]);
+  DLOGI("CRC blue %x", crc.value[2]);
 }
 
 void HWCDisplayPluggableTest::GenerateColorRamp(uint8_t *buffer) {
@@ -414,6 +386,7 @@ void HWCDisplayPluggableTest::GenerateColorRamp(uint8_t *buffer) {
   LayerBufferFormat format = buffer_info_.buffer_config.format;
   uint32_t aligned_width = buffer_info_.alloc_buffer_info.aligned_width;
   uint32_t buffer_stride = 0;
+  uint32_t row_bytes = 0;
 
   uint32_t color_ramp = 0;
   uint32_t start_color_val = 0;
@@ -422,9 +395,8 @@ void HWCDisplayPluggableTest::GenerateColorRamp(uint8_t *buffer) {
   uint32_t ramp_height = 0;
   uint32_t shift_by = 0;
 
-  std::bitset<16> crc_red = {};
-  std::bitset<16> crc_green = {};
-  std::bitset<16> crc_blue = {};
+  PatternRow row = {};
+  PatternCRC crc = {};
 
   switch (panel_bpp_) {
     case kDisplayBpp18:
@@ -446,41 +418,31 @@ void HWCDisplayPluggableTest::GenerateColorRamp(uint8_t *buffer) {
   }
 
   GetStride(format, aligned_width, &buffer_stride);
+  GetStride(format, width, &row_bytes);
+  InitPatternRow(width, &row, &crc);
 
   for (uint32_t loop_height = 0; loop_height < height; loop_height++) {
-    uint32_t color_value = start_color_val;
-    uint8_t *temp = buffer + (loop_height * buffer_stride);
-
-    for (uint32_t loop_width = 0; loop_width < width; loop_width++) {
-      if (color_ramp == kColorRedRamp) {
-        PixelCopy(color_value, 0, 0, 0, &temp);
-        CalcCRC(color_value, &crc_red);
-        CalcCRC(0, &crc_green);
-        CalcCRC(0, &crc_blue);
-      }
-      if (color_ramp == kColorGreenRamp) {
-        PixelCopy(0, color_value, 0, 0, &temp);
-        CalcCRC(0, &crc_red);
-        CalcCRC(color_value, &crc_green);
-        CalcCRC(0, &crc_blue);
-      }
-      if (color_ramp == kColorBlueRamp) {
-        PixelCopy(0, 0, color_value, 0, &temp);
-        CalcCRC(0, &crc_red);
-        CalcCRC(0, &crc_green);
-        CalcCRC(color_value, &crc_blue);
-      }
-      if (color_ramp == kColorWhiteRamp) {
-        PixelCopy(color_value, color_value, color_value, 0, &temp);
-        CalcCRC(color_value, &crc_red);
-        CalcCRC(color_value, &crc_green);
-        CalcCRC(color_value, &crc_blue);
+    if (row.dirty) {
+      for (uint32_t loop_width = 0; loop_width < width; loop_width++) {
+        uint32_t color_value = start_color_val;
+        if (loop_width) {
+          color_value = (start_color_val + ((loop_width % ramp_width) * step_size)) << shift_by;
+        }
+        bool white = (color_ramp == kColorWhiteRamp);
+        row.red[loop_width] = (white || color_ramp == kColorRedRamp) ? color_value : 0;
+        row.green[loop_width] = (white || color_ramp == kColorGreenRamp) ? color_value : 0;
+        row.blue[loop_width] = (white || color_ramp == kColorBlueRamp) ? color_value : 0;
       }
+    }
 
-      color_value = (start_color_val + (((loop_width + 1) % ramp_width) * step_size)) << shift_by;
+    WritePatternRow(&row, buffer + (loop_height * buffer_stride), row_bytes, &crc);
+
+    if (((loop_height + 1) % ramp_height) != 0) {
+      continue;
     }
 
-    if (panel_bpp_ == kDisplayBpp30 && ((loop_height + 1) % ramp_height) == 0) {
+    row.dirty = true;
+    if (panel_bpp_ == kDisplayBpp30) {
       if (start_color_val == 0x180) {
         start_color_val = 0;
         step_size = 4;
@@ -492,14 +454,10 @@ void HWCDisplayPluggableTest::GenerateColorRamp(uint8_t *buffer) {
       continue;
     }
 
-    if (((loop_height + 1) % ramp_height) == 0) {
-      color_ramp = (color_ramp + 1) % 4;
-    }
+    color_ramp = (color_ramp + 1) % 4;
   }
 
-  DLOGI("CRC red %lx", crc_red.to_ulong());
-  DLOGI("CRC green %lx", crc_green.to_ulong());
-  DLOGI("CRC blue %lx", crc_blue.to_ulong());
+  LogPatternCRC(crc);
 }
 
 void HWCDisplayPluggableTest::GenerateBWVertical(uint8_t *buffer) {
@@ -508,44 +466,34 @@ void HWCDisplayPluggableTest::GenerateBWVertical(uint8_t *buffer) {
   LayerBufferFormat format = buffer_info_.buffer_config.format;
   uint32_t aligned_width = buffer_info_.alloc_buffer_info.aligned_width;
   uint32_t buffer_stride = 0;
+  uint32_t row_bytes = 0;
   uint32_t bits_per_component = panel_bpp_ / 3;
   uint32_t max_color_val = (1 << bits_per_component) - 1;
 
-  std::bitset<16> crc_red = {};
-  std::bitset<16> crc_green = {};
-  std::bitset<16> crc_blue = {};
+  PatternRow row = {};
+  PatternCRC crc = {};
 
   if (panel_bpp_ == kDisplayBpp18) {
     max_color_val <<= 2;
   }
 
   GetStride(format, aligned_width, &buffer_stride);
+  GetStride(format, width, &row_bytes);
+  InitPatternRow(width, &row, &crc);
 
-  for (uint32_t loop_height = 0; loop_height < height; loop_height++) {
-    uint32_t color = 0;
-    uint8_t *temp = buffer + (loop_height * buffer_stride);
-
-    for (uint32_t loop_width = 0; loop_width < width; loop_width++) {
-      if (color == kColorBlack) {
-        PixelCopy(0, 0, 0, 0, &temp);
-        CalcCRC(0, &crc_red);
-        CalcCRC(0, &crc_green);
-        CalcCRC(0, &crc_blue);
-      }
-      if (color == kColorWhite) {
-        PixelCopy(max_color_val, max_color_val, max_color_val, 0, &temp);
-        CalcCRC(max_color_val, &crc_red);
-        CalcCRC(max_color_val, &crc_green);
-        CalcCRC(max_color_val, &crc_blue);
-      }
+  // Every row alternates black and white pixels starting with black.
+  for (uint32_t loop_width = 0; loop_width < width; loop_width++) {
+    uint32_t color_value = (loop_width % 2 == kColorWhite) ? max_color_val : 0;
+    row.red[loop_width] = color_value;
+    row.green[loop_width] = color_value;
+    row.blue[loop_width] = color_value;
+  }
 
-      color = (color + 1) % 2;
-    }
+  for (uint32_t loop_height = 0; loop_height < height; loop_height++) {
+    WritePatternRow(&row, buffer + (loop_height * buffer_stride), row_bytes, &crc);
   }
 
-  DLOGI("CRC red %lx", crc_red.to_ulong());
-  DLOGI("CRC green %lx", crc_green.to_ulong());
-  DLOGI("CRC blue %lx", crc_blue.to_ulong());
+  LogPatternCRC(crc);
 }
 
 void HWCDisplayPluggableTest::GenerateColorSquare(uint8_t *buffer) {
@@ -554,12 +502,12 @@ void HWCDisplayPluggableTest::GenerateColorSquare(uint8_t *buffer) {
   LayerBufferFormat format = buffer_info_.buffer_config.format;
   uint32_t aligned_width = buffer_info_.alloc_buffer_info.aligned_width;
   uint32_t buffer_stride = 0;
+  uint32_t row_bytes = 0;
   uint32_t max_color_val = 0;
   uint32_t min_color_val = 0;
 
-  std::bitset<16> crc_red = {};
-  std::bitset<16> crc_green = {};
-  std::bitset<16> crc_blue = {};
+  PatternRow row = {};
+  PatternCRC crc = {};
 
   switch (panel_bpp_) {
     case kDisplayBpp18:
@@ -590,30 +538,28 @@ void HWCDisplayPluggableTest::GenerateColorSquare(uint8_t *buffer) {
   }};
 
   GetStride(format, aligned_width, &buffer_stride);
+  GetStride(format, width, &row_bytes);
+  InitPatternRow(width, &row, &crc);
 
   for (uint32_t loop_height = 0; loop_height < height; loop_height++) {
-    uint32_t color = 0;
-    uint8_t *temp = buffer + (loop_height * buffer_stride);
-
-    for (uint32_t loop_width = 0; loop_width < width; loop_width++) {
-      PixelCopy(colors[color][0], colors[color][1], colors[color][2], 0, &temp);
-      CalcCRC(colors[color][0], &crc_red);
-      CalcCRC(colors[color][1], &crc_green);
-      CalcCRC(colors[color][2], &crc_blue);
-
-      if (((loop_width + 1) % 64) == 0) {
-        color = (color + 1) % colors.size();
+    if (row.dirty) {
+      for (uint32_t loop_width = 0; loop_width < width; loop_width++) {
+        uint32_t color = (loop_width / 64) % colors.size();
+        row.red[loop_width] = colors[color][0];
+        row.green[loop_width] = colors[color][1];
+        row.blue[loop_width] = colors[color][2];
       }
     }
 
+    WritePatternRow(&row, buffer + (loop_height * buffer_stride), row_bytes, &crc);
+
     if (((loop_height + 1) % 64) == 0) {
       std::reverse(colors.begin(), (colors.end() - 1));
+      row.dirty = true;
     }
   }
 
-  DLOGI("CRC red %lx", crc_red.to_ulong());
-  DLOGI("CRC green %lx", crc_green.to_ulong());
-  DLOGI("CRC blue %lx", crc_blue.to_ulong());
+  LogPatternCRC(crc);
 }
 
 int HWCDisplayPluggableTest::InitLayer(Layer *layer) {
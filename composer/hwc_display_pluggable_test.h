@@ -37,7 +37,10 @@
 #ifndef __HWC_DISPLAY_PLUGGABLE_TEST_H__
 #define __HWC_DISPLAY_PLUGGABLE_TEST_H__
 
-#include <bitset>
+#include <utils/pattern_crc.h>
+
+#include <array>
+#include <vector>
 
 #include "hwc_display.h"
 #include "hwc_buffer_allocator.h"
@@ -86,6 +89,23 @@ class HWCDisplayPluggableTest : public HWCDisplay {
   };
 
  private:
+  static const uint32_t kNumCRCComponents = 3;
+
+  struct PatternRow {
+    std::vector<uint32_t> red;
+    std::vector<uint32_t> green;
+    std::vector<uint32_t> blue;
+    std::vector<uint16_t> words;
+    std::array<uint16_t, kNumCRCComponents> crc = {};
+    uint8_t *packed = nullptr;  // First copy of the current row content in the buffer
+    bool dirty = true;
+  };
+
+  struct PatternCRC {
+    PatternCRC16::Shift row_shift;
+    std::array<uint16_t, kNumCRCComponents> value = {};
+  };
+
   HWCDisplayPluggableTest(CoreInterface *core_intf, HWCBufferAllocator *buffer_allocator,
                           HWCCallbacks *callbacks, HWCDisplayEventHandler *event_handler,
                           qService::QService *qservice, Display id, int32_t sdm_id,
@@ -93,10 +113,13 @@ class HWCDisplayPluggableTest : public HWCDisplay {
   int Init();
   int Deinit();
   void DumpInputBuffer();
-  void CalcCRC(uint32_t color_value, std::bitset<16> *crc_data);
+  uint16_t GetCRCWord(uint32_t color_value);
   int FillBuffer();
   int GetStride(LayerBufferFormat format, uint32_t width, uint32_t *stride);
-  void PixelCopy(uint32_t red, uint32_t green, uint32_t blue, uint32_t alpha, uint8_t **buffer);
+  void PackRow(const PatternRow &row, uint8_t *buffer);
+  void InitPatternRow(uint32_t width, PatternRow *row, PatternCRC *crc);
+  void WritePatternRow(PatternRow *row, uint8_t *buffer, uint32_t row_bytes, PatternCRC *crc);
+  void LogPatternCRC(const PatternCRC &crc);
   void GenerateColorRamp(uint8_t *buffer);
   void GenerateBWVertical(uint8_t *buffer);
   void GenerateColorSquare(uint8_t *buffer);
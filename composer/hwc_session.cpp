@@ -36,6 +36,9 @@
 #include <utils/String16.h>
 #include <utils/constants.h>
 #include <utils/debug.h>
+#include <utils/stage_latency.h>
+#include <utils/startup_timeline.h>
+#include <utils/uevent_parser.h>
 #include <QService.h>
 #include <utils/utils.h>
 #include <algorithm>
@@ -106,52 +109,24 @@ int32_t GetDataspaceFromColorMode(ColorMode mode) {
   }
 }
 
-const char *GetTokenValue(const char *uevent_data, int length, const char *token) {
-  const char *iterator_str = uevent_data;
-  const char *pstr = NULL;
-  while (((iterator_str - uevent_data) <= length) && (*iterator_str)) {
-    pstr = strstr(iterator_str, token);
-    if (pstr) {
-      break;
-    }
-    iterator_str += strlen(iterator_str) + 1;
-  }
-
-  if (pstr)
-    pstr = pstr + strlen(token);
-
-  return pstr;
-}
-
-int GetEventValue(const char *uevent_data, int length, const char *event_info) {
-  const char *iterator_str = uevent_data;
-  while (((iterator_str - uevent_data) <= length) && (*iterator_str)) {
-    const char *pstr = strstr(iterator_str, event_info);
-    if (pstr != NULL) {
-      return (atoi(iterator_str + strlen(event_info)));
-    }
-    iterator_str += strlen(iterator_str) + 1;
-  }
-
-  return -1;
-}
-
 void HWCSession::ParseUEvent(char *uevent_data, int length) {
   static constexpr uint32_t uevent_max_count = 3;
-  const char *str_status = GetTokenValue(uevent_data, length, "status=");
-  const char *str_sstmst = GetTokenValue(uevent_data, length, "HOTPLUG=");
-  const char *str_mst = GetTokenValue(uevent_data, length, "MST_HOTPLUG=");
-
-  if (!str_status && !str_mst && !str_sstmst) {
+  if (!UEventParser::MatchDevPath(uevent_data, length, HWC_UEVENT_DRM_EXT_HOTPLUG)) {
     return;
   }
 
-  if (!strcasestr(uevent_data, HWC_UEVENT_DRM_EXT_HOTPLUG)) {
+  UEventParser parser;
+  parser.Parse(uevent_data, length);
+  const char *str_status = parser.GetValue(UEventParser::kKeyStatus);
+  const char *str_sstmst = parser.GetValue(UEventParser::kKeyHotplug);
+  const char *str_mst = parser.GetValue(UEventParser::kKeyMstHotplug);
+
+  if (!str_status && !str_mst && !str_sstmst) {
     return;
   }
 
-  hpd_bpp_ = GetEventValue(uevent_data, length, "bpp=");
-  hpd_pattern_ = GetEventValue(uevent_data, length, "pattern=");
+  hpd_bpp_ = parser.GetIntValue(UEventParser::kKeyBpp);
+  hpd_pattern_ = parser.GetIntValue(UEventParser::kKeyPattern);
 
   DLOGI("UEvent = %s, status = %s, HOTPLUG = %s (SST/MST)%s%s, bpp = %d, pattern = %d", uevent_data,
         str_status ? str_status : "NULL", str_sstmst ? str_sstmst : "NULL",
@@ -184,6 +159,9 @@ void HWCSession::HpdThreadTop() {
     return;
   }
 
+  // Hotplugs are change events, the rest are dropped before they wake up the thread.
+  UEventParser::AttachChangeFilter(uevent_get_fd());
+
   while (1) {
     char uevent_data[PAGE_SIZE] = {};
 
@@ -232,6 +210,7 @@ HWCSession *HWCSession::GetInstance() {
 
 int HWCSession::Init() {
   SCOPE_LOCK(locker_[HWC_DISPLAY_PRIMARY]);
+  ScopedStartupStage startup_stage("HWCSession::Init");
   DLOGI("Initializing HWCSession");
 
   int status = -EINVAL;
@@ -262,6 +241,10 @@ int HWCSession::Init() {
     HWCDebugHandler::DebugAll(value, value);
   }
 
+  value = 0;
+  HWCDebugHandler::Get()->GetProperty(LOG_BACKEND, &value);
+  HWCDebugHandler::SetLogBackend(value);
+
   HWCDebugHandler::Get()->GetProperty(DISABLE_HOTPLUG_BWCHECK, &disable_hotplug_bwcheck_);
   DLOGI("disable_hotplug_bwcheck_: %d", disable_hotplug_bwcheck_);
   HWCDebugHandler::Get()->GetProperty(DISABLE_MASK_LAYER_HINT, &disable_mask_layer_hint_);
@@ -280,14 +263,25 @@ int HWCSession::Init() {
   disable_get_screen_decorator_support_ = (value == 1);
   DLOGI("disable_get_screen_decorator_support: %d", disable_get_screen_decorator_support_);
 
+  value = 0;
+  Debug::Get()->GetProperty(DISABLE_STAGE_LATENCY, &value);
+  StageLatency::SetEnabled(value != 1);
+  DLOGI("stage latency instrumentation: %d", StageLatency::IsEnabled());
+
   DLOGI("Initializing supported display slots");
-  InitSupportedDisplaySlots();
+  {
+    ScopedStartupStage stage("InitSupportedDisplaySlots");
+    InitSupportedDisplaySlots();
+  }
   DLOGI("Initializing supported display slots...done!");
 
   // Create primary display here. Remaining builtin displays will be created after client has set
   // display indexes which may happen sometime before callback is registered.
   DLOGI("Creating the Primary display");
-  status = CreatePrimaryDisplay();
+  {
+    ScopedStartupStage stage("CreatePrimaryDisplay");
+    status = CreatePrimaryDisplay();
+  }
   if (status) {
     DLOGE("Creating the Primary display...failed!");
     // De-initialize
@@ -601,6 +595,9 @@ void HWCSession::Dump(uint32_t *out_size, char *out_buffer) {
       }
     }
     Fence::Dump(&os);
+    StageLatency::Dump(&os);
+    os << "\nStartup timeline:\n";
+    StartupTimeline::Dump(&os);
 
     std::string s = os.str();
     auto copied = s.copy(out_buffer, std::min(s.size(), max_dump_size), 0);
@@ -867,6 +864,8 @@ HWC3::Error HWCSession::PresentDisplay(Display display, shared_ptr<Fence> *out_r
 }
 
 void HWCSession::PostCommitLocked(Display display, shared_ptr<Fence> &retire_fence) {
+  StartupTimeline::Finish("First frame committed");
+
   // Check if hwc's refresh trigger is getting exercised.
   if (callbacks_.NeedsRefresh(display)) {
     hwc_display_[display]->SetPendingRefresh();
@@ -947,11 +946,18 @@ void HWCSession::RegisterCallback(CallbackCommand descriptor, void *callback_dat
     }
     // Create displays since they should now have their final display indices set.
     DLOGI("Handling built-in displays...");
-    if (HandleBuiltInDisplays()) {
-      DLOGW("Failed handling built-in displays.");
+    {
+      ScopedStartupStage stage("HandleBuiltInDisplays");
+      if (HandleBuiltInDisplays()) {
+        DLOGW("Failed handling built-in displays.");
+      }
     }
     DLOGI("Handling pluggable displays...");
-    int32_t err = HandlePluggableDisplays(false);
+    int32_t err = 0;
+    {
+      ScopedStartupStage stage("HandlePluggableDisplays");
+      err = HandlePluggableDisplays(false);
+    }
     if (err) {
       DLOGW("All displays could not be created. Error %d '%s'. Hotplug handling %s.", err,
             strerror(abs(err)), pending_hotplug_event_ == kHotPlugEvent ? "deferred" : "dropped");
@@ -3038,16 +3044,25 @@ int HWCSession::HandlePluggableDisplays(bool delay_hotplug) {
   hwc2_display_t virtual_display_index = (hwc2_display_t)GetDisplayIndex(qdutils::DISPLAY_VIRTUAL);
   std::bitset<kSecureMax> secure_sessions = 0;
 
+  // Hotplug handling runs in stages: display discovery, creation of the SDM displays and publishing
+  // them to the client. Creation takes no display lock, publishing takes the slot locks and
+  // WaitForResources() takes the active built-in lock only to reconfigure it. The secure sessions
+  // are the ones the last HandleSecureSession() saw on the active built-in, at most a frame old. A
+  // session starting since then is applied by the next HandleSecureSession() to every display,
+  // including the ones published here, just as for a session starting after a locked query.
   hwc2_display_t active_builtin_disp_id = GetActiveBuiltinDisplay();
   if (active_builtin_disp_id < HWCCallbacks::kNumDisplays) {
-    Locker::ScopeLock lock_a(locker_[active_builtin_disp_id]);
-    hwc_display_[active_builtin_disp_id]->GetActiveSecureSession(&secure_sessions);
+    secure_sessions = active_secure_sessions_.load();
   }
 
   if (secure_sessions.any() || hwc_display_[virtual_display_index]) {
     // Defer hotplug handling.
     DLOGI("Marking hotplug pending...");
     pending_hotplug_event_ = kHotPlugEvent;
+    if (secure_sessions.any()) {
+      // The pending hotplug is handled after a commit once the session has ended.
+      callbacks_.Refresh(active_builtin_disp_id);
+    }
     return -EAGAIN;
   }
 
@@ -3065,7 +3080,7 @@ int HWCSession::HandlePluggableDisplays(bool delay_hotplug) {
     return status;
   }
 
-  status = HandleConnectedDisplays(&hw_displays_info, delay_hotplug);
+  status = HandleConnectedDisplays(&hw_displays_info, delay_hotplug, active_builtin_disp_id);
   if (status) {
     switch (status) {
       case -EAGAIN:
@@ -3095,12 +3110,20 @@ int HWCSession::HandlePluggableDisplays(bool delay_hotplug) {
   return 0;
 }
 
-int HWCSession::HandleConnectedDisplays(HWDisplaysInfo *hw_displays_info, bool delay_hotplug) {
-  int status = 0;
-  Display client_id = 0;
+int HWCSession::HandleConnectedDisplays(HWDisplaysInfo *hw_displays_info, bool delay_hotplug,
+                                        Display active_builtin_id) {
+  struct PendingDisplay {
+    DisplayMapInfo *map_info = nullptr;
+    HWDisplayInfo info = {};
+    HWCDisplay *hwc_display = nullptr;
+    bool test_pattern = false;
+    bool has_hdr = false;
+  };
 
-  Display active_builtin = GetActiveBuiltinDisplay();
+  int status = 0;
+  std::vector<PendingDisplay> pending_displays;
 
+  // Discovery: pair each newly connected display with a free pluggable slot.
   for (auto &iter : *hw_displays_info) {
     auto &info = iter.second;
 
@@ -3129,6 +3152,8 @@ int HWCSession::HandleConnectedDisplays(HWDisplaysInfo *hw_displays_info, bool d
       }
     });
 
+    // A display created in this pass has not been committed either.
+    first_commit_pending |= !pending_displays.empty();
     if (!disable_hotplug_bwcheck_ && first_commit_pending) {
       // Hotplug bandwidth check is accomplished by creating and hotplugging a new display after
       // a display commit has happened on previous hotplugged displays. This allows the driver to
@@ -3137,67 +3162,96 @@ int HWCSession::HandleConnectedDisplays(HWDisplaysInfo *hw_displays_info, bool d
       status = -EAGAIN;
       if (callbacks_.IsClientConnected()) {
         // Trigger a display refresh since we depend on PresentDisplay() to handle pending hotplugs.
-        Display active_builtin_disp_id = GetActiveBuiltinDisplay();
-        if (active_builtin_disp_id >= HWCCallbacks::kNumDisplays) {
-          active_builtin_disp_id = HWC_DISPLAY_PRIMARY;
+        Display refresh_id = active_builtin_id;
+        if (refresh_id >= HWCCallbacks::kNumDisplays) {
+          refresh_id = HWC_DISPLAY_PRIMARY;
         }
-        callbacks_.Refresh(active_builtin_disp_id);
+        callbacks_.Refresh(refresh_id);
       }
       break;
     }
 
     // find an empty slot to create display.
     for (auto &map_info : map_info_pluggable_) {
-      client_id = map_info.client_id;
-
-      SCOPE_LOCK(locker_[client_id]);
-      auto &hwc_display = hwc_display_[client_id];
-      if (hwc_display) {
-        // Display slot is already used.
+      Display client_id = map_info.client_id;
+      auto slot_taken = std::find_if(pending_displays.begin(), pending_displays.end(),
+                                     [&](auto &p) { return p.map_info == &map_info; });
+      if (slot_taken != pending_displays.end()) {
         continue;
       }
 
-      DLOGI("Create pluggable display, sdm id = %d, client id = %d", info.display_id,
-            UINT32(client_id));
-
-      // Test pattern generation ?
-      map_info.test_pattern = (hpd_bpp_ > 0) && (hpd_pattern_ > 0);
-      int err = 0;
-      if (!map_info.test_pattern) {
-        err = HWCDisplayPluggable::Create(core_intf_, &buffer_allocator_, &callbacks_, this,
-                                          qservice_, client_id, info.display_id, 0, 0, false,
-                                          &hwc_display);
-      } else {
-        err = HWCDisplayPluggableTest::Create(core_intf_, &buffer_allocator_, &callbacks_, this,
-                                              qservice_, client_id, info.display_id,
-                                              UINT32(hpd_bpp_), UINT32(hpd_pattern_), &hwc_display);
+      {
+        SCOPE_LOCK(locker_[client_id]);
+        if (hwc_display_[client_id]) {
+          // Display slot is already used.
+          continue;
+        }
       }
 
-      if (err) {
-        DLOGW("Pluggable display creation failed/aborted. Error %d '%s'.", err, strerror(abs(err)));
-        status = err;
-        // Attempt creating remaining pluggable displays.
-        break;
-      }
+      PendingDisplay pending_display;
+      pending_display.map_info = &map_info;
+      pending_display.info = info;
+      pending_displays.push_back(pending_display);
+      break;
+    }
+  }
 
-      {
-        SCOPE_LOCK(hdr_locker_[client_id]);
-        is_hdr_display_[UINT32(client_id)] = HasHDRSupport(hwc_display);
-      }
+  // Creation: the displays are not visible to the client yet, no display lock is needed.
+  for (auto &pending_display : pending_displays) {
+    Display client_id = pending_display.map_info->client_id;
+    int32_t sdm_id = pending_display.info.display_id;
+    DLOGI("Create pluggable display, sdm id = %d, client id = %d", sdm_id, UINT32(client_id));
 
-      DLOGI("Created pluggable display successfully: sdm id = %d, client id = %d", info.display_id,
-            UINT32(client_id));
+    // Test pattern generation ?
+    pending_display.test_pattern = (hpd_bpp_ > 0) && (hpd_pattern_ > 0);
+    int err = 0;
+    if (!pending_display.test_pattern) {
+      err = HWCDisplayPluggable::Create(core_intf_, &buffer_allocator_, &callbacks_, this,
+                                        qservice_, client_id, sdm_id, 0, 0, false,
+                                        &pending_display.hwc_display);
+    } else {
+      err = HWCDisplayPluggableTest::Create(core_intf_, &buffer_allocator_, &callbacks_, this,
+                                            qservice_, client_id, sdm_id, UINT32(hpd_bpp_),
+                                            UINT32(hpd_pattern_), &pending_display.hwc_display);
+    }
 
-      map_info.disp_type = info.display_type;
-      map_info.sdm_id = info.display_id;
+    if (err) {
+      DLOGW("Pluggable display creation failed/aborted. Error %d '%s'.", err, strerror(abs(err)));
+      status = err;
+      pending_display.hwc_display = nullptr;
+      // Attempt creating remaining pluggable displays.
+      continue;
+    }
 
-      map_active_displays_.insert(std::make_pair(client_id, &map_info));
+    pending_display.has_hdr = HasHDRSupport(pending_display.hwc_display);
+    DLOGI("Created pluggable display successfully: sdm id = %d, client id = %d", sdm_id,
+          UINT32(client_id));
+  }
 
-      pending_hotplugs_.push_back((Display)client_id);
+  // Publish: hand the displays over to their slots.
+  Display client_id = 0;
+  for (auto &pending_display : pending_displays) {
+    if (!pending_display.hwc_display) {
+      continue;
+    }
 
-      // Display is created for this sdm id, move to next connected display.
-      break;
+    DisplayMapInfo &map_info = *pending_display.map_info;
+    client_id = map_info.client_id;
+    {
+      SCOPE_LOCK(locker_[client_id]);
+      hwc_display_[client_id] = pending_display.hwc_display;
+      map_info.test_pattern = pending_display.test_pattern;
+      map_info.disp_type = pending_display.info.display_type;
+      map_info.sdm_id = pending_display.info.display_id;
+      map_active_displays_.insert(std::make_pair(client_id, &map_info));
+    }
+
+    {
+      SCOPE_LOCK(hdr_locker_[client_id]);
+      is_hdr_display_[UINT32(client_id)] = pending_display.has_hdr;
     }
+
+    pending_hotplugs_.push_back(client_id);
   }
 
   // No display was created.
@@ -3206,9 +3260,8 @@ int HWCSession::HandleConnectedDisplays(HWDisplaysInfo *hw_displays_info, bool d
   }
 
   // Active builtin display needs revalidation
-  Display active_builtin_disp_id = GetActiveBuiltinDisplay();
-  if (active_builtin_disp_id < HWCCallbacks::kNumDisplays) {
-    auto ret = WaitForResources(delay_hotplug, active_builtin_disp_id, client_id);
+  if (active_builtin_id < HWCCallbacks::kNumDisplays) {
+    auto ret = WaitForResources(delay_hotplug, active_builtin_id, client_id);
     if (ret != HWC3::Error::None) {
       return -EAGAIN;
     }
@@ -3520,6 +3573,7 @@ void HWCSession::HandleSecureSession() {
     }
     Locker::ScopeLock lock_d(locker_[active_builtin_disp_id]);
     hwc_display_[active_builtin_disp_id]->GetActiveSecureSession(&secure_sessions);
+    active_secure_sessions_ = UINT32(secure_sessions.to_ulong());
   }
 
   if (secure_sessions[kSecureDisplay] || secure_sessions[kSecureCamera]) {
@@ -432,7 +432,8 @@ class HWCSession : public HWCUEvent,
   int CreatePrimaryDisplay();
   int HandleBuiltInDisplays();
   int HandlePluggableDisplays(bool delay_hotplug);
-  int HandleConnectedDisplays(HWDisplaysInfo *hw_displays_info, bool delay_hotplug);
+  int HandleConnectedDisplays(HWDisplaysInfo *hw_displays_info, bool delay_hotplug,
+                              Display active_builtin_id);
   int HandleDisconnectedDisplays(HWDisplaysInfo *hw_displays_info);
   void DestroyDisplay(DisplayMapInfo *map_info);
   void DestroyDisplayLocked(DisplayMapInfo *map_info);
@@ -601,6 +602,7 @@ class HWCSession : public HWCUEvent,
   bool tui_state_transition_[HWCCallbacks::kNumDisplays] = {};
   std::bitset<HWCCallbacks::kNumDisplays> display_ready_;
   bool secure_session_active_ = false;
+  std::atomic<uint32_t> active_secure_sessions_ = 0;  // Of the active built-in, at its last present
   bool is_client_up_ = false;
   std::shared_ptr<IPCIntf> ipc_intf_ = nullptr;
   bool primary_pending_ = true;
@@ -35,6 +35,7 @@
  */
 
 #include <QtiGralloc.h>
+#include <errno.h>
 #include <sync/sync.h>
 
 #include <TonemapFactory.h>
@@ -49,6 +50,7 @@
 
 #include <vector>
 
+#include "cpu_blit_buffer.h"
 #include "hwc_debugger.h"
 #include "hwc_tonemapper.h"
 
@@ -56,6 +58,27 @@
 
 namespace sdm {
 
+#ifndef TARGET_HEADLESS
+// The fallback only runs while the GPU is unavailable, so it is kept to a small pool.
+static const int kCpuToneMapThreads = 2;
+
+static int GetCpuToneMapFormat(CpuBlitFormat format) {
+  switch (format) {
+    case kCpuBlitRGBA8888:
+      return TONEMAP_FORMAT_RGBA8888;
+    case kCpuBlitRGBA1010102:
+      return TONEMAP_FORMAT_RGBA1010102;
+    default:
+      return -1;
+  }
+}
+
+// Linear RGBA only, UBWC variants are formats of their own.
+static bool IsCpuToneMapFormat(LayerBufferFormat format) {
+  return format == kFormatRGBA8888 || format == kFormatRGBA1010102;
+}
+#endif
+
 ToneMapSession::ToneMapSession(HWCBufferAllocator *buffer_allocator)
     : tone_map_task_(*this), buffer_allocator_(buffer_allocator) {
   buffer_info_.resize(kNumIntermediateBuffers);
@@ -73,20 +96,15 @@ void ToneMapSession::OnTask(const ToneMapTaskCode &task_code,
 #ifndef TARGET_HEADLESS
     case ToneMapTaskCode::kCodeGetInstance: {
       ToneMapGetInstanceContext *ctx = static_cast<ToneMapGetInstanceContext *>(task_context);
-      Lut3d &lut_3d = ctx->layer->lut_3d;
-      Color10Bit *grid_entries = NULL;
-      int grid_size = 0;
-      if (lut_3d.validGridEntries) {
-        grid_entries = lut_3d.gridEntries;
-        grid_size = INT(lut_3d.gridSize);
-      }
-      gpu_tone_mapper_ =
-          TonemapperFactory_GetInstance(tone_map_config_.type, lut_3d.lutEntries, lut_3d.dim,
-                                        grid_entries, grid_size, tone_map_config_.secure);
+      CreateToneMapper(ctx->layer);
     } break;
 
     case ToneMapTaskCode::kCodeBlit: {
       ToneMapBlitContext *ctx = static_cast<ToneMapBlitContext *>(task_context);
+      if (!gpu_tone_mapper_) {
+        ctx->error = CpuBlit(ctx->layer, ctx->merged);
+        break;
+      }
       uint8_t buffer_index = current_buffer_index_;
       const void *dst_hnd = reinterpret_cast<const void *>(buffer_info_[buffer_index].private_data);
       const void *src_hnd = reinterpret_cast<const void *>(ctx->layer->input_buffer.buffer_id);
@@ -96,6 +114,7 @@ void ToneMapSession::OnTask(const ToneMapTaskCode &task_code,
 
     case ToneMapTaskCode::kCodeDestroy: {
       delete gpu_tone_mapper_;
+      delete cpu_tone_mapper_;
     } break;
 
 #endif
@@ -104,6 +123,73 @@ void ToneMapSession::OnTask(const ToneMapTaskCode &task_code,
   }
 }
 
+#ifndef TARGET_HEADLESS
+void ToneMapSession::CreateToneMapper(Layer *layer) {
+  Lut3d &lut_3d = layer->lut_3d;
+  Color10Bit *grid_entries = NULL;
+  int grid_size = 0;
+  if (lut_3d.validGridEntries) {
+    grid_entries = lut_3d.gridEntries;
+    grid_size = INT(lut_3d.gridSize);
+  }
+  gpu_tone_mapper_ =
+      TonemapperFactory_GetInstance(tone_map_config_.type, lut_3d.lutEntries, lut_3d.dim,
+                                    grid_entries, grid_size, tone_map_config_.secure);
+  if (gpu_tone_mapper_ || tone_map_config_.secure) {
+    return;
+  }
+
+  // Secure buffers can not be mapped. Other layers the CPU can not read or write, such as YUV or
+  // UBWC video, leave the session inactive so that tone mapping fails as without the fallback.
+  LayerBufferFormat src_format = layer->input_buffer.format;
+  if (!IsCpuToneMapFormat(src_format) || !IsCpuToneMapFormat(layer->request.format)) {
+    DLOGW("GPU tone mapper unavailable, CPU tone mapping of %s to %s is not supported",
+          GetFormatString(src_format), GetFormatString(layer->request.format));
+    return;
+  }
+
+  DLOGW("GPU tone mapper unavailable, falling back to the CPU");
+  cpu_tone_mapper_ = TonemapperFactory_GetCpuInstance(
+      tone_map_config_.type, lut_3d.lutEntries, lut_3d.dim, grid_entries, grid_size,
+      TONEMAP_INTERPOLATION_TRILINEAR, kCpuToneMapThreads);
+}
+
+int ToneMapSession::CpuBlit(const Layer *layer, const shared_ptr<Fence> &acquire_fence) {
+  DTRACE_SCOPED();
+  const native_handle_t *src_hnd =
+      reinterpret_cast<const native_handle_t *>(layer->input_buffer.buffer_id);
+  const native_handle_t *dst_hnd =
+      static_cast<const native_handle_t *>(buffer_info_[current_buffer_index_].private_data);
+
+  // Mapping waits for the source and the release of the previous use of the destination.
+  CpuBlitBuffer src(buffer_allocator_);
+  CpuBlitBuffer dst(buffer_allocator_);
+  if (src.Map(src_hnd, acquire_fence, false) != 0 || dst.Map(dst_hnd, acquire_fence, true) != 0) {
+    return -EINVAL;
+  }
+
+  const CpuBlitImage &src_image = src.GetImage();
+  const CpuBlitImage &dst_image = dst.GetImage();
+  CpuImage cpu_src = {src_image.planes[0].base, INT(src_image.width), INT(src_image.height),
+                      INT(src_image.planes[0].stride / 4), GetCpuToneMapFormat(src_image.format)};
+  CpuImage cpu_dst = {dst_image.planes[0].base, INT(dst_image.width), INT(dst_image.height),
+                      INT(dst_image.planes[0].stride / 4), GetCpuToneMapFormat(dst_image.format)};
+  if (cpu_src.format < 0 || cpu_dst.format < 0) {
+    DLOGE("CPU tone mapping of format %d to %d is not supported", src_image.format,
+          dst_image.format);
+    return -ENOTSUP;
+  }
+
+  // The output is complete when blit() returns, so the layer needs no acquire fence.
+  if (cpu_tone_mapper_->blit(cpu_dst, cpu_src) != 0) {
+    DLOGE("CPU tone mapping failed");
+    return -EINVAL;
+  }
+
+  return 0;
+}
+#endif
+
 DisplayError ToneMapSession::AllocateIntermediateBuffers(const Layer *layer) {
   for (uint8_t i = 0; i < kNumIntermediateBuffers; i++) {
     BufferInfo &buffer_info = buffer_info_[i];
@@ -149,12 +235,17 @@ void ToneMapSession::SetToneMapConfig(Layer *layer, PrimariesTransfer blend_cs)
   tone_map_config_.type = layer->input_buffer.flags.hdr ? TONEMAP_FORWARD : TONEMAP_INVERSE;
   tone_map_config_.blend_cs = blend_cs;
   tone_map_config_.transfer = layer->input_buffer.color_metadata.transfer;
+  tone_map_config_.primaries = layer->input_buffer.color_metadata.colorPrimaries;
+  const MasteringDisplay &mastering = layer->input_buffer.color_metadata.masteringDisplayInfo;
+  tone_map_config_.max_luminance = mastering.maxDisplayLuminance;
+  tone_map_config_.min_luminance = mastering.minDisplayLuminance;
   tone_map_config_.secure = layer->request.flags.secure;
   tone_map_config_.format = layer->request.format;
 }
 
 bool ToneMapSession::IsSameToneMapConfig(Layer *layer, PrimariesTransfer blend_cs) {
   LayerBuffer &buffer = layer->input_buffer;
+  const MasteringDisplay &mastering = buffer.color_metadata.masteringDisplayInfo;
   native_handle_t *handle = static_cast<native_handle_t *>(buffer_info_[0].private_data);
   int tonemap_type = buffer.flags.hdr ? TONEMAP_FORWARD : TONEMAP_INVERSE;
 
@@ -163,15 +254,27 @@ bool ToneMapSession::IsSameToneMapConfig(Layer *layer, PrimariesTransfer blend_c
   buffer_allocator_->GetUnalignedHeight(handle, handle_unaligned_height);
   return ((tonemap_type == tone_map_config_.type) && (blend_cs == tone_map_config_.blend_cs) &&
           (buffer.color_metadata.transfer == tone_map_config_.transfer) &&
+          (buffer.color_metadata.colorPrimaries == tone_map_config_.primaries) &&
+          (mastering.maxDisplayLuminance == tone_map_config_.max_luminance) &&
+          (mastering.minDisplayLuminance == tone_map_config_.min_luminance) &&
           (layer->request.flags.secure == tone_map_config_.secure) &&
           (layer->request.format == tone_map_config_.format) &&
           (layer->request.width == handle_unaligned_width) &&
           (layer->request.height == handle_unaligned_height));
 }
 
+HWCToneMapper::HWCToneMapper(HWCBufferAllocator *allocator) : buffer_allocator_(allocator) {
+  int budget = 0;
+  if (HWCDebugHandler::Get()->GetProperty(TONEMAP_SESSION_BUDGET, &budget) == kErrorNone &&
+      budget > 0) {
+    session_budget_ = UINT32(budget);
+  }
+}
+
 int HWCToneMapper::HandleToneMap(LayerStack *layer_stack) {
   uint32_t gpu_count = 0;
   DisplayError error = kErrorNone;
+  frame_count_++;
 
   for (uint32_t i = 0; i < layer_stack->layers.size(); i++) {
     uint32_t session_index = 0;
@@ -212,7 +315,10 @@ int HWCToneMapper::HandleToneMap(LayerStack *layer_stack) {
       }
 
       ToneMapSession *session = tone_map_sessions_.at(session_index);
-      ToneMap(layer, session);
+      if (ToneMap(layer, session) != 0) {
+        Terminate();
+        return -1;
+      }
       DLOGI_IF(kTagClient, "Layer %d associated with session index %d", i, session_index);
       session->layer_index_ = INT(i);
     }
@@ -221,7 +327,7 @@ int HWCToneMapper::HandleToneMap(LayerStack *layer_stack) {
   return 0;
 }
 
-void HWCToneMapper::ToneMap(Layer *layer, ToneMapSession *session) {
+int HWCToneMapper::ToneMap(Layer *layer, ToneMapSession *session) {
   ToneMapBlitContext ctx = {};
   ctx.layer = layer;
 
@@ -236,34 +342,68 @@ void HWCToneMapper::ToneMap(Layer *layer, ToneMapSession *session) {
   session->tone_map_task_.PerformTask(ToneMapTaskCode::kCodeBlit, &ctx);
   DTRACE_END();
 
+  // The intermediate buffer holds a stale frame, it must not be displayed.
+  if (ctx.error != 0) {
+    return ctx.error;
+  }
+
   DumpToneMapOutput(session, ctx.fence);
   session->UpdateBuffer(ctx.fence, &layer->input_buffer);
+
+  return 0;
 }
 
 void HWCToneMapper::PostCommit(LayerStack *layer_stack) {
-  auto it = tone_map_sessions_.begin();
-  while (it != tone_map_sessions_.end()) {
-    uint32_t session_index = UINT32(std::distance(tone_map_sessions_.begin(), it));
-    ToneMapSession *session = tone_map_sessions_.at(session_index);
+  for (auto session : tone_map_sessions_) {
     if (session->acquired_) {
       Layer *layer = layer_stack->layers.at(UINT32(session->layer_index_));
       // Close the fd returned by GPU ToneMapper and set release fence.
       LayerBuffer &layer_buffer = layer->input_buffer;
       session->SetReleaseFence(layer_buffer.release_fence);
       session->acquired_ = false;
-      it++;
-    } else {
-      DLOGI_IF(kTagClient, "Tone map session %d closed.", session_index);
-      delete session;
-      it = tone_map_sessions_.erase(it);
-      int deleted_session = INT(session_index);
-      // If FB tonemap session gets deleted, reset fb_session_index_, else update it.
-      if (deleted_session == fb_session_index_) {
-        fb_session_index_ = -1;
-      } else if (deleted_session < fb_session_index_) {
-        fb_session_index_--;
+      session->last_used_frame_ = frame_count_;
+    }
+  }
+
+  // Layers may alternate between configurations from one frame to the next, e.g. PiP and main
+  // video with different metadata, so unused sessions stay around while within the budget.
+  EvictIdleSessions();
+}
+
+void HWCToneMapper::EvictIdleSessions() {
+  while (tone_map_sessions_.size() > session_budget_) {
+    int lru_index = -1;
+    for (uint32_t i = 0; i < tone_map_sessions_.size(); i++) {
+      ToneMapSession *session = tone_map_sessions_.at(i);
+      if (session->last_used_frame_ == frame_count_) {
+        continue;
+      }
+      if (lru_index < 0 ||
+          session->last_used_frame_ < tone_map_sessions_.at(UINT32(lru_index))->last_used_frame_) {
+        lru_index = INT(i);
       }
     }
+
+    // Sessions used by the current frame are never evicted.
+    if (lru_index < 0) {
+      break;
+    }
+
+    DLOGI_IF(kTagClient, "Tone map session %d evicted.", lru_index);
+    DeleteSession(UINT32(lru_index));
+    sessions_evicted_++;
+  }
+}
+
+void HWCToneMapper::DeleteSession(uint32_t session_index) {
+  delete tone_map_sessions_.at(session_index);
+  tone_map_sessions_.erase(tone_map_sessions_.begin() + session_index);
+  int deleted_session = INT(session_index);
+  // If FB tonemap session gets deleted, reset fb_session_index_, else update it.
+  if (deleted_session == fb_session_index_) {
+    fb_session_index_ = -1;
+  } else if (deleted_session < fb_session_index_) {
+    fb_session_index_--;
   }
 }
 
@@ -277,6 +417,23 @@ void HWCToneMapper::Terminate() {
   }
 }
 
+void HWCToneMapper::Dump(std::ostringstream *os) {
+  *os << "sessions: " << tone_map_sessions_.size() << "/" << session_budget_;
+  *os << " created: " << sessions_created_ << " reused: " << sessions_reused_;
+  *os << " evicted: " << sessions_evicted_ << std::endl;
+  for (uint32_t i = 0; i < tone_map_sessions_.size(); i++) {
+    const ToneMapConfig &config = tone_map_sessions_.at(i)->tone_map_config_;
+    *os << "session " << i << ": type: " << config.type;
+    *os << " transfer: " << config.transfer << " primaries: " << config.primaries;
+    *os << " mastering: " << config.min_luminance << "-" << config.max_luminance;
+    *os << " blend: " << config.blend_cs.primaries << "/" << config.blend_cs.transfer;
+    *os << " format: " << GetFormatString(config.format) << " secure: " << config.secure;
+    *os << " backend: " << (tone_map_sessions_.at(i)->gpu_tone_mapper_ ? "gpu" : "cpu");
+    *os << " idle frames: " << (frame_count_ - tone_map_sessions_.at(i)->last_used_frame_);
+    *os << std::endl;
+  }
+}
+
 void HWCToneMapper::SetFrameDumpConfig(uint32_t count) {
   DLOGI("Dump FrameConfig count = %d", count);
   dump_frame_count_ = count;
@@ -344,6 +501,7 @@ DisplayError HWCToneMapper::AcquireToneMapSession(Layer *layer, uint32_t *sessio
           (tonemap_session->current_buffer_index_ + 1) % ToneMapSession::kNumIntermediateBuffers;
       tonemap_session->acquired_ = true;
       *session_index = i;
+      sessions_reused_++;
       return kErrorNone;
     }
   }
@@ -359,7 +517,7 @@ DisplayError HWCToneMapper::AcquireToneMapSession(Layer *layer, uint32_t *sessio
   ctx.layer = layer;
   session->tone_map_task_.PerformTask(ToneMapTaskCode::kCodeGetInstance, &ctx);
 
-  if (session->gpu_tone_mapper_ == NULL) {
+  if (!session->IsActive()) {
     DLOGE("Get Tonemapper failed!");
     delete session;
     return kErrorNotSupported;
@@ -373,6 +531,7 @@ DisplayError HWCToneMapper::AcquireToneMapSession(Layer *layer, uint32_t *sessio
 
   session->acquired_ = true;
   tone_map_sessions_.push_back(session);
+  sessions_created_++;
   *session_index = UINT32(tone_map_sessions_.size() - 1);
 
   return kErrorNone;
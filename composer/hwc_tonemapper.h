@@ -43,11 +43,13 @@
 #include <core/layer_stack.h>
 #include <utils/sys.h>
 #include <utils/sync_task.h>
+#include <sstream>
 #include <vector>
 #include "hwc_buffer_sync_handler.h"
 #include "hwc_buffer_allocator.h"
 
 class Tonemapper;
+class CpuTonemapper;
 
 namespace sdm {
 
@@ -65,12 +67,17 @@ struct ToneMapBlitContext : public SyncTask<ToneMapTaskCode>::TaskContext {
   Layer *layer = nullptr;
   shared_ptr<Fence> merged = nullptr;
   shared_ptr<Fence> fence = nullptr;
+  int error = 0;
 };
 
+// Content signature of a session; layers with the same one can share its Tonemapper and 3D LUT.
 struct ToneMapConfig {
   int type = 0;
   PrimariesTransfer blend_cs = {};
   GammaTransfer transfer = Transfer_Max;
+  ColorPrimaries primaries = ColorPrimaries_BT709_5;
+  uint32_t max_luminance = 0;  // Mastering display luminance, cd/m2
+  uint32_t min_luminance = 0;  // Mastering display luminance, 0.0001 cd/m2
   LayerBufferFormat format = kFormatRGBA8888;
   bool secure = false;
 };
@@ -79,6 +86,9 @@ class ToneMapSession : public SyncTask<ToneMapTaskCode>::TaskHandler {
  public:
   explicit ToneMapSession(HWCBufferAllocator *buffer_allocator);
   ~ToneMapSession();
+  void CreateToneMapper(Layer *layer);
+  // Returns 0 once the intermediate buffer holds the tone mapped layer, no fence is needed.
+  int CpuBlit(const Layer *layer, const shared_ptr<Fence> &acquire_fence);
   DisplayError AllocateIntermediateBuffers(const Layer *layer);
   void FreeIntermediateBuffers();
   void UpdateBuffer(const shared_ptr<Fence> &acquire_fence, LayerBuffer *buffer);
@@ -89,10 +99,13 @@ class ToneMapSession : public SyncTask<ToneMapTaskCode>::TaskHandler {
   // TaskHandler methods implementation.
   virtual void OnTask(const ToneMapTaskCode &task_code,
                       SyncTask<ToneMapTaskCode>::TaskContext *task_context);
+  bool IsActive() const { return gpu_tone_mapper_ || cpu_tone_mapper_; }
 
   static const uint8_t kNumIntermediateBuffers = 2;
   SyncTask<ToneMapTaskCode> tone_map_task_;
   Tonemapper *gpu_tone_mapper_ = nullptr;
+  // Used when the GPU tone mapper can not be created, for non secure linear RGB layers only.
+  CpuTonemapper *cpu_tone_mapper_ = nullptr;
   HWCBufferAllocator *buffer_allocator_ = nullptr;
   ToneMapConfig tone_map_config_ = {};
   uint8_t current_buffer_index_ = 0;
@@ -100,11 +113,12 @@ class ToneMapSession : public SyncTask<ToneMapTaskCode>::TaskHandler {
   shared_ptr<Fence> release_fence_[kNumIntermediateBuffers] = {nullptr, nullptr};
   bool acquired_ = false;
   int layer_index_ = -1;
+  uint64_t last_used_frame_ = 0;
 };
 
 class HWCToneMapper {
  public:
-  explicit HWCToneMapper(HWCBufferAllocator *allocator) : buffer_allocator_(allocator) {}
+  explicit HWCToneMapper(HWCBufferAllocator *allocator);
   ~HWCToneMapper() {}
 
   int HandleToneMap(LayerStack *layer_stack);
@@ -112,17 +126,26 @@ class HWCToneMapper {
   void PostCommit(LayerStack *layer_stack);
   void SetFrameDumpConfig(uint32_t count);
   void Terminate();
+  void Dump(std::ostringstream *os);
 
  private:
-  void ToneMap(Layer *layer, ToneMapSession *session);
+  int ToneMap(Layer *layer, ToneMapSession *session);
   DisplayError AcquireToneMapSession(Layer *layer, uint32_t *sess_idx, PrimariesTransfer blend_cs);
   void DumpToneMapOutput(ToneMapSession *session, shared_ptr<sdm::Fence> acquire_fence);
+  void DeleteSession(uint32_t session_index);
+  void EvictIdleSessions();
 
   std::vector<ToneMapSession *> tone_map_sessions_;
   HWCBufferAllocator *buffer_allocator_ = nullptr;
   uint32_t dump_frame_count_ = 0;
   uint32_t dump_frame_index_ = 0;
   int fb_session_index_ = -1;
+  // Sessions not acquired by a frame stay cached until more than session_budget_ are alive.
+  uint32_t session_budget_ = 4;
+  uint64_t frame_count_ = 0;
+  uint64_t sessions_created_ = 0;
+  uint64_t sessions_reused_ = 0;
+  uint64_t sessions_evicted_ = 0;
 };
 
 }  // namespace sdm
@@ -188,7 +188,8 @@ SOONG_CONFIG_qtidisplay := drmpp headless llvmsa \
                            gralloc4 displayconfig_enabled \
                            default var1 var2 var3 llvmcov  \
                            composer_version smmu_proxy \
-                           ubwcp_headers sixzone_version
+                           ubwcp_headers sixzone_version \
+                           release_logs
 
 # Soong Values
 SOONG_CONFIG_qtidisplay_drmpp := true
@@ -205,6 +206,7 @@ SOONG_CONFIG_qtidisplay_smmu_proxy := false
 SOONG_CONFIG_qtidisplay_ubwcp_headers := true
 SOONG_CONFIG_qtidisplay_composer_version := v2
 SOONG_CONFIG_qtidisplay_sixzone_version := v2
+SOONG_CONFIG_qtidisplay_release_logs := false
 ifeq ($(TARGET_USES_COMPOSER3),true)
     SOONG_CONFIG_qtidisplay_composer_version := v3
     $(warning "Using composer3")
@@ -224,6 +226,10 @@ ifeq ($(call is-vendor-board-platform,QCOM),true)
     SOONG_CONFIG_qtidisplay_displayconfig_enabled := true
 endif
 
+ifeq ($(TARGET_BUILD_VARIANT),user)
+    SOONG_CONFIG_qtidisplay_release_logs := true
+endif
+
 
 ifeq ($(filter $(TARGET_BOARD_PLATFORM), kalama niobe neo61 pineapple), $(TARGET_BOARD_PLATFORM))
     SOONG_CONFIG_qtidisplay_ubwcp_headers := false
@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <errno.h>
+#include <log/log.h>
+#include <string.h>
+#include <algorithm>
+
+#include "CpuTonemapper.h"
+
+namespace {
+
+const int kTileRows = 16;
+// Pixels converted to planar float per step, small enough to stay in L1.
+const int kChunk = 64;
+
+//-----------------------------------------------------------------------------
+// Maps NaN and values outside [0, 1] like CLAMP_TO_EDGE does.
+inline float clamp01(float v)
+//-----------------------------------------------------------------------------
+{
+  return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f;
+}
+
+//-----------------------------------------------------------------------------
+inline float halfToFloat(uint16_t h)
+//-----------------------------------------------------------------------------
+{
+  uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+  uint32_t exponent = (h >> 10) & 0x1f;
+  uint32_t mantissa = h & 0x3ff;
+  uint32_t bits = sign;
+  if (exponent == 0x1f) {
+    bits |= 0x7f800000 | (mantissa << 13);
+  } else if (exponent) {
+    bits |= ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (mantissa) {
+    float value = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+    return sign ? -value : value;
+  }
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+//-----------------------------------------------------------------------------
+// Round to nearest even, overflow goes to infinity.
+inline uint16_t floatToHalf(float value)
+//-----------------------------------------------------------------------------
+{
+  const uint32_t kInfinity = 255 << 23;
+  const uint32_t kHalfMax = (127 + 16) << 23;
+  const uint32_t kDenormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint32_t sign = bits & 0x80000000;
+  bits ^= sign;
+
+  uint32_t half;
+  if (bits >= kHalfMax) {
+    half = (bits > kInfinity) ? 0x7e00 : 0x7c00;
+  } else if (bits < (113 << 23)) {
+    float magic;
+    memcpy(&magic, &kDenormMagic, sizeof(magic));
+    float denorm;
+    memcpy(&denorm, &bits, sizeof(denorm));
+    denorm += magic;
+    memcpy(&bits, &denorm, sizeof(bits));
+    half = bits - kDenormMagic;
+  } else {
+    // Rebias the exponent with a subtraction, bits is at least 113 << 23 here. Adding the
+    // wrapped bias instead would trap in the integer overflow sanitizer.
+    uint32_t mantissaOdd = (bits >> 13) & 1;
+    bits -= (127 - 15) << 23;
+    bits += 0xfff + mantissaOdd;
+    half = bits >> 13;
+  }
+
+  return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+//-----------------------------------------------------------------------------
+inline uint32_t quantize(float v, float max)
+//-----------------------------------------------------------------------------
+{
+  return static_cast<uint32_t>(clamp01(v) * max + 0.5f);
+}
+
+//-----------------------------------------------------------------------------
+inline float sample1D(const float *table, int size, float v)
+//-----------------------------------------------------------------------------
+{
+  float position = clamp01(v) * static_cast<float>(size - 1);
+  int index = std::min(static_cast<int>(position), size - 2);
+  float fraction = position - static_cast<float>(index);
+  return table[index] + fraction * (table[index + 1] - table[index]);
+}
+
+//-----------------------------------------------------------------------------
+int bytesPerPixel(int format)
+//-----------------------------------------------------------------------------
+{
+  switch (format) {
+    case TONEMAP_FORMAT_RGBA8888:
+    case TONEMAP_FORMAT_RGBA1010102:
+      return 4;
+    case TONEMAP_FORMAT_RGBA_FP16:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void unpack(const uint8_t *pixels, int format, int count, float *r, float *g, float *b, float *a)
+//-----------------------------------------------------------------------------
+{
+  if (format == TONEMAP_FORMAT_RGBA8888) {
+    for (int i = 0; i < count; i++) {
+      r[i] = pixels[4 * i] * (1.0f / 255.0f);
+      g[i] = pixels[4 * i + 1] * (1.0f / 255.0f);
+      b[i] = pixels[4 * i + 2] * (1.0f / 255.0f);
+      a[i] = pixels[4 * i + 3] * (1.0f / 255.0f);
+    }
+  } else if (format == TONEMAP_FORMAT_RGBA1010102) {
+    for (int i = 0; i < count; i++) {
+      uint32_t word;
+      memcpy(&word, pixels + 4 * i, sizeof(word));
+      r[i] = static_cast<float>(word & 0x3ff) * (1.0f / 1023.0f);
+      g[i] = static_cast<float>((word >> 10) & 0x3ff) * (1.0f / 1023.0f);
+      b[i] = static_cast<float>((word >> 20) & 0x3ff) * (1.0f / 1023.0f);
+      a[i] = static_cast<float>(word >> 30) * (1.0f / 3.0f);
+    }
+  } else {
+    for (int i = 0; i < count; i++) {
+      uint16_t half[4];
+      memcpy(half, pixels + 8 * i, sizeof(half));
+      r[i] = halfToFloat(half[0]);
+      g[i] = halfToFloat(half[1]);
+      b[i] = halfToFloat(half[2]);
+      a[i] = halfToFloat(half[3]);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Writes rgb, alpha is copied from the source pixel so it is never requantized.
+template <class Float4>
+void pack(const Float4 *rgb, const float *alpha, const uint8_t *srcPixels, int srcFormat,
+          uint8_t *pixels, int format, int count)
+//-----------------------------------------------------------------------------
+{
+  bool sameAlpha = (srcFormat == format);
+  if (format == TONEMAP_FORMAT_RGBA8888) {
+    for (int i = 0; i < count; i++) {
+      pixels[4 * i] = static_cast<uint8_t>(quantize(rgb[i][0], 255.0f));
+      pixels[4 * i + 1] = static_cast<uint8_t>(quantize(rgb[i][1], 255.0f));
+      pixels[4 * i + 2] = static_cast<uint8_t>(quantize(rgb[i][2], 255.0f));
+      pixels[4 * i + 3] = sameAlpha ? srcPixels[4 * i + 3] :
+                                      static_cast<uint8_t>(quantize(alpha[i], 255.0f));
+    }
+  } else if (format == TONEMAP_FORMAT_RGBA1010102) {
+    for (int i = 0; i < count; i++) {
+      uint32_t word = quantize(rgb[i][0], 1023.0f) | (quantize(rgb[i][1], 1023.0f) << 10) |
+                      (quantize(rgb[i][2], 1023.0f) << 20);
+      if (sameAlpha) {
+        uint32_t srcWord;
+        memcpy(&srcWord, srcPixels + 4 * i, sizeof(srcWord));
+        word |= srcWord & 0xc0000000;
+      } else {
+        word |= quantize(alpha[i], 3.0f) << 30;
+      }
+      memcpy(pixels + 4 * i, &word, sizeof(word));
+    }
+  } else {
+    for (int i = 0; i < count; i++) {
+      uint16_t half[4] = {floatToHalf(rgb[i][0]), floatToHalf(rgb[i][1]),
+                          floatToHalf(rgb[i][2]), floatToHalf(alpha[i])};
+      if (sameAlpha) {
+        memcpy(&half[3], srcPixels + 8 * i + 6, sizeof(half[3]));
+      }
+      memcpy(pixels + 8 * i, half, sizeof(half));
+    }
+  }
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+CpuTonemapper::CpuTonemapper()
+//-----------------------------------------------------------------------------
+{
+  type = TONEMAP_FORWARD;
+  interpolation = TONEMAP_INTERPOLATION_TRILINEAR;
+  lutSize = 0;
+  xformSize = 0;
+  dst = {};
+  src = {};
+  nextTile = 0;
+  tileCount = 0;
+  activeWorkers = 0;
+  jobId = 0;
+  exit = false;
+}
+
+//-----------------------------------------------------------------------------
+CpuTonemapper::~CpuTonemapper()
+//-----------------------------------------------------------------------------
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    exit = true;
+  }
+  jobCv.notify_all();
+  for (auto &thread : workers) {
+    thread.join();
+  }
+}
+
+//-----------------------------------------------------------------------------
+CpuTonemapper *CpuTonemapper::build(int type, void *colorMap, int colorMapSize, void *lutXform,
+                                    int lutXformSize, int interpolation, int threadCount)
+//-----------------------------------------------------------------------------
+{
+  if (!colorMap || colorMapSize < 2) {
+    ALOGE("Invalid Color Map size = %d", colorMapSize);
+    return NULL;
+  }
+
+  CpuTonemapper *tonemapper = new CpuTonemapper();
+  tonemapper->type = type;
+  tonemapper->interpolation = interpolation;
+
+  // Same RGB10_A2 layout as engine_load3DTexture, red varies fastest.
+  const uint32_t *entries = reinterpret_cast<const uint32_t *>(colorMap);
+  size_t count = static_cast<size_t>(colorMapSize) * colorMapSize * colorMapSize;
+  tonemapper->lutSize = colorMapSize;
+  tonemapper->lut.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    tonemapper->lut[i] = float4{static_cast<float>(entries[i] & 0x3ff) / 1023.0f,
+                                static_cast<float>((entries[i] >> 10) & 0x3ff) / 1023.0f,
+                                static_cast<float>((entries[i] >> 20) & 0x3ff) / 1023.0f, 0.0f};
+  }
+
+  // The non-uniform xform is a per channel 1D LUT, engine_load1DTexture ignores it when empty.
+  if (lutXform && lutXformSize >= 2) {
+    const uint32_t *xform = reinterpret_cast<const uint32_t *>(lutXform);
+    tonemapper->xformSize = lutXformSize;
+    for (int c = 0; c < 3; c++) {
+      tonemapper->xform[c].resize(lutXformSize);
+      for (int i = 0; i < lutXformSize; i++) {
+        tonemapper->xform[c][i] = static_cast<float>((xform[i] >> (10 * c)) & 0x3ff) / 1023.0f;
+      }
+    }
+  }
+
+  for (int i = 1; i < threadCount; i++) {
+    tonemapper->workers.emplace_back(&CpuTonemapper::worker, tonemapper);
+  }
+
+  return tonemapper;
+}
+
+//-----------------------------------------------------------------------------
+int CpuTonemapper::blit(const CpuImage &dstImage, const CpuImage &srcImage)
+//-----------------------------------------------------------------------------
+{
+  if (!dstImage.base || !srcImage.base || !bytesPerPixel(dstImage.format) ||
+      !bytesPerPixel(srcImage.format) || dstImage.width != srcImage.width ||
+      dstImage.height != srcImage.height || dstImage.width <= 0 || dstImage.height <= 0 ||
+      dstImage.stride < dstImage.width || srcImage.stride < srcImage.width) {
+    ALOGE("Invalid blit %dx%d (format %d) to %dx%d (format %d)", srcImage.width, srcImage.height,
+          srcImage.format, dstImage.width, dstImage.height, dstImage.format);
+    return -EINVAL;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    dst = dstImage;
+    src = srcImage;
+    tileCount = (dst.height + kTileRows - 1) / kTileRows;
+    nextTile = 0;
+    activeWorkers = workers.size();
+    jobId++;
+  }
+  jobCv.notify_all();
+
+  runTiles();
+
+  // Workers take part in every job, so none of them can still be reading this one later.
+  std::unique_lock<std::mutex> lock(mutex);
+  doneCv.wait(lock, [this] { return activeWorkers == 0; });
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void CpuTonemapper::worker()
+//-----------------------------------------------------------------------------
+{
+  uint64_t seenJob = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    jobCv.wait(lock, [&] { return exit || jobId != seenJob; });
+    if (exit) {
+      return;
+    }
+    seenJob = jobId;
+
+    lock.unlock();
+    runTiles();
+    lock.lock();
+
+    if (--activeWorkers == 0) {
+      doneCv.notify_one();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void CpuTonemapper::runTiles()
+//-----------------------------------------------------------------------------
+{
+  for (int tile = nextTile++; tile < tileCount; tile = nextTile++) {
+    processRows(tile * kTileRows, std::min((tile + 1) * kTileRows, dst.height));
+  }
+}
+
+//-----------------------------------------------------------------------------
+void CpuTonemapper::processRows(int first, int last)
+//-----------------------------------------------------------------------------
+{
+  float r[kChunk], g[kChunk], b[kChunk], a[kChunk];
+  float lr[kChunk], lg[kChunk], lb[kChunk];
+  float4 rgb[kChunk];
+  int srcBpp = bytesPerPixel(src.format);
+  int dstBpp = bytesPerPixel(dst.format);
+
+  for (int y = first; y < last; y++) {
+    const uint8_t *srcRow = static_cast<const uint8_t *>(src.base) +
+                            static_cast<size_t>(y) * src.stride * srcBpp;
+    uint8_t *dstRow = static_cast<uint8_t *>(dst.base) + static_cast<size_t>(y) * dst.stride * dstBpp;
+
+    for (int x = 0; x < dst.width; x += kChunk) {
+      int count = std::min(kChunk, dst.width - x);
+      const uint8_t *srcPixels = srcRow + x * srcBpp;
+      unpack(srcPixels, src.format, count, r, g, b, a);
+
+      // rgba_inverse_tonemap works on un-premultiplied color.
+      if (type == TONEMAP_INVERSE) {
+        for (int i = 0; i < count; i++) {
+          float scale = a[i] > 0.0f ? 1.0f / a[i] : 1.0f;
+          lr[i] = r[i] * scale;
+          lg[i] = g[i] * scale;
+          lb[i] = b[i] * scale;
+        }
+      } else {
+        std::copy(r, r + count, lr);
+        std::copy(g, g + count, lg);
+        std::copy(b, b + count, lb);
+      }
+
+      if (xformSize) {
+        for (int i = 0; i < count; i++) {
+          lr[i] = sample1D(xform[0].data(), xformSize, lr[i]);
+          lg[i] = sample1D(xform[1].data(), xformSize, lg[i]);
+          lb[i] = sample1D(xform[2].data(), xformSize, lb[i]);
+        }
+      }
+
+      lookup(lr, lg, lb, rgb, count);
+
+      if (type == TONEMAP_INVERSE) {
+        for (int i = 0; i < count; i++) {
+          // Fully transparent pixels pass through unchanged.
+          if (a[i] > 0.0f) {
+            rgb[i] *= a[i];
+          } else {
+            rgb[i] = float4{r[i], g[i], b[i], 0.0f};
+          }
+        }
+      }
+
+      pack(rgb, a, srcPixels, src.format, dstRow + x * dstBpp, dst.format, count);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void CpuTonemapper::lookup(const float *r, const float *g, const float *b, float4 *out,
+                           int count) const
+//-----------------------------------------------------------------------------
+{
+  const int n = lutSize;
+  const float scale = static_cast<float>(n - 1);
+  const float4 *table = lut.data();
+
+  for (int i = 0; i < count; i++) {
+    float pr = clamp01(r[i]) * scale;
+    float pg = clamp01(g[i]) * scale;
+    float pb = clamp01(b[i]) * scale;
+    int ir = std::min(static_cast<int>(pr), n - 2);
+    int ig = std::min(static_cast<int>(pg), n - 2);
+    int ib = std::min(static_cast<int>(pb), n - 2);
+    float fr = pr - static_cast<float>(ir);
+    float fg = pg - static_cast<float>(ig);
+    float fb = pb - static_cast<float>(ib);
+
+    const float4 *c000 = table + (ib * n + ig) * n + ir;
+    const float4 *c010 = c000 + n;
+    const float4 *c001 = c000 + n * n;
+    const float4 *c011 = c001 + n;
+
+    if (interpolation == TONEMAP_INTERPOLATION_TETRAHEDRAL) {
+      // Interpolate inside the one of the six tetrahedra of the cell that holds the point,
+      // 4 corners instead of 8.
+      if (fr > fg) {
+        if (fg > fb) {
+          out[i] = c000[0] + fr * (c000[1] - c000[0]) + fg * (c010[1] - c000[1]) +
+                   fb * (c011[1] - c010[1]);
+        } else if (fr > fb) {
+          out[i] = c000[0] + fr * (c000[1] - c000[0]) + fb * (c001[1] - c000[1]) +
+                   fg * (c011[1] - c001[1]);
+        } else {
+          out[i] = c000[0] + fb * (c001[0] - c000[0]) + fr * (c001[1] - c001[0]) +
+                   fg * (c011[1] - c001[1]);
+        }
+      } else {
+        if (fb > fg) {
+          out[i] = c000[0] + fb * (c001[0] - c000[0]) + fg * (c011[0] - c001[0]) +
+                   fr * (c011[1] - c011[0]);
+        } else if (fb > fr) {
+          out[i] = c000[0] + fg * (c010[0] - c000[0]) + fb * (c011[0] - c010[0]) +
+                   fr * (c011[1] - c011[0]);
+        } else {
+          out[i] = c000[0] + fg * (c010[0] - c000[0]) + fr * (c010[1] - c010[0]) +
+                   fb * (c011[1] - c010[1]);
+        }
+      }
+    } else {
+      float4 c00 = c000[0] + fr * (c000[1] - c000[0]);
+      float4 c10 = c010[0] + fr * (c010[1] - c010[0]);
+      float4 c01 = c001[0] + fr * (c001[1] - c001[0]);
+      float4 c11 = c011[0] + fr * (c011[1] - c011[0]);
+      float4 c0 = c00 + fg * (c10 - c00);
+      float4 c1 = c01 + fg * (c11 - c01);
+      out[i] = c0 + fb * (c1 - c0);
+    }
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __TONEMAPPER_CPUTONEMAPPER_H__
+#define __TONEMAPPER_CPUTONEMAPPER_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Same program types as Tonemapper, without pulling in EGL.
+#ifndef TONEMAP_FORWARD
+#define TONEMAP_FORWARD 0
+#define TONEMAP_INVERSE 1
+#endif
+
+#define TONEMAP_FORMAT_RGBA8888 0     // R, G, B, A bytes
+#define TONEMAP_FORMAT_RGBA1010102 1  // 32 bit words, R in bits 0-9, A in bits 30-31
+#define TONEMAP_FORMAT_RGBA_FP16 2    // 4 half floats
+
+#define TONEMAP_INTERPOLATION_TRILINEAR 0    // Same as the GL_LINEAR sampler of the GPU engine
+#define TONEMAP_INTERPOLATION_TETRAHEDRAL 1
+
+// A CPU mapped image, stride is in pixels.
+struct CpuImage {
+  void *base;
+  int width;
+  int height;
+  int stride;
+  int format;
+};
+
+// CPU implementation of the forward_tonemap and rgba_inverse_tonemap programs. It takes the same
+// packed RGB10_A2 3D LUT and 1D xform as Tonemapper, so both produce the same result for a given
+// configuration. Rows are split in tiles processed by a pool of worker threads.
+class CpuTonemapper {
+ public:
+  ~CpuTonemapper();
+  static CpuTonemapper *build(int type, void *colorMap, int colorMapSize, void *lutXform,
+                              int lutXformSize, int interpolation, int threadCount);
+  // Returns 0 on success or -EINVAL when the images can not be tone mapped.
+  int blit(const CpuImage &dst, const CpuImage &src);
+
+ private:
+  typedef float float4 __attribute__((vector_size(16)));
+
+  CpuTonemapper();
+  void worker();
+  void runTiles();
+  void processRows(int first, int last);
+  void lookup(const float *r, const float *g, const float *b, float4 *out, int count) const;
+
+  int type;
+  int interpolation;
+  int lutSize;
+  std::vector<float4> lut;
+  int xformSize;
+  std::vector<float> xform[3];
+
+  // Current job, only valid during blit()
+  CpuImage dst;
+  CpuImage src;
+  std::atomic<int> nextTile;
+  int tileCount;
+  size_t activeWorkers;
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable jobCv;
+  std::condition_variable doneCv;
+  uint64_t jobId;
+  bool exit;
+};
+
+#endif  //__TONEMAPPER_CPUTONEMAPPER_H__
@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <math.h>
+#include <string.h>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "CpuTonemapper.h"
+using namespace testing;
+
+namespace {
+
+constexpr int kWidth = 203;  // Not a multiple of the internal chunk size
+constexpr int kHeight = 37;  // Not a multiple of the tile size
+constexpr int kStride = 208;
+
+struct Color {
+  double r, g, b, a;
+};
+
+uint32_t pack1010102(double r, double g, double b) {
+  auto q = [](double v) { return static_cast<uint32_t>(lround(fmin(fmax(v, 0.0), 1.0) * 1023)); };
+  return q(r) | (q(g) << 10) | (q(b) << 20) | (3u << 30);
+}
+
+Color unpack1010102(uint32_t word) {
+  return {(word & 0x3ff) / 1023.0, ((word >> 10) & 0x3ff) / 1023.0,
+          ((word >> 20) & 0x3ff) / 1023.0, 1.0};
+}
+
+std::vector<uint32_t> makeLut(int size, Color (*fn)(double, double, double)) {
+  std::vector<uint32_t> lut;
+  for (int b = 0; b < size; b++) {
+    for (int g = 0; g < size; g++) {
+      for (int r = 0; r < size; r++) {
+        Color c = fn(r / (size - 1.0), g / (size - 1.0), b / (size - 1.0));
+        lut.push_back(pack1010102(c.r, c.g, c.b));
+      }
+    }
+  }
+  return lut;
+}
+
+Color identity(double r, double g, double b) {
+  return {r, g, b, 1.0};
+}
+
+// Channel mixing plus a per channel curve, far from linear inside the cells.
+Color toneCurve(double r, double g, double b) {
+  return {pow(0.7 * r + 0.2 * g + 0.1 * b, 0.8), pow(0.1 * r + 0.8 * g + 0.1 * b, 1.2),
+          sqrt(0.2 * r + 0.1 * g + 0.7 * b), 1.0};
+}
+
+Color affine(double r, double g, double b) {
+  return {0.5 * r + 0.25 * g + 0.1, 0.3 * g + 0.6 * b, 0.2 * r + 0.2 * g + 0.5 * b + 0.05, 1.0};
+}
+
+std::vector<uint32_t> makeXform(int size) {
+  std::vector<uint32_t> xform;
+  for (int i = 0; i < size; i++) {
+    double v = i / (size - 1.0);
+    xform.push_back(pack1010102(pow(v, 0.5), pow(v, 0.6), pow(v, 0.7)));
+  }
+  return xform;
+}
+
+// Straightforward double precision model of the GL programs, used as the golden reference.
+class Reference {
+ public:
+  Reference(int type, const std::vector<uint32_t> &lut, int lutSize,
+            const std::vector<uint32_t> &xform, int interpolation)
+    : type(type), lut(lut), lutSize(lutSize), xform(xform), interpolation(interpolation) {}
+
+  Color apply(Color in) const {
+    if (type == TONEMAP_INVERSE && in.a <= 0.0) {
+      return in;
+    }
+    double scale = (type == TONEMAP_INVERSE) ? 1.0 / in.a : 1.0;
+    double c[3] = {in.r * scale, in.g * scale, in.b * scale};
+    if (!xform.empty()) {
+      for (int k = 0; k < 3; k++) {
+        c[k] = sample1D(k, c[k]);
+      }
+    }
+    Color out = interpolation == TONEMAP_INTERPOLATION_TETRAHEDRAL ?
+        tetrahedral(c[0], c[1], c[2]) : trilinear(c[0], c[1], c[2]);
+    if (type == TONEMAP_INVERSE) {
+      out.r *= in.a;
+      out.g *= in.a;
+      out.b *= in.a;
+    }
+    out.a = in.a;
+    return out;
+  }
+
+ private:
+  static double clamp(double v) { return fmin(fmax(v, 0.0), 1.0); }
+
+  double sample1D(int channel, double v) const {
+    double p = clamp(v) * (xform.size() - 1);
+    int i = std::min(static_cast<int>(p), static_cast<int>(xform.size()) - 2);
+    double f = p - i;
+    double lo = ((xform[i] >> (10 * channel)) & 0x3ff) / 1023.0;
+    double hi = ((xform[i + 1] >> (10 * channel)) & 0x3ff) / 1023.0;
+    return lo + f * (hi - lo);
+  }
+
+  Color at(int r, int g, int b) const { return unpack1010102(lut[(b * lutSize + g) * lutSize + r]); }
+
+  Color trilinear(double r, double g, double b) const {
+    int i[3];
+    double f[3];
+    split(r, g, b, i, f);
+    Color out = {0, 0, 0, 1};
+    for (int corner = 0; corner < 8; corner++) {
+      int dr = corner & 1, dg = (corner >> 1) & 1, db = (corner >> 2) & 1;
+      double w = (dr ? f[0] : 1 - f[0]) * (dg ? f[1] : 1 - f[1]) * (db ? f[2] : 1 - f[2]);
+      Color c = at(i[0] + dr, i[1] + dg, i[2] + db);
+      out.r += w * c.r;
+      out.g += w * c.g;
+      out.b += w * c.b;
+    }
+    return out;
+  }
+
+  // Walks from the base corner to the opposite one, one axis at a time in decreasing fraction.
+  Color tetrahedral(double r, double g, double b) const {
+    int i[3];
+    double f[3];
+    split(r, g, b, i, f);
+    int order[3] = {0, 1, 2};
+    std::stable_sort(order, order + 3, [&](int x, int y) { return f[x] > f[y]; });
+    int d[3] = {0, 0, 0};
+    Color prev = at(i[0], i[1], i[2]);
+    Color out = prev;
+    for (int axis : order) {
+      d[axis] = 1;
+      Color next = at(i[0] + d[0], i[1] + d[1], i[2] + d[2]);
+      out.r += f[axis] * (next.r - prev.r);
+      out.g += f[axis] * (next.g - prev.g);
+      out.b += f[axis] * (next.b - prev.b);
+      prev = next;
+    }
+    return out;
+  }
+
+  void split(double r, double g, double b, int *i, double *f) const {
+    double c[3] = {r, g, b};
+    for (int k = 0; k < 3; k++) {
+      double p = clamp(c[k]) * (lutSize - 1);
+      i[k] = std::min(static_cast<int>(p), lutSize - 2);
+      f[k] = p - i[k];
+    }
+  }
+
+  int type;
+  const std::vector<uint32_t> &lut;
+  int lutSize;
+  const std::vector<uint32_t> &xform;
+  int interpolation;
+};
+
+// Normal, non negative values only, which covers the test patterns.
+uint16_t toHalf(double v) {
+  if (v <= 0.0) {
+    return 0;
+  }
+  int exponent;
+  double mantissa = frexp(v, &exponent);  // v = mantissa * 2^exponent, mantissa in [0.5, 1)
+  long bits = lround(mantissa * 2048);
+  if (bits == 2048) {
+    bits = 1024;
+    exponent++;
+  }
+  return static_cast<uint16_t>(((exponent + 14) << 10) | (bits & 0x3ff));
+}
+
+double fromHalf(uint16_t h) {
+  int exponent = (h >> 10) & 0x1f;
+  int mantissa = h & 0x3ff;
+  double v = exponent ? ldexp(1024 + mantissa, exponent - 25) : ldexp(mantissa, -24);
+  return (h & 0x8000) ? -v : v;
+}
+
+class Image {
+ public:
+  explicit Image(int format) : format(format), data(kStride * kHeight * 8, 0xa5) {}
+
+  CpuImage image() { return {data.data(), kWidth, kHeight, kStride, format}; }
+  int bpp() const { return format == TONEMAP_FORMAT_RGBA_FP16 ? 8 : 4; }
+  uint8_t *pixel(int x, int y) { return data.data() + (y * kStride + x) * bpp(); }
+
+  void set(int x, int y, Color c) {
+    uint8_t *p = pixel(x, y);
+    if (format == TONEMAP_FORMAT_RGBA8888) {
+      double v[4] = {c.r, c.g, c.b, c.a};
+      for (int k = 0; k < 4; k++) {
+        p[k] = static_cast<uint8_t>(lround(v[k] * 255));
+      }
+    } else if (format == TONEMAP_FORMAT_RGBA1010102) {
+      uint32_t word = pack1010102(c.r, c.g, c.b) & 0x3fffffff;
+      word |= static_cast<uint32_t>(lround(c.a * 3)) << 30;
+      memcpy(p, &word, sizeof(word));
+    } else {
+      uint16_t h[4] = {toHalf(c.r), toHalf(c.g), toHalf(c.b), toHalf(c.a)};
+      memcpy(p, h, sizeof(h));
+    }
+  }
+
+  Color get(int x, int y) {
+    uint8_t *p = pixel(x, y);
+    if (format == TONEMAP_FORMAT_RGBA8888) {
+      return {p[0] / 255.0, p[1] / 255.0, p[2] / 255.0, p[3] / 255.0};
+    } else if (format == TONEMAP_FORMAT_RGBA1010102) {
+      uint32_t word;
+      memcpy(&word, p, sizeof(word));
+      Color c = unpack1010102(word);
+      c.a = (word >> 30) / 3.0;
+      return c;
+    }
+    uint16_t h[4];
+    memcpy(h, p, sizeof(h));
+    return {fromHalf(h[0]), fromHalf(h[1]), fromHalf(h[2]), fromHalf(h[3])};
+  }
+
+  // Color ramps across the image, alpha steps through 0, 1/3, 2/3 and 1 every row.
+  void fillTestPattern(bool withAlpha) {
+    for (int y = 0; y < kHeight; y++) {
+      for (int x = 0; x < kWidth; x++) {
+        double a = withAlpha ? (y % 4) / 3.0 : 1.0;
+        Color c = {(x % 64) / 63.0, y / (kHeight - 1.0), ((x * 7 + y * 3) % 41) / 40.0, a};
+        // Store premultiplied values the format can represent.
+        set(x, y, {c.r * a, c.g * a, c.b * a, a});
+      }
+    }
+  }
+
+  int format;
+  std::vector<uint8_t> data;
+};
+
+// Allowed difference from the reference: one code of the output format for the unorm formats,
+// half precision rounding plus the float LUT math for FP16.
+double tolerance(int format) {
+  switch (format) {
+    case TONEMAP_FORMAT_RGBA8888:
+      return 1.0 / 255 + 1e-6;
+    case TONEMAP_FORMAT_RGBA1010102:
+      return 1.0 / 1023 + 1e-6;
+    default:
+      return 1.0 / 1024;
+  }
+}
+
+void expectMatchesReference(Image &src, Image &dst, const Reference &reference) {
+  double tol = tolerance(dst.format);
+  int failures = 0;
+  for (int y = 0; y < kHeight && failures < 10; y++) {
+    for (int x = 0; x < kWidth && failures < 10; x++) {
+      Color expected = reference.apply(src.get(x, y));
+      Color actual = dst.get(x, y);
+      if (fabs(expected.r - actual.r) > tol || fabs(expected.g - actual.g) > tol ||
+          fabs(expected.b - actual.b) > tol || expected.a != actual.a) {
+        ADD_FAILURE() << "pixel " << x << "," << y << " expected " << expected.r << " "
+                      << expected.g << " " << expected.b << " " << expected.a << " got "
+                      << actual.r << " " << actual.g << " " << actual.b << " " << actual.a;
+        failures++;
+      }
+    }
+  }
+}
+
+using Params = std::tuple<int /* format */, int /* interpolation */>;
+
+class CpuTonemapperTest : public TestWithParam<Params> {
+ protected:
+  int format() const { return std::get<0>(GetParam()); }
+  int interpolation() const { return std::get<1>(GetParam()); }
+
+  void run(int type, int lutSize, Color (*fn)(double, double, double), int xformSize,
+           int threads) {
+    auto lut = makeLut(lutSize, fn);
+    auto xform = xformSize ? makeXform(xformSize) : std::vector<uint32_t>();
+    std::unique_ptr<CpuTonemapper> tonemapper(CpuTonemapper::build(
+        type, lut.data(), lutSize, xform.empty() ? nullptr : xform.data(),
+        static_cast<int>(xform.size()), interpolation(), threads));
+    ASSERT_NE(nullptr, tonemapper);
+
+    Image src(format()), dst(format());
+    src.fillTestPattern(type == TONEMAP_INVERSE);
+    ASSERT_EQ(0, tonemapper->blit(dst.image(), src.image()));
+    expectMatchesReference(src, dst, Reference(type, lut, lutSize, xform, interpolation()));
+
+    // The stride padding must not be touched.
+    for (int y = 0; y < kHeight; y++) {
+      for (uint8_t *p = dst.pixel(kWidth, y); p < dst.pixel(kStride, y); p++) {
+        ASSERT_EQ(0xa5, *p) << "row " << y;
+      }
+    }
+  }
+};
+
+TEST_P(CpuTonemapperTest, IdentityLut) {
+  run(TONEMAP_FORWARD, 17, identity, 0, 1);
+}
+
+TEST_P(CpuTonemapperTest, ForwardToneCurve) {
+  run(TONEMAP_FORWARD, 33, toneCurve, 0, 4);
+}
+
+TEST_P(CpuTonemapperTest, ForwardToneCurveWithXform) {
+  run(TONEMAP_FORWARD, 17, toneCurve, 64, 3);
+}
+
+TEST_P(CpuTonemapperTest, InversePremultiplied) {
+  run(TONEMAP_INVERSE, 33, toneCurve, 0, 2);
+}
+
+TEST_P(CpuTonemapperTest, InversePremultipliedWithXform) {
+  run(TONEMAP_INVERSE, 9, affine, 32, 4);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Formats, CpuTonemapperTest,
+    Combine(Values(TONEMAP_FORMAT_RGBA8888, TONEMAP_FORMAT_RGBA1010102, TONEMAP_FORMAT_RGBA_FP16),
+            Values(TONEMAP_INTERPOLATION_TRILINEAR, TONEMAP_INTERPOLATION_TETRAHEDRAL)));
+
+TEST(CpuTonemapper, AffineLutIsExactForBothInterpolations) {
+  auto lut = makeLut(5, affine);
+  std::unique_ptr<CpuTonemapper> trilinear(CpuTonemapper::build(
+      TONEMAP_FORWARD, lut.data(), 5, nullptr, 0, TONEMAP_INTERPOLATION_TRILINEAR, 1));
+  std::unique_ptr<CpuTonemapper> tetrahedral(CpuTonemapper::build(
+      TONEMAP_FORWARD, lut.data(), 5, nullptr, 0, TONEMAP_INTERPOLATION_TETRAHEDRAL, 1));
+
+  Image src(TONEMAP_FORMAT_RGBA_FP16), a(TONEMAP_FORMAT_RGBA_FP16), b(TONEMAP_FORMAT_RGBA_FP16);
+  src.fillTestPattern(false);
+  ASSERT_EQ(0, trilinear->blit(a.image(), src.image()));
+  ASSERT_EQ(0, tetrahedral->blit(b.image(), src.image()));
+  for (int y = 0; y < kHeight; y++) {
+    for (int x = 0; x < kWidth; x++) {
+      Color ca = a.get(x, y), cb = b.get(x, y);
+      ASSERT_NEAR(ca.r, cb.r, 1.0 / 1024);
+      ASSERT_NEAR(ca.g, cb.g, 1.0 / 1024);
+      ASSERT_NEAR(ca.b, cb.b, 1.0 / 1024);
+    }
+  }
+}
+
+TEST(CpuTonemapper, ThreadCountDoesNotChangeOutput) {
+  auto lut = makeLut(33, toneCurve);
+  auto xform = makeXform(64);
+  Image src(TONEMAP_FORMAT_RGBA1010102), single(TONEMAP_FORMAT_RGBA1010102);
+  src.fillTestPattern(true);
+
+  std::unique_ptr<CpuTonemapper> reference(CpuTonemapper::build(
+      TONEMAP_INVERSE, lut.data(), 33, xform.data(), 64, TONEMAP_INTERPOLATION_TETRAHEDRAL, 1));
+  ASSERT_EQ(0, reference->blit(single.image(), src.image()));
+
+  std::unique_ptr<CpuTonemapper> threaded(CpuTonemapper::build(
+      TONEMAP_INVERSE, lut.data(), 33, xform.data(), 64, TONEMAP_INTERPOLATION_TETRAHEDRAL, 8));
+  for (int frame = 0; frame < 20; frame++) {
+    Image dst(TONEMAP_FORMAT_RGBA1010102);
+    ASSERT_EQ(0, threaded->blit(dst.image(), src.image()));
+    ASSERT_EQ(single.data, dst.data) << "frame " << frame;
+  }
+}
+
+TEST(CpuTonemapper, ConvertsBetweenFormats) {
+  auto lut = makeLut(17, identity);
+  std::unique_ptr<CpuTonemapper> tonemapper(CpuTonemapper::build(
+      TONEMAP_FORWARD, lut.data(), 17, nullptr, 0, TONEMAP_INTERPOLATION_TRILINEAR, 2));
+  Image src(TONEMAP_FORMAT_RGBA_FP16), dst(TONEMAP_FORMAT_RGBA8888);
+  src.fillTestPattern(false);
+  ASSERT_EQ(0, tonemapper->blit(dst.image(), src.image()));
+  for (int y = 0; y < kHeight; y++) {
+    for (int x = 0; x < kWidth; x++) {
+      Color in = src.get(x, y), out = dst.get(x, y);
+      ASSERT_NEAR(in.r, out.r, 1.0 / 255);
+      ASSERT_NEAR(in.g, out.g, 1.0 / 255);
+      ASSERT_NEAR(in.b, out.b, 1.0 / 255);
+      ASSERT_EQ(255 * in.a, 255 * out.a);
+    }
+  }
+}
+
+TEST(CpuTonemapper, RejectsInvalidConfiguration) {
+  uint32_t entry = 0;
+  EXPECT_EQ(nullptr, CpuTonemapper::build(TONEMAP_FORWARD, &entry, 1, nullptr, 0,
+                                          TONEMAP_INTERPOLATION_TRILINEAR, 1));
+  EXPECT_EQ(nullptr, CpuTonemapper::build(TONEMAP_FORWARD, nullptr, 17, nullptr, 0,
+                                          TONEMAP_INTERPOLATION_TRILINEAR, 1));
+
+  auto lut = makeLut(2, identity);
+  std::unique_ptr<CpuTonemapper> tonemapper(CpuTonemapper::build(
+      TONEMAP_FORWARD, lut.data(), 2, nullptr, 0, TONEMAP_INTERPOLATION_TRILINEAR, 2));
+  Image src(TONEMAP_FORMAT_RGBA8888), dst(TONEMAP_FORMAT_RGBA8888);
+  CpuImage smaller = dst.image();
+  smaller.width--;
+  EXPECT_EQ(-EINVAL, tonemapper->blit(smaller, src.image()));
+  CpuImage badFormat = dst.image();
+  badFormat.format = 42;
+  EXPECT_EQ(-EINVAL, tonemapper->blit(badFormat, src.image()));
+}
+
+}  // namespace
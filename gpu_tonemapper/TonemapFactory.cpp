@@ -32,3 +32,13 @@ Tonemapper *TonemapperFactory_GetInstance(int type, void *colorMap, int colorMap
 
   return tonemapper;
 }
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------
+CpuTonemapper *TonemapperFactory_GetCpuInstance(int type, void *colorMap, int colorMapSize,
+                                                void *lutXform, int lutXformSize,
+                                                int interpolation, int threadCount)
+//----------------------------------------------------------------------------------------------------------------------------------------------------------
+{
+  return CpuTonemapper::build(type, colorMap, colorMapSize, lutXform, lutXformSize, interpolation,
+                              threadCount);
+}
@@ -20,6 +20,7 @@
 #ifndef __TONEMAPPER_TONEMAPPERFACTORY_H__
 #define __TONEMAPPER_TONEMAPPERFACTORY_H__
 
+#include "CpuTonemapper.h"
 #include "Tonemapper.h"
 
 #ifdef __cplusplus
@@ -30,6 +31,11 @@ extern "C" {
 Tonemapper *TonemapperFactory_GetInstance(int type, void *colorMap, int colorMapSize,
                                           void *lutXform, int lutXformSize, bool isSecure);
 
+// returns an instance of the CPU implementation, for when the GPU is unavailable or saturated
+CpuTonemapper *TonemapperFactory_GetCpuInstance(int type, void *colorMap, int colorMapSize,
+                                                void *lutXform, int lutXformSize,
+                                                int interpolation, int threadCount);
+
 #ifdef __cplusplus
 }
 #endif
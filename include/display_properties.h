@@ -244,6 +244,24 @@
 #define PRIORITIZE_CLIENT_CWB                DISPLAY_PROP("prioritize_client_cwb")
 #define TRANSIENT_FPS_CYCLE_COUNT            DISPLAY_PROP("transient_fps_cycle_count")
 #define FORCE_LM_TO_FB_CONFIG                DISPLAY_PROP("force_lm_to_fb_config")
+// Disable per display composition stage latency histograms
+#define DISABLE_STAGE_LATENCY                DISPLAY_PROP("disable_stage_latency")
+// Number of buckets reported per color component by displayed content sampling
+#define HISTOGRAM_BUCKET_COUNT               DISPLAY_PROP("histogram_bucket_count")
+// Debug log backend: 0 logcat, 1 logcat formatted off the composition threads, 2 binary file
+#define LOG_BACKEND                          DISPLAY_PROP("log_backend")
+// Run GL color convert and layer stitch on the CPU instead of the GPU
+#define USE_CPU_BLIT                         DISPLAY_PROP("use_cpu_blit")
+// Number of GPU tone map sessions kept alive, including the ones unused by the current frame
+#define TONEMAP_SESSION_BUDGET               DISPLAY_PROP("tonemap_session_budget")
+// Lower the refresh rate to the detected cadence of content without frame rate metadata
+#define ENABLE_CONTENT_CADENCE               DISPLAY_PROP("enable_content_cadence")
+// Time vsync events are kept on after the client stops needing them, 0 turns them off at once
+#define VSYNC_OFF_DELAY_MS                   DISPLAY_PROP("vsync_off_delay_ms")
+// Memory in KB kept per display for converted color mode PP features, 0 turns the cache off
+#define PP_FEATURE_CACHE_KB                  DISPLAY_PROP("pp_feature_cache_kb")
+// Hold qsync commits for the measured present latency rather than a whole vsync period
+#define ENABLE_MEASURED_QSYNC_HOLD           DISPLAY_PROP("enable_measured_qsync_hold")
 
 // Add all other.properties above
 // End of property
@@ -0,0 +1,698 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "binary_log.h"
+
+namespace display {
+
+namespace {
+
+constexpr size_t kRingSize = 32 * 1024;
+constexpr size_t kMaxPayload = 1024;
+constexpr size_t kMaxString = 512;
+constexpr uint8_t kPadding = 0xFF;
+constexpr auto kDrainPeriod = std::chrono::milliseconds(20);
+
+enum LengthModifier {
+  kLengthNone,
+  kLengthChar,
+  kLengthShort,
+  kLengthLong,
+  kLengthLongLong,
+  kLengthIntMax,
+  kLengthSize,
+  kLengthPtrDiff,
+  kLengthLongDouble,
+};
+
+struct Spec {
+  const char *start;         // '%'
+  const char *length_start;  // First character after flags, width and precision
+  LengthModifier length;
+  char conversion;
+  int star_count;            // Number of '*' width/precision arguments
+};
+
+// Parses the conversion at p, which points at '%'. Returns the character after the conversion or
+// nullptr when the specification is malformed.
+const char *ParseSpec(const char *p, Spec *spec) {
+  spec->start = p++;
+  spec->star_count = 0;
+  while (*p && strchr("-+ #0'", *p)) {
+    p++;
+  }
+  if (*p == '*') {
+    spec->star_count++;
+    p++;
+  }
+  while (*p >= '0' && *p <= '9') {
+    p++;
+  }
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      spec->star_count++;
+      p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+      p++;
+    }
+  }
+
+  spec->length_start = p;
+  spec->length = kLengthNone;
+  switch (*p) {
+    case 'h':
+      spec->length = (p[1] == 'h') ? kLengthChar : kLengthShort;
+      p += (p[1] == 'h') ? 2 : 1;
+      break;
+    case 'l':
+      spec->length = (p[1] == 'l') ? kLengthLongLong : kLengthLong;
+      p += (p[1] == 'l') ? 2 : 1;
+      break;
+    case 'q':
+      spec->length = kLengthLongLong;
+      p++;
+      break;
+    case 'j':
+      spec->length = kLengthIntMax;
+      p++;
+      break;
+    case 'z':
+      spec->length = kLengthSize;
+      p++;
+      break;
+    case 't':
+      spec->length = kLengthPtrDiff;
+      p++;
+      break;
+    case 'L':
+      spec->length = kLengthLongDouble;
+      p++;
+      break;
+    default:
+      break;
+  }
+
+  spec->conversion = *p;
+  return *p ? p + 1 : nullptr;
+}
+
+class PayloadWriter {
+ public:
+  PayloadWriter(uint8_t *payload, size_t size) : payload_(payload), size_(size) { }
+
+  void Int(uint64_t value) { Put(&value, sizeof(value)); }
+  void Double(double value) { Put(&value, sizeof(value)); }
+  void String(const char *str) {
+    if (!str) {
+      str = "(null)";
+    }
+    uint16_t length = static_cast<uint16_t>(strnlen(str, kMaxString));
+    length = static_cast<uint16_t>(std::min(size_t(length), Available(sizeof(length))));
+    Put(&length, sizeof(length));
+    Put(str, length);
+  }
+
+  size_t Size() const { return offset_; }
+
+ private:
+  size_t Available(size_t reserve) const {
+    return (size_ > offset_ + reserve) ? size_ - offset_ - reserve : 0;
+  }
+
+  void Put(const void *data, size_t size) {
+    if (offset_ + size <= size_) {
+      memcpy(payload_ + offset_, data, size);
+      offset_ += size;
+    } else {
+      offset_ = size_;
+    }
+  }
+
+  uint8_t *payload_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+class PayloadReader {
+ public:
+  PayloadReader(const uint8_t *payload, size_t size) : payload_(payload), size_(size) { }
+
+  bool Int(uint64_t *value) { return Get(value, sizeof(*value)); }
+  bool Double(double *value) { return Get(value, sizeof(*value)); }
+  bool String(std::string *str) {
+    uint16_t length = 0;
+    if (!Get(&length, sizeof(length)) || offset_ + length > size_) {
+      return false;
+    }
+    str->assign(reinterpret_cast<const char *>(payload_ + offset_), length);
+    offset_ += length;
+    return true;
+  }
+
+ private:
+  bool Get(void *data, size_t size) {
+    if (offset_ + size > size_) {
+      return false;
+    }
+    memcpy(data, payload_ + offset_, size);
+    offset_ += size;
+    return true;
+  }
+
+  const uint8_t *payload_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+template <typename T>
+void AppendFormatted(std::string *out, const std::string &spec, const int *stars, int star_count,
+                     T value) {
+  char buffer[kMaxString * 2];
+  int length = 0;
+  switch (star_count) {
+    case 0:
+      length = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+      break;
+    case 1:
+      length = snprintf(buffer, sizeof(buffer), spec.c_str(), stars[0], value);
+      break;
+    default:
+      length = snprintf(buffer, sizeof(buffer), spec.c_str(), stars[0], stars[1], value);
+      break;
+  }
+  if (length > 0) {
+    out->append(buffer, std::min(size_t(length), sizeof(buffer) - 1));
+  }
+}
+
+uint64_t Now() {
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+struct EntryHeader {
+  uint16_t size;  // Whole record, multiple of 8
+  uint8_t level;  // kPadding marks the unused tail of the ring before a wrap
+  uint8_t reserved;
+  uint32_t payload_size;
+  uint64_t timestamp;
+  const char *format;
+};
+
+// Variable sized records, written by the owning thread and read by the drain thread.
+class ThreadRing {
+ public:
+  explicit ThreadRing(uint32_t tid) : tid(tid) { }
+
+  // Returns true when the ring just got more than half full and the drain thread should be woken.
+  bool Push(LogLevel level, const char *format, const uint8_t *payload, size_t payload_size) {
+    size_t need = (sizeof(EntryHeader) + payload_size + 7) & ~size_t(7);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t used = head - tail_.load(std::memory_order_acquire);
+    size_t offset = static_cast<size_t>(head % kRingSize);
+    size_t skip = (kRingSize - offset < need) ? kRingSize - offset : 0;
+    if (used + skip + need > kRingSize) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    if (skip) {
+      EntryHeader padding = {static_cast<uint16_t>(skip), kPadding, 0, 0, 0, nullptr};
+      memcpy(buffer_ + offset, &padding, sizeof(padding.size) + sizeof(padding.level));
+      offset = 0;
+    }
+    EntryHeader header = {static_cast<uint16_t>(need), static_cast<uint8_t>(level), 0,
+                          static_cast<uint32_t>(payload_size), Now(), format};
+    memcpy(buffer_ + offset, &header, sizeof(header));
+    memcpy(buffer_ + offset + sizeof(header), payload, payload_size);
+    head_.store(head + skip + need, std::memory_order_release);
+
+    return used <= kRingSize / 2 && used + skip + need > kRingSize / 2;
+  }
+
+  template <class Fn>
+  void Drain(Fn fn) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (tail != head) {
+      const uint8_t *record = buffer_ + (tail % kRingSize);
+      EntryHeader header = {};
+      memcpy(&header, record, sizeof(header.size) + sizeof(header.level));
+      if (header.level != kPadding) {
+        memcpy(&header, record, sizeof(header));
+        fn(header, record + sizeof(header));
+      }
+      tail += header.size;
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  const uint32_t tid;
+  std::atomic<bool> retired{false};
+  std::atomic<uint64_t> dropped{0};
+
+ private:
+  alignas(8) uint8_t buffer_[kRingSize];
+  // Byte counters, 64 bit so they never wrap under the integer overflow sanitizer.
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+};
+
+struct PendingEntry {
+  uint64_t timestamp;
+  uint32_t tid;
+  LogLevel level;
+  const char *format;
+  std::string payload;
+};
+
+class Drainer {
+ public:
+  // Intentionally leaked, threads may log while static destructors run.
+  static Drainer &Get() {
+    static Drainer *drainer = new Drainer();
+    return *drainer;
+  }
+
+  int Start(BinaryLog::Sink *sink, const char *path) {
+    std::lock_guard<std::mutex> start_lock(start_mutex_);
+    if (thread_.joinable()) {
+      return -EBUSY;
+    }
+
+    FILE *file = nullptr;
+    if (path) {
+      file = fopen(path, "ae");
+      if (!file) {
+        return -errno;
+      }
+      if (ftell(file) == 0) {
+        BinaryLogFileHeader header = {};
+        memcpy(header.magic, kBinaryLogMagic, sizeof(header.magic));
+        header.version = kBinaryLogVersion;
+        fwrite(&header, sizeof(header), 1, file);
+      }
+    } else if (!sink) {
+      return -EINVAL;
+    }
+
+    sink_ = sink;
+    file_ = file;
+    formats_.clear();
+    exit_ = false;
+    thread_ = std::thread(&Drainer::Run, this);
+    active_.store(true, std::memory_order_release);
+
+    return 0;
+  }
+
+  void Stop() {
+    std::lock_guard<std::mutex> start_lock(start_mutex_);
+    if (!thread_.joinable()) {
+      return;
+    }
+
+    active_.store(false, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exit_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+
+    if (file_) {
+      fclose(file_);
+      file_ = nullptr;
+    }
+    sink_ = nullptr;
+  }
+
+  bool IsActive() const { return active_.load(std::memory_order_acquire); }
+
+  std::shared_ptr<ThreadRing> Register() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rings_.push_back(std::make_shared<ThreadRing>(static_cast<uint32_t>(gettid())));
+    return rings_.back();
+  }
+
+  void Notify() { cv_.notify_one(); }
+
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!IsActive()) {
+      return;
+    }
+    uint64_t request = ++flush_requested_;
+    cv_.notify_one();
+    flushed_cv_.wait(lock, [this, request] { return flushed_ >= request || exit_; });
+  }
+
+ private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool exit = false;
+    while (!exit) {
+      cv_.wait_for(lock, kDrainPeriod);
+      exit = exit_;
+      uint64_t request = flush_requested_;
+      std::vector<std::shared_ptr<ThreadRing>> rings = rings_;
+      lock.unlock();
+
+      std::vector<std::shared_ptr<ThreadRing>> finished = DrainOnce(rings);
+
+      lock.lock();
+      for (auto &ring : finished) {
+        rings_.erase(std::find(rings_.begin(), rings_.end(), ring));
+      }
+      flushed_ = request;
+      flushed_cv_.notify_all();
+    }
+  }
+
+  // Returns the rings whose thread had exited before they were drained, those are empty now.
+  std::vector<std::shared_ptr<ThreadRing>> DrainOnce(
+      const std::vector<std::shared_ptr<ThreadRing>> &rings) {
+    std::vector<std::shared_ptr<ThreadRing>> finished;
+    pending_.clear();
+    uint64_t dropped = 0;
+    for (auto &ring : rings) {
+      if (ring->retired.load(std::memory_order_acquire)) {
+        finished.push_back(ring);
+      }
+      ring->Drain([this, &ring](const EntryHeader &header, const uint8_t *payload) {
+        pending_.push_back({header.timestamp, ring->tid, static_cast<LogLevel>(header.level),
+                            header.format,
+                            std::string(reinterpret_cast<const char *>(payload),
+                                        header.payload_size)});
+      });
+      dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    std::stable_sort(pending_.begin(), pending_.end(),
+                     [](const PendingEntry &a, const PendingEntry &b) {
+                       return a.timestamp < b.timestamp;
+                     });
+
+    for (auto &entry : pending_) {
+      if (file_) {
+        WriteEntry(entry);
+      } else {
+        std::string text = BinaryLog::Format(
+            entry.format, reinterpret_cast<const uint8_t *>(entry.payload.data()),
+            entry.payload.size());
+        char prefix[64];
+        snprintf(prefix, sizeof(prefix), "[%llu.%06llu %u] ",
+                 static_cast<unsigned long long>(entry.timestamp / 1000000000),
+                 static_cast<unsigned long long>((entry.timestamp / 1000) % 1000000), entry.tid);
+        sink_->Write(entry.level, (prefix + text).c_str());
+      }
+    }
+
+    if (dropped && sink_) {
+      std::string text = "Binary log dropped " + std::to_string(dropped) + " records";
+      sink_->Write(LogLevel::kWarning, text.c_str());
+    }
+    if (file_) {
+      fflush(file_);
+    }
+
+    return finished;
+  }
+
+  void WriteEntry(const PendingEntry &entry) {
+    uint64_t id = reinterpret_cast<uintptr_t>(entry.format);
+    if (formats_.insert(id).second) {
+      uint8_t type = kBinaryLogFormat;
+      uint32_t length = static_cast<uint32_t>(strlen(entry.format));
+      fwrite(&type, sizeof(type), 1, file_);
+      fwrite(&length, sizeof(length), 1, file_);
+      fwrite(&id, sizeof(id), 1, file_);
+      fwrite(entry.format, 1, length, file_);
+    }
+
+    uint8_t type = kBinaryLogEntry;
+    uint8_t level = static_cast<uint8_t>(entry.level);
+    uint16_t size = static_cast<uint16_t>(entry.payload.size());
+    fwrite(&type, sizeof(type), 1, file_);
+    fwrite(&level, sizeof(level), 1, file_);
+    fwrite(&size, sizeof(size), 1, file_);
+    fwrite(&entry.tid, sizeof(entry.tid), 1, file_);
+    fwrite(&entry.timestamp, sizeof(entry.timestamp), 1, file_);
+    fwrite(&id, sizeof(id), 1, file_);
+    fwrite(entry.payload.data(), 1, size, file_);
+  }
+
+  std::mutex start_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable flushed_cv_;
+  std::thread thread_;
+  std::atomic<bool> active_{false};
+  bool exit_ = false;
+  uint64_t flush_requested_ = 0;
+  uint64_t flushed_ = 0;
+  std::vector<std::shared_ptr<ThreadRing>> rings_;
+
+  // Drain thread only.
+  BinaryLog::Sink *sink_ = nullptr;
+  FILE *file_ = nullptr;
+  std::vector<PendingEntry> pending_;
+  std::unordered_set<uint64_t> formats_;
+};
+
+struct ThreadRingRef {
+  ThreadRingRef() : ring(Drainer::Get().Register()) { }
+  ~ThreadRingRef() { ring->retired.store(true, std::memory_order_release); }
+
+  std::shared_ptr<ThreadRing> ring;
+};
+
+}  // namespace
+
+int BinaryLog::Start(Sink *sink, const char *path) {
+  return Drainer::Get().Start(sink, path);
+}
+
+void BinaryLog::Stop() {
+  Drainer::Get().Stop();
+}
+
+bool BinaryLog::IsActive() {
+  return Drainer::Get().IsActive();
+}
+
+void BinaryLog::Record(LogLevel level, const char *format, va_list args) {
+  uint8_t payload[kMaxPayload];
+  size_t size = Encode(format, args, payload, sizeof(payload));
+
+  thread_local ThreadRingRef ring_ref;
+  if (ring_ref.ring->Push(level, format, payload, size)) {
+    Drainer::Get().Notify();
+  }
+}
+
+void BinaryLog::Flush() {
+  Drainer::Get().Flush();
+}
+
+size_t BinaryLog::Encode(const char *format, va_list args, uint8_t *payload, size_t size) {
+  int saved_errno = errno;
+  PayloadWriter writer(payload, size);
+
+  for (const char *p = strchr(format, '%'); p; p = strchr(p, '%')) {
+    Spec spec;
+    p = ParseSpec(p, &spec);
+    if (!p) {
+      break;
+    }
+    for (int i = 0; i < spec.star_count; i++) {
+      writer.Int(static_cast<uint64_t>(va_arg(args, int)));
+    }
+
+    switch (spec.conversion) {
+      case 'd':
+      case 'i': {
+        int64_t value = 0;
+        switch (spec.length) {
+          case kLengthChar: value = static_cast<signed char>(va_arg(args, int)); break;
+          case kLengthShort: value = static_cast<short>(va_arg(args, int)); break;
+          case kLengthLong: value = va_arg(args, long); break;
+          case kLengthLongLong: value = va_arg(args, long long); break;
+          case kLengthIntMax: value = va_arg(args, intmax_t); break;
+          case kLengthSize: value = va_arg(args, ssize_t); break;
+          case kLengthPtrDiff: value = va_arg(args, ptrdiff_t); break;
+          default: value = va_arg(args, int); break;
+        }
+        writer.Int(static_cast<uint64_t>(value));
+      } break;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X': {
+        uint64_t value = 0;
+        switch (spec.length) {
+          case kLengthChar: value = static_cast<unsigned char>(va_arg(args, unsigned)); break;
+          case kLengthShort: value = static_cast<unsigned short>(va_arg(args, unsigned)); break;
+          case kLengthLong: value = va_arg(args, unsigned long); break;
+          case kLengthLongLong: value = va_arg(args, unsigned long long); break;
+          case kLengthIntMax: value = va_arg(args, uintmax_t); break;
+          case kLengthSize: value = va_arg(args, size_t); break;
+          case kLengthPtrDiff: value = static_cast<uint64_t>(va_arg(args, ptrdiff_t)); break;
+          default: value = va_arg(args, unsigned); break;
+        }
+        writer.Int(value);
+      } break;
+      case 'c':
+        writer.Int(static_cast<uint64_t>(va_arg(args, int)));
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        if (spec.length == kLengthLongDouble) {
+          writer.Double(static_cast<double>(va_arg(args, long double)));
+        } else {
+          writer.Double(va_arg(args, double));
+        }
+        break;
+      case 's':
+        writer.String(va_arg(args, const char *));
+        break;
+      case 'p':
+        writer.Int(reinterpret_cast<uintptr_t>(va_arg(args, void *)));
+        break;
+      case 'm':
+        writer.String(strerror(saved_errno));
+        break;
+      case 'n':
+        va_arg(args, void *);
+        break;
+      case '%':
+        break;
+      default:
+        // Unknown conversion, the remaining arguments cannot be located.
+        return writer.Size();
+    }
+  }
+
+  return writer.Size();
+}
+
+std::string BinaryLog::Format(const char *format, const uint8_t *payload, size_t size) {
+  PayloadReader reader(payload, size);
+  std::string out;
+
+  const char *p = format;
+  for (const char *percent = strchr(p, '%'); percent; percent = strchr(p, '%')) {
+    out.append(p, percent);
+    Spec spec;
+    p = ParseSpec(percent, &spec);
+    if (!p) {
+      out.append(percent);
+      return out;
+    }
+
+    int stars[2] = {};
+    uint64_t value = 0;
+    double real = 0;
+    bool ok = true;
+    for (int i = 0; i < spec.star_count; i++) {
+      ok = ok && reader.Int(&value);
+      stars[i] = static_cast<int>(value);
+    }
+
+    // Flags, width and precision are kept, the length modifier is rewritten to match the
+    // canonical argument types of the payload.
+    std::string text(spec.start, spec.length_start);
+    switch (spec.conversion) {
+      case 'd':
+      case 'i':
+        if ((ok = ok && reader.Int(&value))) {
+          AppendFormatted(&out, text + "ll" + spec.conversion, stars, spec.star_count,
+                          static_cast<long long>(value));
+        }
+        break;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        if ((ok = ok && reader.Int(&value))) {
+          AppendFormatted(&out, text + "ll" + spec.conversion, stars, spec.star_count,
+                          static_cast<unsigned long long>(value));
+        }
+        break;
+      case 'c':
+        if ((ok = ok && reader.Int(&value))) {
+          AppendFormatted(&out, text + spec.conversion, stars, spec.star_count,
+                          static_cast<int>(value));
+        }
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        if ((ok = ok && reader.Double(&real))) {
+          AppendFormatted(&out, text + spec.conversion, stars, spec.star_count, real);
+        }
+        break;
+      case 's':
+      case 'm': {
+        std::string str;
+        if ((ok = ok && reader.String(&str))) {
+          AppendFormatted(&out, text + 's', stars, spec.star_count, str.c_str());
+        }
+      } break;
+      case 'p':
+        if ((ok = ok && reader.Int(&value))) {
+          AppendFormatted(&out, text + 'p', stars, spec.star_count,
+                          reinterpret_cast<void *>(static_cast<uintptr_t>(value)));
+        }
+        break;
+      case 'n':
+        break;
+      case '%':
+        out.push_back('%');
+        break;
+      default:
+        ok = false;
+        break;
+    }
+
+    if (!ok) {
+      out.append("<truncated>");
+      return out;
+    }
+  }
+  out.append(p);
+
+  return out;
+}
+
+}  // namespace display
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __BINARY_LOG_H__
+#define __BINARY_LOG_H__
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace display {
+
+enum class LogLevel : uint8_t {
+  kError,
+  kWarning,
+  kInfo,
+  kDebug,
+  kVerbose,
+};
+
+// Deferred logging backend. Record() copies the format string pointer and the raw arguments into
+// a ring owned by the calling thread; a background thread formats them for a Sink or appends them
+// to a binary file that display_binary_log_decoder turns back into text.
+class BinaryLog {
+ public:
+  class Sink {
+   public:
+    virtual void Write(LogLevel level, const char *text) = 0;
+
+   protected:
+    virtual ~Sink() { }
+  };
+
+  // Starts the drain thread. Records go to path in binary form when it is non-null, otherwise
+  // they are formatted and handed to sink.
+  static int Start(Sink *sink, const char *path);
+  static void Stop();
+  static bool IsActive();
+
+  static void Record(LogLevel level, const char *format, va_list args);
+  // Blocks until everything recorded before the call has been written out.
+  static void Flush();
+
+  // Arguments are encoded independent of the recording ABI: integers and pointers as 64 bit,
+  // floating point as double and strings as a 16 bit length followed by the characters.
+  static size_t Encode(const char *format, va_list args, uint8_t *payload, size_t size);
+  static std::string Format(const char *format, const uint8_t *payload, size_t size);
+};
+
+// Binary file layout: BinaryLogFileHeader followed by records, each starting with a one byte
+// BinaryLogRecord type. Multi byte fields are little endian.
+//   kBinaryLogFormat: uint32 length, uint64 format id, length bytes of format text.
+//   kBinaryLogEntry:  uint8 level, uint16 payload size, uint32 tid, uint64 monotonic ns,
+//                     uint64 format id, payload.
+struct BinaryLogFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+
+static const char kBinaryLogMagic[8] = {'D', 'I', 'S', 'P', 'B', 'L', 'O', 'G'};
+static const uint32_t kBinaryLogVersion = 1;
+
+enum BinaryLogRecord : uint8_t {
+  kBinaryLogFormat = 1,
+  kBinaryLogEntry = 2,
+};
+
+}  // namespace display
+
+#endif  // __BINARY_LOG_H__
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <android/log.h>
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "binary_log.h"
+
+namespace {
+
+using display::BinaryLog;
+using display::LogLevel;
+
+enum Backend {
+  kBackendLogcat,
+  kBackendDeferred,
+};
+
+class NullSink : public BinaryLog::Sink {
+ public:
+  void Write(LogLevel, const char *text) override { benchmark::DoNotOptimize(text); }
+};
+
+__attribute__((format(printf, 2, 3))) void Log(Backend backend, const char *format, ...) {
+  va_list list;
+  va_start(list, format);
+  if (backend == kBackendLogcat) {
+    __android_log_vprint(ANDROID_LOG_DEBUG, "SDM-bench", format, list);
+  } else {
+    BinaryLog::Record(LogLevel::kDebug, format, list);
+  }
+  va_end(list);
+}
+
+// Roughly the debug output of one Prepare cycle of a four layer frame with all tags enabled.
+void LogPrepare(Backend backend, int frame) {
+  const char *name = "com.android.systemui#0";
+  Log(backend, "DisplayBase::Prepare: Display %d-%d frame %d", 0, 1, frame);
+  for (int i = 0; i < 4; i++) {
+    Log(backend, "Layer %d name %s format %d blending %d flags 0x%x", i, name, 42 + i, 1, 0x10);
+    Log(backend, "Layer %d src [%.1f %.1f %.1f %.1f] dst [%d %d %d %d]", i, 0.0f, 0.0f, 1080.0f,
+        2400.0f, 0, 0, 1080, 2400);
+    Log(backend, "Layer %d composition %d plane %u pipe %u rect %u", i, 2, 47 + i, i, 0);
+    Log(backend, "Layer %d acquire fence %d buffer id %llu", i, 120 + i,
+        static_cast<unsigned long long>(0x1000 + frame));
+  }
+  Log(backend, "Strategy::Start: %s layers %zu", "GPU-Composition", static_cast<size_t>(4));
+  Log(backend, "ResManager::Acquire: pipes %u mixer %ux%u split %d", 4u, 1080u, 2400u, 0);
+  Log(backend, "CompManager::Prepare: composition %d bw %.3f clk %llu", 1, 1.875,
+      static_cast<unsigned long long>(300000000));
+  Log(backend, "HWDeviceDRM::Validate: Display %d crtc %u connector %u", 0, 132u, 31u);
+  Log(backend, "HWDeviceDRM::SetupAtomic: vrefresh %u mode 0x%x qsync %d", 120u, 0x5u, 0);
+  Log(backend, "DisplayBase::Prepare: Status %d", 0);
+}
+
+void BM_PrepareLogcat(benchmark::State &state) {
+  int frame = 0;
+  for (auto _ : state) {
+    LogPrepare(kBackendLogcat, frame++);
+  }
+}
+BENCHMARK(BM_PrepareLogcat)->UseRealTime();
+
+void BM_PrepareDeferred(benchmark::State &state) {
+  NullSink sink;
+  BinaryLog::Start(&sink, nullptr);
+  int frame = 0;
+  for (auto _ : state) {
+    LogPrepare(kBackendDeferred, frame++);
+  }
+  BinaryLog::Stop();
+}
+BENCHMARK(BM_PrepareDeferred)->UseRealTime();
+
+void BM_PrepareBinary(benchmark::State &state) {
+  char path[] = "/data/local/tmp/binary_log_benchmark.bin";
+  unlink(path);
+  if (BinaryLog::Start(nullptr, path)) {
+    state.SkipWithError("Failed to open binary log");
+    return;
+  }
+  int frame = 0;
+  for (auto _ : state) {
+    LogPrepare(kBackendDeferred, frame++);
+  }
+  BinaryLog::Stop();
+  unlink(path);
+}
+BENCHMARK(BM_PrepareBinary)->UseRealTime();
+
+__attribute__((format(printf, 3, 4))) size_t Encode(uint8_t *payload, size_t size, const char *format, ...) {
+  va_list list;
+  va_start(list, format);
+  size_t length = BinaryLog::Encode(format, list, payload, size);
+  va_end(list);
+
+  return length;
+}
+
+// Producer side only: the per record cost a composition thread pays.
+void BM_Encode(benchmark::State &state) {
+  uint8_t payload[512];
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Encode(payload, sizeof(payload),
+                                    "Layer %d src [%.1f %.1f %.1f %.1f] name %s", 1, 0.0, 0.0,
+                                    1080.0, 2400.0, "layer"));
+  }
+}
+BENCHMARK(BM_Encode);
+
+}  // namespace
+
+BENCHMARK_MAIN();
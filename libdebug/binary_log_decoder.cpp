@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+// Prints the records of a binary log written by display::BinaryLog as text, one line per record:
+//   <monotonic seconds> <tid> <level> <message>
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_log.h"
+
+using display::BinaryLog;
+using display::BinaryLogFileHeader;
+
+namespace {
+
+template <typename T>
+bool Read(FILE *file, T *value) {
+  return fread(value, sizeof(*value), 1, file) == 1;
+}
+
+bool Read(FILE *file, size_t size, std::vector<char> *data) {
+  data->resize(size);
+  return !size || fread(data->data(), size, 1, file) == 1;
+}
+
+int Decode(FILE *file) {
+  BinaryLogFileHeader header = {};
+  if (!Read(file, &header) || memcmp(header.magic, display::kBinaryLogMagic,
+                                     sizeof(header.magic))) {
+    fprintf(stderr, "Not a display binary log\n");
+    return -1;
+  }
+  if (header.version != display::kBinaryLogVersion) {
+    fprintf(stderr, "Unsupported binary log version %u\n", header.version);
+    return -1;
+  }
+
+  const char kLevels[] = {'E', 'W', 'I', 'D', 'V'};
+  std::unordered_map<uint64_t, std::string> formats;
+  std::vector<char> data;
+  uint8_t type = 0;
+  while (Read(file, &type)) {
+    if (type == display::kBinaryLogFormat) {
+      uint32_t length = 0;
+      uint64_t id = 0;
+      if (!Read(file, &length) || !Read(file, &id) || !Read(file, length, &data)) {
+        break;
+      }
+      formats[id].assign(data.data(), data.size());
+    } else if (type == display::kBinaryLogEntry) {
+      uint8_t level = 0;
+      uint16_t size = 0;
+      uint32_t tid = 0;
+      uint64_t timestamp = 0;
+      uint64_t id = 0;
+      if (!Read(file, &level) || !Read(file, &size) || !Read(file, &tid) ||
+          !Read(file, &timestamp) || !Read(file, &id) || !Read(file, size, &data)) {
+        break;
+      }
+      auto format = formats.find(id);
+      std::string text = (format == formats.end()) ? "<unknown format>" :
+          BinaryLog::Format(format->second.c_str(), reinterpret_cast<uint8_t *>(data.data()),
+                            data.size());
+      printf("%llu.%06llu %5u %c %s\n", static_cast<unsigned long long>(timestamp / 1000000000),
+             static_cast<unsigned long long>((timestamp / 1000) % 1000000), tid,
+             level < sizeof(kLevels) ? kLevels[level] : '?', text.c_str());
+    } else {
+      fprintf(stderr, "Corrupt record type %u at offset %ld\n", type, ftell(file) - 1);
+      return -1;
+    }
+  }
+
+  if (!feof(file)) {
+    fprintf(stderr, "Truncated record at offset %ld\n", ftell(file));
+    return -1;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s <binary log>\n", argv[0]);
+    return 1;
+  }
+
+  FILE *file = fopen(argv[1], "rb");
+  if (!file) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  int ret = Decode(file);
+  fclose(file);
+
+  return ret ? 1 : 0;
+}
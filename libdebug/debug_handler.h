@@ -30,8 +30,16 @@
 #ifndef __DEBUG_HANDLER_H__
 #define __DEBUG_HANDLER_H__
 
+#include <stdint.h>
 #include <bitset>
 
+// Build time ceiling for tagged debug and verbose logs: bit n keeps the logs of tag n in the
+// binary. Logs of cleared tags are removed by the compiler, the runtime log mask still filters the
+// ones that are kept. Errors, warnings, info and untagged logs are not affected.
+#ifndef DISPLAY_LOG_DEBUG_TAGS
+#define DISPLAY_LOG_DEBUG_TAGS 0xFFFFFFFF
+#endif
+
 #define DLOG(method, format, ...) \
   display::DebugHandler::Get()->method(__CLASS__ "::%s: " format, __FUNCTION__, ##__VA_ARGS__)
 
@@ -40,11 +48,16 @@
     DLOG(method, format, ##__VA_ARGS__); \
   }
 
+#define DLOG_DEBUG_IF(tag, method, format, ...) \
+  if (display::IsDebugTagCompiled(tag) && display::DebugHandler::GetLogMask()[tag]) { \
+    DLOG(method, format, ##__VA_ARGS__); \
+  }
+
 #define DLOGE_IF(tag, format, ...) DLOG_IF(tag, Error, format, ##__VA_ARGS__)
 #define DLOGW_IF(tag, format, ...) DLOG_IF(tag, Warning, format, ##__VA_ARGS__)
 #define DLOGI_IF(tag, format, ...) DLOG_IF(tag, Info, format, ##__VA_ARGS__)
-#define DLOGD_IF(tag, format, ...) DLOG_IF(tag, Debug, format, ##__VA_ARGS__)
-#define DLOGV_IF(tag, format, ...) DLOG_IF(tag, Verbose, format, ##__VA_ARGS__)
+#define DLOGD_IF(tag, format, ...) DLOG_DEBUG_IF(tag, Debug, format, ##__VA_ARGS__)
+#define DLOGV_IF(tag, format, ...) DLOG_DEBUG_IF(tag, Verbose, format, ##__VA_ARGS__)
 
 #define DLOGE(format, ...) DLOG(Error, format, ##__VA_ARGS__)
 #define DLOGW(format, ...) DLOG(Warning, format, ##__VA_ARGS__)
@@ -60,6 +73,13 @@
 
 namespace display {
 
+constexpr uint32_t kCompiledDebugTags = DISPLAY_LOG_DEBUG_TAGS;
+
+// Folds to a constant for the usual enum tags, so disabled sites generate no code.
+constexpr bool IsDebugTagCompiled(uint32_t tag) {
+  return tag < 32 && ((kCompiledDebugTags >> tag) & 1);
+}
+
 class DebugHandler {
  public:
   // __format__(printf hints the compiler to validate format specifiers vs arguments provided.
@@ -30,12 +30,17 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <ctime>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -49,35 +54,146 @@
 
 constexpr static auto implementation_defined_max_frame_ringbuffer = 300;
 
+namespace {
+// The hardware histogram only carries V of HSV_888, which is component 2.
+constexpr uint8_t hw_supported_components = HWC2_FORMAT_COMPONENT_2;
+static_assert((HIST_V_SIZE & (HIST_V_SIZE - 1)) == 0, "histogram size must be a power of two");
+
+struct SharedTimeKeeper final : histogram::TimeKeeper {
+  explicit SharedTimeKeeper(std::shared_ptr<histogram::TimeKeeper> const &tk) : tk(tk) {}
+  nsecs_t current_time() const final { return tk->current_time(); }
+  std::shared_ptr<histogram::TimeKeeper> const tk;
+};
+
+std::vector<uint64_t> rebucket(std::array<uint64_t, HIST_V_SIZE> const &frame,
+                               uint32_t num_buckets) {
+  std::vector<uint64_t> bins(num_buckets, 0);
+  auto const bucket_compression = HIST_V_SIZE / num_buckets;
+  for (auto i = 0u; i < HIST_V_SIZE; i++)
+    bins[i / bucket_compression] += frame[i];
+  return bins;
+}
+}  // namespace
+
+namespace histogram {
+
+// One thread fetches and inserts the blobs for every started collector, oldest event first.
+// Each collector only keeps its latest pending event, so a collector is queued at most once.
+// schedule() runs under the collector lock, so the processor never calls into a collector while
+// holding its own mutex.
+class BlobProcessor {
+ public:
+  static BlobProcessor &get() {
+    static BlobProcessor processor;
+    return processor;
+  }
+
+  void attach() {
+    std::unique_lock<decltype(mutex)> lk(mutex);
+    if (attached++ == 0) {
+      auto const gen = ++generation;
+      thread = std::thread(&BlobProcessor::run, this, gen);
+    }
+  }
+
+  void detach(HistogramCollector *collector) {
+    std::unique_lock<decltype(mutex)> lk(mutex);
+    queue.erase(std::remove(queue.begin(), queue.end(), collector), queue.end());
+    cv.wait(lk, [this, collector] { return busy != collector; });
+    if (--attached != 0)
+      return;
+
+    // Invalidates the running thread, a later attach() starts a new one.
+    generation++;
+    cv.notify_all();
+    auto stopped = std::move(thread);
+    lk.unlock();
+    if (stopped.joinable())
+      stopped.join();
+  }
+
+  void schedule(HistogramCollector *collector) {
+    std::unique_lock<decltype(mutex)> lk(mutex);
+    if (std::find(queue.begin(), queue.end(), collector) == queue.end())
+      queue.push_back(collector);
+    cv.notify_all();
+  }
+
+ private:
+  void run(uint64_t gen) {
+    pthread_setname_np(pthread_self(), "histogram_blob");
+    std::unique_lock<decltype(mutex)> lk(mutex);
+    while (true) {
+      cv.wait(lk, [this, gen] { return generation != gen || !queue.empty(); });
+      if (generation != gen)
+        return;
+
+      busy = queue.front();
+      queue.pop_front();
+      lk.unlock();
+      busy->process_blob();
+      lk.lock();
+      busy = nullptr;
+      cv.notify_all();
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<HistogramCollector *> queue;
+  HistogramCollector *busy = nullptr;
+  uint32_t attached = 0;
+  uint64_t generation = 0;
+  std::thread thread;
+};
+
+}  // namespace histogram
+
+bool histogram::DrmBlobSource::read(int fd, BlobId id, drm_msm_hist *hist) {
+  drmModePropertyBlobPtr blob = drmModeGetPropertyBlob(fd, id);
+  if (!blob || !blob->data) {
+    return false;
+  }
+  bool valid = (blob->length >= sizeof(*hist));
+  if (valid)
+    memcpy(hist, blob->data, sizeof(*hist));
+  drmModeFreePropertyBlob(blob);
+  return valid;
+}
+
 histogram::HistogramCollector::HistogramCollector()
-    : histogram(histogram::Ringbuffer::create(implementation_defined_max_frame_ringbuffer,
-                                              std::make_unique<histogram::DefaultTimeKeeper>())) {}
+    : HistogramCollector(std::make_unique<histogram::DrmBlobSource>(),
+                         std::make_shared<histogram::DefaultTimeKeeper>()) {}
+
+histogram::HistogramCollector::HistogramCollector(std::unique_ptr<BlobSource> source,
+                                                  std::shared_ptr<TimeKeeper> tk)
+    : blob_source(std::move(source)),
+      timekeeper(std::move(tk)),
+      histogram(histogram::Ringbuffer::create(implementation_defined_max_frame_ringbuffer,
+                                              std::make_unique<SharedTimeKeeper>(timekeeper))) {}
 
 histogram::HistogramCollector::~HistogramCollector() {
   stop();
 }
 
-namespace {
-static constexpr size_t numBuckets = 8;
-static_assert((HIST_V_SIZE % numBuckets) == 0,
-              "histogram cannot be rebucketed to smaller number of buckets");
-static constexpr int bucket_compression = HIST_V_SIZE / numBuckets;
-
-std::array<uint64_t, numBuckets> rebucketTo8Buckets(
-    std::array<uint64_t, HIST_V_SIZE> const &frame) {
-  std::array<uint64_t, numBuckets> bins;
-  bins.fill(0);
-  for (auto i = 0u; i < HIST_V_SIZE; i++)
-    bins[i / bucket_compression] += frame[i];
-  return bins;
+bool histogram::HistogramCollector::set_bucket_count(uint32_t buckets) {
+  if (buckets == 0 || buckets > HIST_V_SIZE || (HIST_V_SIZE % buckets) != 0)
+    return false;
+  std::unique_lock<decltype(mutex)> lk(mutex);
+  num_buckets = buckets;
+  return true;
 }
-}  // namespace
 
 std::string histogram::HistogramCollector::Dump() const {
+  std::unique_lock<decltype(mutex)> lk(mutex);
+  auto const rb = histogram;
+  auto const buckets = num_buckets;
+  lk.unlock();
+
   uint64_t num_frames = 0;
   std::array<uint64_t, HIST_V_SIZE> all_sample_buckets;
-  std::tie(num_frames, all_sample_buckets) = histogram->collect_cumulative();
-  std::array<uint64_t, numBuckets> samples = rebucketTo8Buckets(all_sample_buckets);
+  std::tie(num_frames, all_sample_buckets) = rb->collect_cumulative();
+  std::vector<uint64_t> samples = rebucket(all_sample_buckets, buckets);
 
   std::stringstream ss;
   ss << "Color Sampling, dark (0.0) to light (1.0): sampled frames: " << num_frames << '\n';
@@ -103,28 +219,38 @@ HWC2::Error histogram::HistogramCollector::collect(
   if (!out_samples_size || !out_num_frames)
     return HWC2::Error::BadParameter;
 
-  out_samples_size[0] = 0;
-  out_samples_size[1] = 0;
-  out_samples_size[2] = numBuckets;
-  out_samples_size[3] = 0;
+  std::unique_lock<decltype(mutex)> lk(mutex);
+  auto const rb = histogram;
+  auto const buckets = num_buckets;
+  // A mask of 0 enables all supported components.
+  auto const components = (component_mask ? component_mask : hw_supported_components) &
+                          hw_supported_components;
+  lk.unlock();
+
+  for (auto c = 0u; c < NUM_HISTOGRAM_COLOR_COMPONENTS; c++)
+    out_samples_size[c] = (components & (1u << c)) ? static_cast<int32_t>(buckets) : 0;
 
+  // The ringbuffer keeps prefix sums, so any window costs O(HIST_V_SIZE) regardless of length.
   uint64_t num_frames = 0;
   std::array<uint64_t, HIST_V_SIZE> samples;
 
   if (max_frames == 0 && timestamp == 0) {
-    std::tie(num_frames, samples) = histogram->collect_cumulative();
+    std::tie(num_frames, samples) = rb->collect_cumulative();
   } else if (max_frames == 0) {
-    std::tie(num_frames, samples) = histogram->collect_after(timestamp);
+    std::tie(num_frames, samples) = rb->collect_after(timestamp);
   } else if (timestamp == 0) {
-    std::tie(num_frames, samples) = histogram->collect_max(max_frames);
+    std::tie(num_frames, samples) = rb->collect_max(max_frames);
   } else {
-    std::tie(num_frames, samples) = histogram->collect_max_after(timestamp, max_frames);
+    std::tie(num_frames, samples) = rb->collect_max_after(timestamp, max_frames);
   }
 
-  auto samples_rebucketed = rebucketTo8Buckets(samples);
+  auto samples_rebucketed = rebucket(samples, buckets);
   *out_num_frames = num_frames;
-  if (out_samples && out_samples[2])
-    memcpy(out_samples[2], samples_rebucketed.data(), sizeof(uint64_t) * samples_rebucketed.size());
+  for (auto c = 0u; c < NUM_HISTOGRAM_COLOR_COMPONENTS; c++) {
+    if (out_samples && out_samples[c] && out_samples_size[c])
+      memcpy(out_samples[c], samples_rebucketed.data(),
+             sizeof(uint64_t) * samples_rebucketed.size());
+  }
 
   return HWC2::Error::None;
 }
@@ -136,7 +262,7 @@ HWC2::Error histogram::HistogramCollector::getAttributes(int32_t *format, int32_
 
   *format = HAL_PIXEL_FORMAT_HSV_888;
   *dataspace = HAL_DATASPACE_UNKNOWN;
-  *supported_components = HWC2_FORMAT_COMPONENT_2;
+  *supported_components = hw_supported_components;
   return HWC2::Error::None;
 }
 
@@ -145,15 +271,24 @@ void histogram::HistogramCollector::start() {
 }
 
 void histogram::HistogramCollector::start(uint64_t max_frames) {
+  start(max_frames, 0);
+}
+
+void histogram::HistogramCollector::start(uint64_t max_frames, uint8_t mask) {
   std::unique_lock<decltype(mutex)> lk(mutex);
+  component_mask = mask;
   if (started) {
     return;
   }
 
   started = true;
-  histogram =
-      histogram::Ringbuffer::create(max_frames, std::make_unique<histogram::DefaultTimeKeeper>());
-  monitoring_thread = std::thread(&HistogramCollector::blob_processing_thread, this);
+  if (max_frames == 0) {
+    max_frames = implementation_defined_max_frame_ringbuffer;
+  }
+  histogram = histogram::Ringbuffer::create(max_frames,
+                                            std::make_unique<SharedTimeKeeper>(timekeeper));
+  lk.unlock();
+  BlobProcessor::get().attach();
 }
 
 void histogram::HistogramCollector::stop() {
@@ -163,11 +298,10 @@ void histogram::HistogramCollector::stop() {
   }
 
   started = false;
-  cv.notify_all();
+  work_available = false;
   lk.unlock();
 
-  if (monitoring_thread.joinable())
-    monitoring_thread.join();
+  BlobProcessor::get().detach(this);
 }
 
 void histogram::HistogramCollector::notify_histogram_event(int blob_source_fd, BlobId id,
@@ -181,51 +315,41 @@ void histogram::HistogramCollector::notify_histogram_event(int blob_source_fd, B
     ALOGI("notified of histogram event before consuming last one. prior event discarded");
   }
 
-  panel_width_ = width;
-  panel_height_ = height;
-
   work_available = true;
-  blobwork = HistogramCollector::BlobWork{blob_source_fd, id};
-  cv.notify_all();
+  blobwork = HistogramCollector::BlobWork{blob_source_fd, id, width, height};
+  // Queued under the collector lock, so stop() either sees this entry when it detaches or this
+  // call sees started cleared. Otherwise a destroyed collector could be left in the queue.
+  BlobProcessor::get().schedule(this);
 }
 
-void histogram::HistogramCollector::blob_processing_thread() {
-  pthread_setname_np(pthread_self(), "histogram_blob");
-
+void histogram::HistogramCollector::process_blob() {
   std::unique_lock<decltype(mutex)> lk(mutex);
+  if (!started || !work_available) {
+    return;
+  }
 
-  while (true) {
-    cv.wait(lk, [this] { return !started || work_available; });
-    if (!started) {
-      return;
-    }
-
-    auto work = blobwork;
-    work_available = false;
-    lk.unlock();
-
-    drmModePropertyBlobPtr blob = drmModeGetPropertyBlob(work.fd, work.id);
-    if (!blob || !blob->data) {
-      lk.lock();
-      continue;
-    }
+  auto work = blobwork;
+  auto rb = histogram;
+  work_available = false;
+  lk.unlock();
 
-    bool pass = hist_data_validate(*static_cast<struct drm_msm_hist *>(blob->data));
-    if (pass) {
-      histogram->insert(*static_cast<struct drm_msm_hist *>(blob->data));
-    }
-    drmModeFreePropertyBlob(blob);
+  drm_msm_hist hist;
+  if (!blob_source->read(work.fd, work.id, &hist)) {
+    return;
+  }
 
-    lk.lock();
+  if (hist_data_validate(hist, work.width, work.height)) {
+    rb->insert(hist);
   }
 }
 
-bool histogram::HistogramCollector::hist_data_validate(struct drm_msm_hist const &hist) {
+bool histogram::HistogramCollector::hist_data_validate(struct drm_msm_hist const &hist,
+                                                       uint32_t width, uint32_t height) {
   uint32_t hist_checksum = 0;
-  uint32_t pixels_sum = panel_width_ * panel_height_;
+  uint32_t pixels_sum = width * height;
 
   if (pixels_sum == 0) {
-    ALOGI("Invalid panel_width %u, height  %u", panel_width_, panel_height_);
+    ALOGI("Invalid panel_width %u, height  %u", width, height);
     return false;
   }
 
@@ -242,8 +366,8 @@ bool histogram::HistogramCollector::hist_data_validate(struct drm_msm_hist const
 
   // Hist data is valid when the sum of all hist data equals the total number of pixels
   if (pixels_sum != hist_checksum) {
-    ALOGI("Invalid hsit data, panel_width %u, height %u, hist_checksum %u", panel_width_,
-          panel_height_, hist_checksum);
+    ALOGI("Invalid hsit data, panel_width %u, height %u, hist_checksum %u", width, height,
+          hist_checksum);
     return false;
   }
 
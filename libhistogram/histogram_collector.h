@@ -24,10 +24,9 @@
 #ifndef HISTOGRAM_HISTOGRAM_COLLECTOR_H_
 #define HISTOGRAM_HISTOGRAM_COLLECTOR_H_
 #include <android-base/thread_annotations.h>
-#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
 #define HWC2_INCLUDE_STRINGIFICATION
 #define HWC2_USE_CPP11
 #include <hardware/hwcomposer2.h>
@@ -37,18 +36,40 @@
 // number of enums in hwc2_format_color_component_t;
 #define NUM_HISTOGRAM_COLOR_COMPONENTS 4
 
+struct drm_msm_hist;
+
 namespace histogram {
 typedef uint32_t BlobId;
 
 class Ringbuffer;
+class BlobProcessor;
+struct TimeKeeper;
+
+// Reads the histogram blob published by the driver.
+struct BlobSource {
+  virtual bool read(int fd, BlobId id, drm_msm_hist *hist) = 0;
+  virtual ~BlobSource() = default;
+};
+
+struct DrmBlobSource final : BlobSource {
+  bool read(int fd, BlobId id, drm_msm_hist *hist) final;
+};
+
+// Per display content sampling state. Blobs of all started collectors in the process are fetched
+// and inserted by one shared processing thread.
 class HistogramCollector {
  public:
   HistogramCollector();
+  HistogramCollector(std::unique_ptr<BlobSource> source, std::shared_ptr<TimeKeeper> tk);
   ~HistogramCollector();
 
   void start();
   void start(uint64_t max_frames);
+  // max_frames of 0 selects the default depth, component_mask of 0 enables all supported.
+  void start(uint64_t max_frames, uint8_t component_mask);
   void stop();
+  // num_buckets must divide HIST_V_SIZE; applies to subsequent collect() calls.
+  bool set_bucket_count(uint32_t num_buckets);
 
   void notify_histogram_event(int blob_source_fd, BlobId id, uint32_t width, uint32_t height);
 
@@ -61,28 +82,31 @@ class HistogramCollector {
                             uint8_t *supported_components) const;
 
  private:
+  friend class BlobProcessor;
+
   HistogramCollector(HistogramCollector const &) = delete;
   HistogramCollector &operator=(HistogramCollector const &) = delete;
-  void blob_processing_thread();
-  bool hist_data_validate(struct drm_msm_hist const &hist);
+  void process_blob();
+  bool hist_data_validate(struct drm_msm_hist const &hist, uint32_t width, uint32_t height);
 
-  std::condition_variable cv;
   std::mutex mutable mutex;
   bool started /* GUARDED_BY(mutex) */ = false;
 
   struct BlobWork {
     int fd; /* non-owning! */
     BlobId id;
+    uint32_t width;
+    uint32_t height;
   } blobwork /* GUARDED_BY(mutex) */;
   // no optional in c++14.
   bool work_available = false; /* GUARDED_BY(mutex) */
   ;
 
-  std::thread monitoring_thread;
-
-  std::unique_ptr<histogram::Ringbuffer> histogram;
-  uint32_t panel_width_ = 0;
-  uint32_t panel_height_ = 0;
+  std::unique_ptr<BlobSource> const blob_source;
+  std::shared_ptr<TimeKeeper> const timekeeper;
+  std::shared_ptr<histogram::Ringbuffer> histogram /* GUARDED_BY(mutex) */;
+  uint8_t component_mask /* GUARDED_BY(mutex) */ = 0;
+  uint32_t num_buckets /* GUARDED_BY(mutex) */ = 8;
 };
 
 }  // namespace histogram
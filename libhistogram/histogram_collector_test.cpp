@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <set>
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "histogram_collector.h"
+#include "ringbuffer.h"
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint32_t kWidth = 16;
+constexpr uint32_t kHeight = 16;
+constexpr int kFakeFd = 42;
+
+struct FakeTimeKeeper : histogram::TimeKeeper {
+  void tick() { fake_time += std::chrono::nanoseconds(1ms).count(); }
+  nsecs_t current_time() const final { return fake_time; }
+
+ private:
+  std::atomic<nsecs_t> fake_time{0};
+};
+
+// Serves synthetic drm_msm_hist blobs by id and records the threads reading them.
+struct FakeBlobSource : histogram::BlobSource {
+  bool read(int fd, histogram::BlobId id, drm_msm_hist *hist) final {
+    std::lock_guard<std::mutex> lk(mutex);
+    readers.insert(std::this_thread::get_id());
+    auto it = blobs.find(id);
+    if (fd != kFakeFd || it == blobs.end())
+      return false;
+    *hist = it->second;
+    return true;
+  }
+
+  void add(histogram::BlobId id, drm_msm_hist const &hist) {
+    std::lock_guard<std::mutex> lk(mutex);
+    blobs[id] = hist;
+  }
+
+  std::mutex mutex;
+  std::map<histogram::BlobId, drm_msm_hist> blobs;
+  std::set<std::thread::id> readers;
+};
+
+// All pixels of the frame in a single histogram bin.
+drm_msm_hist makeFrame(uint32_t bin) {
+  drm_msm_hist hist{};
+  hist.data[bin] = kWidth * kHeight;
+  return hist;
+}
+
+struct Sample {
+  uint64_t frames = 0;
+  int32_t sizes[NUM_HISTOGRAM_COLOR_COMPONENTS] = {};
+  std::vector<uint64_t> components[NUM_HISTOGRAM_COLOR_COMPONENTS];
+};
+
+Sample collect(histogram::HistogramCollector const &collector, uint64_t max_frames) {
+  Sample sample;
+  uint64_t *buffers[NUM_HISTOGRAM_COLOR_COMPONENTS];
+  for (auto c = 0u; c < NUM_HISTOGRAM_COLOR_COMPONENTS; c++) {
+    sample.components[c].assign(HIST_V_SIZE, 0);
+    buffers[c] = sample.components[c].data();
+  }
+  EXPECT_THAT(collector.collect(max_frames, 0, sample.sizes, buffers, &sample.frames),
+              Eq(HWC2::Error::None));
+  for (auto c = 0u; c < NUM_HISTOGRAM_COLOR_COMPONENTS; c++)
+    sample.components[c].resize(sample.sizes[c]);
+  return sample;
+}
+
+bool waitForFrames(histogram::HistogramCollector const &collector, uint64_t frames) {
+  for (auto i = 0; i < 2000; i++) {
+    if (collect(collector, 1000).frames >= frames)
+      return true;
+    std::this_thread::sleep_for(1ms);
+  }
+  return false;
+}
+
+class HistogramCollectorTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<histogram::HistogramCollector> createCollector(FakeBlobSource **source) {
+    auto blob_source = std::make_unique<FakeBlobSource>();
+    *source = blob_source.get();
+    return std::make_unique<histogram::HistogramCollector>(std::move(blob_source), tk);
+  }
+
+  // Publishes a frame and waits for the processing thread to insert it.
+  void feed(histogram::HistogramCollector &collector, FakeBlobSource &source,
+            histogram::BlobId id, uint32_t bin, uint64_t expected_frames) {
+    source.add(id, makeFrame(bin));
+    collector.notify_histogram_event(kFakeFd, id, kWidth, kHeight);
+    ASSERT_TRUE(waitForFrames(collector, expected_frames));
+    tk->tick();
+  }
+
+  std::shared_ptr<FakeTimeKeeper> tk = std::make_shared<FakeTimeKeeper>();
+};
+
+}  // namespace
+
+TEST_F(HistogramCollectorTest, Attributes) {
+  FakeBlobSource *source = nullptr;
+  auto collector = createCollector(&source);
+  int32_t format = 0;
+  int32_t dataspace = -1;
+  uint8_t components = 0;
+  EXPECT_THAT(collector->getAttributes(&format, &dataspace, &components), Eq(HWC2::Error::None));
+  EXPECT_THAT(format, Eq(HAL_PIXEL_FORMAT_HSV_888));
+  EXPECT_THAT(dataspace, Eq(HAL_DATASPACE_UNKNOWN));
+  EXPECT_THAT(components, Eq(HWC2_FORMAT_COMPONENT_2));
+}
+
+TEST_F(HistogramCollectorTest, BucketCountValidation) {
+  FakeBlobSource *source = nullptr;
+  auto collector = createCollector(&source);
+  EXPECT_FALSE(collector->set_bucket_count(0));
+  EXPECT_FALSE(collector->set_bucket_count(3));
+  EXPECT_FALSE(collector->set_bucket_count(HIST_V_SIZE * 2));
+  EXPECT_TRUE(collector->set_bucket_count(1));
+  EXPECT_TRUE(collector->set_bucket_count(HIST_V_SIZE));
+
+  auto sample = collect(*collector, 0);
+  EXPECT_THAT(sample.sizes, ElementsAre(0, 0, HIST_V_SIZE, 0));
+}
+
+TEST_F(HistogramCollectorTest, SyntheticFeedIsRebucketed) {
+  FakeBlobSource *source = nullptr;
+  auto collector = createCollector(&source);
+  ASSERT_TRUE(collector->set_bucket_count(16));
+  collector->start(10);
+
+  feed(*collector, *source, 1, 0, 1);
+  feed(*collector, *source, 2, HIST_V_SIZE - 1, 2);
+
+  auto sample = collect(*collector, 10);
+  EXPECT_THAT(sample.frames, Eq(2u));
+  EXPECT_THAT(sample.sizes, ElementsAre(0, 0, 16, 0));
+  uint64_t const pixels_ms = kWidth * kHeight;
+  for (auto i = 0u; i < 16; i++) {
+    uint64_t expected = (i == 0 || i == 15) ? pixels_ms : 0;
+    EXPECT_THAT(sample.components[2][i], Eq(expected)) << "bucket " << i;
+  }
+
+  sample = collect(*collector, 1);
+  EXPECT_THAT(sample.frames, Eq(1u));
+  EXPECT_THAT(sample.components[2][15], Eq(pixels_ms));
+  EXPECT_THAT(sample.components[2][0], Eq(0u));
+  collector->stop();
+}
+
+TEST_F(HistogramCollectorTest, InvalidHistogramIsDropped) {
+  FakeBlobSource *source = nullptr;
+  auto collector = createCollector(&source);
+  collector->start(10);
+
+  drm_msm_hist bad = makeFrame(3);
+  bad.data[4] = 1;
+  source->add(7, bad);
+  collector->notify_histogram_event(kFakeFd, 7, kWidth, kHeight);
+  feed(*collector, *source, 8, 3, 1);
+
+  EXPECT_THAT(collect(*collector, 10).frames, Eq(1u));
+  collector->stop();
+}
+
+TEST_F(HistogramCollectorTest, ComponentMask) {
+  FakeBlobSource *source = nullptr;
+  auto collector = createCollector(&source);
+
+  collector->start(10, HWC2_FORMAT_COMPONENT_0 | HWC2_FORMAT_COMPONENT_1);
+  EXPECT_THAT(collect(*collector, 0).sizes, ElementsAre(0, 0, 0, 0));
+
+  collector->start(10, HWC2_FORMAT_COMPONENT_2 | HWC2_FORMAT_COMPONENT_3);
+  EXPECT_THAT(collect(*collector, 0).sizes, ElementsAre(0, 0, 8, 0));
+
+  collector->start(10, 0);
+  EXPECT_THAT(collect(*collector, 0).sizes, ElementsAre(0, 0, 8, 0));
+  collector->stop();
+}
+
+TEST_F(HistogramCollectorTest, DisplaysShareOneProcessingThread) {
+  FakeBlobSource *source0 = nullptr;
+  FakeBlobSource *source1 = nullptr;
+  auto display0 = createCollector(&source0);
+  auto display1 = createCollector(&source1);
+  display0->start(100);
+  display1->start(100);
+
+  for (auto i = 1u; i <= 20; i++) {
+    feed(*display0, *source0, i, 10, i);
+    feed(*display1, *source1, 100 + i, 200, i);
+  }
+
+  auto sample0 = collect(*display0, 100);
+  auto sample1 = collect(*display1, 100);
+  EXPECT_THAT(sample0.frames, Eq(20u));
+  EXPECT_THAT(sample1.frames, Eq(20u));
+  EXPECT_THAT(sample0.components[2][10 * 8 / HIST_V_SIZE], Gt(0u));
+  EXPECT_THAT(sample0.components[2][200 * 8 / HIST_V_SIZE], Eq(0u));
+  EXPECT_THAT(sample1.components[2][200 * 8 / HIST_V_SIZE], Gt(0u));
+  EXPECT_THAT(sample1.components[2][10 * 8 / HIST_V_SIZE], Eq(0u));
+
+  std::set<std::thread::id> readers = source0->readers;
+  readers.insert(source1->readers.begin(), source1->readers.end());
+  EXPECT_THAT(readers.size(), Eq(1u));
+  EXPECT_THAT(*readers.begin(), Ne(std::this_thread::get_id()));
+
+  display0->stop();
+  // The remaining display keeps being served after the other one stops.
+  feed(*display1, *source1, 500, 200, 21);
+  display1->stop();
+}
+
+TEST_F(HistogramCollectorTest, RestartAfterStop) {
+  FakeBlobSource *source = nullptr;
+  auto collector = createCollector(&source);
+  collector->start(10);
+  feed(*collector, *source, 1, 0, 1);
+  collector->stop();
+
+  collector->start(10);
+  EXPECT_THAT(collect(*collector, 10).frames, Eq(0u));
+  feed(*collector, *source, 2, 0, 1);
+  collector->stop();
+}
+
+// Events racing stop() must not leave the collector queued once it is destroyed. The other
+// display keeps the processing thread alive so it would pick up such a stale entry.
+TEST_F(HistogramCollectorTest, NotifyRacingStop) {
+  FakeBlobSource *keeper_source = nullptr;
+  auto keeper = createCollector(&keeper_source);
+  keeper->start(10);
+
+  for (auto i = 0u; i < 200; i++) {
+    FakeBlobSource *source = nullptr;
+    auto collector = createCollector(&source);
+    collector->start(10);
+    std::atomic<bool> done{false};
+    std::thread notifier([&] {
+      while (!done.load())
+        collector->notify_histogram_event(kFakeFd, 1, kWidth, kHeight);
+    });
+    std::this_thread::sleep_for(10us);
+    collector->stop();
+    done = true;
+    notifier.join();
+    collector.reset();
+  }
+
+  feed(*keeper, *keeper_source, 1, 0, 1);
+  keeper->stop();
+}
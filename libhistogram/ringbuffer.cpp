@@ -25,7 +25,10 @@
 #include <log/log.h>
 #include <unistd.h>
 #include <algorithm>
-#include <iostream>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <thread>
 
 #include "ringbuffer.h"
 
@@ -33,9 +36,37 @@ nsecs_t histogram::DefaultTimeKeeper::current_time() const {
   return systemTime(SYSTEM_TIME_MONOTONIC);
 }
 
+namespace {
+
+int64_t displayed_ms(nsecs_t start, nsecs_t end) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(end - start))
+      .count();
+}
+
+template <typename T>
+T load(std::atomic<T> const &value) {
+  return value.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+void store(std::atomic<T> &value, T desired) {
+  value.store(desired, std::memory_order_relaxed);
+}
+
+}  // namespace
+
 histogram::Ringbuffer::Ringbuffer(size_t ringbuffer_size, std::unique_ptr<histogram::TimeKeeper> tk)
-    : rb_max_size(ringbuffer_size), timekeeper(std::move(tk)), cumulative_frame_count(0) {
-  cumulative_bins.fill(0);
+    : sequence(0),
+      storage(std::make_shared<Storage>(ringbuffer_size)),
+      head(0),
+      size(0),
+      rb_max_size(ringbuffer_size),
+      timekeeper(std::move(tk)),
+      cumulative_frame_count(0) {
+  for (auto i = 0u; i < HIST_V_SIZE; i++) {
+    store(newest_frame[i], 0u);
+    store(cumulative_bins[i], uint64_t(0));
+  }
 }
 
 std::unique_ptr<histogram::Ringbuffer> histogram::Ringbuffer::create(
@@ -46,116 +77,190 @@ std::unique_ptr<histogram::Ringbuffer> histogram::Ringbuffer::create(
       new histogram::Ringbuffer(ringbuffer_size, std::move(tk)));
 }
 
-void histogram::Ringbuffer::update_cumulative(nsecs_t now, uint64_t &count,
-                                              std::array<uint64_t, HIST_V_SIZE> &bins) const {
-  if (ringbuffer.empty())
+template <typename Fn>
+auto histogram::Ringbuffer::read(Fn const &fn) const
+    -> decltype(fn(std::declval<Storage const &>())) {
+  while (true) {
+    auto const seq = sequence.load(std::memory_order_acquire);
+    if (seq & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    auto const snapshot = std::atomic_load(&storage);
+    auto result = fn(*snapshot);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) == seq)
+      return result;
+  }
+}
+
+void histogram::Ringbuffer::begin_write() {
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void histogram::Ringbuffer::end_write() {
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void histogram::Ringbuffer::update_cumulative(nsecs_t now, uint64_t &count, Bins &bins) const {
+  if (load(size) == 0)
     return;
 
   count++;
-  ALOGI("count : %llu", static_cast<unsigned long long>(count));
-
-  const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(
-      std::chrono::nanoseconds(now - ringbuffer.front().start_timestamp));
+  auto const &newest = std::atomic_load(&storage)->at(load(head) - 1);
+  auto const delta = static_cast<uint64_t>(displayed_ms(load(newest.start_timestamp), now));
 
-  for (auto i = 0u; i < bins.size(); i++) {
-    ALOGI("histogram.data[%d]: %u\n", i, ringbuffer.front().histogram.data[i]);
-    auto const increment = ringbuffer.front().histogram.data[i] * delta.count();
+  // Branch free, the saturation check does not sit on a data dependent branch.
+  for (auto i = 0u; i < HIST_V_SIZE; i++) {
+    uint64_t const data = load(newest_frame[i]);
+    uint64_t const increment = data * delta;
+    uint64_t const sum = bins[i] + increment;
     // Check increment non-0 to avoid overflow in the next hist event
-    if (CC_UNLIKELY(increment && ((bins[i] + increment < bins[i]) ||
-                                  (increment < ringbuffer.front().histogram.data[i])))) {
-      bins[i] = std::numeric_limits<uint64_t>::max();
-    } else {
-      bins[i] += increment;
-    }
-    ALOGI("bins[%d]: %llu\n", i, static_cast<unsigned long long>(bins[i]));
+    bool const saturate = (increment != 0) & ((sum < bins[i]) | (increment < data));
+    bins[i] = saturate ? std::numeric_limits<uint64_t>::max() : sum;
   }
 }
 
-void histogram::Ringbuffer::insert(drm_msm_hist const &frame) {
-  std::cout << "Enter insert ringbuffer" << std::endl;
+void histogram::Ringbuffer::copy_slot(Slot const &from, Slot &to) {
+  store(to.start_timestamp, load(from.start_timestamp));
+  for (auto i = 0u; i < HIST_V_SIZE; i++)
+    store(to.prefix[i], load(from.prefix[i]));
+}
 
-  std::unique_lock<decltype(mutex)> lk(mutex);
+void histogram::Ringbuffer::insert(drm_msm_hist const &frame) {
+  std::unique_lock<decltype(writer_mutex)> lk(writer_mutex);
   auto now = timekeeper->current_time();
+  auto &rb = *storage;
+  auto const seq = load(head);
+  auto const count = load(size);
 
-  std::cout << "update cumulative count" << std::endl;
-  update_cumulative(now, cumulative_frame_count, cumulative_bins);
+  // Only the producer writes these, so it can compute outside the write section.
+  uint64_t frame_count = load(cumulative_frame_count);
+  Bins bins;
+  for (auto i = 0u; i < HIST_V_SIZE; i++)
+    bins[i] = load(cumulative_bins[i]);
+  update_cumulative(now, frame_count, bins);
 
-  if (ringbuffer.size() == rb_max_size)
-    ringbuffer.pop_back();
-  if (!ringbuffer.empty())
-    ringbuffer.front().end_timestamp = now;
+  begin_write();
+  store(cumulative_frame_count, frame_count);
+  for (auto i = 0u; i < HIST_V_SIZE; i++)
+    store(cumulative_bins[i], bins[i]);
 
-  std::cout << "Exit insert ringbuffer" << std::endl;
-  ringbuffer.push_front({frame, now, 0});
+  auto &next = rb.at(seq);
+  if (count == 0) {
+    for (auto &prefix : next.prefix)
+      store(prefix, uint64_t(0));
+  } else {
+    // prev and next alias when the capacity is 1, which the in-place update handles.
+    auto const &prev = rb.at(seq - 1);
+    auto const delta = static_cast<uint64_t>(displayed_ms(load(prev.start_timestamp), now));
+    for (auto i = 0u; i < HIST_V_SIZE; i++) {
+      store(next.prefix[i], load(prev.prefix[i]) + load(newest_frame[i]) * delta);
+    }
+  }
+  store(next.start_timestamp, now);
+  for (auto i = 0u; i < HIST_V_SIZE; i++)
+    store(newest_frame[i], frame.data[i]);
+
+  store(head, seq + 1);
+  store(size, std::min(count + 1, load(rb_max_size)));
+  end_write();
 }
 
 bool histogram::Ringbuffer::resize(size_t ringbuffer_size) {
-  std::unique_lock<decltype(mutex)> lk(mutex);
+  std::unique_lock<decltype(writer_mutex)> lk(writer_mutex);
   if (ringbuffer_size == 0)
     return false;
-  rb_max_size = ringbuffer_size;
-  if (ringbuffer.size() > rb_max_size)
-    ringbuffer.resize(rb_max_size);
+
+  auto const seq = load(head);
+  auto const count = std::min(load(size), static_cast<uint64_t>(ringbuffer_size));
+  if (ringbuffer_size > storage->slots.size()) {
+    // Readers may still hold the old storage, so grow into a copy and publish it.
+    auto grown = std::make_shared<Storage>(ringbuffer_size);
+    for (auto i = seq - count; i < seq; i++)
+      copy_slot(storage->at(i), grown->at(i));
+    begin_write();
+    std::atomic_store(&storage, std::shared_ptr<Storage>(std::move(grown)));
+  } else {
+    begin_write();
+  }
+
+  store(rb_max_size, static_cast<uint64_t>(ringbuffer_size));
+  store(size, count);
+  end_write();
   return true;
 }
 
+histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_newest(Storage const &rb,
+                                                                    uint64_t num_frames,
+                                                                    nsecs_t now) const {
+  auto const collect_first = std::min(num_frames, load(size));
+  if (collect_first == 0)
+    return {0, {}};
+
+  auto const seq = load(head);
+  auto const &newest = rb.at(seq - 1);
+  auto const &oldest = rb.at(seq - collect_first);
+  auto const delta = static_cast<uint64_t>(displayed_ms(load(newest.start_timestamp), now));
+
+  Bins bins;
+  for (auto i = 0u; i < HIST_V_SIZE; i++) {
+    bins[i] = load(newest.prefix[i]) - load(oldest.prefix[i]) + load(newest_frame[i]) * delta;
+  }
+  return {collect_first, bins};
+}
+
+uint64_t histogram::Ringbuffer::count_after(Storage const &rb, nsecs_t timestamp) const {
+  // Start timestamps never decrease, so binary search for the newest frames starting at or
+  // after timestamp.
+  auto const seq = load(head);
+  uint64_t lo = 0;
+  uint64_t hi = load(size);
+  while (lo < hi) {
+    auto const mid = lo + (hi - lo) / 2;
+    if (load(rb.at(seq - 1 - mid).start_timestamp) >= timestamp) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
 histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_cumulative() const {
-  std::unique_lock<decltype(mutex)> lk(mutex);
-  histogram::Ringbuffer::Sample sample{cumulative_frame_count, cumulative_bins};
-  update_cumulative(timekeeper->current_time(), std::get<0>(sample), std::get<1>(sample));
-  return sample;
+  return read([this](Storage const &) {
+    histogram::Ringbuffer::Sample sample{load(cumulative_frame_count), {}};
+    for (auto i = 0u; i < HIST_V_SIZE; i++)
+      std::get<1>(sample)[i] = load(cumulative_bins[i]);
+    update_cumulative(timekeeper->current_time(), std::get<0>(sample), std::get<1>(sample));
+    return sample;
+  });
 }
 
 histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_ringbuffer_all() const {
-  std::unique_lock<decltype(mutex)> lk(mutex);
-  return collect_max(ringbuffer.size(), lk);
+  return read([this](Storage const &rb) {
+    return collect_newest(rb, load(size), timekeeper->current_time());
+  });
 }
 
 histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_after(nsecs_t timestamp) const {
-  std::unique_lock<decltype(mutex)> lk(mutex);
-  return collect_max_after(timestamp, ringbuffer.size(), lk);
+  return read([this, timestamp](Storage const &rb) {
+    return collect_newest(rb, count_after(rb, timestamp), timekeeper->current_time());
+  });
 }
 
 histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max(uint32_t max_frames) const {
-  std::unique_lock<decltype(mutex)> lk(mutex);
-  return collect_max(max_frames, lk);
+  return read([this, max_frames](Storage const &rb) {
+    return collect_newest(rb, max_frames, timekeeper->current_time());
+  });
 }
 
 histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max_after(nsecs_t timestamp,
                                                                        uint32_t max_frames) const {
-  std::unique_lock<decltype(mutex)> lk(mutex);
-  return collect_max_after(timestamp, max_frames, lk);
-}
-
-histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max(
-    uint32_t max_frames, std::unique_lock<std::mutex> const &) const {
-  auto collect_first = std::min(static_cast<size_t>(max_frames), ringbuffer.size());
-  if (collect_first == 0)
-    return {0, {}};
-  std::array<uint64_t, HIST_V_SIZE> bins;
-  bins.fill(0);
-  for (auto it = ringbuffer.begin(); it != ringbuffer.end() &&
-    it != ringbuffer.begin() + collect_first; it++) {
-    nsecs_t end_timestamp = it->end_timestamp;
-    if (it == ringbuffer.begin()) {
-      end_timestamp = timekeeper->current_time();
-    }
-    const auto time_displayed = std::chrono::nanoseconds(end_timestamp - it->start_timestamp);
-    const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(time_displayed);
-    for (auto i = 0u; i < HIST_V_SIZE; i++) {
-      bins[i] += it->histogram.data[i] * delta.count();
-    }
-  }
-  return {collect_first, bins};
-}
-
-histogram::Ringbuffer::Sample histogram::Ringbuffer::collect_max_after(
-    nsecs_t timestamp, uint32_t max_frames, std::unique_lock<std::mutex> const &lk) const {
-  auto ts_filter_begin = std::lower_bound(
-      ringbuffer.begin(), ringbuffer.end(), HistogramEntry{{}, timestamp, 0},
-      [](auto const &a, auto const &b) { return a.start_timestamp >= b.start_timestamp; });
-
-  auto collect_last = std::min(std::distance(ringbuffer.begin(), ts_filter_begin),
-                               static_cast<std::ptrdiff_t>(max_frames));
-  return collect_max(collect_last, lk);
+  return read([this, timestamp, max_frames](Storage const &rb) {
+    auto const collect_last =
+        std::min(count_after(rb, timestamp), static_cast<uint64_t>(max_frames));
+    return collect_newest(rb, collect_last, timekeeper->current_time());
+  });
 }
@@ -23,10 +23,12 @@
 #include <xf86drm.h>
 #include <xf86drmMode.h>
 #include <array>
-#include <deque>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 namespace histogram {
 
@@ -44,6 +46,15 @@ struct DefaultTimeKeeper final : TimeKeeper {
   nsecs_t current_time() const final;
 };
 
+// Fixed capacity ring of histogram frames. insert() and resize() come from a single producer
+// (the blob processing thread) and are serialized by writer_mutex. Readers never block the
+// producer: they retry on a sequence counter that is odd while the producer is updating. Every
+// field a reader looks at is atomic and accessed relaxed, the fences around the sequence counter
+// provide the ordering.
+//
+// Each slot keeps the prefix sum of the time weighted bins of every frame inserted before it, so
+// the weight of the newest n frames is prefix(newest) - prefix(oldest) plus the still-displayed
+// newest frame, independent of n.
 class Ringbuffer {
  public:
   static std::unique_ptr<Ringbuffer> create(size_t ringbuffer_size, std::unique_ptr<TimeKeeper> tk);
@@ -63,24 +74,43 @@ class Ringbuffer {
   Ringbuffer(Ringbuffer const &) = delete;
   Ringbuffer &operator=(Ringbuffer const &) = delete;
 
-  Sample collect_max(uint32_t max_frames, std::unique_lock<std::mutex> const &) const;
-  Sample collect_max_after(nsecs_t timestamp, uint32_t max_frames,
-                           std::unique_lock<std::mutex> const &) const;
-  void update_cumulative(nsecs_t now, uint64_t &count,
-                         std::array<uint64_t, HIST_V_SIZE> &bins) const;
-
-  std::mutex mutable mutex;
-  struct HistogramEntry {
-    drm_msm_hist histogram;
-    nsecs_t start_timestamp;
-    nsecs_t end_timestamp;
+  using Bins = std::array<uint64_t, HIST_V_SIZE>;
+  using AtomicBins = std::array<std::atomic<uint64_t>, HIST_V_SIZE>;
+  struct Slot {
+    std::atomic<nsecs_t> start_timestamp;
+    AtomicBins prefix;  // time weighted bins of all frames inserted before this one
+  };
+  struct Storage {
+    explicit Storage(size_t capacity) : slots(capacity) {}
+    Slot &at(uint64_t sequence) { return slots[sequence % slots.size()]; }
+    Slot const &at(uint64_t sequence) const { return slots[sequence % slots.size()]; }
+    std::vector<Slot> slots;
   };
-  std::deque<HistogramEntry> ringbuffer;
-  size_t rb_max_size;
+
+  template <typename Fn>
+  auto read(Fn const &fn) const -> decltype(fn(std::declval<Storage const &>()));
+  void begin_write();
+  void end_write();
+
+  Sample collect_newest(Storage const &storage, uint64_t num_frames, nsecs_t now) const;
+  uint64_t count_after(Storage const &storage, nsecs_t timestamp) const;
+  void update_cumulative(nsecs_t now, uint64_t &count, Bins &bins) const;
+  static void copy_slot(Slot const &from, Slot &to);
+
+  std::mutex writer_mutex;
+  std::atomic<uint32_t> sequence;
+  // Replaced by resize() when growing past the current capacity, readers use std::atomic_load.
+  std::shared_ptr<Storage> storage;
+
+  // Written by the producer between begin_write() and end_write().
+  std::atomic<uint64_t> head;  // number of frames ever inserted
+  std::atomic<uint64_t> size;  // number of frames currently in the ring
+  std::atomic<uint64_t> rb_max_size;
+  std::array<std::atomic<uint32_t>, HIST_V_SIZE> newest_frame;
   std::unique_ptr<TimeKeeper> const timekeeper;
 
-  uint64_t cumulative_frame_count;
-  std::array<uint64_t, HIST_V_SIZE> cumulative_bins;
+  std::atomic<uint64_t> cumulative_frame_count;
+  AtomicBins cumulative_bins;
 };
 
 }  // namespace histogram
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <thread>
+
+#include "ringbuffer.h"
+
+namespace {
+
+struct FakeTimeKeeper : histogram::TimeKeeper {
+  nsecs_t current_time() const final { return fake_time += 16666666; }
+
+ private:
+  std::atomic<nsecs_t> mutable fake_time{0};
+};
+
+drm_msm_hist makeFrame(uint32_t fill) {
+  drm_msm_hist frame{};
+  for (auto i = 0u; i < HIST_V_SIZE; i++) {
+    frame.data[i] = fill + i;
+  }
+  return frame;
+}
+
+std::unique_ptr<histogram::Ringbuffer> makeFilledRingbuffer(size_t size) {
+  auto rb = histogram::Ringbuffer::create(size, std::make_unique<FakeTimeKeeper>());
+  for (auto i = 0u; i < size; i++) {
+    rb->insert(makeFrame(i));
+  }
+  return rb;
+}
+
+void BM_Insert(benchmark::State &state) {
+  auto rb = makeFilledRingbuffer(state.range(0));
+  auto frame = makeFrame(7);
+  for (auto _ : state) {
+    rb->insert(frame);
+  }
+}
+BENCHMARK(BM_Insert)->Arg(300);
+
+void BM_CollectMax(benchmark::State &state) {
+  auto rb = makeFilledRingbuffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rb->collect_max(state.range(0)));
+  }
+}
+BENCHMARK(BM_CollectMax)->Arg(8)->Arg(60)->Arg(300);
+
+void BM_CollectAfter(benchmark::State &state) {
+  auto rb = makeFilledRingbuffer(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rb->collect_after(1));
+  }
+}
+BENCHMARK(BM_CollectAfter)->Arg(8)->Arg(60)->Arg(300);
+
+// Collection from the benchmark thread while another thread inserts at full speed.
+void BM_CollectMaxWithProducer(benchmark::State &state) {
+  auto rb = makeFilledRingbuffer(state.range(0));
+  std::atomic<bool> done{false};
+  std::thread producer([&] {
+    auto frame = makeFrame(3);
+    while (!done) {
+      rb->insert(frame);
+    }
+  });
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rb->collect_max(state.range(0)));
+  }
+  done = true;
+  producer.join();
+}
+BENCHMARK(BM_CollectMaxWithProducer)->Arg(300);
+
+}  // namespace
+
+BENCHMARK_MAIN();
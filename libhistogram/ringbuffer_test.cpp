@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <chrono>
 #include <numeric>
+#include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -50,6 +53,15 @@ struct TickingTimeKeeper : histogram::TimeKeeper {
   nsecs_t mutable fake_time = 0;
 };
 
+struct SteppingTimeKeeper : histogram::TimeKeeper {
+  void tick() { fake_time.fetch_add(toNsecs(1ms)); }
+
+  nsecs_t current_time() const final { return fake_time.load(); }
+
+ private:
+  std::atomic<nsecs_t> fake_time{0};
+};
+
 void insertFrameIncrementTimeline(histogram::Ringbuffer &rb, TickingTimeKeeper &tk,
                                   drm_msm_hist &frame) {
   rb.insert(frame);
@@ -407,6 +419,107 @@ TEST_F(RingbufferTestCases, TimeWeightingTest) {
   }
 }
 
+TEST_F(RingbufferTestCases, TestWindowsMatchPerFrameSum) {
+  static constexpr auto numSlots = 300u;
+  static constexpr auto numInsertions = 1000u;
+  auto tk = std::make_shared<TickingTimeKeeper>();
+  auto rb = histogram::Ringbuffer::create(numSlots, std::make_unique<TimeKeeperWrapper>(tk));
+
+  std::vector<std::tuple<uint64_t /* fill */, uint64_t /* ms */>> frames;
+  for (auto i = 0u; i < numInsertions; i++) {
+    drm_msm_hist frame {};
+    uint64_t fill = (i * 7919u) % 1000u;
+    uint64_t ms = 1 + (i % 5);
+    for (auto j = 0u; j < HIST_V_SIZE; j++) {
+      frame.data[j] = fill + j;
+    }
+    rb->insert(frame);
+    tk->increment_by(std::chrono::milliseconds(ms));
+    frames.emplace_back(fill, ms);
+  }
+
+  for (auto window : {1u, 2u, 17u, 299u, 300u, 500u}) {
+    std::tie(numFrames, bins) = rb->collect_max(window);
+    auto expected_frames = std::min(window, numSlots);
+    ASSERT_THAT(numFrames, Eq(expected_frames));
+    for (auto j = 0u; j < HIST_V_SIZE; j++) {
+      uint64_t expected = 0;
+      for (auto k = numInsertions - expected_frames; k < numInsertions; k++) {
+        expected += (std::get<0>(frames[k]) + j) * std::get<1>(frames[k]);
+      }
+      EXPECT_THAT(bins[j], Eq(expected));
+    }
+  }
+}
+
+TEST_F(RingbufferTestCases, TestResizeUpAfterWrap) {
+  auto tk = std::make_shared<TickingTimeKeeper>();
+  auto rb = histogram::Ringbuffer::create(3, std::make_unique<TimeKeeperWrapper>(tk));
+
+  insertFrameIncrementTimeline(*rb, *tk, frame0);
+  insertFrameIncrementTimeline(*rb, *tk, frame1);
+  insertFrameIncrementTimeline(*rb, *tk, frame2);
+  insertFrameIncrementTimeline(*rb, *tk, frame3);
+  insertFrameIncrementTimeline(*rb, *tk, frame4);
+
+  EXPECT_THAT(rb->resize(5), Eq(true));
+  std::tie(numFrames, bins) = rb->collect_ringbuffer_all();
+  EXPECT_THAT(numFrames, Eq(3));
+  EXPECT_THAT(bins, Each(fill_frame2 + fill_frame3 + fill_frame4));
+
+  insertFrameIncrementTimeline(*rb, *tk, frame0);
+  insertFrameIncrementTimeline(*rb, *tk, frame1);
+  std::tie(numFrames, bins) = rb->collect_ringbuffer_all();
+  EXPECT_THAT(numFrames, Eq(5));
+  EXPECT_THAT(bins, Each(fill_frame2 + fill_frame3 + fill_frame4 + fill_frame0 + fill_frame1));
+
+  std::tie(numFrames, bins) = rb->collect_after(toNsecs(6ms));
+  EXPECT_THAT(numFrames, Eq(1));
+  EXPECT_THAT(bins, Each(fill_frame1));
+}
+
+TEST_F(RingbufferTestCases, TestConcurrentCollectSeesWholeFrames) {
+  static constexpr auto numInsertions = 20000u;
+  auto tk = std::make_shared<SteppingTimeKeeper>();
+  auto rb = histogram::Ringbuffer::create(8, std::make_unique<TimeKeeperWrapper>(tk));
+  std::atomic<bool> done{false};
+
+  // Every frame has all bins equal, so any torn read shows up as unequal bins.
+  std::thread producer([&] {
+    drm_msm_hist frame {};
+    for (auto i = 1u; i <= numInsertions; i++) {
+      std::fill(std::begin(frame.data), std::end(frame.data), i);
+      rb->insert(frame);
+      tk->tick();
+      if (i == numInsertions / 2)
+        rb->resize(16);
+    }
+    done = true;
+  });
+
+  std::vector<std::thread> consumers;
+  std::atomic<uint64_t> torn{0};
+  for (auto c = 0; c < 3; c++) {
+    consumers.emplace_back([&] {
+      int frames = 0;
+      std::array<uint64_t, HIST_V_SIZE> sample;
+      while (!done) {
+        std::tie(frames, sample) = rb->collect_max(5);
+        if (std::any_of(sample.begin(), sample.end(), [&](auto v) { return v != sample[0]; }))
+          torn++;
+      }
+    });
+  }
+
+  producer.join();
+  for (auto &consumer : consumers)
+    consumer.join();
+  EXPECT_THAT(torn.load(), Eq(0u));
+
+  std::tie(numFrames, bins) = rb->collect_ringbuffer_all();
+  EXPECT_THAT(numFrames, Eq(16));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -236,6 +236,32 @@ unsigned long getMetaDataSizeWithReservedRegion(uint64_t reserved_size) {
   return static_cast<unsigned long>(ROUND_UP_PAGESIZE(sizeof(MetaData_t) + reserved_size));
 }
 
+static int mapMetaData(private_handle_t *handle, uintptr_t *base_out, unsigned long *size_out) {
+    auto size = getMetaDataSize();
+    void *base = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED,
+            handle->fd_metadata, 0);
+    if (base == reinterpret_cast<void*>(MAP_FAILED)) {
+        ALOGE("%s: metadata mmap failed - handle:%p fd: %d err: %s",
+            __func__, handle, handle->fd_metadata, strerror(errno));
+        return -1;
+    }
+    auto metadata = reinterpret_cast<MetaData_t *>(base);
+    if (metadata->reservedSize) {
+      auto reserved_size = metadata->reservedSize;
+      munmap(base, size);
+      size = getMetaDataSizeWithReservedRegion(reserved_size);
+      base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle->fd_metadata, 0);
+      if (base == reinterpret_cast<void *>(MAP_FAILED)) {
+        ALOGE("%s: metadata mmap failed - handle:%p fd: %d err: %s", __func__, handle,
+              handle->fd_metadata, strerror(errno));
+        return -1;
+      }
+    }
+    *base_out = reinterpret_cast<uintptr_t>(base);
+    *size_out = size;
+    return 0;
+}
+
 static int validateAndMap(private_handle_t* handle) {
     if (private_handle_t::validate(handle)) {
         ALOGE("%s: Private handle is invalid - handle:%p", __func__, handle);
@@ -247,42 +273,42 @@ static int validateAndMap(private_handle_t* handle) {
     }
 
     if (!handle->base_metadata) {
-        auto size = getMetaDataSize();
-        void *base = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED,
-                handle->fd_metadata, 0);
-        if (base == reinterpret_cast<void*>(MAP_FAILED)) {
-            ALOGE("%s: metadata mmap failed - handle:%p fd: %d err: %s",
-                __func__, handle, handle->fd_metadata, strerror(errno));
-            return -1;
-        }
-        handle->base_metadata = (uintptr_t) base;
-        auto metadata = reinterpret_cast<MetaData_t *>(handle->base_metadata);
-        if (metadata->reservedSize) {
-          auto reserved_size = metadata->reservedSize;
-          munmap(reinterpret_cast<void *>(handle->base_metadata), getMetaDataSize());
-          handle->base_metadata = 0;
-          size = getMetaDataSizeWithReservedRegion(reserved_size);
-          void *new_base =
-              mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle->fd_metadata, 0);
-          if (new_base == reinterpret_cast<void *>(MAP_FAILED)) {
-            ALOGE("%s: metadata mmap failed - handle:%p fd: %d err: %s", __func__, handle,
-                  handle->fd_metadata, strerror(errno));
+        uintptr_t base = 0;
+        unsigned long size = 0;
+        if (mapMetaData(handle, &base, &size) != 0) {
             return -1;
-          }
-          handle->base_metadata = (uintptr_t)new_base;
         }
+        handle->base_metadata = base;
     }
     return 0;
 }
 
-static void unmapAndReset(private_handle_t *handle) {
-    if (private_handle_t::validate(handle) == 0 && handle->base_metadata) {
-      // If reservedSize is 0, the return value will be the same as getMetaDataSize
-      auto metadata = reinterpret_cast<MetaData_t *>(handle->base_metadata);
-      auto size = getMetaDataSizeWithReservedRegion(metadata->reservedSize);
-      munmap(reinterpret_cast<void *>(handle->base_metadata), size);
-      handle->base_metadata = 0;
+// Runs op on the metadata of the handle. A handle imported through gralloc keeps its metadata
+// mapped from ImportHandleLocked() until ReleaseBuffer(), so that mapping is used and left to
+// gralloc. Otherwise the region is mapped for this call only, without touching the handle.
+template <class Op>
+static int runOnMetaData(private_handle_t *handle, Op op) {
+    if (private_handle_t::validate(handle)) {
+        ALOGE("%s: Private handle is invalid - handle:%p", __func__, handle);
+        return -1;
+    }
+    if (handle->fd_metadata < 0) {
+      // Metadata cannot be used
+      return -1;
+    }
+
+    if (handle->base_metadata) {
+      return op(reinterpret_cast<MetaData_t *>(handle->base_metadata));
     }
+
+    uintptr_t base = 0;
+    unsigned long size = 0;
+    if (mapMetaData(handle, &base, &size) != 0) {
+      return -1;
+    }
+    auto ret = op(reinterpret_cast<MetaData_t *>(base));
+    munmap(reinterpret_cast<void *>(base), size);
+    return ret;
 }
 
 int setMetaData(private_handle_t *handle, DispParamType paramType,
@@ -628,15 +654,15 @@ int copyMetaDataVaToVa(MetaData_t *src_data, MetaData_t *dst_data) {
 
 int setMetaDataAndUnmap(struct private_handle_t *handle, enum DispParamType paramType,
                         void *param) {
-    auto ret = setMetaData(handle, paramType, param);
-    unmapAndReset(handle);
-    return ret;
+    return runOnMetaData(handle, [&](MetaData_t *data) {
+      return setMetaDataVa(data, paramType, param);
+    });
 }
 
 int getMetaDataAndUnmap(struct private_handle_t *handle,
                         enum DispFetchParamType paramType,
                         void *param) {
-    auto ret = getMetaData(handle, paramType, param);
-    unmapAndReset(handle);
-    return ret;
+    return runOnMetaData(handle, [&](MetaData_t *data) {
+      return getMetaDataVa(data, paramType, param);
+    });
 }
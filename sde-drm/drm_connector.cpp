@@ -418,6 +418,14 @@ void DRMConnectorManager::Perform(DRMOps code, uint32_t obj_id, drmModeAtomicReq
   it->second->Perform(code, req, args);
 }
 
+void DRMConnectorManager::PostCommit(uint32_t conn_id, bool success) {
+  lock_guard<mutex> lock(lock_);
+  auto it = connector_pool_.find(conn_id);
+  if (it != connector_pool_.end()) {
+    it->second->PostCommit(success);
+  }
+}
+
 int DRMConnectorManager::GetConnectorInfo(uint32_t conn_id, DRMConnectorInfo *info) {
   lock_guard<mutex> lock(lock_);
   int ret = -ENODEV;
@@ -1487,6 +1495,12 @@ void DRMConnector::Perform(DRMOps code, drmModeAtomicReq *req, va_list args) {
   }
 }
 
+void DRMConnector::PostCommit(bool success) {
+  if (pp_mgr_) {
+    pp_mgr_->PostCommit(success);
+  }
+}
+
 void DRMConnector::SetROI(drmModeAtomicReq *req, uint32_t obj_id, uint32_t num_roi,
                           DRMRect *conn_rois) {
 #ifdef SDE_MAX_ROI_V1
@@ -1024,6 +1024,10 @@ bool DRMCrtc::ConfigureScalerLUT(drmModeAtomicReq *req, uint32_t dir_lut_blob_id
 }
 
 void DRMCrtc::PostCommit(bool success) {
+  if (pp_mgr_) {
+    pp_mgr_->PostCommit(success);
+  }
+
   if (success) {
     if (is_lut_validated_) {
       is_lut_configured_ = true;
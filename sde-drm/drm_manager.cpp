@@ -30,6 +30,8 @@
 #include <drm_logger.h>
 
 #include <string.h>
+#include <chrono>
+#include <thread>
 #include "drm_atomic_req.h"
 #include "drm_connector.h"
 #include "drm_crtc.h"
@@ -41,6 +43,10 @@ using std::lock_guard;
 using std::mutex;
 using std::pair;
 using std::make_pair;
+using std::thread;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
 
 extern "C" {
 
@@ -108,28 +114,52 @@ int DRMManager::Init(int drm_fd) {
     DRM_LOGE("Failed to get Connector Mgr");
     return DRM_ERR_INVALID;
   }
-  conn_mgr_->Init(resource);
 
   encoder_mgr_ = new DRMEncoderManager(fd_);
   if (!encoder_mgr_) {
     DRM_LOGE("Failed to get Encoder Mgr");
     return DRM_ERR_INVALID;
   }
-  encoder_mgr_->Init(resource);
 
   crtc_mgr_ = new DRMCrtcManager(fd_);
   if (!crtc_mgr_) {
     DRM_LOGE("Failed to get Crtc Mgr");
     return DRM_ERR_INVALID;
   }
-  crtc_mgr_->Init(resource);
 
   plane_mgr_ = new DRMPlaneManager(fd_);
   if (!plane_mgr_) {
     DRM_LOGE("Failed to get Plane Mgr");
     return DRM_ERR_INVALID;
   }
+
+  // A manager only touches its own objects and the property enum tables of its object type, so
+  // the object types are parsed concurrently. Planes are the most numerous, they stay on this
+  // thread.
+  auto start = steady_clock::now();
+  auto elapsed_us = [start]() {
+    return static_cast<long long>(duration_cast<microseconds>(steady_clock::now() - start).count());
+  };
+  long long conn_us = 0, encoder_us = 0, crtc_us = 0;
+  thread conn_thread([&]() {
+    conn_mgr_->Init(resource);
+    conn_us = elapsed_us();
+  });
+  thread encoder_thread([&]() {
+    encoder_mgr_->Init(resource);
+    encoder_us = elapsed_us();
+  });
+  thread crtc_thread([&]() {
+    crtc_mgr_->Init(resource);
+    crtc_us = elapsed_us();
+  });
   plane_mgr_->Init();
+  long long plane_us = elapsed_us();
+  conn_thread.join();
+  encoder_thread.join();
+  crtc_thread.join();
+  DRM_LOGI("Parsed DRM objects in %lld us: connectors %lld us, encoders %lld us, crtcs %lld us, "
+           "planes %lld us", elapsed_us(), conn_us, encoder_us, crtc_us, plane_us);
 
   dpps_mgr_intf_ = GetDppsManagerIntf();
   if (dpps_mgr_intf_)
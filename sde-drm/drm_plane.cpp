@@ -256,6 +256,26 @@ static uint8_t UCSC_GC_PQ = 2;
 static uint8_t UCSC_GC_GAMMA2_2 = 3;
 static uint8_t UCSC_GC_HLG = 4;
 
+// Values of the enums above as found on the first parse, carried in the plane snapshot
+static uint8_t *const kPlaneEnums[] = {
+  &REFLECT_X, &REFLECT_Y, &ROTATE_90, &ROTATE_0,
+  &NON_SECURE, &SECURE, &NON_SECURE_DIR_TRANSLATION, &SECURE_DIR_TRANSLATION,
+  &MULTIRECT_NONE, &MULTIRECT_PARALLEL, &MULTIRECT_SERIAL,
+  &UNDEFINED, &OPAQUE, &PREMULTIPLIED, &COVERAGE, &SKIP_BLENDING,
+  &UCSC_IGC_DISABLE, &UCSC_IGC_SRGB, &UCSC_IGC_REC709, &UCSC_IGC_GAMMA2_2, &UCSC_IGC_HLG,
+  &UCSC_IGC_PQ,
+  &UCSC_GC_DISABLE, &UCSC_GC_SRGB, &UCSC_GC_PQ, &UCSC_GC_GAMMA2_2, &UCSC_GC_HLG,
+};
+static const uint32_t kPlaneEnumCount = sizeof(kPlaneEnums) / sizeof(kPlaneEnums[0]);
+
+// Parsed planes are kept here so a restart of the service within the same boot can skip
+// reading every plane property and capability blob from the driver again.
+static const char *kPlaneSnapshotPath = "/data/vendor/display/sde_drm_planes.snapshot";
+// Bump whenever SaveSnapshot() or DRMPlaneTypeInfo changes.
+static const uint32_t kPlaneSnapshotVersion = 2;
+// Bound on format and version lists read back, well above what any plane reports.
+static const uint32_t kMaxSnapshotEntries = 4096;
+
 static void SetRect(DRMRect &source, drm_clip_rect *target) {
   target->x1 = uint16_t(source.left);
   target->y1 = uint16_t(source.top);
@@ -463,6 +483,20 @@ void DRMPlaneManager::Init() {
     return;
   }
 
+  string fingerprint = GetDRMSnapshotFingerprint(fd_, kPlaneSnapshotVersion, resource->planes,
+                                                 resource->count_planes);
+  if (fingerprint.empty() || !RestorePlanes(resource, fingerprint)) {
+    plane_pool_.clear();
+    ParsePlanes(resource);
+    if (!fingerprint.empty()) {
+      SavePlanes(resource, fingerprint);
+    }
+  }
+
+  drmModeFreePlaneResources(resource);
+}
+
+void DRMPlaneManager::ParsePlanes(drmModePlaneRes *resource) {
   const uint32_t yield_on_count = 5;
   for (uint32_t i = 0; i < resource->count_planes; i++) {
     if (!(i % yield_on_count)) {
@@ -479,8 +513,62 @@ void DRMPlaneManager::Init() {
       DRM_LOGE("Critical error: drmModeGetPlane() failed for plane %d.", resource->planes[i]);
     }
   }
+}
 
-  drmModeFreePlaneResources(resource);
+bool DRMPlaneManager::RestorePlanes(drmModePlaneRes *resource, const string &fingerprint) {
+  DRMSnapshotReader reader;
+  if (!reader.Load(kPlaneSnapshotPath, fingerprint)) {
+    return false;
+  }
+
+  uint32_t property_count = 0;
+  uint8_t enum_values[kPlaneEnumCount] = {};
+  if (!reader.Get(&property_count) || property_count != (uint32_t)DRMProperty::MAX ||
+      !reader.Get(enum_values, sizeof(enum_values))) {
+    return false;
+  }
+
+  // Planes are saved in enumeration order, the fingerprint already matched their ids.
+  for (uint32_t i = 0; i < resource->count_planes; i++) {
+    unique_ptr<DRMPlane> plane(new DRMPlane(fd_, i));
+    drmModePlane *libdrm_plane = drmModeGetPlane(fd_, resource->planes[i]);
+    if (!libdrm_plane || !plane->InitFromSnapshot(libdrm_plane, &reader)) {
+      if (!libdrm_plane) {
+        DRM_LOGE("Critical error: drmModeGetPlane() failed for plane %d.", resource->planes[i]);
+      }
+      return false;
+    }
+    plane_pool_[resource->planes[i]] = std::move(plane);
+  }
+
+  if (!reader.AtEnd()) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < kPlaneEnumCount; i++) {
+    *kPlaneEnums[i] = enum_values[i];
+  }
+
+  DRM_LOGI("Restored %d planes from %s", resource->count_planes, kPlaneSnapshotPath);
+  return true;
+}
+
+void DRMPlaneManager::SavePlanes(drmModePlaneRes *resource, const string &fingerprint) {
+  // A plane that failed to parse would be missing from the snapshot, parse again next time.
+  if (plane_pool_.size() != resource->count_planes) {
+    return;
+  }
+
+  DRMSnapshotWriter writer;
+  writer.Put((uint32_t)DRMProperty::MAX);
+  for (uint32_t i = 0; i < kPlaneEnumCount; i++) {
+    writer.Put(*kPlaneEnums[i]);
+  }
+  for (uint32_t i = 0; i < resource->count_planes; i++) {
+    plane_pool_.at(resource->planes[i])->SaveSnapshot(&writer);
+  }
+
+  writer.Save(kPlaneSnapshotPath, fingerprint);
 }
 
 void DRMPlaneManager::DumpByID(uint32_t id) {
@@ -936,12 +1024,170 @@ void DRMPlane::ParseProperties() {
 void DRMPlane::InitAndParse(drmModePlane *plane) {
   drm_plane_ = plane;
   ParseProperties();
+  InitPPManager();
+}
 
+void DRMPlane::InitPPManager() {
   unique_ptr<DRMPPManager> pp_mgr(new DRMPPManager(fd_));
   pp_mgr_ = std::move(pp_mgr);
   pp_mgr_->Init(prop_mgr_, DRM_MODE_OBJECT_PLANE);
 }
 
+template <typename T>
+static void PutFormats(const vector<pair<uint32_t, T>> &formats, DRMSnapshotWriter *writer) {
+  writer->Put(uint32_t(formats.size()));
+  for (auto &format : formats) {
+    writer->Put(format.first);
+    writer->Put(format.second);
+  }
+}
+
+template <typename T>
+static bool GetFormats(DRMSnapshotReader *reader, vector<pair<uint32_t, T>> *formats) {
+  uint32_t count = 0;
+  if (!reader->Get(&count) || count > kMaxSnapshotEntries) {
+    return false;
+  }
+
+  formats->resize(count);
+  for (auto &format : *formats) {
+    if (!reader->Get(&format.first) || !reader->Get(&format.second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename K>
+static void PutVersionMap(const map<K, uint32_t> &versions, DRMSnapshotWriter *writer) {
+  writer->Put(uint32_t(versions.size()));
+  for (auto &version : versions) {
+    writer->Put(version.first);
+    writer->Put(version.second);
+  }
+}
+
+template <typename K>
+static bool GetVersionMap(DRMSnapshotReader *reader, map<K, uint32_t> *versions) {
+  uint32_t count = 0;
+  if (!reader->Get(&count) || count > kMaxSnapshotEntries) {
+    return false;
+  }
+
+  versions->clear();
+  for (uint32_t i = 0; i < count; i++) {
+    K key = {};
+    uint32_t version = 0;
+    if (!reader->Get(&key) || !reader->Get(&version)) {
+      return false;
+    }
+    (*versions)[key] = version;
+  }
+  return true;
+}
+
+void DRMPlane::SaveSnapshot(DRMSnapshotWriter *writer) {
+  writer->Put(drm_plane_->plane_id);
+
+  uint32_t count = 0;
+  for (uint32_t i = (uint32_t)DRMProperty::INVALID + 1; i < (uint32_t)DRMProperty::MAX; i++) {
+    count += prop_mgr_.IsPropertyAvailable(DRMProperty(i)) ? 1 : 0;
+  }
+  writer->Put(count);
+  for (uint32_t i = (uint32_t)DRMProperty::INVALID + 1; i < (uint32_t)DRMProperty::MAX; i++) {
+    if (prop_mgr_.IsPropertyAvailable(DRMProperty(i))) {
+      writer->Put(i);
+      writer->Put(prop_mgr_.GetPropertyId(DRMProperty(i)));
+    }
+  }
+  writer->Put(has_excl_rect_);
+
+  const DRMPlaneTypeInfo &info = plane_type_info_;
+  writer->Put(info.type);
+  writer->Put(info.master_plane_id);
+  PutFormats(info.formats_supported, writer);
+  writer->Put(info.max_linewidth);
+  writer->Put(info.max_scaler_linewidth);
+  writer->Put(info.max_rotation_linewidth);
+  writer->Put(info.max_upscale);
+  writer->Put(info.max_downscale);
+  writer->Put(info.max_horizontal_deci);
+  writer->Put(info.max_vertical_deci);
+  writer->Put(info.max_pipe_bandwidth);
+  writer->Put(info.max_pipe_bandwidth_high);
+  writer->Put(info.cache_size);
+  writer->Put(info.has_excl_rect);
+  writer->Put(info.qseed3_version);
+  writer->Put(info.multirect_prop_present);
+  writer->Put(info.inrot_version);
+  PutFormats(info.inrot_fmts_supported, writer);
+  writer->Put(info.true_inline_dwnscale_rt_num);
+  writer->Put(info.true_inline_dwnscale_rt_denom);
+  writer->Put(info.inverse_pma);
+  writer->Put(info.dgm_csc_version);
+  PutVersionMap(info.tonemap_lut_version_map, writer);
+  PutVersionMap(info.ucsc_block_version_map, writer);
+  writer->Put(info.block_sec_ui);
+  writer->Put(info.pipe_idx);
+  writer->Put(info.demura_block_capability);
+}
+
+bool DRMPlane::InitFromSnapshot(drmModePlane *plane, DRMSnapshotReader *reader) {
+  drm_plane_ = plane;
+
+  uint32_t plane_id = 0;
+  uint32_t count = 0;
+  if (!reader->Get(&plane_id) || plane_id != drm_plane_->plane_id || !reader->Get(&count) ||
+      count >= (uint32_t)DRMProperty::MAX) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t prop_enum = 0;
+    uint32_t prop_id = 0;
+    if (!reader->Get(&prop_enum) || !reader->Get(&prop_id) ||
+        prop_enum <= (uint32_t)DRMProperty::INVALID || prop_enum >= (uint32_t)DRMProperty::MAX) {
+      return false;
+    }
+    prop_mgr_.SetPropertyId(DRMProperty(prop_enum), prop_id);
+  }
+
+  DRMPlaneTypeInfo &info = plane_type_info_;
+  bool valid = reader->Get(&has_excl_rect_) &&
+               reader->Get(&info.type) &&
+               reader->Get(&info.master_plane_id) &&
+               GetFormats(reader, &info.formats_supported) &&
+               reader->Get(&info.max_linewidth) &&
+               reader->Get(&info.max_scaler_linewidth) &&
+               reader->Get(&info.max_rotation_linewidth) &&
+               reader->Get(&info.max_upscale) &&
+               reader->Get(&info.max_downscale) &&
+               reader->Get(&info.max_horizontal_deci) &&
+               reader->Get(&info.max_vertical_deci) &&
+               reader->Get(&info.max_pipe_bandwidth) &&
+               reader->Get(&info.max_pipe_bandwidth_high) &&
+               reader->Get(&info.cache_size) &&
+               reader->Get(&info.has_excl_rect) &&
+               reader->Get(&info.qseed3_version) &&
+               reader->Get(&info.multirect_prop_present) &&
+               reader->Get(&info.inrot_version) &&
+               GetFormats(reader, &info.inrot_fmts_supported) &&
+               reader->Get(&info.true_inline_dwnscale_rt_num) &&
+               reader->Get(&info.true_inline_dwnscale_rt_denom) &&
+               reader->Get(&info.inverse_pma) &&
+               reader->Get(&info.dgm_csc_version) &&
+               GetVersionMap(reader, &info.tonemap_lut_version_map) &&
+               GetVersionMap(reader, &info.ucsc_block_version_map) &&
+               reader->Get(&info.block_sec_ui) &&
+               reader->Get(&info.pipe_idx) &&
+               reader->Get(&info.demura_block_capability);
+  if (!valid) {
+    return false;
+  }
+
+  InitPPManager();
+  return true;
+}
+
 bool DRMPlane::ConfigureScalerLUT(drmModeAtomicReq *req, uint32_t dir_lut_blob_id,
                                   uint32_t cir_lut_blob_id, uint32_t sep_lut_blob_id) {
   if (plane_type_info_.type != DRMPlaneType::VIG || is_lut_configured_) {
@@ -1195,6 +1441,12 @@ void DRMPlane::PostValidate(uint32_t crtc_id, bool success) {
 void DRMPlane::PostCommit(uint32_t crtc_id, bool success) {
   DRM_LOGD("crtc %d", crtc_id);
   if (!success) {
+    uint32_t assigned_crtc = 0;
+    GetAssignedCrtc(&assigned_crtc);
+    // Only planes in the failed commit invalidate their blobs, other displays commit on their own
+    if (pp_mgr_ && (requested_crtc_id_ == crtc_id || assigned_crtc == crtc_id)) {
+      pp_mgr_->PostCommit(success);
+    }
     // To reset
     PostValidate(crtc_id, success);
     return;
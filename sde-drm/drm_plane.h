@@ -46,6 +46,7 @@
 
 #include "drm_property.h"
 #include "drm_pp_manager.h"
+#include "drm_snapshot.h"
 
 namespace sde_drm {
 
@@ -63,6 +64,9 @@ class DRMPlane {
   explicit DRMPlane(int fd, uint32_t priority);
   ~DRMPlane();
   void InitAndParse(drmModePlane *plane);
+  // Same as InitAndParse() with the parsed state read back from a snapshot of an earlier run
+  bool InitFromSnapshot(drmModePlane *plane, DRMSnapshotReader *reader);
+  void SaveSnapshot(DRMSnapshotWriter *writer);
   void GetId(uint32_t *id) { *id = drm_plane_->plane_id; }
   void GetType(DRMPlaneType *type) { *type = plane_type_info_.type; }
   void GetPriority(uint32_t *priority) { *priority = priority_; }
@@ -108,6 +112,7 @@ class DRMPlane {
   typedef std::map<DRMProperty, std::tuple<uint64_t, drmModePropertyRes *>> PropertyMap;
   void ParseProperties();
   void GetTypeInfo(const PropertyMap &props);
+  void InitPPManager();
   void PerformWrapper(DRMOps code, drmModeAtomicReq *req, ...);
 
   int fd_ = -1;
@@ -169,6 +174,9 @@ class DRMPlaneManager {
 
  private:
   void Perform(DRMOps code, drmModeAtomicReq *req, uint32_t obj_id, ...);
+  void ParsePlanes(drmModePlaneRes *resource);
+  bool RestorePlanes(drmModePlaneRes *resource, const std::string &fingerprint);
+  void SavePlanes(drmModePlaneRes *resource, const std::string &fingerprint);
 
   int fd_ = -1;
   // Map of plane id to DRMPlane *
@@ -75,6 +75,7 @@
 #include <memory>
 #include <map>
 #include <string>
+#include <utility>
 
 #include "drm_pp_manager.h"
 #include "drm_property.h"
@@ -87,18 +88,11 @@ DRMPPManager::DRMPPManager(int fd) : fd_(fd) {
 
 DRMPPManager::~DRMPPManager() {
 #ifdef PP_DRM_ENABLE
-  DRMPPPropInfo prop_info = {};
-
-  /* free previously created blob to avoid memory leak */
-  for (int i = 0; i < kPPFeaturesMax; i++) {
-    prop_info = pp_prop_map_[i];
-    for (int j = 0; j < NUM_CACHED_BLOB_ID; j++) {
-      if (prop_info.blob_id[j] > 0) {
-        drmModeDestroyPropertyBlob(fd_, prop_info.blob_id[j]);
-        prop_info.blob_id[j] = 0;
-      }
-    }
+  /* free previously created blobs, set or cached, to avoid memory leak */
+  for (auto &blob : pp_blobs_) {
+    drmModeDestroyPropertyBlob(fd_, blob.blob_id);
   }
+  pp_blobs_.clear();
 #endif
   fd_ = -1;
 }
@@ -338,31 +332,108 @@ int DRMPPManager::SetPPBlobProperty(drmModeAtomicReq *req, uint32_t obj_id,
     return 0;
   }
 
-  /* free previously created blob for this feature if exist */
-  if (prop_info->blob_id[prop_info->blob_id_index] > 0) {
-    ret = drmModeDestroyPropertyBlob(fd_, prop_info->blob_id[prop_info->blob_id_index]);
-    if (ret) {
-      DRM_LOGE("failed to destroy property blob for feature %d, ret = %d", feature.id, ret);
-      return ret;
-    } else {
-      prop_info->blob_id[prop_info->blob_id_index] = 0;
-    }
+  blob_id = AcquirePPBlob(feature);
+  if (blob_id == 0) {
+    return DRM_ERR_INVALID;
   }
 
-  ret = drmModeCreatePropertyBlob(fd_, feature.payload, feature.payload_size, &blob_id);
-  if (ret || blob_id == 0) {
-    DRM_LOGE("failed to create property blob ret %d, blob_id = %d", ret, blob_id);
-    return DRM_ERR_INVALID;
+  /* release the blob this slot held, it is not in use by pending commits anymore */
+  if (prop_info->blob_id[prop_info->blob_id_index] > 0) {
+    ReleasePPBlob(prop_info->blob_id[prop_info->blob_id_index]);
   }
 
   prop_info->blob_id[prop_info->blob_id_index] = blob_id;
   prop_info->blob_id_index = (++prop_info->blob_id_index) % NUM_CACHED_BLOB_ID;
   drmModeAtomicAddProperty(req, obj_id, prop_info->prop_id, blob_id);
+  ret = 0;
 
 #endif
   return ret;
 }
 
+uint32_t DRMPPManager::AcquirePPBlob(const DRMPPFeatureInfo &feature) {
+  uint32_t blob_id = 0;
+#ifdef PP_DRM_ENABLE
+  /* the same tables set again, as after idle power collapse or a DPMS cycle, reuse their blob.
+   * With a few blobs per object, comparing payloads is cheaper than hashing and cannot collide.
+   */
+  const uint8_t *payload = reinterpret_cast<const uint8_t *>(feature.payload);
+  for (auto it = pp_blobs_.begin(); it != pp_blobs_.end(); it++) {
+    if (it->valid && it->feature_id == feature.id && it->payload.size() == feature.payload_size &&
+        it->payload.size() && !memcmp(it->payload.data(), payload, feature.payload_size)) {
+      it->ref_count++;
+      pp_blobs_.splice(pp_blobs_.begin(), pp_blobs_, it);
+      return pp_blobs_.front().blob_id;
+    }
+  }
+
+  int ret = drmModeCreatePropertyBlob(fd_, feature.payload, feature.payload_size, &blob_id);
+  if (ret || blob_id == 0) {
+    DRM_LOGE("failed to create property blob ret %d, blob_id = %d", ret, blob_id);
+    return 0;
+  }
+
+  DRMPPBlob blob;
+  blob.feature_id = feature.id;
+  blob.blob_id = blob_id;
+  blob.ref_count = 1;
+  if (NUM_CACHED_PP_BLOBS) {
+    blob.payload.assign(payload, payload + feature.payload_size);
+  }
+  pp_blobs_.push_front(std::move(blob));
+#endif
+  return blob_id;
+}
+
+void DRMPPManager::ReleasePPBlob(uint32_t blob_id) {
+#ifdef PP_DRM_ENABLE
+  auto it = std::find_if(pp_blobs_.begin(), pp_blobs_.end(),
+                         [blob_id](const DRMPPBlob &blob) { return blob.blob_id == blob_id; });
+  if (it == pp_blobs_.end() || --it->ref_count) {
+    return;
+  }
+
+  /* keep the blob unless invalidated, then destroy the least recently set unreferenced ones */
+  uint32_t cached = 0;
+  for (it = pp_blobs_.begin(); it != pp_blobs_.end();) {
+    if (it->ref_count || (it->valid && ++cached <= NUM_CACHED_PP_BLOBS)) {
+      it++;
+      continue;
+    }
+    int ret = drmModeDestroyPropertyBlob(fd_, it->blob_id);
+    if (ret) {
+      DRM_LOGE("failed to destroy property blob %d for feature %d, ret = %d", it->blob_id,
+               it->feature_id, ret);
+    }
+    it = pp_blobs_.erase(it);
+  }
+#endif
+}
+
+void DRMPPManager::InvalidatePPBlobs() {
+#ifdef PP_DRM_ENABLE
+  /* blobs still set are destroyed when their slots release them */
+  for (auto it = pp_blobs_.begin(); it != pp_blobs_.end();) {
+    it->valid = false;
+    if (it->ref_count) {
+      it++;
+      continue;
+    }
+    drmModeDestroyPropertyBlob(fd_, it->blob_id);
+    it = pp_blobs_.erase(it);
+  }
+#endif
+}
+
+void DRMPPManager::PostCommit(bool success) {
+  /* a failed commit, such as with -EACCES once DRM master is lost, may have left blob IDs that
+   * the kernel rejects. Stop reusing them, and create blobs again for the next commits.
+   */
+  if (!success) {
+    InvalidatePPBlobs();
+  }
+}
+
 void DRMPPManager::SetPPEvent(uint32_t obj_id, DRMPPFeatureInfo &feature) {
 #ifdef PP_DRM_ENABLE
   int ret  = 0;
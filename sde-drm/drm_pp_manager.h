@@ -31,11 +31,15 @@
 #define __DRM_PP_MANAGER_H__
 
 #include <limits>
+#include <list>
+#include <vector>
 #include "drm_utils.h"
 #include "drm_interface.h"
 #include "drm_property.h"
 
 #define NUM_CACHED_BLOB_ID 2
+// Unreferenced PP blobs kept per object for their tables to be set again, 0 disables the cache
+#define NUM_CACHED_PP_BLOBS 4
 
 namespace sde_drm {
 
@@ -47,6 +51,16 @@ struct DRMPPPropInfo {
   uint32_t blob_id_index;
 };
 
+// A created property blob with the payload it was created from. The blob_id slots of the feature
+// hold references, and an unreferenced blob is destroyed once evicted or invalidated.
+struct DRMPPBlob {
+  uint32_t feature_id = 0;
+  uint32_t blob_id = 0;
+  uint32_t ref_count = 0;
+  bool valid = true;
+  std::vector<uint8_t> payload;
+};
+
 class DRMPPManager {
  public:
   explicit DRMPPManager(int fd);
@@ -55,6 +69,7 @@ class DRMPPManager {
   void DeInit() {}
   void GetPPInfo(DRMPPFeatureInfo *info);
   void SetPPFeature(drmModeAtomicReq *req, uint32_t obj_id, DRMPPFeatureInfo &feature);
+  void PostCommit(bool success);
 
  private:
   int SetPPBlobProperty(drmModeAtomicReq *req, uint32_t obj_id, struct DRMPPPropInfo *prop_info,
@@ -62,10 +77,14 @@ class DRMPPManager {
   int SetPPRangeProperty(drmModeAtomicReq *req, uint32_t obj_id, struct DRMPPPropInfo *prop_info,
                         DRMPPFeatureInfo &feature);
   void SetPPEvent(uint32_t obj_id, DRMPPFeatureInfo &feature);
+  uint32_t AcquirePPBlob(const DRMPPFeatureInfo &feature);
+  void ReleasePPBlob(uint32_t blob_id);
+  void InvalidatePPBlobs();
 
   int fd_ = -1;
   uint32_t object_type_ = std::numeric_limits<uint32_t>::max();
   DRMPPPropInfo pp_prop_map_[kPPFeaturesMax] = {};
+  std::list<DRMPPBlob> pp_blobs_ {};  // Most recently set first
 };
 
 }  // namespace sde_drm
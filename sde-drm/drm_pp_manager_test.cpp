@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+
+#include <set>
+#include <vector>
+
+#include "drm_pp_manager.h"
+
+// The libdrm calls DRMPPManager makes, stubbed to track which blobs are alive.
+namespace {
+
+std::set<uint32_t> alive_blobs;
+uint32_t next_blob_id = 1;
+uint32_t blob_creates = 0;
+uint64_t last_value = 0;
+
+}  // namespace
+
+int drmModeAtomicAddProperty(drmModeAtomicReqPtr, uint32_t, uint32_t, uint64_t value) {
+  EXPECT_TRUE(!value || alive_blobs.count(uint32_t(value))) << "Blob " << value << " destroyed";
+  last_value = value;
+  return 0;
+}
+
+int drmModeCreatePropertyBlob(int, const void *, size_t, uint32_t *id) {
+  *id = next_blob_id++;
+  alive_blobs.insert(*id);
+  blob_creates++;
+  return 0;
+}
+
+int drmModeDestroyPropertyBlob(int, uint32_t id) {
+  EXPECT_EQ(alive_blobs.erase(id), 1u) << "Blob " << id << " destroyed twice";
+  return 0;
+}
+
+int drmIoctl(int, unsigned long, void *) {
+  return 0;
+}
+
+namespace sde_drm {
+namespace {
+
+const uint32_t kObjId = 1;
+const uint32_t kTableWords = 1000;
+const uint32_t kTables = NUM_CACHED_PP_BLOBS + NUM_CACHED_BLOB_ID + 2;
+
+class DRMPPManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alive_blobs.clear();
+    blob_creates = 0;
+    for (uint32_t i = 0; i < kTables; i++) {
+      tables_[i].assign(kTableWords, i);
+    }
+  }
+
+  void TearDown() override {
+    mgr_.reset();
+    EXPECT_TRUE(alive_blobs.empty());
+  }
+
+  // Sets a table on a blob feature, returns the blob ID it was set with.
+  uint64_t Apply(DRMPPFeatureID id, uint32_t table) {
+    DRMPPFeatureInfo feature = {};
+    feature.id = id;
+    feature.type = kPropBlob;
+    feature.payload = tables_[table].data();
+    feature.payload_size = kTableWords * sizeof(uint32_t);
+    mgr_->SetPPFeature(req_, kObjId, feature);
+    return last_value;
+  }
+
+  std::unique_ptr<DRMPPManager> mgr_ {new DRMPPManager(3)};
+  drmModeAtomicReq *req_ = reinterpret_cast<drmModeAtomicReq *>(0x1);
+  std::vector<uint32_t> tables_[kTables];
+};
+
+TEST_F(DRMPPManagerTest, SameTablesReuseBlob) {
+  uint64_t gamut = Apply(kFeatureGamut, 0);
+  uint64_t igc = Apply(kFeatureIgc, 1);
+  EXPECT_EQ(blob_creates, 2u);
+  for (uint32_t i = 0; i < 10; i++) {
+    EXPECT_EQ(Apply(kFeatureGamut, 0), gamut);
+    EXPECT_EQ(Apply(kFeatureIgc, 1), igc);
+  }
+  EXPECT_EQ(blob_creates, 2u);
+}
+
+TEST_F(DRMPPManagerTest, SameTablesOfOtherFeatureCreateBlob) {
+  uint64_t gamut = Apply(kFeatureGamut, 0);
+  EXPECT_NE(Apply(kFeatureIgc, 0), gamut);
+  EXPECT_EQ(blob_creates, 2u);
+}
+
+TEST_F(DRMPPManagerTest, UnreferencedBlobsAreBounded) {
+  for (uint32_t i = 0; i < kTables; i++) {
+    Apply(kFeatureGamut, i);
+  }
+  EXPECT_EQ(blob_creates, kTables);
+  EXPECT_EQ(alive_blobs.size(), size_t(NUM_CACHED_BLOB_ID + NUM_CACHED_PP_BLOBS));
+
+  // The most recently set tables are still cached.
+  Apply(kFeatureGamut, kTables - 1 - NUM_CACHED_BLOB_ID);
+  EXPECT_EQ(blob_creates, kTables);
+}
+
+TEST_F(DRMPPManagerTest, FailedCommitInvalidatesBlobs) {
+  // Tables 1 and 2 are left set, table 0 only cached.
+  Apply(kFeatureGamut, 0);
+  Apply(kFeatureGamut, 1);
+  uint64_t set = Apply(kFeatureGamut, 2);
+  mgr_->PostCommit(true);
+  EXPECT_EQ(alive_blobs.size(), 3u);
+
+  mgr_->PostCommit(false);
+  EXPECT_EQ(alive_blobs.size(), size_t(NUM_CACHED_BLOB_ID));
+  EXPECT_NE(Apply(kFeatureGamut, 2), set);
+  EXPECT_EQ(blob_creates, 4u);
+}
+
+}  // namespace
+}  // namespace sde_drm
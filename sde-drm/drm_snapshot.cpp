@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <drm_logger.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <xf86drm.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "drm_snapshot.h"
+
+#define __CLASS__ "DRMSnapshot"
+
+namespace sde_drm {
+
+using std::string;
+using std::vector;
+
+static const uint32_t kSnapshotMagic = 0x53445253;  // "SRDS" in file order
+
+// Table driven CRC32, only meant to catch truncated or corrupted files. Shifts and xors only, a
+// wrapping hash would trap in the integer overflow sanitizer libsdedrm is built with.
+static uint64_t Checksum(const vector<uint8_t> &data) {
+  static const vector<uint32_t> table = [] {
+    vector<uint32_t> out(256);
+    for (uint32_t byte = 0; byte < 256; byte++) {
+      uint32_t crc = byte;
+      for (uint32_t bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320U : 0);
+      }
+      out[byte] = crc;
+    }
+    return out;
+  }();
+
+  uint32_t crc = 0xffffffffU;
+  for (uint8_t byte : data) {
+    crc = table[(crc ^ byte) & 0xff] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+void DRMSnapshotWriter::Put(const void *data, size_t size) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  payload_.insert(payload_.end(), bytes, bytes + size);
+}
+
+bool DRMSnapshotWriter::Save(const string &path, const string &fingerprint) {
+  string tmp_path = path + ".tmp";
+  FILE *file = fopen(tmp_path.c_str(), "wb");
+  if (!file) {
+    DRM_LOGI("Failed to create %s, %s", tmp_path.c_str(), strerror(errno));
+    return false;
+  }
+
+  uint32_t fingerprint_size = static_cast<uint32_t>(fingerprint.size());
+  uint64_t payload_size = payload_.size();
+  uint64_t checksum = Checksum(payload_);
+  bool written = fwrite(&kSnapshotMagic, sizeof(kSnapshotMagic), 1, file) == 1 &&
+                 fwrite(&fingerprint_size, sizeof(fingerprint_size), 1, file) == 1 &&
+                 fwrite(fingerprint.data(), 1, fingerprint.size(), file) == fingerprint.size() &&
+                 fwrite(&payload_size, sizeof(payload_size), 1, file) == 1 &&
+                 fwrite(&checksum, sizeof(checksum), 1, file) == 1 &&
+                 fwrite(payload_.data(), 1, payload_.size(), file) == payload_.size();
+  written = (fflush(file) == 0) && written;
+  fclose(file);
+
+  if (!written || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    DRM_LOGE("Failed to write %s, %s", path.c_str(), strerror(errno));
+    unlink(tmp_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool DRMSnapshotReader::Load(const string &path, const string &fingerprint) {
+  payload_.clear();
+  offset_ = 0;
+
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  uint32_t magic = 0;
+  uint32_t fingerprint_size = 0;
+  uint64_t payload_size = 0;
+  uint64_t checksum = 0;
+  bool valid = fread(&magic, sizeof(magic), 1, file) == 1 && magic == kSnapshotMagic &&
+               fread(&fingerprint_size, sizeof(fingerprint_size), 1, file) == 1 &&
+               fingerprint_size == fingerprint.size();
+  if (valid) {
+    string saved(fingerprint_size, '\0');
+    valid = fread(&saved[0], 1, saved.size(), file) == saved.size() && saved == fingerprint;
+  }
+  // A plane snapshot is a few tens of KB, anything much larger is not one of ours.
+  valid = valid && fread(&payload_size, sizeof(payload_size), 1, file) == 1 &&
+          payload_size <= (16 << 20) && fread(&checksum, sizeof(checksum), 1, file) == 1;
+  if (valid) {
+    payload_.resize(payload_size);
+    valid = fread(payload_.data(), 1, payload_.size(), file) == payload_.size() &&
+            fgetc(file) == EOF && Checksum(payload_) == checksum;
+  }
+  fclose(file);
+
+  if (!valid) {
+    DRM_LOGI("Ignoring stale snapshot %s", path.c_str());
+    payload_.clear();
+  }
+
+  return valid;
+}
+
+bool DRMSnapshotReader::Get(void *data, size_t size) {
+  if (size > payload_.size() - offset_) {
+    return false;
+  }
+
+  memcpy(data, payload_.data() + offset_, size);
+  offset_ += size;
+  return true;
+}
+
+string GetDRMSnapshotFingerprint(int fd, uint32_t format_version, const uint32_t *ids,
+                                 uint32_t count) {
+  std::ostringstream fingerprint;
+  fingerprint << "v" << format_version;
+
+  // Changes on every boot, so a snapshot never outlives the kernel it was taken on.
+  std::ifstream boot_id_file("/proc/sys/kernel/random/boot_id");
+  string boot_id;
+  std::getline(boot_id_file, boot_id);
+  if (boot_id.empty()) {
+    return "";
+  }
+  fingerprint << "|" << boot_id;
+
+  struct utsname name = {};
+  if (uname(&name) == 0) {
+    fingerprint << "|" << name.release << "|" << name.version;
+  }
+
+  drmVersionPtr version = drmGetVersion(fd);
+  if (version) {
+    fingerprint << "|" << (version->name ? version->name : "") << "|" << version->version_major
+                << "." << version->version_minor << "." << version->version_patchlevel << "|"
+                << (version->date ? version->date : "");
+    drmFreeVersion(version);
+  }
+
+  fingerprint << "|";
+  for (uint32_t i = 0; i < count; i++) {
+    fingerprint << ids[i] << ",";
+  }
+
+  return fingerprint.str();
+}
+
+}  // namespace sde_drm
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __DRM_SNAPSHOT_H__
+#define __DRM_SNAPSHOT_H__
+
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sde_drm {
+
+// Parsed DRM objects saved across restarts of the service. A snapshot is only loaded back when
+// its fingerprint matches the running kernel, driver and boot, anything else is a miss and the
+// caller parses the objects from the driver again.
+class DRMSnapshotWriter {
+ public:
+  void Put(const void *data, size_t size);
+  template <typename T>
+  void Put(const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Not a plain value");
+    Put(&value, sizeof(value));
+  }
+
+  // Write to a temporary file first so a crash never leaves a partial snapshot behind.
+  bool Save(const std::string &path, const std::string &fingerprint);
+
+ private:
+  std::vector<uint8_t> payload_ {};
+};
+
+class DRMSnapshotReader {
+ public:
+  bool Load(const std::string &path, const std::string &fingerprint);
+  bool Get(void *data, size_t size);
+  template <typename T>
+  bool Get(T *value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Not a plain value");
+    return Get(value, sizeof(*value));
+  }
+  bool AtEnd() const { return offset_ == payload_.size(); }
+
+ private:
+  std::vector<uint8_t> payload_ {};
+  size_t offset_ = 0;
+};
+
+// Identifies the boot, kernel and driver the objects were parsed on, along with the object ids
+// they were parsed for. format_version is bumped by the caller whenever its layout changes.
+// Empty when the boot can not be identified, snapshots must not be used then.
+std::string GetDRMSnapshotFingerprint(int fd, uint32_t format_version, const uint32_t *ids,
+                                      uint32_t count);
+
+}  // namespace sde_drm
+
+#endif  // __DRM_SNAPSHOT_H__
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "drm_snapshot.h"
+
+namespace sde_drm {
+namespace {
+
+const char *kFingerprint = "v1|boot|kernel|1,2,3,";
+
+struct PlaneEntry {
+  uint32_t id;
+  uint32_t type;
+  uint64_t formats;
+};
+
+class DRMSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = ::testing::TempDir() + "drm_snapshot_test.snapshot";
+    unlink(path_.c_str());
+  }
+
+  void TearDown() override { unlink(path_.c_str()); }
+
+  // Saves a few planes and a large table, as DRMPlaneManager does.
+  bool SavePlanes() {
+    DRMSnapshotWriter writer;
+    writer.Put(uint32_t(3));
+    for (uint32_t i = 0; i < 3; i++) {
+      writer.Put(PlaneEntry{i + 1, i % 2, 0x1234567890abcdefULL >> i});
+    }
+    writer.Put(table_.data(), table_.size());
+    return writer.Save(path_, kFingerprint);
+  }
+
+  // Overwrites one byte of the saved file, at offset from the end.
+  void CorruptByte(long offset) {
+    FILE *file = fopen(path_.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    fseek(file, -offset, SEEK_END);
+    int byte = fgetc(file);
+    fseek(file, -offset, SEEK_END);
+    fputc(byte ^ 0x5a, file);
+    fclose(file);
+  }
+
+  std::string path_;
+  std::vector<uint8_t> table_ = std::vector<uint8_t>(64 << 10, 0xa5);
+};
+
+TEST_F(DRMSnapshotTest, SavedPlanesLoadBack) {
+  ASSERT_TRUE(SavePlanes());
+
+  DRMSnapshotReader reader;
+  ASSERT_TRUE(reader.Load(path_, kFingerprint));
+  uint32_t count = 0;
+  ASSERT_TRUE(reader.Get(&count));
+  ASSERT_EQ(count, 3u);
+  for (uint32_t i = 0; i < count; i++) {
+    PlaneEntry entry = {};
+    ASSERT_TRUE(reader.Get(&entry));
+    EXPECT_EQ(entry.id, i + 1);
+    EXPECT_EQ(entry.type, i % 2);
+    EXPECT_EQ(entry.formats, 0x1234567890abcdefULL >> i);
+  }
+  std::vector<uint8_t> table(table_.size());
+  ASSERT_TRUE(reader.Get(table.data(), table.size()));
+  EXPECT_EQ(table, table_);
+  EXPECT_TRUE(reader.AtEnd());
+  EXPECT_FALSE(reader.Get(&count));
+}
+
+TEST_F(DRMSnapshotTest, OtherFingerprintMisses) {
+  ASSERT_TRUE(SavePlanes());
+  DRMSnapshotReader reader;
+  EXPECT_FALSE(reader.Load(path_, "v1|other boot|kernel|1,2,3,"));
+  EXPECT_TRUE(reader.AtEnd());
+}
+
+TEST_F(DRMSnapshotTest, CorruptedPayloadMisses) {
+  ASSERT_TRUE(SavePlanes());
+  CorruptByte(100);
+  DRMSnapshotReader reader;
+  EXPECT_FALSE(reader.Load(path_, kFingerprint));
+}
+
+TEST_F(DRMSnapshotTest, TruncatedFileMisses) {
+  ASSERT_TRUE(SavePlanes());
+  FILE *file = fopen(path_.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fclose(file);
+  ASSERT_EQ(truncate(path_.c_str(), size - 1), 0);
+
+  DRMSnapshotReader reader;
+  EXPECT_FALSE(reader.Load(path_, kFingerprint));
+}
+
+TEST_F(DRMSnapshotTest, MissingFileMisses) {
+  DRMSnapshotReader reader;
+  EXPECT_FALSE(reader.Load(path_, kFingerprint));
+}
+
+}  // namespace
+}  // namespace sde_drm
@@ -88,6 +88,18 @@ class BufferSyncHandler {
  */
   virtual void GetSyncInfo(int fd, std::ostringstream *os) = 0;
 
+  /*! @brief Method to get the time at which the fence of given file descriptor signaled
+
+    @details This method returns the CLOCK_MONOTONIC time in nanoseconds at which the last of the
+    fences in the sync file signaled. It fails if any of them is still pending.
+
+    @param[in] fd file descriptor
+    @param[out] timestamp_ns signal time
+
+    @return \link int \endlink
+ */
+  virtual int GetSignalTime(int fd, int64_t *timestamp_ns) = 0;
+
  protected:
   virtual ~BufferSyncHandler() { }
 };
@@ -383,6 +383,18 @@ struct PanelFeatureInfo {
   uint32_t fps = 0;
 };
 
+/*! @brief This struct stores the vsync timing predicted from the recent vsync history
+
+  @sa DisplayInterface::GetVSyncPrediction
+*/
+struct VSyncPrediction {
+  int64_t period_ns = 0;              //!< Measured period, nominal one until measured
+  bool fitted = false;                //!< Period and phase fitted to the vsync history
+  int64_t present_latency_ns = 0;     //!< Time from commit to present, 0 until measured
+  int64_t expected_present_ns = 0;    //!< Present time of a frame committed at the given time
+  std::vector<int64_t> vsyncs_ns {};  //!< Next vsyncs after the given time
+};
+
 /*! @brief Display device event handler implemented by the client.
 
   @details This class declares prototype for display device event handler methods which must be
@@ -1370,6 +1382,21 @@ class DisplayInterface {
   virtual DisplayError PanelOprInfo(const std::string &client_name, bool enable,
                                     SdmDisplayCbInterface<PanelOprPayload> *cb_intf) = 0;
 
+  /*! @brief Method to predict the vsync timing of the display.
+
+   @details Predicts the next vsyncs after the given CLOCK_MONOTONIC time from the period and
+   phase fitted to the recent vsyncs, and the present time of a frame committed at that time from
+   the measured commit latency.
+
+   @param[in] timestamp_ns : time to predict from
+   @param[in] count : number of vsyncs to predict
+   @param[out] prediction : \link VSyncPrediction \endlink
+
+   @return \link DisplayError \endlink
+  */
+  virtual DisplayError GetVSyncPrediction(int64_t timestamp_ns, uint32_t count,
+                                          VSyncPrediction *prediction) = 0;
+
  protected:
   virtual ~DisplayInterface() { }
 };
@@ -656,6 +656,15 @@ class PPFeaturesConfig {
     return feature;
   }
 
+  // Takes the feature off the list without destroying it, the caller owns it then.
+  inline PPFeatureInfo* ReleaseFeature(uint32_t feature_id) {
+    PPFeatureInfo* feature = GetFeature(feature_id);
+    if (feature) {
+      feature_[feature_id] = NULL;
+    }
+    return feature;
+  }
+
   inline Locker &GetLocker(void) { return locker_; }
   inline PPFrameCaptureData *GetFrameCaptureData(void) { return &frame_capture_data; }
   inline PPDETuningCfgData *GetDETuningCfgData(void) { return &de_tuning_data_; }
@@ -55,6 +55,7 @@ using std::vector;
 
 const int kMaxSDELayers = 16;   // Maximum number of layers that can be handled by MDP5 hardware
                                 // in a given layer stack.
+const uint32_t kMaxFrameROIs = 4;  // Maximum number of partial update ROIs the driver takes.
 #define MAX_PLANES 4
 #define MAX_DETAIL_ENHANCE_CURVE 3
 #define MAJOR 28
@@ -262,6 +263,46 @@ enum HWPowerState {
 };
 
 typedef std::map<HWSubBlockType, std::vector<LayerBufferFormat>> FormatsMap;
+
+// Set of formats with constant time lookup. LayerBufferFormat values come in groups starting at
+// multiples of 0x100 with fewer than 64 formats each, so every format maps to one bit.
+class FormatSet {
+ public:
+  bool Insert(LayerBufferFormat format) {
+    size_t bit = 0;
+    if (!GetBit(format, &bit) || bits_.test(bit)) {
+      return false;
+    }
+    bits_.set(bit);
+    return true;
+  }
+
+  bool Contains(LayerBufferFormat format) const {
+    size_t bit = 0;
+    return GetBit(format, &bit) && bits_.test(bit);
+  }
+
+  bool Empty() const { return bits_.none(); }
+  size_t Count() const { return bits_.count(); }
+
+ private:
+  static const size_t kGroupCount = 8;
+  static const size_t kGroupSize = 64;
+
+  static bool GetBit(LayerBufferFormat format, size_t *bit) {
+    uint32_t group = static_cast<uint32_t>(format) >> 8;
+    uint32_t index = static_cast<uint32_t>(format) & 0xff;
+    if (group >= kGroupCount || index >= kGroupSize) {
+      return false;
+    }
+    *bit = group * kGroupSize + index;
+    return true;
+  }
+
+  std::bitset<kGroupCount * kGroupSize> bits_;
+};
+
+typedef std::map<HWSubBlockType, FormatSet> FormatSetMap;
 typedef std::map<LayerBufferFormat, float> CompRatioMap;
 
 // Base Postprocessing features information.
@@ -412,6 +453,7 @@ struct HWResourceInfo {
   HWDynBwLimitInfo dyn_bw_info;
   std::vector<HWPipeCaps> hw_pipes;
   FormatsMap supported_formats_map;
+  FormatSetMap supported_format_sets;  // supported_formats_map for lookups
   HWRotatorInfo hw_rot_info;
   HWDestScalarInfo hw_dest_scalar_info;
   bool has_hdr = false;
@@ -977,6 +1019,8 @@ struct HWLayersInfo {
   HWDNSCInfo demura_dnsc_cfg = {};
   SelfRefreshState self_refresh_state = kSelfRefreshNone;
   uint64_t expected_present_time = 0;
+  uint64_t present_latency_ns = 0;  // Measured time from commit to present, 0 until measured
+  uint64_t commit_time_ns = 0;      // CLOCK_MONOTONIC time the atomic commit was issued
 };
 
 struct DispLayerStack {
@@ -144,6 +144,11 @@ class HWInterface {
   virtual DisplayError Flush(HWLayersInfo *hw_layers_info) = 0;
   virtual DisplayError GetPPFeaturesVersion(PPFeatureVersion *vers) = 0;
   virtual DisplayError SetPPFeature(PPFeatureInfo *feature) = 0;
+  // PP features set after a non zero cache key are kept converted under it, until the next key.
+  virtual DisplayError SetPPFeatureCacheKey(uint64_t cache_key) = 0;
+  // Looks up the PP features kept under the key, feature_mask has a bit per PPGlobalColorFeatureID.
+  virtual DisplayError GetCachedPPFeatures(uint64_t cache_key, uint32_t *feature_mask) = 0;
+  virtual DisplayError SetCachedPPFeatures(uint64_t cache_key) = 0;
   virtual DisplayError SetVSyncState(bool enable) = 0;
   virtual void SetIdleTimeoutMs(uint32_t timeout_ms) = 0;
   virtual DisplayError SetDisplayMode(const HWDisplayMode hw_display_mode) = 0;
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CACHE_KEY_H__
+#define __CACHE_KEY_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <string>
+#include <type_traits>
+
+namespace sdm {
+
+// Table driven CRC-64 (ECMA-182) of the inputs a cached value is computed from, to look it up in
+// an LruCache. Shifts and xors only, a wrapping hash would trap in the integer overflow sanitizer
+// the display libraries are built with. Strings are hashed with their terminator so that
+// neighbouring strings cannot run into each other. Never 0, which is left to stand for no key.
+class CacheKey {
+ public:
+  template <typename T>
+  CacheKey &Add(const T &value) {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "Only scalars are hashed by value, structs may hold padding");
+    return AddBytes(&value, sizeof(value));
+  }
+
+  CacheKey &Add(const std::string &value) { return AddBytes(value.c_str(), value.size() + 1); }
+
+  uint64_t Get() const { return ~crc_ ? ~crc_ : 1; }
+
+ private:
+  static const std::array<uint64_t, 256> &Table() {
+    static const std::array<uint64_t, 256> table = [] {
+      std::array<uint64_t, 256> out;
+      for (uint32_t byte = 0; byte < 256; byte++) {
+        uint64_t crc = byte;
+        for (uint32_t bit = 0; bit < 8; bit++) {
+          crc = (crc >> 1) ^ ((crc & 1) ? 0xc96c5795d7870f42ULL : 0);
+        }
+        out[byte] = crc;
+      }
+      return out;
+    }();
+    return table;
+  }
+
+  CacheKey &AddBytes(const void *data, size_t length) {
+    const std::array<uint64_t, 256> &table = Table();
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < length; i++) {
+      crc_ = table[(crc_ ^ bytes[i]) & 0xff] ^ (crc_ >> 8);
+    }
+    return *this;
+  }
+
+  uint64_t crc_ = ~0ULL;
+};
+
+}  // namespace sdm
+
+#endif  // __CACHE_KEY_H__
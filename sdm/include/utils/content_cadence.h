@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CONTENT_CADENCE_H__
+#define __CONTENT_CADENCE_H__
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace sdm {
+
+// Estimates the rate at which the content of a layer changes from the times its new buffers are
+// presented. Presents land on vsync, so a 24 fps video on a 60 Hz panel shows up as alternating
+// intervals of two and three vsyncs. The estimate is the mean interval over a window with dropped
+// and doubled frames left out, and is only taken when both halves of the window agree.
+class CadenceDetector {
+ public:
+  void AddPresent(uint64_t timestamp_ns);
+  void Reset();
+  // Content rate in fps, 0 until a steady cadence has been confirmed.
+  uint32_t GetRate() const { return rate_; }
+  uint64_t GetLastPresent() const { return last_present_ns_; }
+
+ private:
+  static const uint32_t kWindow = 16;
+
+  uint32_t Estimate() const;
+
+  uint64_t intervals_[kWindow] = {};
+  uint32_t interval_count_ = 0;  // Newest interval is at (interval_count_ - 1) % kWindow
+  uint64_t last_present_ns_ = 0;
+  uint32_t candidate_ = 0;
+  uint32_t candidate_frames_ = 0;
+  uint32_t rate_ = 0;
+};
+
+struct LayerPresent {
+  uint64_t layer_id = 0;
+  bool updating = false;
+};
+
+// Follows the cadence of every layer in a stack by layer id.
+class ContentCadenceTracker {
+ public:
+  // Records one frame and drops layers that left the stack. Returns the highest content rate of
+  // the layers updating recently, or 0 when one of them has no steady cadence.
+  uint32_t Update(const std::vector<LayerPresent> &layers, uint64_t timestamp_ns);
+  void Reset() { detectors_.clear(); }
+
+ private:
+  std::unordered_map<uint64_t, CadenceDetector> detectors_;
+  std::vector<uint64_t> stale_ids_;
+};
+
+}  // namespace sdm
+
+#endif  // __CONTENT_CADENCE_H__
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __CPU_BLIT_H__
+#define __CPU_BLIT_H__
+
+#include <stdint.h>
+#include <core/layer_buffer.h>
+#include <core/sdm_types.h>
+#include <utils/constants.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sdm {
+
+enum CpuBlitFormat {
+  kCpuBlitRGBA8888,     // R, G, B, A bytes
+  kCpuBlitRGBX8888,     // R, G, B, X bytes, read as opaque
+  kCpuBlitBGRA8888,     // B, G, R, A bytes
+  kCpuBlitRGBA1010102,  // 32 bit words, R in bits 0-9, A in bits 30-31
+  kCpuBlitNV12,         // 8 bit Y plane, interleaved CbCr plane subsampled 2x2
+  kCpuBlitP010,         // NV12 layout with 16 bit samples, 10 bit value in the MSBs
+};
+
+enum CpuBlitMatrix {
+  kCpuBlitBT601,
+  kCpuBlitBT709,
+  kCpuBlitBT2020,
+};
+
+struct CpuBlitPlane {
+  uint8_t *base = nullptr;
+  uint32_t stride = 0;  // In bytes
+};
+
+// A CPU mapped image. RGB formats use planes[0] only.
+struct CpuBlitImage {
+  CpuBlitFormat format = kCpuBlitRGBA8888;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  CpuBlitPlane planes[2] = {};
+};
+
+// CPU implementation of the GLColorConvert and GLLayerStitch operations, and of the buffer copies
+// of the readback paths. Sources are sampled bilinearly at texel centres like a GL_LINEAR sampler
+// with a 1:1 fast path, and the rows of the destination are split between the calling thread and
+// a pool of worker threads.
+class CpuBlitter {
+ public:
+  // thread_count includes the calling thread, 0 picks one per online CPU.
+  explicit CpuBlitter(uint32_t thread_count);
+  ~CpuBlitter();
+
+  // Process wide pool of at most kMaxSharedThreads threads, for the composer fallbacks. Jobs of
+  // different callers run one after the other.
+  static CpuBlitter &GetShared();
+  static const uint32_t kMaxSharedThreads = 4;
+
+  // Converts src_rect of an RGB image into dst_rect of an NV12 or P010 image. An invalid
+  // src_rect samples the whole source, dst_rect is expanded to even coordinates.
+  DisplayError ConvertToYUV(const CpuBlitImage &src, const LayerRect &src_rect,
+                            const CpuBlitImage &dst, const LayerRect &dst_rect,
+                            CpuBlitMatrix matrix, bool full_range);
+
+  // Copies src_rect of an RGB image into dst_rect of another one, without blending. When the
+  // scissor is valid it is cleared to transparent black first and the copy is clipped to it.
+  DisplayError Stitch(const CpuBlitImage &src, const LayerRect &src_rect, const CpuBlitImage &dst,
+                      const LayerRect &dst_rect, const LayerRect &scissor);
+
+  // Copies an image into another one of the same size, with independent strides. RGB formats
+  // convert between each other and NV12 converts to and from P010, rounding to the nearest code.
+  DisplayError Copy(const CpuBlitImage &src, const CpuBlitImage &dst);
+
+  // Zeroes size bytes at base.
+  void Clear(void *base, size_t size);
+
+  // Calls func(first, last) on ranges of at most grain items until [0, count) is covered, on the
+  // calling thread and the pool. Returns when all ranges are done.
+  void ParallelFor(uint32_t count, uint32_t grain,
+                   const std::function<void(uint32_t, uint32_t)> &func);
+
+  uint32_t GetThreadCount() const { return UINT32(workers_.size() + 1); }
+
+ private:
+  void Worker();
+  void RunRanges();
+
+  // Current job, only valid during ParallelFor()
+  const std::function<void(uint32_t, uint32_t)> *func_ = nullptr;
+  uint32_t count_ = 0;
+  uint32_t grain_ = 1;
+  std::atomic<uint32_t> next_ = {0};
+  size_t active_workers_ = 0;
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::mutex job_mutex_;
+  std::condition_variable job_cv_;
+  std::condition_variable done_cv_;
+  uint64_t job_id_ = 0;
+  bool exit_ = false;
+};
+
+}  // namespace sdm
+
+#endif  // __CPU_BLIT_H__
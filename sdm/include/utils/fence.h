@@ -90,6 +90,9 @@ class Fence {
 
   static string GetStr(const shared_ptr<Fence> &fence);
 
+  // CLOCK_MONOTONIC time at which the fence signaled, fails while it is pending.
+  static int GetSignalTime(const shared_ptr<Fence> &fence, int64_t *timestamp_ns);
+
   // Write all fences info to the output stream.
   static void Dump(std::ostringstream *os);
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __LRU_CACHE_H__
+#define __LRU_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace sdm {
+
+// Least recently used cache of values given by 64 bit key, each with the number of bytes it holds.
+// The least recently used values are dropped to stay within the memory budget, a value larger than
+// the whole budget is not kept. Not thread safe.
+template <typename Value>
+class LruCache {
+ public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+    size_t count = 0;
+  };
+
+  explicit LruCache(size_t budget_bytes = 0) : budget_bytes_(budget_bytes) {}
+
+  void SetBudget(size_t budget_bytes) {
+    budget_bytes_ = budget_bytes;
+    Trim(0);
+  }
+
+  // Returns the value of the key, made the most recently used, nullptr if absent. Counted as a hit
+  // or a miss.
+  Value *Find(uint64_t key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      stats_.misses++;
+      return nullptr;
+    }
+
+    stats_.hits++;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->value;
+  }
+
+  // Returns the value of the key without counting the lookup or changing its use.
+  Value *Peek(uint64_t key) {
+    auto it = index_.find(key);
+    return (it == index_.end()) ? nullptr : &it->second->value;
+  }
+
+  // Replaces any value of the key. Returns the value kept, nullptr if it does not fit.
+  Value *Insert(uint64_t key, Value &&value, size_t bytes) {
+    Erase(key);
+    if (bytes > budget_bytes_) {
+      return nullptr;
+    }
+
+    Trim(bytes);
+    entries_.push_front(Entry{key, bytes, std::move(value)});
+    index_[key] = entries_.begin();
+    stats_.bytes += bytes;
+    stats_.count++;
+    return &entries_.front().value;
+  }
+
+  void Erase(uint64_t key) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      Remove(it->second);
+    }
+  }
+
+  void Clear() {
+    entries_.clear();
+    index_.clear();
+    stats_.bytes = 0;
+    stats_.count = 0;
+  }
+
+  const Stats &GetStats() const { return stats_; }
+
+  // Percentage of lookups found, 0 before the first one.
+  uint32_t GetHitRate() const {
+    uint64_t lookups = stats_.hits + stats_.misses;
+    return lookups ? uint32_t(stats_.hits * 100 / lookups) : 0;
+  }
+
+ private:
+  struct Entry {
+    uint64_t key;
+    size_t bytes;
+    Value value;
+  };
+
+  typedef typename std::list<Entry>::iterator EntryIterator;
+
+  void Remove(EntryIterator entry) {
+    stats_.bytes -= entry->bytes;
+    stats_.count--;
+    index_.erase(entry->key);
+    entries_.erase(entry);
+  }
+
+  // Drops the least recently used values until bytes more fit in the budget.
+  void Trim(size_t bytes) {
+    while (!entries_.empty() && stats_.bytes + bytes > budget_bytes_) {
+      Remove(std::prev(entries_.end()));
+      stats_.evictions++;
+    }
+  }
+
+  size_t budget_bytes_ = 0;
+  std::list<Entry> entries_;  // Most recently used first
+  std::unordered_map<uint64_t, EntryIterator> index_;
+  Stats stats_;
+};
+
+}  // namespace sdm
+
+#endif  // __LRU_CACHE_H__
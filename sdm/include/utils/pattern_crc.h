@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __PATTERN_CRC_H__
+#define __PATTERN_CRC_H__
+
+#include <core/layer_buffer.h>
+#include <stdint.h>
+#include <array>
+
+namespace sdm {
+
+// Table driven CRC16 of a display test pattern, one 16 bit word per color component. A step
+// computes crc' = F(crc ^ word) with F linear, so F^n is kept as two byte indexed tables and
+// Update() folds four words per iteration.
+class PatternCRC16 {
+ public:
+  static const uint32_t kSlice = 4;
+
+  // Linear map F^n applied to a CRC state, split into low and high byte lookups. Rows that repeat
+  // fold into a running CRC as Shift(width).Apply(crc) ^ Update(0, row).
+  class Shift {
+   public:
+    Shift() = default;
+    explicit Shift(uint32_t steps);
+    uint16_t Apply(uint16_t x) const { return lo_[x & 0xFF] ^ hi_[x >> 8]; }
+    void Build(const uint16_t basis[16]);
+
+   private:
+    std::array<uint16_t, 256> lo_ = {};
+    std::array<uint16_t, 256> hi_ = {};
+  };
+
+  static uint16_t Update(uint16_t crc, const uint16_t *words, uint32_t count);
+
+ private:
+  static const std::array<Shift, kSlice> &Tables();
+};
+
+// Packs one row of pattern components into an RGBA8888, RGB888 or RGBA1010102 buffer with zero
+// alpha. Returns false for other formats.
+bool PackPatternRow(LayerBufferFormat format, const uint32_t *red, const uint32_t *green,
+                    const uint32_t *blue, uint32_t width, uint8_t *buffer);
+
+}  // namespace sdm
+
+#endif  // __PATTERN_CRC_H__
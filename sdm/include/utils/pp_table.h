@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __PP_TABLE_H__
+#define __PP_TABLE_H__
+
+#include <stdint.h>
+
+namespace sdm {
+
+// Writes first[i] and second[i] to dst[2i] and dst[2i + 1], as the DRM UAPI lays out tables of
+// entry pairs. Four entries are done at a time in NEON registers on arm64, whatever the count, so
+// runtime lengths are vectorized without relying on the compiler. The tables need no alignment
+// but may not overlap.
+void InterleavePPTables(const uint32_t *first, const uint32_t *second, uint32_t count,
+                        uint32_t *dst);
+
+}  // namespace sdm
+
+#endif  // __PP_TABLE_H__
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __REFRESH_RATE_ARBITER_H__
+#define __REFRESH_RATE_ARBITER_H__
+
+#include <stdint.h>
+
+namespace sdm {
+
+struct RefreshRateInputs {
+  uint32_t min_rate = 0;
+  uint32_t max_rate = 0;
+  uint32_t default_rate = 0;   // Rate of the active mode, used without any other input
+  uint32_t forced_rate = 0;    // Rate forced by the client
+  uint32_t metadata_rate = 0;  // Rate from layer metadata, already within range
+  uint32_t content_rate = 0;   // Rate detected from the content cadence
+  bool idle = false;           // Idle timeout expired with nothing updating
+  bool qsync = false;          // Panel follows the content by itself, content_rate is unused
+};
+
+// Picks the panel refresh rate from all inputs, in order of precedence: forced, idle, metadata,
+// content cadence and the default. Raising the rate takes effect at once. Lowering it for the
+// content cadence only does once the lower rate has been asked for over a hold time, so short
+// bursts of video or animation do not switch the panel back and forth.
+class RefreshRateArbiter {
+ public:
+  uint32_t Select(const RefreshRateInputs &inputs, uint64_t timestamp_ns);
+  // Rate last selected, which the panel runs at. Changes made elsewhere are reported here.
+  void SetCurrentRate(uint32_t rate) { current_rate_ = rate; }
+  uint32_t GetSwitchCount() const { return switch_count_; }
+
+  // Smallest multiple of rate within range, so every frame is shown for the same number of vsyncs.
+  static uint32_t GetMultipleInRange(uint32_t rate, uint32_t min_rate, uint32_t max_rate);
+
+ private:
+  static const uint64_t kLowerHoldNs = 500000000;
+
+  uint32_t current_rate_ = 0;
+  uint32_t pending_rate_ = 0;
+  uint64_t pending_since_ns_ = 0;
+  uint32_t switch_count_ = 0;
+};
+
+}  // namespace sdm
+
+#endif  // __REFRESH_RATE_ARBITER_H__
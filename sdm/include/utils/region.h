@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __REGION_H__
+#define __REGION_H__
+
+#include <core/layer_stack.h>
+#include <stdint.h>
+#include <vector>
+
+namespace sdm {
+
+// Set of pixels kept as bands of rows, each band a sorted list of disjoint spans. Bands are sorted
+// from top to bottom, never overlap and neighbours with the same spans are joined, so every set of
+// pixels has exactly one representation. LayerRects are rounded out to whole pixels.
+class Region {
+ public:
+  Region() = default;
+  explicit Region(const LayerRect &rect);
+  // Union of all rects, in one pass rather than one union per rect.
+  explicit Region(const std::vector<LayerRect> &rects);
+
+  Region Union(const Region &other) const;
+  Region Intersect(const Region &other) const;
+  Region Subtract(const Region &other) const;
+
+  bool IsEmpty() const { return bands_.empty(); }
+  uint64_t Area() const;
+  LayerRect Bounds() const;
+  bool Contains(const LayerRect &rect) const;
+  // One rect per span, top to bottom and left to right within a band.
+  std::vector<LayerRect> GetRects() const;
+
+  bool operator==(const Region &other) const {
+    return bands_ == other.bands_ && spans_ == other.spans_;
+  }
+  bool operator!=(const Region &other) const { return !(*this == other); }
+
+ private:
+  struct Band {
+    int32_t top;
+    int32_t bottom;
+    uint32_t first_span;  // Index of the first span edge in spans_
+    uint32_t span_count;
+
+    bool operator==(const Band &other) const {
+      return top == other.top && bottom == other.bottom && first_span == other.first_span &&
+             span_count == other.span_count;
+    }
+  };
+
+  enum Op {
+    kOpUnion,
+    kOpIntersect,
+    kOpSubtract,
+  };
+
+  Region Combine(const Region &other, Op op) const;
+  void AddBand(int32_t top, int32_t bottom, const int32_t *spans, uint32_t span_count);
+
+  std::vector<Band> bands_;
+  // Span edges, left and right of each span in turn
+  std::vector<int32_t> spans_;
+};
+
+}  // namespace sdm
+
+#endif  // __REGION_H__
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __ROI_CLUSTER_H__
+#define __ROI_CLUSTER_H__
+
+#include <core/layer_stack.h>
+#include <stdint.h>
+#include <vector>
+
+namespace sdm {
+
+// Panel rules for partial update ROIs, along with the cost of sending one more ROI. The cost is
+// in pixels: each ROI is a separate panel write with its own column and page address commands,
+// which takes about as long as transferring that many pixels. Two ROIs are merged whenever the
+// pixels the merge adds cost less than the ROI it saves.
+struct RoiClusterConfig {
+  uint32_t max_rois = 1;
+  uint32_t left_align = 1;
+  uint32_t width_align = 1;
+  uint32_t top_align = 1;
+  uint32_t height_align = 1;
+  uint32_t min_width = 1;
+  uint32_t min_height = 1;
+  uint32_t roi_overhead = 0;
+};
+
+// Group dirty regions into at most max_rois aligned ROIs within bounds. ROIs are written to the
+// panel as separate bands of rows, so the ROIs returned never share a row and are sorted from top
+// to bottom. Leaves rois empty when no dirty region falls within bounds.
+void ClusterDirtyRegions(const std::vector<LayerRect> &dirty_regions, const LayerRect &bounds,
+                         const RoiClusterConfig &config, std::vector<LayerRect> *rois);
+
+// Pixels plus per ROI overhead of updating rois, as used to decide on merges.
+uint64_t GetRoiCost(const std::vector<LayerRect> &rois, const RoiClusterConfig &config);
+
+}  // namespace sdm
+
+#endif  // __ROI_CLUSTER_H__
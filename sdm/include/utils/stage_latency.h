@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __STAGE_LATENCY_H__
+#define __STAGE_LATENCY_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <sstream>
+
+namespace sdm {
+
+enum LatencyStage {
+  kStageBuildLayerStack,  // HWCDisplay::BuildLayerStack
+  kStagePrepare,          // CompManager::Prepare
+  kStageValidate,         // HWDeviceDRM::Validate
+  kStageSetupAtomic,      // HWDeviceDRM::SetupAtomic
+  kStageAtomicCommit,     // drmModeAtomicCommit
+  kStagePostCommit,       // DisplayBase::PostCommit
+  kStageMax,
+};
+
+// Per display latency distribution of the composition stages. Record() only appends to a ring
+// owned by the calling thread; rings are folded into log-linear (HDR) histograms, precise to 1/64
+// of the value, when they fill up or when the statistics are dumped. The histograms of a display
+// are allocated by AddDisplay(), so folding never allocates on the composition thread. Samples of
+// displays that were not added are counted as dropped.
+class StageLatency {
+ public:
+  static void AddDisplay(int32_t display_id);
+  static void Record(int32_t display_id, LatencyStage stage, uint64_t start_ns, uint64_t end_ns);
+  static uint64_t Now();
+
+  static void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Write count, p50, p90, p99, p99.9 and max per display and stage, in microseconds.
+  static void Dump(std::ostringstream *os);
+  // Clears the statistics, added displays stay registered.
+  static void Reset();
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+class ScopedStageLatency {
+ public:
+  ScopedStageLatency(int32_t display_id, LatencyStage stage)
+    : display_id_(display_id), stage_(stage),
+      start_ns_(StageLatency::IsEnabled() ? StageLatency::Now() : 0) { }
+
+  ~ScopedStageLatency() {
+    if (start_ns_) {
+      StageLatency::Record(display_id_, stage_, start_ns_, StageLatency::Now());
+    }
+  }
+
+ private:
+  int32_t display_id_;
+  LatencyStage stage_;
+  uint64_t start_ns_;
+};
+
+}  // namespace sdm
+
+#endif  // __STAGE_LATENCY_H__
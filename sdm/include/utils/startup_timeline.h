@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __STARTUP_TIMELINE_H__
+#define __STARTUP_TIMELINE_H__
+
+#include <stdint.h>
+#include <sstream>
+#include <string>
+
+namespace sdm {
+
+// Timeline of the service start, from the first recorded stage to the first committed frame.
+// Stages can be recorded from any thread, times are taken from CLOCK_BOOTTIME so the breakdown
+// also shows how long after boot each stage ran. Finish() logs the breakdown once, stages
+// recorded after it are dropped.
+class StartupTimeline {
+ public:
+  static void Record(const std::string &stage, uint64_t start_ns, uint64_t end_ns);
+  static void Finish(const char *event);
+  static bool IsFinished();
+  static uint64_t Now();
+
+  // Write the stages in start order, with the thread they ran on.
+  static void Dump(std::ostringstream *os);
+};
+
+class ScopedStartupStage {
+ public:
+  explicit ScopedStartupStage(const std::string &stage)
+    : stage_(StartupTimeline::IsFinished() ? "" : stage), start_ns_(StartupTimeline::Now()) { }
+
+  ~ScopedStartupStage() {
+    if (!stage_.empty()) {
+      StartupTimeline::Record(stage_, start_ns_, StartupTimeline::Now());
+    }
+  }
+
+ private:
+  std::string stage_;
+  uint64_t start_ns_;
+};
+
+}  // namespace sdm
+
+#endif  // __STARTUP_TIMELINE_H__
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace sdm {
+
+// Source of CLOCK_MONOTONIC time in nanoseconds, replaced in tests to drive the timers.
+class TimerClock {
+ public:
+  virtual ~TimerClock() {}
+  virtual uint64_t GetTimeNs() = 0;
+};
+
+typedef std::function<void()> TimerCallback;
+
+// Hierarchical timing wheel of 1 ms ticks, with 64 slots on each of its 4 levels. Arming and
+// canceling a timer take constant time. Arming a pending timer for later only records the new
+// deadline, the timer is moved once its old slot comes due, so timers re-armed on every commit
+// cost neither list operations nor system calls. With CreateFd(), a timerfd is kept programmed
+// for the next slot due, and Advance() is to be called whenever it is readable. Callbacks run
+// from Advance() without the wheel lock held and may arm timers.
+class TimerWheel {
+ public:
+  // Uses CLOCK_MONOTONIC without a clock.
+  explicit TimerWheel(TimerClock *clock = nullptr);
+  ~TimerWheel();
+
+  // Creates the timerfd to poll, only for CLOCK_MONOTONIC.
+  int CreateFd();
+  int GetFd() const { return fd_; }
+
+  // Callback may be empty for a timer that is only queried.
+  uint32_t Create(const TimerCallback &callback);
+  void Arm(uint32_t id, uint32_t timeout_ms);
+  void Cancel(uint32_t id);
+  bool IsPending(uint32_t id);
+  // True once the timeout has passed, until the timer is armed or canceled again.
+  bool HasExpired(uint32_t id);
+  // Runs the callbacks of the timers due by now and returns their count.
+  uint32_t Advance();
+  // Time at which Advance() is next needed, 0 without pending timers.
+  uint64_t GetNextExpiry();
+
+ private:
+  static const uint32_t kSlotBits = 6;
+  static const uint32_t kSlots = 1 << kSlotBits;
+  static const uint32_t kLevels = 4;
+  static const uint64_t kTickNs = 1000000;
+  static const int32_t kNone = -1;
+
+  enum TimerState {
+    kTimerIdle,
+    kTimerPending,
+    kTimerExpired,
+  };
+
+  struct Timer {
+    TimerCallback callback;
+    TimerState state = kTimerIdle;
+    uint64_t deadline_ns = 0;
+    uint32_t level = 0;
+    uint32_t slot = 0;
+    int32_t prev = kNone;
+    int32_t next = kNone;
+  };
+
+  uint64_t Now();
+  void Link(uint32_t id, uint64_t min_tick);
+  void Unlink(uint32_t id);
+  void Cascade(uint32_t level);
+  void Step(std::vector<uint32_t> *due);
+  uint64_t GetNextExpiryLocked();
+  void ProgramFd();
+
+  std::mutex lock_;
+  TimerClock *clock_ = nullptr;
+  std::vector<Timer> timers_;
+  int32_t heads_[kLevels][kSlots];
+  uint64_t occupied_[kLevels] = {};  // Bit per slot holding timers
+  uint64_t current_tick_ = 0;        // Last tick processed
+  uint32_t linked_count_ = 0;
+  int fd_ = -1;
+  uint64_t programmed_ns_ = 0;       // Expiry the timerfd is set for, 0 while disarmed
+};
+
+}  // namespace sdm
+
+#endif  // __TIMER_WHEEL_H__
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __UEVENT_PARSER_H__
+#define __UEVENT_PARSER_H__
+
+#include <stdint.h>
+
+namespace sdm {
+
+// Splits a kernel uevent, an "action@devpath" header followed by NUL separated KEY=value fields,
+// in a single pass. Only the keys below are kept, looked up with a perfect hash of their length
+// and first character. Values point into the parsed buffer, which has to outlive the parser.
+class UEventParser {
+ public:
+  enum Key {
+    kKeyStatus,      // status
+    kKeyHotplug,     // HOTPLUG
+    kKeyMstHotplug,  // MST_HOTPLUG
+    kKeyBpp,         // bpp
+    kKeyPattern,     // pattern
+    kKeyMax,
+  };
+
+  // True if the devpath in the header of the uevent contains path, ignoring case.
+  static bool MatchDevPath(const char *data, int length, const char *path);
+  // Attaches a socket filter to the uevent netlink socket so that only change events are
+  // received, which hotplugs are reported as.
+  static int AttachChangeFilter(int fd);
+
+  // Returns the number of keys found.
+  uint32_t Parse(const char *data, int length);
+  const char *GetHeader() const { return header_; }
+  // Value of the key, nullptr if absent.
+  const char *GetValue(Key key) const { return values_[key]; }
+  // Value of the key as an integer, -1 if absent.
+  int GetIntValue(Key key) const;
+
+ private:
+  const char *header_ = nullptr;
+  const char *values_[kKeyMax] = {};
+};
+
+}  // namespace sdm
+
+#endif  // __UEVENT_PARSER_H__
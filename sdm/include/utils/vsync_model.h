@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __VSYNC_MODEL_H__
+#define __VSYNC_MODEL_H__
+
+#include <stdint.h>
+#include <vector>
+
+namespace sdm {
+
+// Fits the period and phase of a display's vsync to its recent timestamps, so vsyncs can be
+// predicted while events are off or late. Each timestamp is given a vsync index from the current
+// estimate, which keeps the fit right across missed events, and the line through them is fitted by
+// least squares with late event deliveries left out. All times are CLOCK_MONOTONIC nanoseconds.
+class VSyncModel {
+ public:
+  // Period of the active mode. Changing it drops the history.
+  void SetNominalPeriod(int64_t period_ns);
+  void AddVSync(int64_t timestamp_ns);
+  // A frame committed at commit_ns was presented at present_ns, when its retire fence signaled.
+  void AddPresent(int64_t commit_ns, int64_t present_ns);
+  void Reset();
+
+  // True once there is a vsync to predict from.
+  bool IsValid() const { return sample_count_ > 0 && nominal_period_ns_ > 0; }
+  // True once enough vsyncs have been seen for the period to be fitted.
+  bool IsFitted() const { return fitted_; }
+  int64_t GetPeriod() const;
+  // Shortest time from commit to present seen recently, 0 until measured.
+  int64_t GetPresentLatency() const;
+  // Times of the next count vsyncs after timestamp_ns.
+  void PredictVSyncs(int64_t timestamp_ns, uint32_t count, std::vector<int64_t> *vsyncs) const;
+  // Vsync at which a frame committed at timestamp_ns is expected to be presented.
+  int64_t GetExpectedPresentTime(int64_t timestamp_ns) const;
+
+ private:
+  static const uint32_t kMaxSamples = 32;
+  static const uint32_t kMaxLatencies = 32;
+
+  struct Sample {
+    int64_t timestamp_ns;
+    int64_t index;  // Vsync count since the first sample
+  };
+
+  void Fit();
+  int64_t NextVSync(int64_t timestamp_ns) const;
+
+  int64_t nominal_period_ns_ = 0;
+  Sample samples_[kMaxSamples] = {};
+  uint32_t sample_count_ = 0;  // Newest sample is at (sample_count_ - 1) % kMaxSamples
+  bool fitted_ = false;
+  double period_ns_ = 0;
+  int64_t anchor_ns_ = 0;  // Fitted time of the newest sample's vsync
+  int64_t latencies_[kMaxLatencies] = {};
+  uint32_t latency_count_ = 0;
+};
+
+}  // namespace sdm
+
+#endif  // __VSYNC_MODEL_H__
@@ -65,6 +65,7 @@
 
 #include <dlfcn.h>
 #include <private/color_interface.h>
+#include <utils/cache_key.h>
 #include <utils/constants.h>
 #include <utils/debug.h>
 #include <algorithm>
@@ -198,6 +199,9 @@ ColorManagerProxy::ColorManagerProxy(int32_t id, DisplayType type, HWInterface *
       break;
     }
   }
+
+  // The single buffer check of the dynamic switch needs every mode feature on the list.
+  mode_cache_enabled_ = !dyn_switch;
 }
 
 ColorManagerProxy *ColorManagerProxy::CreateColorManagerProxy(DisplayType type,
@@ -315,6 +319,8 @@ DisplayError ColorManagerProxy::ColorSVCRequestRoute(const PPDisplayAPIPayload &
                                                      PPPendingParams *pending_action) {
   DisplayError ret = kErrorNone;
 
+  FlushModeFeatures();
+  mode_cache_generation_++;
   // On completion, dspp_features_ will be populated and mark dirty with all resolved dspp
   // feature list with paramaters being transformed into target requirement.
   ret = color_intf_->ColorSVCRequestRoute(in_payload, out_payload, &pp_features_, pending_action);
@@ -371,6 +377,8 @@ DisplayError ColorManagerProxy::ApplyDefaultDisplayMode(void) {
   DisplayError ret = kErrorNone;
 
   // On POR, will be invoked from prepare<> request once bootanimation is done.
+  FlushModeFeatures();
+  mode_cache_generation_++;
   ret = color_intf_->ApplyDefaultDisplayMode(&pp_features_);
 
   return ret;
@@ -400,6 +408,7 @@ DisplayError ColorManagerProxy::Commit() {
   }
 
   if (is_dirty) {
+    ret = CommitModeFeatures();
     while (ret == kErrorNone) {
       PPFeatureInfo *feature = nullptr;
       if (pp_features_.RetrieveNextFeature(&feature) || !feature) {
@@ -482,6 +491,8 @@ DisplayError ColorManagerProxy::ColorMgrGetModes(uint32_t *mode_cnt,
 }
 
 DisplayError ColorManagerProxy::ColorMgrSetMode(int32_t color_mode_id) {
+  FlushModeFeatures();
+  mode_cache_generation_++;
   return color_intf_->ColorIntfSetDisplayMode(&pp_features_, 0, color_mode_id);
 }
 
@@ -507,6 +518,7 @@ DisplayError ColorManagerProxy::ColorMgrSetColorTransform(uint32_t length,
     return kErrorNone;
   }
 
+  mode_cache_generation_++;
   struct snapdragoncolor::ColorTransform color_transform = {};
   for (uint32_t i = 0; i < length; i++) {
     color_transform.coeff_array[i] = static_cast<float>(*(trans_data + i));
@@ -526,6 +538,7 @@ DisplayError ColorManagerProxy::ColorMgrSetColorTransform(uint32_t length,
 }
 
 DisplayError ColorManagerProxy::ColorMgrGetDefaultModeID(int32_t *mode_id) {
+  FlushModeFeatures();
   return color_intf_->ColorIntfGetDefaultModeID(&pp_features_, 0, mode_id);
 }
 
@@ -543,6 +556,7 @@ DisplayError ColorManagerProxy::ColorMgrSetModeWithRenderIntent(int32_t color_mo
 }
 
 DisplayError ColorManagerProxy::ColorMgrSetSprIntf(std::shared_ptr<SPRIntf> spr_intf) {
+  mode_cache_generation_++;
   return color_intf_->ColorIntfSetSprInterface(spr_intf);
 }
 
@@ -574,6 +588,10 @@ DisplayError ColorManagerProxy::Validate(DispLayerStack *disp_layer_stack) {
   }
 
   if (needs_update_ || apply_mode_ || update_meta_data) {
+    if (needs_update_) {
+      // The STC library changed its assets on its own, the modes it produced before are stale.
+      mode_cache_generation_++;
+    }
     UpdateModeHwassets(cur_mode_id_, curr_mode_, update_meta_data, meta_data_);
     DumpColorMetaData(meta_data_);
     apply_mode_ = false;
@@ -640,6 +658,7 @@ DisplayError ColorManagerProxy::ApplySwAssets() {
     DLOGE("Failed to process kScModeSwAssets, err %d", err);
     error = kErrorUndefined;
   } else if (!sw_params.payload.empty()) {
+    FlushModeFeatures();
     error = ConvertToPPFeatures(sw_params, &pp_features_);
     if (error != kErrorNone) {
       DLOGE("Failed to update Stc SW assets, error %d", error);
@@ -655,6 +674,7 @@ DisplayError ColorManagerProxy::NotifyDisplayCalibrationMode(bool in_calibration
     return kErrorUndefined;
   }
 
+  mode_cache_generation_++;
   ScPayload payload;
   payload.len = sizeof(in_calibration);
   payload.prop = kNotifyDisplayCalibrationMode;
@@ -730,15 +750,144 @@ DisplayError ColorManagerProxy::UpdateModeHwassets(int32_t mode_id,
     return kErrorUndefined;
   }
 
+  FlushModeFeatures();
+  uint64_t cache_key = 0;
+  if (mode_cache_enabled_ && !valid_meta_data) {
+    cache_key = GetModeCacheKey(mode_id, color_mode);
+  }
+
+  uint32_t feature_mask = 0;
+  if (cache_key && hw_intf_->GetCachedPPFeatures(cache_key, &feature_mask) == kErrorNone) {
+    // The mode's features replace the ones converted before them, as converting them would.
+    for (uint32_t id = 0; id < kMaxNumPPFeatures; id++) {
+      if (feature_mask & (1U << id)) {
+        pp_features_.AddFeature(id, nullptr);
+      }
+    }
+    mode_cache_key_ = cache_key;
+    mode_cache_hit_ = true;
+    mode_hw_params_.payload.swap(hw_params.payload);
+    pp_features_.MarkAsDirty();
+    return kErrorNone;
+  }
+
+  // Features converted before are set aside, so the ones left on the list are the mode's. The
+  // mode's are taken off the list until commit, so no other writer can free them in between.
+  PPFeatureInfo *prev_features[kMaxNumPPFeatures] = {};
+  if (cache_key) {
+    for (uint32_t id = 0; id < kMaxNumPPFeatures; id++) {
+      prev_features[id] = pp_features_.ReleaseFeature(id);
+    }
+  }
+
   error = ConvertToPPFeatures(hw_params, &pp_features_);
+  if (cache_key) {
+    for (uint32_t id = 0; id < kMaxNumPPFeatures; id++) {
+      PPFeatureInfo *feature = pp_features_.ReleaseFeature(id);
+      if (!feature) {
+        pp_features_.AddFeature(id, prev_features[id]);
+        continue;
+      }
+      delete prev_features[id];
+      mode_features_[id].reset(feature);
+    }
+  }
+
   if (error != kErrorNone) {
+    ResetModeCache();
     DLOGE("Failed to convert hw assets to PP features, error = %d", error);
     return kErrorUndefined;
   }
+  mode_cache_key_ = cache_key;
   pp_features_.MarkAsDirty();
   return error;
 }
 
+// Key of the features a mode converts to on the current panel config, for as long as the
+// generation stays.
+uint64_t ColorManagerProxy::GetModeCacheKey(int32_t mode_id,
+                                            const snapdragoncolor::ColorMode &color_mode) {
+  CacheKey key;
+  key.Add(mode_cache_generation_).Add(mode_id);
+  key.Add(color_mode.gamut).Add(color_mode.gamma).Add(color_mode.intent);
+  key.Add(color_mode.intent_name);
+  for (auto &hw_asset : color_mode.hw_assets) {
+    key.Add(hw_asset);
+  }
+
+  // The color libraries read the panel state through the display, a mode may convert differently
+  // for another resolution, refresh rate or panel mode.
+  uint32_t active_config = 0;
+  HWDisplayAttributes attributes = {};
+  HWPanelInfo panel_info = {};
+  hw_intf_->GetActiveConfig(&active_config);
+  hw_intf_->GetDisplayAttributes(active_config, &attributes);
+  hw_intf_->GetHWPanelInfo(&panel_info);
+  key.Add(active_config).Add(attributes.x_pixels).Add(attributes.y_pixels);
+  key.Add(attributes.fps).Add(attributes.vsync_period_ns).Add(attributes.topology);
+  key.Add(panel_info.mode);
+
+  return key.Get();
+}
+
+// Other features are about to be converted. Pending mode features go back on the list first, so
+// the new ones replace them as before, and are no longer cached.
+void ColorManagerProxy::FlushModeFeatures() {
+  if (mode_cache_hit_) {
+    DisplayError error = ConvertToPPFeatures(mode_hw_params_, &pp_features_);
+    if (error != kErrorNone) {
+      DLOGE("Failed to convert hw assets to PP features, error = %d", error);
+    }
+  }
+  for (uint32_t id = 0; id < kMaxNumPPFeatures; id++) {
+    // A feature on the list was converted after the mode's.
+    if (mode_features_[id] && !pp_features_.GetFeature(id)) {
+      pp_features_.AddFeature(id, mode_features_[id].release());
+    }
+  }
+  ResetModeCache();
+}
+
+void ColorManagerProxy::ResetModeCache() {
+  mode_cache_key_ = 0;
+  mode_cache_hit_ = false;
+  for (uint32_t id = 0; id < kMaxNumPPFeatures; id++) {
+    mode_features_[id].reset();
+  }
+  mode_hw_params_.payload.clear();
+}
+
+// Sets the pending mode features from the cache, or sets and caches the converted ones. Features
+// on the list are set after them, so any converted since the mode win as before.
+DisplayError ColorManagerProxy::CommitModeFeatures() {
+  DisplayError error = kErrorNone;
+  if (mode_cache_hit_) {
+    error = hw_intf_->SetCachedPPFeatures(mode_cache_key_);
+    if (error != kErrorNone) {
+      DLOGW("Cached PP features not found, key %" PRIx64, mode_cache_key_);
+      FlushModeFeatures();
+      return kErrorNone;
+    }
+    ResetModeCache();
+    return kErrorNone;
+  }
+
+  if (!mode_cache_key_) {
+    return kErrorNone;
+  }
+
+  hw_intf_->SetPPFeatureCacheKey(mode_cache_key_);
+  for (uint32_t id = 0; id < kMaxNumPPFeatures && error == kErrorNone; id++) {
+    if (mode_features_[id]) {
+      error = hw_intf_->SetPPFeature(mode_features_[id].get());
+    }
+  }
+  hw_intf_->SetPPFeatureCacheKey(0);
+  ResetModeCache();
+
+  return error;
+}
+
 void ColorManagerProxy::DumpColorMetaData(const ColorMetaData &color_metadata) {
   DLOGI_IF(kTagResources, "Primaries = %d, Range = %d, Transfer = %d, Matrix Coeffs = %d",
            color_metadata.colorPrimaries, color_metadata.range, color_metadata.transfer,
@@ -796,6 +945,7 @@ DisplayError ColorManagerProxy::ColorMgrSetLtmPccConfig(void* pcc_input, size_t
     return kErrorUndefined;
   }
 
+  mode_cache_generation_++;
   ScPayload in_data = {};
   in_data.prop = snapdragoncolor::kSetLtmPccConfig;
   if (pcc_input) {
@@ -866,6 +1016,7 @@ DisplayError ColorManagerProxy::ConfigureCWBDither(CwbConfig *cwb_cfg, bool free
     //<<! update asset name from kPbDither to kPbCWBDither
     //<<! convert data struct from dither_coeff_data to SDEDitherCfg
     dither_hw_params.payload[0].hw_asset = snapdragoncolor::kPbCWBDither;
+    FlushModeFeatures();
     error = ConvertToPPFeatures(dither_hw_params, &pp_features_);
     if (error != kErrorNone) {
       DLOGE("Failed to convert cwb dither feature, error %d", error);
@@ -43,6 +43,7 @@
 #include <array>
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
 #include <mutex>
 
@@ -184,6 +185,10 @@ class ColorManagerProxy {
   void DumpColorMetaData(const ColorMetaData &color_metadata);
   bool HasNativeModeSupport();
   DisplayError ApplySwAssets();
+  uint64_t GetModeCacheKey(int32_t mode_id, const snapdragoncolor::ColorMode &color_mode);
+  void FlushModeFeatures();
+  void ResetModeCache();
+  DisplayError CommitModeFeatures();
 
   int32_t display_id_;
   DisplayType device_type_;
@@ -200,6 +205,13 @@ class ColorManagerProxy {
   snapdragoncolor::ScPostBlendInterface *stc_intf_ = NULL;
   snapdragoncolor::ColorMode curr_mode_;
   bool needs_update_ = false;
+  bool mode_cache_enabled_ = false;     // Mode features are kept converted by the HW interface
+  uint64_t mode_cache_generation_ = 0;  // Changed when the color libraries may convert differently
+  uint64_t mode_cache_key_ = 0;         // Key of the mode features pending commit, 0 if none
+  bool mode_cache_hit_ = false;         // Pending mode features are set from the cache
+  // Converted for the pending mode, off the list until commit
+  std::unique_ptr<PPFeatureInfo> mode_features_[kMaxNumPPFeatures];
+  HwConfigOutputParams mode_hw_params_;  // Converted if the cached features are not applied
 };
 
 class ColorFeatureCheckingImpl : public FeatureInterface {
@@ -35,9 +35,11 @@
 #include <utils/constants.h>
 #include <utils/debug.h>
 #include <utils/locker.h>
+#include <utils/startup_timeline.h>
 #include <utils/utils.h>
 #include <sys/mman.h>
 #include <private/hw_info_interface.h>
+#include <future>
 #include <map>
 #include <vector>
 
@@ -71,43 +73,62 @@ CoreImpl::CoreImpl(BufferAllocator *buffer_allocator,
 DisplayError CoreImpl::Init() {
   SCOPE_LOCK(locker_);
   DisplayError error = kErrorNone;
+  std::future<DisplayError> hw_info_status;
 
-  // Try to load extension library & get handle to its interface.
-  if (extension_lib_.Open(EXTENSION_LIBRARY_NAME)) {
-    if (!extension_lib_.Sym(CREATE_EXTENSION_INTERFACE_NAME,
-                            reinterpret_cast<void **>(&create_extension_intf_)) ||
-        !extension_lib_.Sym(DESTROY_EXTENSION_INTERFACE_NAME,
-                            reinterpret_cast<void **>(&destroy_extension_intf_))) {
-      DLOGE("Unable to load symbols, error = %s", extension_lib_.Error());
-      return kErrorUndefined;
-    }
+  int value = 0;
+  Debug::Get()->GetProperty(ENABLE_NULL_DISPLAY_PROP, &value);
+  enable_null_display_ = (value == 1);
+  DLOGI("property: enable_null_display_ = %d", enable_null_display_);
 
-    error = create_extension_intf_(EXTENSION_VERSION_TAG, &extension_intf_);
-    if (error != kErrorNone) {
-      DLOGE("Unable to create interface");
-      return error;
-    }
-  } else {
+  // Parsing the DRM objects does not depend on the extension library, so it runs while the
+  // library and its dependencies are loaded.
+  if (!enable_null_display_) {
+    hw_info_status = std::async(std::launch::async, [this]() {
+      ScopedStartupStage stage("HW info");
+      DisplayError status = HWInfoInterface::Create(&hw_info_intf_);
+      if (status != kErrorNone) {
+        return status;
+      }
+      return hw_info_intf_->GetHWResourceInfo(&hw_resource_);
+    });
+  }
+
+  {
+    ScopedStartupStage stage("Load " EXTENSION_LIBRARY_NAME);
+    // Try to load extension library & get handle to its interface.
+    if (extension_lib_.Open(EXTENSION_LIBRARY_NAME)) {
+      if (!extension_lib_.Sym(CREATE_EXTENSION_INTERFACE_NAME,
+                              reinterpret_cast<void **>(&create_extension_intf_)) ||
+          !extension_lib_.Sym(DESTROY_EXTENSION_INTERFACE_NAME,
+                              reinterpret_cast<void **>(&destroy_extension_intf_))) {
+        DLOGE("Unable to load symbols, error = %s", extension_lib_.Error());
+        error = kErrorUndefined;
+        goto CleanupOnError;
+      }
+
+      error = create_extension_intf_(EXTENSION_VERSION_TAG, &extension_intf_);
+      if (error != kErrorNone) {
+        DLOGE("Unable to create interface");
+        goto CleanupOnError;
+      }
+    } else {
 #ifdef TRUSTED_VM
-    // Any library linked to libsdmextension is not present for LE, LE wont be able to load the
-    // libsdmextension library due to undefined reference. To avoid it mark it as fatal on LE
-    DLOGE("Unable to load = %s, error = %s", EXTENSION_LIBRARY_NAME, extension_lib_.Error());
+      // Any library linked to libsdmextension is not present for LE, LE wont be able to load the
+      // libsdmextension library due to undefined reference. To avoid it mark it as fatal on LE
+      DLOGE("Unable to load = %s, error = %s", EXTENSION_LIBRARY_NAME, extension_lib_.Error());
 #else
-    DLOGW("Unable to load = %s, error = %s", EXTENSION_LIBRARY_NAME, extension_lib_.Error());
+      DLOGW("Unable to load = %s, error = %s", EXTENSION_LIBRARY_NAME, extension_lib_.Error());
 #endif
+    }
   }
 
-  int value = 0;
-  Debug::Get()->GetProperty(ENABLE_NULL_DISPLAY_PROP, &value);
-  enable_null_display_ = (value == 1);
-  DLOGI("property: enable_null_display_ = %d", enable_null_display_);
   if (enable_null_display_) {
     hw_info_intf_ = new HWInfoDefault();
     return kErrorNone;
   }
 
-  error = HWInfoInterface::Create(&hw_info_intf_);
-  if (error != kErrorNone) {
+  error = hw_info_status.get();
+  if (!hw_info_intf_) {
     DisplayError err = HandleNullDisplay();
 
     if ((err != kErrorNone) || !enable_null_display_) {
@@ -117,7 +138,6 @@ DisplayError CoreImpl::Init() {
     return kErrorNone;
   }
 
-  error = hw_info_intf_->GetHWResourceInfo(&hw_resource_);
   if (error != kErrorNone) {
     goto CleanupOnError;
   }
@@ -165,6 +185,10 @@ DisplayError CoreImpl::Init() {
   return kErrorNone;
 
 CleanupOnError:
+  // The HW info may still be getting created when the extension library failed.
+  if (hw_info_status.valid()) {
+    hw_info_status.wait();
+  }
   if (hw_info_intf_) {
     HWInfoInterface::Destroy(hw_info_intf_);
   }
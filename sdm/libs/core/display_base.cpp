@@ -35,6 +35,8 @@
 #include <utils/debug.h>
 #include <utils/formats.h>
 #include <utils/rect.h>
+#include <utils/stage_latency.h>
+#include <utils/sys.h>
 #include <utils/utils.h>
 #include <drm_interface.h>
 #include <private/hw_info_interface.h>
@@ -108,6 +110,15 @@ DisplayBase::DisplayBase(DisplayType display_type, DisplayEventHandler *event_ha
   commit_thread_.swap(commit_thread);
 
   DLOGI("Commit thread started for display: %d", display_type);
+
+  idle_timer_ = timer_wheel_.Create([this] { HandleIdleTimer(); });
+  timer_exit_fd_ = Sys::eventfd_(0, 0);
+  if (timer_exit_fd_ < 0 || timer_wheel_.CreateFd() < 0) {
+    DLOGE("Failed to create timer fds for display: %d", display_type);
+    return;
+  }
+  std::thread timer_thread(&DisplayBase::TimerThread, this);
+  timer_thread_.swap(timer_thread);
 }
 
 DisplayBase::DisplayBase(int32_t display_id, DisplayType display_type,
@@ -122,6 +133,11 @@ DisplayBase::DisplayBase(int32_t display_id, DisplayType display_type,
 }
 
 DisplayBase::~DisplayBase() {
+  StopTimerThread();
+  if (timer_exit_fd_ >= 0) {
+    Sys::close_(timer_exit_fd_);
+  }
+
   // Signal worker thread and wait for it to terminate.
   {
     ClientLock lock(disp_mutex_);
@@ -135,6 +151,7 @@ DisplayBase::~DisplayBase() {
 DisplayError DisplayBase::Init() {
   ClientLock lock(disp_mutex_);
   DisplayError error = kErrorNone;
+  StageLatency::AddDisplay(display_id_);
   hw_panel_info_ = HWPanelInfo();
   hw_intf_->GetHWPanelInfo(&hw_panel_info_);
   default_panel_mode_ = hw_panel_info_.mode;
@@ -641,21 +658,12 @@ void DisplayBase::ConfigureCwbParams(LayerStack *layer_stack) {
 
 bool DisplayBase::IsWriteBackSupportedFormat(const LayerBufferFormat &format) {
   // check whether writeback supported for parameter color format or not.
-  std::map<HWSubBlockType, std::vector<LayerBufferFormat>>::iterator it =
-      hw_resource_info_.supported_formats_map.find(HWSubBlockType::kHWWBIntfOutput);
-  if (it == hw_resource_info_.supported_formats_map.end()) {
-    return false;
-  }
-  std::vector<LayerBufferFormat> &supported_sdm_formats = it->second;
-  if (supported_sdm_formats.empty()) {
+  auto it = hw_resource_info_.supported_format_sets.find(HWSubBlockType::kHWWBIntfOutput);
+  if (it == hw_resource_info_.supported_format_sets.end()) {
     return false;
   }
-  for (int i = 0; i < supported_sdm_formats.size(); i++) {
-    if (supported_sdm_formats[i] == format) {
-      return true;
-    }
-  }
-  return false;
+
+  return it->second.Contains(format);
 }
 
 DisplayError DisplayBase::BuildLayerStackStats(LayerStack *layer_stack) {
@@ -954,7 +962,10 @@ DisplayError DisplayBase::Prepare(LayerStack *layer_stack) {
   CheckMMRMState();
 
   while (true) {
-    error = comp_manager_->Prepare(display_comp_ctx_, disp_layer_stack_);
+    {
+      ScopedStageLatency stage_latency(display_id_, kStagePrepare);
+      error = comp_manager_->Prepare(display_comp_ctx_, disp_layer_stack_);
+    }
     if (error != kErrorNone) {
       break;
     }
@@ -1440,26 +1451,9 @@ void DisplayBase::CommitThread() {
     disp_mutex_.worker_busy = false;
     disp_mutex_.worker_cv.notify_one();
 
-    auto timeout_at = WaitUntil();
-    auto wait_duration = timeout_at.time_since_epoch().count() -
-                         std::chrono::system_clock::now().time_since_epoch().count();
-
     // Wait for client thread to signal. Handle spurious interrupts.
-    if (!(disp_mutex_.worker_cv.wait_until(disp_mutex_.worker_mutex, timeout_at,
-                                           [this] { return (disp_mutex_.worker_busy); }))) {
-      DLOGI("Received idle timeout, panel: %s, timeout: %d us",
-            hw_panel_info_.mode == kModeVideo ? "video" : "cmd", wait_duration);
-
-      event_handler_->HandleEvent(kIdleTimeout);
-      if (hw_panel_info_.mode == kModeCommand || idle_active_ms_ <= 0) {
-        //Notify Display Idle to AIDL clients
-        event_handler_->HandleEvent(kPostIdleTimeout);
-        idle_hint_set_ = true;
-      } else {
-        IdleTimeout();
-      }
-      continue;
-    }
+    disp_mutex_.worker_cv.wait(disp_mutex_.worker_mutex,
+                               [this] { return (disp_mutex_.worker_busy); });
 
     if (disp_mutex_.worker_exit) {
       DLOGI("Terminate commit thread.");
@@ -1470,6 +1464,46 @@ void DisplayBase::CommitThread() {
   }
 }
 
+// Derived displays whose timers call into them stop the thread before they are destroyed.
+void DisplayBase::StopTimerThread() {
+  if (!timer_thread_.joinable()) {
+    return;
+  }
+
+  uint64_t exit_value = 1;
+  Sys::write_(timer_exit_fd_, &exit_value, sizeof(exit_value));
+  timer_thread_.join();
+}
+
+void DisplayBase::TimerThread() {
+  DLOGI("Timer thread started. %d-%d", display_id_, display_type_);
+
+  struct pollfd fds[2] = {};
+  fds[0].fd = timer_wheel_.GetFd();
+  fds[0].events = POLLIN;
+  fds[1].fd = timer_exit_fd_;
+  fds[1].events = POLLIN;
+  while (1) {
+    int ret = Sys::poll_(fds, 2, -1);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      DLOGE("poll failed, error = %s", strerror(errno));
+      break;
+    }
+
+    if (fds[1].revents & POLLIN) {
+      DLOGI("Terminate timer thread.");
+      break;
+    }
+
+    if (fds[0].revents & POLLIN) {
+      timer_wheel_.Advance();
+    }
+  }
+}
+
 DisplayError DisplayBase::SetUpCommit(LayerStack *layer_stack) {
   DTRACE_SCOPED();
   DisplayError error = kErrorNone;
@@ -1623,6 +1657,8 @@ DisplayError DisplayBase::PerformHwCommit(HWLayersInfo *hw_layers_info) {
     return error;
   }
 
+  ArmIdleTimer();
+
   cwb_active_ = false;
   cwb_output_buf_ = {};
 
@@ -1640,6 +1676,7 @@ void DisplayBase::CleanupOnError() {
 
 DisplayError DisplayBase::PostCommit(HWLayersInfo *hw_layers_info) {
   DTRACE_SCOPED();
+  ScopedStageLatency stage_latency(display_id_, kStagePostCommit);
   idle_hint_set_ = false;
   // Store retire fence to track commit start.
   CacheRetireFence();
@@ -4323,7 +4360,8 @@ void DisplayBase::PrepareForAsyncTransition() {
   disp_layer_stack_->stack = nullptr;
 }
 
-std::chrono::system_clock::time_point DisplayBase::WaitUntil() {
+// Idle timeout to run from now, 0 when none should.
+int DisplayBase::GetIdleTimeoutMs() {
   int idle_time_ms;
   if (hw_panel_info_.mode == kModeCommand || idle_active_ms_ <= 0) {
     // Idle Timer is configured to notify display idle to AIDL clients
@@ -4331,21 +4369,48 @@ std::chrono::system_clock::time_point DisplayBase::WaitUntil() {
   } else {
     idle_time_ms = disp_layer_stack_->info.set_idle_time_ms;
   }
-  std::chrono::milliseconds timeout_duration;
 
   DLOGV_IF(kTagDisplay, "Off: %d, time: %d, timeout:%d, panel: %s", state_ == kStateOff,
            idle_time_ms, handle_idle_timeout_, hw_panel_info_.mode == kModeVideo ? "video" : "cmd");
 
-  // Indefinite wait if state is off or idle timeout has triggered
+  // No timeout if state is off or idle timeout has triggered
   if (state_ == kStateOff || idle_time_ms <= 0 || handle_idle_timeout_ || pending_commit_ ||
       idle_hint_set_) {
-    timeout_duration = std::chrono::milliseconds(INT_MAX);
-  } else {
-    timeout_duration = std::chrono::milliseconds(idle_time_ms);
+    return 0;
   }
 
-  std::chrono::system_clock::time_point current_time = std::chrono::system_clock::now();
-  return current_time + timeout_duration;
+  return idle_time_ms;
+}
+
+// Called after every commit. Re-arming the pending timer on each frame only moves its deadline.
+void DisplayBase::ArmIdleTimer() {
+  int idle_time_ms = GetIdleTimeoutMs();
+  if (idle_time_ms <= 0) {
+    timer_wheel_.Cancel(idle_timer_);
+    return;
+  }
+
+  timer_wheel_.Arm(idle_timer_, UINT32(idle_time_ms));
+}
+
+void DisplayBase::HandleIdleTimer() {
+  ClientLock lock(disp_mutex_);
+  // A commit made while waiting for the lock has armed the timer again, or the display has since
+  // been turned off or prepared a frame.
+  if (!timer_wheel_.HasExpired(idle_timer_) || GetIdleTimeoutMs() <= 0) {
+    return;
+  }
+
+  DLOGI("Received idle timeout, panel: %s", hw_panel_info_.mode == kModeVideo ? "video" : "cmd");
+
+  event_handler_->HandleEvent(kIdleTimeout);
+  if (hw_panel_info_.mode == kModeCommand || idle_active_ms_ <= 0) {
+    //Notify Display Idle to AIDL clients
+    event_handler_->HandleEvent(kPostIdleTimeout);
+    idle_hint_set_ = true;
+  } else {
+    IdleTimeout();
+  }
 }
 
 DisplayError DisplayBase::ConfigureCwbForIdleFallback(LayerStack *layer_stack) {
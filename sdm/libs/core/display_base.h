@@ -44,6 +44,7 @@
 #include <private/noise_plugin_dbg.h>
 #include <private/hw_interface.h>
 #include <private/hw_events_interface.h>
+#include <utils/timer_wheel.h>
 
 #include <limits.h>
 #include <map>
@@ -264,6 +265,10 @@ class DisplayBase : public DisplayInterface, public CompManagerEventHandler {
                                     SdmDisplayCbInterface<PanelOprPayload> *cb_intf) {
     return kErrorNotSupported;
   }
+  virtual DisplayError GetVSyncPrediction(int64_t timestamp_ns, uint32_t count,
+                                          VSyncPrediction *prediction) {
+    return kErrorNotSupported;
+  }
 
  protected:
   struct DisplayMutex {
@@ -337,6 +342,8 @@ class DisplayBase : public DisplayInterface, public CompManagerEventHandler {
   void SetPendingPowerState(DisplayState state);
   DisplayError SetupPanelFeatureFactory();
   void CommitThread();
+  void TimerThread();
+  void StopTimerThread();
   virtual void HandleAsyncCommit();
   void MMRMEvent(uint32_t clk);
   void CheckMMRMState();
@@ -353,12 +360,19 @@ class DisplayBase : public DisplayInterface, public CompManagerEventHandler {
   DisplayError HandleNoiseLayer(LayerStack *layer_stack);
   void PrepareForAsyncTransition();
   virtual void IdleTimeout() {}
-  std::chrono::system_clock::time_point WaitUntil();
+  int GetIdleTimeoutMs();
+  void ArmIdleTimer();
+  void HandleIdleTimer();
   virtual void Abort();
   DisplayError DisableDestinationScalar();
 
   DisplayMutex disp_mutex_;
   std::thread commit_thread_;
+  // Timers of the display, run from their own thread when the timerfd expires.
+  TimerWheel timer_wheel_;
+  std::thread timer_thread_;
+  int timer_exit_fd_ = -1;
+  uint32_t idle_timer_ = 0;
   int32_t display_id_ = -1;
   DisplayType display_type_;
   DisplayEventHandler *event_handler_ = NULL;
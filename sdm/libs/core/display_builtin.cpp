@@ -58,20 +58,23 @@ DisplayBuiltIn::DisplayBuiltIn(DisplayEventHandler *event_handler, HWInfoInterfa
                                BufferAllocator *buffer_allocator, CompManager *comp_manager,
                                std::shared_ptr<IPCIntf> ipc_intf)
   : DisplayBase(kBuiltIn, event_handler, kDeviceBuiltIn, buffer_allocator, comp_manager,
-                hw_info_intf), ipc_intf_(ipc_intf) {}
+                hw_info_intf), ipc_intf_(ipc_intf) {
+  lower_fps_timer_ = timer_wheel_.Create(TimerCallback());
+  vsync_off_timer_ = timer_wheel_.Create([this] { HandleVSyncOffTimer(); });
+}
 
 DisplayBuiltIn::DisplayBuiltIn(int32_t display_id, DisplayEventHandler *event_handler,
                                HWInfoInterface *hw_info_intf,
                                BufferAllocator *buffer_allocator, CompManager *comp_manager,
                                std::shared_ptr<IPCIntf> ipc_intf)
   : DisplayBase(display_id, kBuiltIn, event_handler, kDeviceBuiltIn, buffer_allocator, comp_manager,
-                hw_info_intf), ipc_intf_(ipc_intf) {}
-
-DisplayBuiltIn::~DisplayBuiltIn() {
+                hw_info_intf), ipc_intf_(ipc_intf) {
+  lower_fps_timer_ = timer_wheel_.Create(TimerCallback());
+  vsync_off_timer_ = timer_wheel_.Create([this] { HandleVSyncOffTimer(); });
 }
 
-static uint64_t GetTimeInMs(struct timespec ts) {
-  return (ts.tv_sec * 1000 + (ts.tv_nsec + 500000) / 1000000);
+DisplayBuiltIn::~DisplayBuiltIn() {
+  StopTimerThread();
 }
 
 DisplayError DisplayBuiltIn::Init() {
@@ -194,6 +197,14 @@ DisplayError DisplayBuiltIn::Init() {
   DebugHandler::Get()->GetProperty(ENHANCE_IDLE_TIME, &value);
   enhance_idle_time_ = (value == 1);
 
+  value = 0;
+  DebugHandler::Get()->GetProperty(ENABLE_CONTENT_CADENCE, &value);
+  enable_content_cadence_ = hw_panel_info_.dynamic_fps && (value == 1);
+
+  value = 0;
+  DebugHandler::Get()->GetProperty(VSYNC_OFF_DELAY_MS, &value);
+  vsync_off_delay_ms_ = (value > 0) ? UINT32(value) : 0;
+
   value = 0;
   DebugHandler::Get()->GetProperty(ENABLE_DPPS_DYNAMIC_FPS, &value);
   enable_dpps_dyn_fps_ = (value == 1);
@@ -280,6 +291,11 @@ DisplayError DisplayBuiltIn::PrePrepare(LayerStack *layer_stack) {
   }
   disp_layer_stack_->info.spr_enable = spr_enable_;
 
+  {
+    std::lock_guard<std::mutex> guard(vsync_model_lock_);
+    vsync_model_.SetNominalPeriod(static_cast<int64_t>(display_attributes_.vsync_period_ns));
+  }
+  UpdateContentCadence(layer_stack);
   AppendCWBLayer(layer_stack);
   // Do not skip validate if needs update PP features.
   if (color_mgr_) {
@@ -373,15 +389,9 @@ void DisplayBuiltIn::NotifyDppsHdrPresent(LayerStack *layer_stack) {
 }
 
 void DisplayBuiltIn::CacheFrameROI() {
-  left_frame_roi_ = {};
-  right_frame_roi_ = {};
-
-  // Cache the Frame ROI.
-  if (disp_layer_stack_->info.left_frame_roi.size() &&
-      disp_layer_stack_->info.right_frame_roi.size()) {
-    left_frame_roi_ = disp_layer_stack_->info.left_frame_roi.at(0);
-    right_frame_roi_ = disp_layer_stack_->info.right_frame_roi.at(0);
-  }
+  // Cache the Frame ROIs.
+  left_frame_roi_ = disp_layer_stack_->info.left_frame_roi;
+  right_frame_roi_ = disp_layer_stack_->info.right_frame_roi;
 }
 
 void DisplayBuiltIn::UpdateQsyncMode() {
@@ -996,8 +1006,29 @@ DisplayError DisplayBuiltIn::CommitLocked(LayerStack *layer_stack) {
   DTRACE_SCOPED();
   last_panel_mode_ = hw_panel_info_.mode;
   PreCommit(layer_stack);
+  UpdatePresentLatency();
+
+  disp_layer_stack_->info.commit_time_ns = 0;
+  DisplayError error = DisplayBase::CommitLocked(layer_stack);
+  if (error == kErrorNone && disp_layer_stack_->info.commit_time_ns) {
+    pending_present_fence_ = disp_layer_stack_->info.retire_fence;
+    pending_commit_ns_ = int64_t(disp_layer_stack_->info.commit_time_ns);
+  }
+
+  return error;
+}
+
+// The retire fence of the last commit signals when its frame is presented, by the time of the next
+// commit it usually has.
+void DisplayBuiltIn::UpdatePresentLatency() {
+  std::lock_guard<std::mutex> guard(vsync_model_lock_);
+  int64_t present_ns = 0;
+  if (pending_present_fence_ && !Fence::GetSignalTime(pending_present_fence_, &present_ns)) {
+    vsync_model_.AddPresent(pending_commit_ns_, present_ns);
+  }
+  pending_present_fence_ = nullptr;
 
-  return DisplayBase::CommitLocked(layer_stack);
+  disp_layer_stack_->info.present_latency_ns = UINT64(vsync_model_.GetPresentLatency());
 }
 
 DisplayError DisplayBuiltIn::PostCommit(HWLayersInfo *hw_layers_info) {
@@ -1025,12 +1056,15 @@ DisplayError DisplayBuiltIn::PostCommit(HWLayersInfo *hw_layers_info) {
     deferred_config_.Clear();
   }
 
-  clock_gettime(CLOCK_MONOTONIC, &idle_timer_start_);
   int idle_time_ms = disp_layer_stack_->info.set_idle_time_ms;
   if (idle_time_ms >= 0) {
     hw_intf_->SetIdleTimeoutMs(UINT32(idle_time_ms));
     idle_time_ms_ = idle_time_ms;
   }
+  // Counted from the last commit that reached the panel, so it does not run before the first.
+  if (hw_layers_info->retire_fence) {
+    timer_wheel_.Arm(lower_fps_timer_, UINT32(idle_time_ms_));
+  }
 
   if (switch_to_cmd_) {
     uint32_t pending;
@@ -1398,10 +1432,7 @@ bool DisplayBuiltIn::CanLowerFps(bool idle_screen) {
     return false;
   }
 
-  struct timespec now;
-  clock_gettime(CLOCK_MONOTONIC, &now);
-  uint64_t elapsed_time_ms = GetTimeInMs(now) - GetTimeInMs(idle_timer_start_);
-  bool can_lower = elapsed_time_ms >= UINT32(idle_time_ms_);
+  bool can_lower = timer_wheel_.HasExpired(lower_fps_timer_);
   DLOGV_IF(kTagDisplay, "lower fps: %d", can_lower);
 
   return can_lower;
@@ -1409,13 +1440,19 @@ bool DisplayBuiltIn::CanLowerFps(bool idle_screen) {
 
 DisplayError DisplayBuiltIn::VSync(int64_t timestamp) {
   DTRACE_SCOPED();
-  bool qsync_enabled = enable_qsync_idle_ && (active_qsync_mode_ != kQSyncModeNone);
-  // Client isn't aware of underlying qsync mode.
-  // Disable vsync propagation as long as qsync is enabled.
-  bool propagate_vsync = vsync_enable_ && !drop_hw_vsync_ && !qsync_enabled;
-  if (!propagate_vsync) {
-    // Re enable when display updates.
-    SetVsyncStatus(false /*Disable vsync events.*/);
+  {
+    std::lock_guard<std::mutex> guard(vsync_model_lock_);
+    vsync_model_.AddVSync(timestamp);
+  }
+
+  if (!NeedsVSync()) {
+    // Re enable when display updates. Kept on for a while first, if asked for, so vsyncs soon
+    // needed again do not take a round trip to the driver.
+    if (!vsync_off_delay_ms_) {
+      SetVsyncStatus(false /*Disable vsync events.*/);
+    } else if (!timer_wheel_.IsPending(vsync_off_timer_)) {
+      timer_wheel_.Arm(vsync_off_timer_, vsync_off_delay_ms_);
+    }
     return kErrorNone;
   }
 
@@ -1426,10 +1463,29 @@ DisplayError DisplayBuiltIn::VSync(int64_t timestamp) {
   return kErrorNone;
 }
 
+bool DisplayBuiltIn::NeedsVSync() {
+  bool qsync_enabled = enable_qsync_idle_ && (active_qsync_mode_ != kQSyncModeNone);
+  // Client isn't aware of underlying qsync mode.
+  // Disable vsync propagation as long as qsync is enabled.
+  return vsync_enable_ && !drop_hw_vsync_ && !qsync_enabled;
+}
+
+void DisplayBuiltIn::HandleVSyncOffTimer() {
+  ClientLock lock(disp_mutex_);
+  // Vsync may have been needed again, or the display turned off, while waiting for the lock.
+  if (!timer_wheel_.HasExpired(vsync_off_timer_) || state_ == kStateOff ||
+      pending_vsync_enable_ || NeedsVSync()) {
+    return;
+  }
+
+  SetVsyncStatus(false /*Disable vsync events.*/);
+}
+
 void DisplayBuiltIn::SetVsyncStatus(bool enable) {
   string trace_name = enable ? "enable" : "disable";
   DTRACE_BEGIN(trace_name.c_str());
   if (enable) {
+    timer_wheel_.Cancel(vsync_off_timer_);
     // Enable if vsync is still enabled.
     hw_events_intf_->SetEventState(HWEvent::VSYNC, vsync_enable_);
     pending_vsync_enable_ = false;
@@ -1871,6 +1927,14 @@ std::string DisplayBuiltIn::Dump() {
   os << " Topology: " << display_attributes_.topology;
   os << " Qsync mode: " << active_qsync_mode_;
   os << std::noboolalpha;
+  os << "\n Refresh rate: " << current_refresh_rate_ << " content rate: " << content_rate_
+     << " switches: " << refresh_rate_arbiter_.GetSwitchCount();
+  {
+    std::lock_guard<std::mutex> guard(vsync_model_lock_);
+    os << "\n VSync model period: " << vsync_model_.GetPeriod()
+       << " fitted: " << vsync_model_.IsFitted()
+       << " present latency: " << vsync_model_.GetPresentLatency();
+  }
 
   DynamicRangeType curr_dynamic_range = kSdrType;
   if (std::find(current_color_mode_.hw_assets.begin(), current_color_mode_.hw_assets.end(),
@@ -2240,7 +2304,7 @@ bool DisplayBuiltIn::CanCompareFrameROI(LayerStack *layer_stack) {
   if (layer_stack->flags.demura_present)
     stack_fudge_factor++;
 
-  if (!hw_panel_info_.partial_update || (hw_panel_info_.left_roi_count != 1) ||
+  if (!hw_panel_info_.partial_update || !hw_panel_info_.left_roi_count ||
       layer_stack->flags.geometry_changed || layer_stack->flags.skip_present ||
       (layer_stack->layers.size() !=
        (disp_layer_stack_->info.app_layer_count + stack_fudge_factor))) {
@@ -2293,9 +2357,18 @@ bool DisplayBuiltIn::CanSkipDisplayPrepare(LayerStack *layer_stack) {
     return false;
   }
 
-  // Compare the cached and calculated Frame ROIs.
-  bool same_roi = IsCongruent(left_frame_roi_, disp_layer_stack_->info.left_frame_roi.at(0)) &&
-                  IsCongruent(right_frame_roi_, disp_layer_stack_->info.right_frame_roi.at(0));
+  // Compare the cached and calculated Frame ROIs, panels taking several ROIs may get several. The
+  // lists are compared rather than the pixels they cover, since each ROI is programmed as is.
+  const std::vector<LayerRect> &left_frame_roi = disp_layer_stack_->info.left_frame_roi;
+  const std::vector<LayerRect> &right_frame_roi = disp_layer_stack_->info.right_frame_roi;
+  bool same_roi = (left_frame_roi_.size() == left_frame_roi.size()) &&
+                  (right_frame_roi_.size() == right_frame_roi.size());
+  for (uint32_t i = 0; same_roi && i < left_frame_roi.size(); i++) {
+    same_roi = IsCongruent(left_frame_roi_.at(i), left_frame_roi.at(i));
+  }
+  for (uint32_t i = 0; same_roi && i < right_frame_roi.size(); i++) {
+    same_roi = IsCongruent(right_frame_roi_.at(i), right_frame_roi.at(i));
+  }
 
   if (same_roi) {
     // Update Surface Damage rectangle(s) in HW layers.
@@ -3084,19 +3157,14 @@ DisplayError DisplayBuiltIn::ChangeFps() {
 
   uint32_t num_updating_layers = GetUpdatingLayersCount();
   bool one_updating_layer = (num_updating_layers == 1);
-  uint32_t refresh_rate = GetOptimalRefreshRate(one_updating_layer);
+  bool idle_screen = GetUpdatingAppLayersCount(disp_layer_stack_->stack) == 0;
+  uint32_t refresh_rate = GetOptimalRefreshRate(one_updating_layer, idle_screen);
 
   if (refresh_rate < hw_panel_info_.min_fps || refresh_rate > hw_panel_info_.max_fps) {
     DLOGE("Invalid Fps = %d request", refresh_rate);
     return kErrorParameters;
   }
 
-  bool idle_screen = GetUpdatingAppLayersCount(disp_layer_stack_->stack) == 0;
-  if (!disp_layer_stack_->stack->force_refresh_rate && IdleFallbackLowerFps(idle_screen) &&
-      !enable_qsync_idle_) {
-    refresh_rate = hw_panel_info_.min_fps;
-  }
-
   if (current_refresh_rate_ != refresh_rate) {
     DisplayError error = hw_intf_->SetRefreshRate(refresh_rate);
     if (error != kErrorNone) {
@@ -3135,10 +3203,7 @@ bool DisplayBuiltIn::IdleFallbackLowerFps(bool idle_screen) {
     return false;
   }
 
-  struct timespec now;
-  clock_gettime(CLOCK_MONOTONIC, &now);
-  uint64_t elapsed_time_ms = GetTimeInMs(now) - GetTimeInMs(idle_timer_start_);
-  bool can_lower = elapsed_time_ms >= UINT32(idle_time_ms_);
+  bool can_lower = timer_wheel_.HasExpired(lower_fps_timer_);
   DLOGV_IF(kTagDisplay, "display %d-%d , lower fps: %d", display_id_, display_type_, can_lower);
 
   return can_lower;
@@ -3156,19 +3221,82 @@ uint32_t DisplayBuiltIn::GetUpdatingLayersCount() {
   return updating_count;
 }
 
-uint32_t DisplayBuiltIn::GetOptimalRefreshRate(bool one_updating_layer) {
+uint32_t DisplayBuiltIn::GetOptimalRefreshRate(bool one_updating_layer, bool idle_screen) {
   LayerStack *layer_stack = disp_layer_stack_->stack;
-  if (layer_stack->force_refresh_rate) {
-    return layer_stack->force_refresh_rate;
+  RefreshRateInputs inputs;
+  inputs.min_rate = hw_panel_info_.min_fps;
+  inputs.max_rate = hw_panel_info_.max_fps;
+  inputs.default_rate = active_refresh_rate_;
+  inputs.forced_rate = layer_stack->force_refresh_rate;
+  if (one_updating_layer) {
+    inputs.metadata_rate = CalculateMetaDataRefreshRate();
+  }
+  inputs.content_rate = content_rate_;
+  inputs.idle = !inputs.forced_rate && IdleFallbackLowerFps(idle_screen) && !enable_qsync_idle_;
+  inputs.qsync = (active_qsync_mode_ != kQSyncModeNone);
+
+  refresh_rate_arbiter_.SetCurrentRate(current_refresh_rate_);
+  return refresh_rate_arbiter_.Select(inputs, GetPresentTime(layer_stack));
+}
+
+// Follows the cadence of the app layers, for content that submits below the panel rate without
+// frame rate metadata.
+void DisplayBuiltIn::UpdateContentCadence(LayerStack *layer_stack) {
+  if (!enable_content_cadence_ || !layer_stack->flags.layer_id_support) {
+    content_rate_ = 0;
+    return;
+  }
+
+  layer_presents_.clear();
+  for (auto layer : layer_stack->layers) {
+    if (layer->composition == kCompositionGPUTarget) {
+      break;
+    }
+    LayerPresent present;
+    present.layer_id = layer->layer_id;
+    present.updating = layer->flags.updating;
+    layer_presents_.push_back(present);
+  }
+
+  uint32_t content_rate = content_cadence_.Update(layer_presents_, GetPresentTime(layer_stack));
+  if (content_rate != content_rate_) {
+    DLOGI_IF(kTagDisplay, "Display %d-%d content rate %d", display_id_, display_type_,
+             content_rate);
+    content_rate_ = content_rate;
+  }
+}
+
+uint64_t DisplayBuiltIn::GetPresentTime(LayerStack *layer_stack) {
+  if (layer_stack->expected_present_time) {
+    return layer_stack->expected_present_time;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  int64_t now_ns = int64_t(now.tv_sec) * 1000000000 + now.tv_nsec;
+  std::lock_guard<std::mutex> guard(vsync_model_lock_);
+  int64_t present_ns = vsync_model_.GetExpectedPresentTime(now_ns);
+  return UINT64(present_ns ? present_ns : now_ns);
+}
+
+DisplayError DisplayBuiltIn::GetVSyncPrediction(int64_t timestamp_ns, uint32_t count,
+                                                VSyncPrediction *prediction) {
+  if (!prediction) {
+    return kErrorParameters;
   }
 
-  uint32_t metadata_refresh_rate = CalculateMetaDataRefreshRate();
-  if (layer_stack->flags.use_metadata_refresh_rate && one_updating_layer &&
-      metadata_refresh_rate) {
-    return metadata_refresh_rate;
+  std::lock_guard<std::mutex> guard(vsync_model_lock_);
+  if (!vsync_model_.IsValid()) {
+    return kErrorNotSupported;
   }
 
-  return active_refresh_rate_;
+  prediction->period_ns = vsync_model_.GetPeriod();
+  prediction->fitted = vsync_model_.IsFitted();
+  prediction->present_latency_ns = vsync_model_.GetPresentLatency();
+  prediction->expected_present_ns = vsync_model_.GetExpectedPresentTime(timestamp_ns);
+  vsync_model_.PredictVSyncs(timestamp_ns, count, &prediction->vsyncs_ns);
+
+  return kErrorNone;
 }
 
 uint32_t DisplayBuiltIn::CalculateMetaDataRefreshRate() {
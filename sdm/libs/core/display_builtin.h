@@ -45,6 +45,9 @@
 #include <private/panel_feature_factory_intf.h>
 #include <private/hw_events_interface.h>
 #include <private/display_event_proxy_intf.h>
+#include <utils/content_cadence.h>
+#include <utils/refresh_rate_arbiter.h>
+#include <utils/vsync_model.h>
 #include <string>
 #include <vector>
 
@@ -199,14 +202,19 @@ class DisplayBuiltIn : public DisplayBase, HWEventHandler, DppsPropIntf {
   DisplayError SetAlternateDisplayConfig(uint32_t *alt_config) override;
   DisplayError HandleSecureEvent(SecureEvent secure_event, bool *needs_refresh) override;
   DisplayError PostHandleSecureEvent(SecureEvent secure_event) override;
+  DisplayError GetVSyncPrediction(int64_t timestamp_ns, uint32_t count,
+                                  VSyncPrediction *prediction) override;
   void InitCWBBuffer();
   void DeinitCWBBuffer();
   void AppendCWBLayer(LayerStack *layer_stack);
   uint32_t GetUpdatingAppLayersCount(LayerStack *layer_stack);
   DisplayError ChangeFps();
   uint32_t GetUpdatingLayersCount();
-  uint32_t GetOptimalRefreshRate(bool one_updating_layer);
+  uint32_t GetOptimalRefreshRate(bool one_updating_layer, bool idle_screen);
   uint32_t CalculateMetaDataRefreshRate();
+  void UpdateContentCadence(LayerStack *layer_stack);
+  uint64_t GetPresentTime(LayerStack *layer_stack);
+  void UpdatePresentLatency();
   uint32_t SanitizeRefreshRate(uint32_t req_refresh_rate, uint32_t max_refresh_rate,
                                uint32_t min_refresh_rate);
   DisplayError UpdateTransferTime(uint32_t transfer_time) override;
@@ -263,6 +271,8 @@ class DisplayBuiltIn : public DisplayBase, HWEventHandler, DppsPropIntf {
   void HandleQsyncPostCommit();
   void UpdateQsyncMode();
   void SetVsyncStatus(bool enable);
+  bool NeedsVSync();
+  void HandleVSyncOffTimer();
   void SendBacklight();
   void SendDisplayConfigs();
   bool CanLowerFps(bool idle_screen);
@@ -292,8 +302,8 @@ class DisplayBuiltIn : public DisplayBase, HWEventHandler, DppsPropIntf {
   float cached_brightness_ = 0.0f;
   bool pending_brightness_ = false;
   recursive_mutex brightness_lock_;
-  LayerRect left_frame_roi_ = {};
-  LayerRect right_frame_roi_ = {};
+  std::vector<LayerRect> left_frame_roi_ = {};
+  std::vector<LayerRect> right_frame_roi_ = {};
   Locker dpps_pu_lock_;
   bool dpps_pu_nofiy_pending_ = false;
   enum class SamplingState { Off, On } samplingState = SamplingState::Off;
@@ -314,8 +324,19 @@ class DisplayBuiltIn : public DisplayBase, HWEventHandler, DppsPropIntf {
   QSyncMode active_qsync_mode_ = kQSyncModeNone;
   std::shared_ptr<IPCIntf> ipc_intf_ = nullptr;
   bool enhance_idle_time_ = false;
+  bool enable_content_cadence_ = false;
+  uint32_t content_rate_ = 0;
+  ContentCadenceTracker content_cadence_;
+  std::vector<LayerPresent> layer_presents_;
+  RefreshRateArbiter refresh_rate_arbiter_;
+  std::mutex vsync_model_lock_;
+  VSyncModel vsync_model_;
+  shared_ptr<Fence> pending_present_fence_ = nullptr;  // Retire fence of the last commit
+  int64_t pending_commit_ns_ = 0;
   int idle_time_ms_ = 0;
-  struct timespec idle_timer_start_;
+  uint32_t lower_fps_timer_ = 0;  // Expires once idle_time_ms_ has passed since the last commit
+  uint32_t vsync_off_delay_ms_ = 0;
+  uint32_t vsync_off_timer_ = 0;
   std::shared_ptr<DemuraIntf> demura_ = nullptr;
   bool demuratn_enabled_ = false;
   std::shared_ptr<DemuraTnCoreUvmIntf> demuratn_ = nullptr;
@@ -165,6 +165,8 @@ class DisplayNull : public DisplayInterface {
   MAKE_NO_OP(GetPanelFeatureInfo(PanelFeatureInfo *info));
   MAKE_NO_OP(PanelOprInfo(const std::string &client_name, bool enable,
                           SdmDisplayCbInterface<PanelOprPayload> *cb_intf));
+  MAKE_NO_OP(GetVSyncPrediction(int64_t timestamp_ns, uint32_t count,
+                                VSyncPrediction *prediction));
 
  protected:
   DisplayConfigVariableInfo default_variable_config_ = {};
@@ -617,6 +617,14 @@ DisplayError ResourceDefault::Config(DisplayResourceContext *display_resource_ct
   LayerRect src_rect = layer.src_rect;
   LayerRect dst_rect = layer.dst_rect;
 
+  // A partial update only fetches the part of the FB target inside the frame ROI.
+  if (layer_info.left_frame_roi.size() == 1) {
+    error = CropToFrameROI(layer, layer_info.left_frame_roi.at(0), &src_rect, &dst_rect);
+    if (error != kErrorNone) {
+      return error;
+    }
+  }
+
   error = ValidateDimensions(src_rect, dst_rect);
   if (error != kErrorNone) {
     return error;
@@ -726,6 +734,31 @@ bool ResourceDefault::CalculateCropRects(const LayerRect &scissor, LayerRect *cr
     return false;
 }
 
+DisplayError ResourceDefault::CropToFrameROI(const Layer &layer, const LayerRect &frame_roi,
+                                             LayerRect *src_rect, LayerRect *dst_rect) {
+  if (!IsValid(frame_roi)) {
+    return kErrorNone;
+  }
+
+  LayerRect dst = Intersection(*dst_rect, frame_roi);
+  if (!IsValid(dst)) {
+    DLOGV_IF(kTagResources, "FB layer is outside the frame ROI");
+    return kErrorNotSupported;
+  }
+  if (IsCongruent(dst, *dst_rect)) {
+    return kErrorNone;
+  }
+
+  // Map the cropped destination back to the source, then mirror it for the flips of the layer.
+  LayerRect src = {};
+  MapRect(*dst_rect, *src_rect, dst, &src);
+  TransformHV(*src_rect, src, layer.transform, &src);
+  *src_rect = src;
+  *dst_rect = dst;
+
+  return kErrorNone;
+}
+
 DisplayError ResourceDefault::ValidateLayerParams(const Layer *layer) {
   const LayerRect &src = layer->src_rect;
   const LayerRect &dst = layer->dst_rect;
@@ -210,6 +210,8 @@ class ResourceDefault : public ResourceInterface {
                              const LayerRect &src_rect, const LayerRect &dst_rect,
                              HWLayerConfig *layer_config);
   bool CalculateCropRects(const LayerRect &scissor, LayerRect *crop, LayerRect *dst);
+  DisplayError CropToFrameROI(const Layer &layer, const LayerRect &frame_roi,
+                              LayerRect *src_rect, LayerRect *dst_rect);
   DisplayError ValidateLayerParams(const Layer *layer);
   DisplayError ValidateDimensions(const LayerRect &crop, const LayerRect &dst);
   DisplayError ValidatePipeParams(HWPipeInfo *pipe_info, LayerBufferFormat format);
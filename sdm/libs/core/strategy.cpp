@@ -28,10 +28,13 @@
 
 #include <utils/constants.h>
 #include <utils/debug.h>
+#include <algorithm>
 #include <vector>
 
 #include "strategy.h"
 #include "utils/rect.h"
+#include "utils/region.h"
+#include "utils/roi_cluster.h"
 
 #define __CLASS__ "Strategy"
 
@@ -88,6 +91,7 @@ DisplayError Strategy::Deinit() {
 
 void Strategy::GenerateROI(DispLayerStack *disp_layer_stack, const PUConstraints &pu_constraints) {
   disp_layer_stack_ = disp_layer_stack;
+  pu_constraints_ = pu_constraints;
 
   if (partial_update_intf_) {
     partial_update_intf_->Start(pu_constraints);
@@ -190,6 +194,10 @@ void Strategy::GenerateROI() {
   disp_layer_stack_->info.left_frame_roi = {};
   disp_layer_stack_->info.right_frame_roi = {};
 
+  if (!split_display && GenerateDamageROI()) {
+    return;
+  }
+
   if (split_display) {
     float left_split = FLOAT(mixer_attributes_.split_left);
     disp_layer_stack_->info.left_frame_roi.push_back(LayerRect(0.0f, 0.0f,
@@ -203,6 +211,95 @@ void Strategy::GenerateROI() {
   }
 }
 
+// Without the extension every layer is composed by the GPU, so the screen changes only where the
+// updating layers are damaged. ResourceDefault crops the single FB target pipe to the frame ROI
+// and has no way to stitch several, so the damage is always covered by one ROI.
+bool Strategy::GenerateDamageROI() {
+  // Damage, metadata or color changes on a layer may touch pixels outside its damage.
+  const uint32_t kDamageOnlyMask = (1 << kSurfaceDamage) | (1 << kSurfaceInvalidate);
+
+  HWLayersInfo &info = disp_layer_stack_->info;
+  LayerStack *layer_stack = disp_layer_stack_->stack;
+  if (strategy_intf_ || !pu_constraints_.enable || !hw_panel_info_.partial_update ||
+      layer_stack->flags.geometry_changed || fb_config_.x_pixels != mixer_attributes_.width ||
+      fb_config_.y_pixels != mixer_attributes_.height) {
+    return false;
+  }
+
+  LayerRect domain = LayerRect(0.0f, 0.0f, FLOAT(mixer_attributes_.width),
+                               FLOAT(mixer_attributes_.height));
+  LayerTransform panel_transform = {};
+  panel_transform.flip_horizontal = hw_panel_info_.panel_orientation.flip_horizontal;
+  panel_transform.flip_vertical = hw_panel_info_.panel_orientation.flip_vertical;
+  std::vector<LayerRect> dirty_regions;
+  for (uint32_t i = 0; i < info.app_layer_count; i++) {
+    Layer *layer = layer_stack->layers.at(i);
+    if (layer->update_mask.to_ulong() & ~kDamageOnlyMask) {
+      return false;
+    }
+    if (!layer->flags.updating) {
+      continue;
+    }
+
+    // Empty damage is a full update of the layer. Rotated layers are taken whole, scaled ones get
+    // a pixel of margin for the filter.
+    std::vector<LayerRect> layer_dirty;
+    const LayerRect &src = layer->src_rect;
+    const LayerRect &dst = layer->dst_rect;
+    bool scaled = (src.right - src.left) != (dst.right - dst.left) ||
+                  (src.bottom - src.top) != (dst.bottom - dst.top);
+    if (layer->dirty_regions.empty() || layer->transform.rotation != 0.0f) {
+      layer_dirty.push_back(dst);
+    } else {
+      for (auto &dirty : layer->dirty_regions) {
+        LayerRect rect = Intersection(dirty, src);
+        if (!IsValid(rect)) {
+          continue;
+        }
+        TransformHV(src, rect, layer->transform, &rect);
+        MapRect(src, dst, rect, &rect);
+        if (scaled) {
+          rect = LayerRect(rect.left - 1.0f, rect.top - 1.0f, rect.right + 1.0f,
+                           rect.bottom + 1.0f);
+        }
+        layer_dirty.push_back(rect);
+      }
+    }
+
+    for (auto &rect : layer_dirty) {
+      LayerRect panel_rect = {};
+      TransformHV(domain, rect, panel_transform, &panel_rect);
+      dirty_regions.push_back(panel_rect);
+    }
+  }
+
+  RoiClusterConfig config;
+  config.max_rois = 1;
+  config.left_align = UINT32(std::max(hw_panel_info_.left_align, 1));
+  config.width_align = UINT32(std::max(hw_panel_info_.width_align, 1));
+  config.top_align = UINT32(std::max(hw_panel_info_.top_align, 1));
+  config.height_align = UINT32(std::max(hw_panel_info_.height_align, 1));
+  config.min_width = UINT32(std::max(hw_panel_info_.min_roi_width, 1));
+  config.min_height = UINT32(std::max(hw_panel_info_.min_roi_height, 1));
+
+  // Layers stacked over each other often report the same damage, bound the disjoint union.
+  Region damage = Region(dirty_regions).Intersect(Region(domain));
+  if (damage.IsEmpty()) {
+    return false;
+  }
+
+  std::vector<LayerRect> rois;
+  ClusterDirtyRegions(damage.GetRects(), domain, config, &rois);
+  if (rois.empty() || GetRoiCost(rois, config) >= GetRoiCost({domain}, config)) {
+    return false;
+  }
+
+  info.left_frame_roi.push_back(rois.at(0));
+  info.right_frame_roi.push_back(LayerRect(0.0f, 0.0f, 0.0f, 0.0f));
+
+  return true;
+}
+
 DisplayError Strategy::Reconfigure(const HWPanelInfo &hw_panel_info,
                                    const HWDisplayAttributes &display_attributes,
                                    const HWMixerAttributes &mixer_attributes,
@@ -210,6 +307,10 @@ DisplayError Strategy::Reconfigure(const HWPanelInfo &hw_panel_info,
   DisplayError error = kErrorNone;
 
   if (!extension_intf_) {
+    hw_panel_info_ = hw_panel_info;
+    display_attributes_ = display_attributes;
+    mixer_attributes_ = mixer_attributes;
+    fb_config_ = fb_config;
     return kErrorNone;
   }
 
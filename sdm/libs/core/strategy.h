@@ -68,6 +68,7 @@ class Strategy {
 
  private:
   void GenerateROI();
+  bool GenerateDamageROI();
 
   ExtensionInterface *extension_intf_ = NULL;
   StrategyInterface *strategy_intf_ = NULL;
@@ -77,6 +78,7 @@ class Strategy {
   HWResourceInfo hw_resource_info_;
   HWPanelInfo hw_panel_info_;
   DispLayerStack *disp_layer_stack_ = NULL;
+  PUConstraints pu_constraints_ = {};
   HWMixerAttributes mixer_attributes_ = {};
   HWDisplayAttributes display_attributes_ = {};
   DisplayConfigVariableInfo fb_config_ = {};
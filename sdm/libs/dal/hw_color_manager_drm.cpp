@@ -67,6 +67,7 @@
 
 #include <array>
 #include <map>
+#include <cstddef>
 #include <cstring>
 #include <vector>
 #include <new>
@@ -75,6 +76,7 @@
 #include <display/drm/msm_drm_pp.h>
 #endif
 #include <utils/debug.h>
+#include <utils/pp_table.h>
 #include "hw_color_manager_drm.h"
 
 #ifdef PP_DRM_ENABLE
@@ -386,6 +388,12 @@ void HWColorManagerDrm::FreeDrmFeatureData(DRMPPFeatureInfo *feature) {
   }
 }
 
+DrmPPFeatureSet::~DrmPPFeatureSet() {
+  for (auto &feature : features) {
+    color_mgr->FreeDrmFeatureData(&feature.info);
+  }
+}
+
 DisplayError HWColorManagerDrm::GetDrmPCC(const PPFeatureInfo &in_data,
                                           DRMPPFeatureInfo *out_data) {
   DisplayError ret = kErrorNone;
@@ -1064,11 +1072,14 @@ DisplayError HWColorManagerDrm::GetDrmGamut(const PPFeatureInfo &in_data,
                 sizeof(uint32_t) * GAMUT_3D_SCALE_OFF_SZ);
   }
 
+  // The table length depends on the mode, so interleave the entries explicitly rather than leave
+  // the runtime bound loop to the compiler.
+  static_assert(sizeof(mdp_gamut->col[0][0]) == 2 * sizeof(uint32_t) &&
+                offsetof(drm_msm_3d_gamut_entry, c2_c1) == sizeof(uint32_t),
+                "Gamut entry is not a c0, c2_c1 pair");
   for (uint32_t row = 0; row < GAMUT_3D_TBL_NUM; row++) {
-    for (uint32_t col = 0; col < size; col++) {
-      mdp_gamut->col[row][col].c0 = sde_gamut->c0_data[row][col];
-      mdp_gamut->col[row][col].c2_c1 = sde_gamut->c1_c2_data[row][col];
-    }
+    InterleavePPTables(sde_gamut->c0_data[row], sde_gamut->c1_c2_data[row], size,
+                       &mdp_gamut->col[row][0].c0);
   }
   out_data->payload = mdp_gamut;
 #endif
@@ -101,6 +101,22 @@ class HWColorManagerDrm {
                                                       DRMPPFeatureInfo *out_data);
 };
 
+// DRM PP features converted for a color mode, kept to be set again without converting them.
+struct DrmPPFeatureSet {
+  struct Feature {
+    DRMPPFeatureInfo info = {};
+    bool crtc_feature = true;
+  };
+
+  explicit DrmPPFeatureSet(HWColorManagerDrm *color_mgr) : color_mgr(color_mgr) {}
+  ~DrmPPFeatureSet();
+
+  HWColorManagerDrm *color_mgr = nullptr;
+  std::vector<Feature> features;
+  uint32_t feature_mask = 0;  // Bit per PPGlobalColorFeatureID
+  size_t bytes = 0;
+};
+
 }  // namespace sdm
 
 #endif  // __HW_COLOR_MANAGER_DRM_H__
@@ -61,6 +61,8 @@
 #include <utils/rect.h>
 #include <utils/utils.h>
 #include <utils/fence.h>
+#include <utils/stage_latency.h>
+#include <utils/startup_timeline.h>
 #include <private/hw_info_interface.h>
 #include <dirent.h>
 
@@ -528,6 +530,8 @@ HWDeviceDRM::HWDeviceDRM(BufferAllocator *buffer_allocator, HWInfoInterface *hw_
 }
 
 DisplayError HWDeviceDRM::Init() {
+  ScopedStartupStage startup_stage(std::string("HWDeviceDRM::Init ") +
+                                   (device_name_ ? device_name_ : ""));
   int ret = 0;
   DRMMaster *drm_master = {};
   DRMMaster::GetInstance(&drm_master);
@@ -616,6 +620,14 @@ DisplayError HWDeviceDRM::Init() {
   Debug::GetProperty(ENABLE_BRIGHTNESS_DRM_PROP, &value);
   enable_brightness_drm_prop_ = (value == 1);
 
+  value = 0;
+  Debug::GetProperty(ENABLE_MEASURED_QSYNC_HOLD, &value);
+  measured_qsync_hold_ = (value == 1);
+
+  value = kPPFeatureCacheKB;
+  Debug::GetProperty(PP_FEATURE_CACHE_KB, &value);
+  pp_feature_cache_.SetBudget(size_t(std::max(value, 0)) * 1024);
+
   return kErrorNone;
 }
 
@@ -1432,6 +1444,7 @@ void HWDeviceDRM::SetupAtomic(Fence::ScopedRef &scoped_ref, HWLayersInfo *hw_lay
   }
 
   DTRACE_SCOPED();
+  ScopedStageLatency stage_latency(display_id_, kStageSetupAtomic);
   uint32_t hw_layer_count = UINT32(hw_layers_info->hw_layers.size());
   HWQosData &qos_data = hw_layers_info->qos_data;
   DRMSecurityLevel crtc_security_level = DRMSecurityLevel::SECURE_NON_SECURE;
@@ -1451,13 +1464,15 @@ void HWDeviceDRM::SetupAtomic(Fence::ScopedRef &scoped_ref, HWLayersInfo *hw_lay
     if (IsFullFrameUpdate(*hw_layers_info)) {
       ResetROI();
     } else {
-      const int kNumMaxROIs = 4;
-      DRMRect crtc_rects[kNumMaxROIs] = {{0, 0, mixer_attributes_.width, mixer_attributes_.height}};
-      DRMRect conn_rects[kNumMaxROIs] = {{0, 0, display_attributes_[index].x_pixels,
-                                          display_attributes_[index].y_pixels}};
-      DRMRect spr_rects[kNumMaxROIs] = {{0, 0, mixer_attributes_.width, mixer_attributes_.height}};
-
-      for (uint32_t i = 0; i < hw_layers_info->left_frame_roi.size(); i++) {
+      DRMRect crtc_rects[kMaxFrameROIs] = {{0, 0, mixer_attributes_.width,
+                                            mixer_attributes_.height}};
+      DRMRect conn_rects[kMaxFrameROIs] = {{0, 0, display_attributes_[index].x_pixels,
+                                            display_attributes_[index].y_pixels}};
+      DRMRect spr_rects[kMaxFrameROIs] = {{0, 0, mixer_attributes_.width,
+                                           mixer_attributes_.height}};
+      uint32_t num_rects = std::min(kMaxFrameROIs, UINT32(hw_layers_info->left_frame_roi.size()));
+
+      for (uint32_t i = 0; i < num_rects; i++) {
         auto &roi = hw_layers_info->left_frame_roi.at(i);
         // TODO(user): In multi PU, stitch ROIs vertically adjacent and upate plane destination
         crtc_rects[i].left = UINT32(roi.left);
@@ -1474,7 +1489,7 @@ void HWDeviceDRM::SetupAtomic(Fence::ScopedRef &scoped_ref, HWLayersInfo *hw_lay
         spr_rects[i].bottom = UINT32(roi.bottom);
       }
 
-      uint32_t num_rects = std::max(1u, UINT32(hw_layers_info->left_frame_roi.size()));
+      num_rects = std::max(1u, num_rects);
       drm_atomic_intf_->Perform(DRMOps::CRTC_SET_ROI, token_.crtc_id, num_rects, crtc_rects,
                                 spr_rects);
       drm_atomic_intf_->Perform(DRMOps::CONNECTOR_SET_ROI, token_.conn_id, num_rects, conn_rects);
@@ -1928,6 +1943,7 @@ void HWDeviceDRM::ClearSolidfillStages() {
 
 DisplayError HWDeviceDRM::Validate(HWLayersInfo *hw_layers_info) {
   DTRACE_SCOPED();
+  ScopedStageLatency stage_latency(display_id_, kStageValidate);
 
   DisplayError err = kErrorNone;
   int ret = registry_.Register(hw_layers_info);
@@ -2041,9 +2057,16 @@ DisplayError HWDeviceDRM::AtomicCommit(HWLayersInfo *hw_layers_info) {
     uint64_t qsync_fps_period = (1000.0f / FLOAT(connector_info_.qsync_fps)) * 1000000;
     if (hw_layers_info->expected_present_time > current_time) {
       if ((hw_layers_info->expected_present_time - current_time) > qsync_fps_period) {
+        // Hold the commit for a vsync period, or when enabled for as long as it is measured to
+        // take to present, with some margin.
         uint64_t vsync_period = display_attributes_[current_mode_index_].vsync_period_ns;
-        if (hw_layers_info->expected_present_time > vsync_period) {
-          elapse_timestamp = hw_layers_info->expected_present_time - vsync_period;
+        uint64_t lead = vsync_period;
+        if (measured_qsync_hold_ && hw_layers_info->present_latency_ns) {
+          lead = hw_layers_info->present_latency_ns + kPresentLatencyMarginNs;
+          lead = (lead < vsync_period) ? lead : vsync_period;
+        }
+        if (hw_layers_info->expected_present_time > lead) {
+          elapse_timestamp = hw_layers_info->expected_present_time - lead;
         }
       }
     }
@@ -2053,7 +2076,11 @@ DisplayError HWDeviceDRM::AtomicCommit(HWLayersInfo *hw_layers_info) {
     usleep(UINT32((elapse_timestamp - current_time) / 1000));
   }
 
+  // Present latency is measured from here, after any qsync hold.
+  uint64_t commit_start = StageLatency::Now();
+  hw_layers_info->commit_time_ns = commit_start;
   int ret = drm_atomic_intf_->Commit(sync_commit, false /* retain_planes*/);
+  StageLatency::Record(display_id_, kStageAtomicCommit, commit_start, StageLatency::Now());
   shared_ptr<Fence> release_fence = Fence::Create(INT(release_fence_fd), "release");
   shared_ptr<Fence> retire_fence = Fence::Create(INT(retire_fence_fd), "retire");
   if (ret) {
@@ -2399,9 +2426,69 @@ DisplayError HWDeviceDRM::SetPPFeature(PPFeatureInfo *feature) {
       drm_atomic_intf_->Perform(DRMOps::CONNECTOR_SET_POST_PROC,
                                 token_.conn_id, &kernel_params);
 
+    if (pp_cache_pending_ && !ret) {
+      // The set takes over the payload.
+      pp_cache_pending_->features.push_back({kernel_params, crtc_feature});
+      pp_cache_pending_->bytes += sizeof(kernel_params) + kernel_params.payload_size;
+      kernel_params.payload = nullptr;
+    }
+
     hw_color_mgr_->FreeDrmFeatureData(&kernel_params);
   }
 
+  if (pp_cache_pending_) {
+    pp_cache_pending_->feature_mask |= 1U << feature->feature_id_;
+  }
+
+  return kErrorNone;
+}
+
+DisplayError HWDeviceDRM::SetPPFeatureCacheKey(uint64_t cache_key) {
+  if (pp_cache_pending_) {
+    size_t bytes = pp_cache_pending_->bytes;
+    pp_feature_cache_.Insert(pp_cache_key_, std::move(pp_cache_pending_), bytes);
+    pp_cache_pending_ = nullptr;
+  }
+
+  pp_cache_key_ = cache_key;
+  if (cache_key && hw_color_mgr_) {
+    pp_cache_pending_.reset(new DrmPPFeatureSet(hw_color_mgr_.get()));
+  }
+
+  return kErrorNone;
+}
+
+DisplayError HWDeviceDRM::GetCachedPPFeatures(uint64_t cache_key, uint32_t *feature_mask) {
+  auto cached = pp_feature_cache_.Find(cache_key);
+  auto &stats = pp_feature_cache_.GetStats();
+  DLOGI_IF(kTagQDCM, "PP features %s, hit rate %u%% of %" PRIu64 ", %zu bytes in %zu sets",
+           cached ? "cached" : "not cached", pp_feature_cache_.GetHitRate(),
+           stats.hits + stats.misses, stats.bytes, stats.count);
+  if (!cached) {
+    return kErrorParameters;
+  }
+
+  *feature_mask = (*cached)->feature_mask;
+
+  return kErrorNone;
+}
+
+DisplayError HWDeviceDRM::SetCachedPPFeatures(uint64_t cache_key) {
+  auto cached = pp_feature_cache_.Peek(cache_key);
+  if (!cached) {
+    return kErrorParameters;
+  }
+
+  for (auto &feature : (*cached)->features) {
+    // The payload is copied into a blob, the cached one stays as it was.
+    DRMPPFeatureInfo kernel_params = feature.info;
+    if (feature.crtc_feature) {
+      drm_atomic_intf_->Perform(DRMOps::CRTC_SET_POST_PROC, token_.crtc_id, &kernel_params);
+    } else {
+      drm_atomic_intf_->Perform(DRMOps::CONNECTOR_SET_POST_PROC, token_.conn_id, &kernel_params);
+    }
+  }
+
   return kErrorNone;
 }
 
@@ -3404,16 +3491,16 @@ void HWDeviceDRM::ConfigureConcurrentWriteback(const HWLayersInfo &hw_layer_info
       drm_atomic_intf_->Perform(DRMOps::CONNECTOR_SET_ROI, vitual_conn_id, 0, nullptr);
       DLOGV_IF(kTagDriverConfig, "roi_v1 of virtual connector is set NULL (Full Frame update).");
     } else {
-      const int kNumMaxROIs = 4;
-      sde_drm::DRMRect conn_rects[kNumMaxROIs] = {full_frame};
-      for (uint32_t i = 0; i < hw_layer_info.left_frame_roi.size(); i++) {
+      sde_drm::DRMRect conn_rects[kMaxFrameROIs] = {full_frame};
+      uint32_t num_rects = std::min(kMaxFrameROIs, UINT32(hw_layer_info.left_frame_roi.size()));
+      for (uint32_t i = 0; i < num_rects; i++) {
         auto &roi = hw_layer_info.left_frame_roi.at(i);
         conn_rects[i].left = UINT32(roi.left);
         conn_rects[i].right = UINT32(roi.right);
         conn_rects[i].top = UINT32(roi.top);
         conn_rects[i].bottom = UINT32(roi.bottom);
       }
-      uint32_t num_rects = std::max(1u, UINT32(hw_layer_info.left_frame_roi.size()));
+      num_rects = std::max(1u, num_rects);
       drm_atomic_intf_->Perform(DRMOps::CONNECTOR_SET_ROI, vitual_conn_id, num_rects, conn_rects);
     }
 
@@ -67,6 +67,7 @@
 #define __HW_DEVICE_DRM_H__
 
 #include <utils/formats.h>
+#include <utils/lru_cache.h>
 #include <private/hw_interface.h>
 #include <drm_interface.h>
 #include <errno.h>
@@ -145,6 +146,9 @@ class HWDeviceDRM : public HWInterface {
   void PostCommitConcurrentWriteback(std::shared_ptr<LayerBuffer> output_buffer);
   virtual DisplayError GetPPFeaturesVersion(PPFeatureVersion *vers);
   virtual DisplayError SetPPFeature(PPFeatureInfo *feature);
+  virtual DisplayError SetPPFeatureCacheKey(uint64_t cache_key);
+  virtual DisplayError GetCachedPPFeatures(uint64_t cache_key, uint32_t *feature_mask);
+  virtual DisplayError SetCachedPPFeatures(uint64_t cache_key);
   // This API is no longer supported, expectation is to call the correct API on HWEvents
   virtual DisplayError SetVSyncState(bool enable);
   virtual void SetIdleTimeoutMs(uint32_t timeout_ms);
@@ -225,6 +229,9 @@ class HWDeviceDRM : public HWInterface {
   static const int kMaxStringLength = 1024;
   static const int kNumPhysicalDisplays = 2;
   static const int kMaxSysfsCommandLength = 12;
+  // Added to the measured commit latency when holding a commit for its expected present time.
+  static const uint64_t kPresentLatencyMarginNs = 1000000;
+  static const int kPPFeatureCacheKB = 512;
 
   DisplayError SetFormat(const LayerBufferFormat &source, uint32_t *target);
   DisplayError SetStride(HWDeviceType device_type, LayerBufferFormat format, uint32_t width,
@@ -376,6 +383,7 @@ class HWDeviceDRM : public HWInterface {
   uint32_t transfer_time_updated_ = 0;
   bool force_tonemapping_ = false;
   bool enable_brightness_drm_prop_ = false;
+  bool measured_qsync_hold_ = false;
   int cached_brightness_level_ = -1;
   int current_brightness_ = -1;
   bool seamless_mode_switch_ = false;
@@ -392,6 +400,9 @@ class HWDeviceDRM : public HWInterface {
   bool autorefresh_ = false;
   std::unique_ptr<HWColorManagerDrm> hw_color_mgr_ = {};
   float aspect_ratio_threshold_ = 1.0;
+  uint64_t pp_cache_key_ = 0;
+  std::unique_ptr<DrmPPFeatureSet> pp_cache_pending_ = {};  // Features set under pp_cache_key_
+  LruCache<std::unique_ptr<DrmPPFeatureSet>> pp_feature_cache_;
 };
 
 }  // namespace sdm
@@ -338,6 +338,8 @@ DisplayError HWInfoDRM::GetHWResourceInfo(HWResourceInfo *hw_resource) {
           hw_resource->dyn_bw_info.pipe_bw_limit[index]);
   }
 
+  PopulateFormatSets(hw_resource);
+
   if (!hw_resource_) {
     hw_resource_ = new HWResourceInfo();
     *hw_resource_ = *hw_resource;
@@ -660,9 +662,30 @@ void HWInfoDRM::PopulateSupportedFmts(HWSubBlockType sub_blk_type,
 void HWInfoDRM::PopulateSupportedInlineFmts(const sde_drm::DRMPlaneTypeInfo &info,
                                             HWResourceInfo *hw_resource) {
   vector<LayerBufferFormat> *inrot_fmts = &hw_resource->inline_rot_info.inrot_fmts_supported;
+  vector<LayerBufferFormat> sdm_formats;
 
+  // Every VIG plane reports the same list, keep each format once.
+  FormatSet known_formats;
+  for (auto &format : *inrot_fmts) {
+    known_formats.Insert(format);
+  }
   for (auto &fmts : info.inrot_fmts_supported) {
-    GetSDMFormat(fmts.first, fmts.second, inrot_fmts);
+    GetSDMFormat(fmts.first, fmts.second, &sdm_formats);
+  }
+  for (auto &format : sdm_formats) {
+    if (known_formats.Insert(format)) {
+      inrot_fmts->push_back(format);
+    }
+  }
+}
+
+void HWInfoDRM::PopulateFormatSets(HWResourceInfo *hw_resource) {
+  hw_resource->supported_format_sets.clear();
+  for (auto &it : hw_resource->supported_formats_map) {
+    FormatSet &format_set = hw_resource->supported_format_sets[it.first];
+    for (auto &format : it.second) {
+      format_set.Insert(format);
+    }
   }
 }
 
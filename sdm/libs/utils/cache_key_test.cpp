@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <utils/cache_key.h>
+#include <utils/lru_cache.h>
+
+#include <string>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+// The inputs a color mode's PP features are keyed on.
+struct ModeInputs {
+  uint32_t generation = 1;
+  int32_t mode_id = 3;
+  std::vector<std::string> hw_assets = {"PCC", "Gamut", "IGC"};
+  uint32_t x_pixels = 1080;
+  uint32_t y_pixels = 2400;
+  uint32_t fps = 60;
+  int panel_mode = 1;
+};
+
+uint64_t ModeKey(const ModeInputs &inputs) {
+  CacheKey key;
+  key.Add(inputs.generation).Add(inputs.mode_id);
+  for (auto &hw_asset : inputs.hw_assets) {
+    key.Add(hw_asset);
+  }
+  key.Add(inputs.x_pixels).Add(inputs.y_pixels).Add(inputs.fps).Add(inputs.panel_mode);
+  return key.Get();
+}
+
+TEST(CacheKeyTest, SameInputsHit) {
+  LruCache<int> cache(1024);
+  ModeInputs inputs;
+  cache.Insert(ModeKey(inputs), 7, 4);
+
+  int *value = cache.Find(ModeKey(ModeInputs()));
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, 7);
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+  EXPECT_EQ(cache.GetStats().misses, 0u);
+}
+
+TEST(CacheKeyTest, PanelStateChangeMisses) {
+  LruCache<int> cache(1024);
+  cache.Insert(ModeKey(ModeInputs()), 7, 4);
+
+  ModeInputs refresh_rate;
+  refresh_rate.fps = 120;
+  ModeInputs resolution;
+  resolution.x_pixels = 1440;
+  resolution.y_pixels = 3200;
+  ModeInputs panel_mode;
+  panel_mode.panel_mode = 2;
+  ModeInputs generation;
+  generation.generation = 2;
+  for (auto &inputs : {refresh_rate, resolution, panel_mode, generation}) {
+    EXPECT_EQ(cache.Find(ModeKey(inputs)), nullptr);
+  }
+  EXPECT_EQ(cache.GetStats().hits, 0u);
+  EXPECT_EQ(cache.GetStats().misses, 4u);
+}
+
+TEST(CacheKeyTest, StringsDoNotRunTogether) {
+  CacheKey first;
+  first.Add(std::string("ab")).Add(std::string("c"));
+  CacheKey second;
+  second.Add(std::string("a")).Add(std::string("bc"));
+  EXPECT_NE(first.Get(), second.Get());
+}
+
+TEST(CacheKeyTest, MatchesCrc64Check) {
+  CacheKey key;
+  for (char c : std::string("123456789")) {
+    key.Add(c);
+  }
+  EXPECT_EQ(key.Get(), 0x995dc9bbdf1939faULL);
+}
+
+TEST(CacheKeyTest, NeverZero) {
+  EXPECT_NE(CacheKey().Get(), 0u);
+  EXPECT_NE(ModeKey(ModeInputs()), 0u);
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/constants.h>
+#include <utils/content_cadence.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#define __CLASS__ "ContentCadence"
+
+namespace sdm {
+
+// Fewer intervals than this give no estimate.
+static const uint32_t kMinIntervals = 8;
+// A gap this long is a pause in the content, not a slow cadence.
+static const uint64_t kMaxIntervalNs = 250000000;
+// A layer last presented longer ago than this is static and has no say in the rate.
+static const uint64_t kActiveNs = 300000000;
+// Intervals further than this factor from the median are dropped or doubled frames.
+static const float kOutlierRatio = 1.6f;
+// The halves of the window may differ this much in rate. Presents are quantized to vsync, which
+// alone moves the rate of a half by a few percent.
+static const float kSteadyTolerance = 0.1f;
+// The rate of the whole window may differ this much from the standard rate it is taken for.
+static const float kSnapTolerance = 0.04f;
+// Consecutive estimates of the same rate needed before it is reported.
+static const uint32_t kConfirmFrames = 8;
+
+static const uint32_t kStandardRates[] = {24, 25, 30, 48, 50, 60, 72, 90, 96, 120, 144};
+
+static uint32_t SnapToStandardRate(float rate) {
+  uint32_t nearest = 0;
+  float nearest_error = kSnapTolerance;
+  for (uint32_t standard : kStandardRates) {
+    float error = fabsf(rate - FLOAT(standard)) / FLOAT(standard);
+    if (error < nearest_error) {
+      nearest = standard;
+      nearest_error = error;
+    }
+  }
+  return nearest;
+}
+
+void CadenceDetector::AddPresent(uint64_t timestamp_ns) {
+  if (last_present_ns_ && timestamp_ns <= last_present_ns_) {
+    return;
+  }
+
+  uint64_t interval = timestamp_ns - last_present_ns_;
+  bool paused = !last_present_ns_ || interval > kMaxIntervalNs;
+  last_present_ns_ = timestamp_ns;
+  if (paused) {
+    interval_count_ = 0;
+    candidate_ = 0;
+    candidate_frames_ = 0;
+    rate_ = 0;
+    return;
+  }
+
+  intervals_[interval_count_ % kWindow] = interval;
+  interval_count_++;
+
+  // An unsteady window keeps the current rate, so the rate only moves once a new cadence has held
+  // for a while.
+  uint32_t estimate = Estimate();
+  if (!estimate) {
+    candidate_frames_ = 0;
+    return;
+  }
+  if (estimate != candidate_) {
+    candidate_ = estimate;
+    candidate_frames_ = 0;
+  }
+  if (++candidate_frames_ >= kConfirmFrames) {
+    rate_ = candidate_;
+  }
+}
+
+void CadenceDetector::Reset() {
+  *this = CadenceDetector();
+}
+
+uint32_t CadenceDetector::Estimate() const {
+  uint32_t count = (interval_count_ < kWindow) ? interval_count_ : kWindow;
+  if (count < kMinIntervals) {
+    return 0;
+  }
+
+  uint64_t ordered[kWindow];
+  uint32_t first = interval_count_ - count;
+  for (uint32_t i = 0; i < count; i++) {
+    ordered[i] = intervals_[(first + i) % kWindow];
+  }
+
+  // Lower median, so that alternating intervals of a pulldown both stay within the outlier ratio.
+  uint64_t sorted[kWindow];
+  std::copy(ordered, ordered + count, sorted);
+  std::nth_element(sorted, sorted + (count - 1) / 2, sorted + count);
+  float median = FLOAT(sorted[(count - 1) / 2]);
+
+  uint64_t sum[2] = {};
+  uint32_t kept[2] = {};
+  for (uint32_t i = 0; i < count; i++) {
+    float interval = FLOAT(ordered[i]);
+    if (interval > median * kOutlierRatio || interval * kOutlierRatio < median) {
+      continue;
+    }
+    uint32_t half = (2 * i < count) ? 0 : 1;
+    sum[half] += ordered[i];
+    kept[half]++;
+  }
+  if (kept[0] < kMinIntervals / 2 - 1 || kept[1] < kMinIntervals / 2 - 1) {
+    return 0;
+  }
+
+  float rate[2];
+  for (uint32_t half = 0; half < 2; half++) {
+    rate[half] = 1e9f * FLOAT(kept[half]) / FLOAT(sum[half]);
+  }
+  if (rate[0] > rate[1] * (1.0f + kSteadyTolerance) ||
+      rate[1] > rate[0] * (1.0f + kSteadyTolerance)) {
+    return 0;
+  }
+
+  float mean_rate = 1e9f * FLOAT(kept[0] + kept[1]) / FLOAT(sum[0] + sum[1]);
+  return SnapToStandardRate(mean_rate);
+}
+
+uint32_t ContentCadenceTracker::Update(const std::vector<LayerPresent> &layers,
+                                       uint64_t timestamp_ns) {
+  uint32_t content_rate = 0;
+  bool unknown = false;
+  for (auto &layer : layers) {
+    CadenceDetector &detector = detectors_[layer.layer_id];
+    if (layer.updating) {
+      detector.AddPresent(timestamp_ns);
+    }
+    uint64_t last_present = detector.GetLastPresent();
+    if (!last_present || timestamp_ns - last_present > kActiveNs) {
+      continue;
+    }
+    if (!detector.GetRate()) {
+      unknown = true;
+    }
+    content_rate = std::max(content_rate, detector.GetRate());
+  }
+
+  if (detectors_.size() > layers.size()) {
+    stale_ids_.clear();
+    for (auto &entry : detectors_) {
+      auto match = [&entry](const LayerPresent &layer) { return layer.layer_id == entry.first; };
+      if (std::find_if(layers.begin(), layers.end(), match) == layers.end()) {
+        stale_ids_.push_back(entry.first);
+      }
+    }
+    for (uint64_t id : stale_ids_) {
+      detectors_.erase(id);
+    }
+  }
+
+  return unknown ? 0 : content_rate;
+}
+
+}  // namespace sdm
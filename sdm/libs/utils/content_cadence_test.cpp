@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <utils/constants.h>
+#include <utils/content_cadence.h>
+#include <utils/refresh_rate_arbiter.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+const uint64_t kMs = 1000000;
+
+// A 120 Hz panel switching between 30 and 120 Hz.
+const uint32_t kMinRate = 30;
+const uint32_t kMaxRate = 120;
+
+struct Present {
+  uint64_t timestamp_ns;
+  uint64_t layer_id;
+};
+
+// Frame rate of a 23.976 fps video as presented on a 60 Hz panel, in vsyncs per frame. Recorded
+// from a player, with a repeated and a late frame.
+const uint8_t kRecordedVideoVsyncs[] = {
+  2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 3, 2,
+  3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 5, 2, 3, 2, 3, 2, 3, 2,
+  3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2,
+};
+
+class CadenceSimulation {
+ public:
+  // Adds presents of a layer at the given rate from start for duration, aligned to a panel vsync.
+  void AddCadence(uint64_t layer_id, float rate, uint64_t start_ns, uint64_t duration_ns,
+                  float vsync_rate = 120.0f, uint64_t seed = 0, uint64_t jitter_ns = 0) {
+    std::mt19937 rng(static_cast<uint32_t>(seed));
+    double vsync_ns = 1e9 / vsync_rate;
+    for (double t = 0; t < double(duration_ns); t += 1e9 / rate) {
+      double jitter = jitter_ns ? double(rng() % (2 * jitter_ns)) - double(jitter_ns) : 0;
+      double vsync = std::ceil((t + jitter) / vsync_ns);
+      presents_.push_back({start_ns + uint64_t(std::max(vsync, 0.0) * vsync_ns), layer_id});
+    }
+  }
+
+  void AddVsyncTrace(uint64_t layer_id, const uint8_t *vsyncs, size_t count, uint64_t start_ns) {
+    double vsync_ns = 1e9 / 60.0;
+    double t = 0;
+    for (size_t i = 0; i < count; i++) {
+      presents_.push_back({start_ns + uint64_t(t), layer_id});
+      t += vsyncs[i] * vsync_ns;
+    }
+  }
+
+  // Replays all presents in order, one frame per distinct timestamp. Returns the rate selected
+  // for each frame.
+  std::vector<uint32_t> Run(uint32_t metadata_rate = 0) {
+    std::stable_sort(presents_.begin(), presents_.end(),
+                     [](const Present &a, const Present &b) {
+                       return a.timestamp_ns < b.timestamp_ns;
+                     });
+    std::map<uint64_t, bool> stack;
+    for (auto &present : presents_) {
+      stack[present.layer_id] = false;
+    }
+
+    std::vector<uint32_t> rates;
+    arbiter_.SetCurrentRate(kMaxRate);
+    for (size_t i = 0; i < presents_.size();) {
+      uint64_t timestamp = presents_[i].timestamp_ns;
+      for (auto &entry : stack) {
+        entry.second = false;
+      }
+      for (; i < presents_.size() && presents_[i].timestamp_ns == timestamp; i++) {
+        stack[presents_[i].layer_id] = true;
+      }
+
+      std::vector<LayerPresent> layers;
+      for (auto &entry : stack) {
+        LayerPresent layer;
+        layer.layer_id = entry.first;
+        layer.updating = entry.second;
+        layers.push_back(layer);
+      }
+
+      RefreshRateInputs inputs;
+      inputs.min_rate = kMinRate;
+      inputs.max_rate = kMaxRate;
+      inputs.default_rate = kMaxRate;
+      inputs.metadata_rate = metadata_rate;
+      inputs.content_rate = tracker_.Update(layers, timestamp);
+      rates.push_back(arbiter_.Select(inputs, timestamp));
+    }
+    return rates;
+  }
+
+  uint32_t GetSwitchCount() const { return arbiter_.GetSwitchCount(); }
+
+ private:
+  std::vector<Present> presents_;
+  ContentCadenceTracker tracker_;
+  RefreshRateArbiter arbiter_;
+};
+
+TEST(CadenceDetectorTest, DetectsStandardRates) {
+  const float kRates[] = {24.0f, 30.0f, 48.0f, 60.0f};
+  for (float rate : kRates) {
+    CadenceDetector detector;
+    for (uint32_t frame = 0; frame < 48; frame++) {
+      uint64_t vsync = uint64_t(std::ceil(FLOAT(frame) * 120.0f / rate));
+      detector.AddPresent(1000 * kMs + vsync * 1000000000 / 120);
+    }
+    EXPECT_EQ(detector.GetRate(), uint32_t(rate));
+  }
+}
+
+TEST(CadenceDetectorTest, PauseResetsRate) {
+  CadenceDetector detector;
+  uint64_t t = 1000 * kMs;
+  for (uint32_t frame = 0; frame < 40; frame++, t += 1000000000 / 30) {
+    detector.AddPresent(t);
+  }
+  EXPECT_EQ(detector.GetRate(), 30U);
+  detector.AddPresent(t + 1000 * kMs);
+  EXPECT_EQ(detector.GetRate(), 0U);
+}
+
+TEST(CadenceDetectorTest, IrregularContentHasNoRate) {
+  std::mt19937 rng(3);
+  CadenceDetector detector;
+  uint64_t t = 1000 * kMs;
+  for (uint32_t frame = 0; frame < 200; frame++) {
+    t += (8 + rng() % 60) * kMs;
+    detector.AddPresent(t);
+    EXPECT_EQ(detector.GetRate(), 0U) << "Frame " << frame;
+  }
+}
+
+TEST(RefreshRateArbiterTest, MultipleInRange) {
+  EXPECT_EQ(RefreshRateArbiter::GetMultipleInRange(24, 30, 120), 48U);
+  EXPECT_EQ(RefreshRateArbiter::GetMultipleInRange(24, 48, 60), 48U);
+  EXPECT_EQ(RefreshRateArbiter::GetMultipleInRange(30, 30, 120), 30U);
+  EXPECT_EQ(RefreshRateArbiter::GetMultipleInRange(25, 60, 60), 60U);
+  EXPECT_EQ(RefreshRateArbiter::GetMultipleInRange(144, 30, 120), 120U);
+}
+
+TEST(RefreshRateArbiterTest, Precedence) {
+  RefreshRateArbiter arbiter;
+  arbiter.SetCurrentRate(120);
+  RefreshRateInputs inputs;
+  inputs.min_rate = 30;
+  inputs.max_rate = 120;
+  inputs.default_rate = 120;
+  inputs.content_rate = 24;
+  inputs.metadata_rate = 60;
+  EXPECT_EQ(arbiter.Select(inputs, 0), 60U);
+  inputs.idle = true;
+  EXPECT_EQ(arbiter.Select(inputs, 1), 30U);
+  inputs.forced_rate = 90;
+  EXPECT_EQ(arbiter.Select(inputs, 2), 90U);
+  EXPECT_EQ(arbiter.GetSwitchCount(), 3U);
+}
+
+TEST(RefreshRateArbiterTest, QsyncIgnoresContent) {
+  RefreshRateArbiter arbiter;
+  arbiter.SetCurrentRate(120);
+  RefreshRateInputs inputs;
+  inputs.min_rate = 30;
+  inputs.max_rate = 120;
+  inputs.default_rate = 120;
+  inputs.content_rate = 30;
+  inputs.qsync = true;
+  for (uint64_t t = 0; t < 2000 * kMs; t += 10 * kMs) {
+    EXPECT_EQ(arbiter.Select(inputs, t), 120U);
+  }
+  inputs.qsync = false;
+  EXPECT_EQ(arbiter.Select(inputs, 2000 * kMs), 120U);
+  EXPECT_EQ(arbiter.Select(inputs, 2500 * kMs), 30U);
+  EXPECT_EQ(arbiter.GetSwitchCount(), 1U);
+}
+
+TEST(ContentCadenceTest, RecordedVideoSettlesAt48) {
+  CadenceSimulation simulation;
+  size_t count = sizeof(kRecordedVideoVsyncs) / sizeof(kRecordedVideoVsyncs[0]);
+  simulation.AddVsyncTrace(1, kRecordedVideoVsyncs, count, 1000 * kMs);
+  std::vector<uint32_t> rates = simulation.Run();
+  EXPECT_EQ(rates.front(), 120U);
+  EXPECT_EQ(rates.back(), 48U);
+  // The late frames must not bounce the panel back up.
+  EXPECT_EQ(simulation.GetSwitchCount(), 1U);
+}
+
+TEST(ContentCadenceTest, JitteryVideoSettlesAt30) {
+  CadenceSimulation simulation;
+  simulation.AddCadence(1, 30.0f, 1000 * kMs, 5000 * kMs, 120.0f, 11, 3 * kMs);
+  std::vector<uint32_t> rates = simulation.Run();
+  EXPECT_EQ(rates.back(), 30U);
+  EXPECT_EQ(simulation.GetSwitchCount(), 1U);
+}
+
+TEST(ContentCadenceTest, ScrollingStaysAtMax) {
+  CadenceSimulation simulation;
+  simulation.AddCadence(1, 120.0f, 1000 * kMs, 3000 * kMs);
+  std::vector<uint32_t> rates = simulation.Run();
+  EXPECT_TRUE(std::all_of(rates.begin(), rates.end(), [](uint32_t rate) { return rate == 120; }));
+  EXPECT_EQ(simulation.GetSwitchCount(), 0U);
+}
+
+// Touching the screen during playback raises the rate for the animation at once. Once the UI is
+// static again the panel goes back to the video rate.
+TEST(ContentCadenceTest, AnimationDuringVideo) {
+  CadenceSimulation simulation;
+  simulation.AddCadence(1, 24.0f, 1000 * kMs, 6000 * kMs, 60.0f);
+  simulation.AddCadence(2, 120.0f, 4000 * kMs, 400 * kMs);
+  std::vector<uint32_t> rates = simulation.Run();
+  EXPECT_EQ(rates.back(), 48U);
+  EXPECT_EQ(simulation.GetSwitchCount(), 3U);
+}
+
+// A single frame of a static layer counts as unknown content only while it is recent.
+TEST(ContentCadenceTest, OneOffUpdateDuringVideo) {
+  CadenceSimulation simulation;
+  simulation.AddCadence(1, 30.0f, 1000 * kMs, 4000 * kMs);
+  simulation.AddCadence(2, 1.0f, 3000 * kMs, 1 * kMs);
+  std::vector<uint32_t> rates = simulation.Run();
+  EXPECT_EQ(rates.back(), 30U);
+  EXPECT_EQ(simulation.GetSwitchCount(), 3U);
+}
+
+// Short bursts at a lower rate never last for the hold time and leave the panel alone.
+TEST(ContentCadenceTest, ShortBurstsKeepRate) {
+  CadenceSimulation simulation;
+  for (uint64_t start = 1000; start < 6000; start += 1000) {
+    simulation.AddCadence(1, 30.0f, start * kMs, 800 * kMs);
+    simulation.AddCadence(1, 120.0f, (start + 800) * kMs, 200 * kMs);
+  }
+  simulation.Run();
+  EXPECT_EQ(simulation.GetSwitchCount(), 0U);
+}
+
+TEST(ContentCadenceTest, MetadataOverridesCadence) {
+  CadenceSimulation simulation;
+  simulation.AddCadence(1, 24.0f, 1000 * kMs, 3000 * kMs);
+  std::vector<uint32_t> rates = simulation.Run(60);
+  EXPECT_TRUE(std::all_of(rates.begin(), rates.end(), [](uint32_t rate) { return rate == 60; }));
+  EXPECT_EQ(simulation.GetSwitchCount(), 1U);
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,697 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <utils/constants.h>
+#include <utils/cpu_blit.h>
+#include <utils/debug.h>
+#include <utils/rect.h>
+
+#include <algorithm>
+
+#define __CLASS__ "CpuBlitter"
+
+namespace sdm {
+
+namespace {
+
+// Rows handed out at once; a 4K row pair of P010 is around 30 KB of output.
+const uint32_t kStitchGrain = 16;
+const uint32_t kConvertGrain = 8;
+const uint32_t kCopyGrain = 32;
+const size_t kClearChunk = 1 << 20;
+
+struct Span {
+  int32_t left = 0;
+  int32_t top = 0;
+  int32_t right = 0;
+  int32_t bottom = 0;
+
+  int32_t Width() const { return right - left; }
+  int32_t Height() const { return bottom - top; }
+  bool IsEmpty() const { return right <= left || bottom <= top; }
+};
+
+Span ToSpan(const LayerRect &rect) {
+  return {INT32(floorf(rect.left)), INT32(floorf(rect.top)), INT32(ceilf(rect.right)),
+          INT32(ceilf(rect.bottom))};
+}
+
+Span Clip(const Span &span, const Span &bounds) {
+  return {std::max(span.left, bounds.left), std::max(span.top, bounds.top),
+          std::min(span.right, bounds.right), std::min(span.bottom, bounds.bottom)};
+}
+
+bool IsRGB(CpuBlitFormat format) {
+  return format == kCpuBlitRGBA8888 || format == kCpuBlitRGBX8888 ||
+         format == kCpuBlitBGRA8888 || format == kCpuBlitRGBA1010102;
+}
+
+bool IsYUV(CpuBlitFormat format) {
+  return format == kCpuBlitNV12 || format == kCpuBlitP010;
+}
+
+bool IsMapped(const CpuBlitImage &image) {
+  if (!image.width || !image.height || !image.planes[0].base) {
+    return false;
+  }
+
+  uint32_t bpp = (image.format == kCpuBlitNV12) ? 1 : (image.format == kCpuBlitP010) ? 2 : 4;
+  if (image.planes[0].stride < image.width * bpp) {
+    return false;
+  }
+
+  return !IsYUV(image.format) ||
+         (image.planes[1].base && image.planes[1].stride >= ((image.width + 1) & ~1U) * bpp);
+}
+
+// Normalized channels of a run of pixels, one array per channel so the loops vectorize.
+struct Pixels {
+  std::vector<float> r, g, b, a;
+
+  void Resize(size_t count) {
+    r.resize(count);
+    g.resize(count);
+    b.resize(count);
+    a.resize(count);
+  }
+};
+
+void Decode(CpuBlitFormat format, const uint8_t *row, int32_t x, int32_t count, Pixels *out) {
+  float *r = out->r.data(), *g = out->g.data(), *b = out->b.data(), *a = out->a.data();
+  const float k8 = 1.0f / 255.0f;
+  const uint8_t *p = row + x * 4;
+
+  switch (format) {
+    case kCpuBlitRGBA8888:
+    case kCpuBlitRGBX8888:
+      for (int32_t i = 0; i < count; i++) {
+        r[i] = p[4 * i] * k8;
+        g[i] = p[4 * i + 1] * k8;
+        b[i] = p[4 * i + 2] * k8;
+        a[i] = p[4 * i + 3] * k8;
+      }
+      if (format == kCpuBlitRGBX8888) {
+        std::fill(a, a + count, 1.0f);
+      }
+      break;
+    case kCpuBlitBGRA8888:
+      for (int32_t i = 0; i < count; i++) {
+        b[i] = p[4 * i] * k8;
+        g[i] = p[4 * i + 1] * k8;
+        r[i] = p[4 * i + 2] * k8;
+        a[i] = p[4 * i + 3] * k8;
+      }
+      break;
+    case kCpuBlitRGBA1010102: {
+      const uint32_t *w = reinterpret_cast<const uint32_t *>(p);
+      for (int32_t i = 0; i < count; i++) {
+        r[i] = (w[i] & 0x3ff) * (1.0f / 1023.0f);
+        g[i] = ((w[i] >> 10) & 0x3ff) * (1.0f / 1023.0f);
+        b[i] = ((w[i] >> 20) & 0x3ff) * (1.0f / 1023.0f);
+        a[i] = (w[i] >> 30) * (1.0f / 3.0f);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+inline uint32_t Quantize(float value, float max) {
+  return static_cast<uint32_t>(std::min(std::max(value * max, 0.0f), max) + 0.5f);
+}
+
+void Encode(CpuBlitFormat format, const Pixels &in, int32_t count, uint8_t *row, int32_t x) {
+  const float *r = in.r.data(), *g = in.g.data(), *b = in.b.data(), *a = in.a.data();
+  uint8_t *p = row + x * 4;
+
+  switch (format) {
+    case kCpuBlitRGBA8888:
+    case kCpuBlitRGBX8888:
+      for (int32_t i = 0; i < count; i++) {
+        p[4 * i] = UINT8(Quantize(r[i], 255.0f));
+        p[4 * i + 1] = UINT8(Quantize(g[i], 255.0f));
+        p[4 * i + 2] = UINT8(Quantize(b[i], 255.0f));
+        p[4 * i + 3] = (format == kCpuBlitRGBX8888) ? 0xff : UINT8(Quantize(a[i], 255.0f));
+      }
+      break;
+    case kCpuBlitBGRA8888:
+      for (int32_t i = 0; i < count; i++) {
+        p[4 * i] = UINT8(Quantize(b[i], 255.0f));
+        p[4 * i + 1] = UINT8(Quantize(g[i], 255.0f));
+        p[4 * i + 2] = UINT8(Quantize(r[i], 255.0f));
+        p[4 * i + 3] = UINT8(Quantize(a[i], 255.0f));
+      }
+      break;
+    case kCpuBlitRGBA1010102: {
+      uint32_t *w = reinterpret_cast<uint32_t *>(p);
+      for (int32_t i = 0; i < count; i++) {
+        w[i] = Quantize(r[i], 1023.0f) | (Quantize(g[i], 1023.0f) << 10) |
+               (Quantize(b[i], 1023.0f) << 20) | (Quantize(a[i], 3.0f) << 30);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// Maps the columns and rows of a destination rect to the source rect, sampling at texel centres
+// like GL_LINEAR with clamp to edge.
+class Sampler {
+ public:
+  Sampler(const CpuBlitImage &src, const Span &src_span, const Span &dst_span, const Span &draw)
+    : src_(src), src_span_(src_span), dst_span_(dst_span), draw_(draw) {
+    scale_x_ = FLOAT(src_span.Width()) / FLOAT(dst_span.Width());
+    scale_y_ = FLOAT(src_span.Height()) / FLOAT(dst_span.Height());
+    identity_ = (src_span.Width() == dst_span.Width() && src_span.Height() == dst_span.Height());
+    if (identity_) {
+      return;
+    }
+
+    int32_t count = draw.Width();
+    x0_.resize(count);
+    x1_.resize(count);
+    fx_.resize(count);
+    for (int32_t i = 0; i < count; i++) {
+      float sx = FLOAT(src_span.left) + (FLOAT(draw.left + i - dst_span.left) + 0.5f) * scale_x_ -
+                 0.5f;
+      Resolve(sx, src_span.left, src_span.right, &x0_[i], &x1_[i], &fx_[i]);
+      // Relative to the decoded source run.
+      x0_[i] -= src_span.left;
+      x1_[i] -= src_span.left;
+    }
+  }
+
+  bool IsIdentity() const { return identity_; }
+
+  // Samples the draw columns of destination row y. rows holds two scratch runs of the source width.
+  void FetchRow(int32_t y, Pixels rows[2], Pixels *out) const {
+    int32_t count = draw_.Width();
+    if (identity_) {
+      int32_t sy = y - dst_span_.top + src_span_.top;
+      Decode(src_.format, src_.planes[0].base + size_t(sy) * src_.planes[0].stride,
+             draw_.left - dst_span_.left + src_span_.left, count, out);
+      return;
+    }
+
+    float sy = FLOAT(src_span_.top) + (FLOAT(y - dst_span_.top) + 0.5f) * scale_y_ - 0.5f;
+    int32_t y0 = 0, y1 = 0;
+    float fy = 0.0f;
+    Resolve(sy, src_span_.top, src_span_.bottom, &y0, &y1, &fy);
+
+    int32_t width = src_span_.Width();
+    const uint8_t *base = src_.planes[0].base;
+    Decode(src_.format, base + size_t(y0) * src_.planes[0].stride, src_span_.left, width, &rows[0]);
+    Decode(src_.format, base + size_t(y1) * src_.planes[0].stride, src_span_.left, width, &rows[1]);
+    Lerp(rows[0].r.data(), rows[1].r.data(), fy, width);
+    Lerp(rows[0].g.data(), rows[1].g.data(), fy, width);
+    Lerp(rows[0].b.data(), rows[1].b.data(), fy, width);
+    Lerp(rows[0].a.data(), rows[1].a.data(), fy, width);
+
+    Gather(rows[0].r.data(), out->r.data(), count);
+    Gather(rows[0].g.data(), out->g.data(), count);
+    Gather(rows[0].b.data(), out->b.data(), count);
+    Gather(rows[0].a.data(), out->a.data(), count);
+  }
+
+ private:
+  static void Resolve(float coord, int32_t low, int32_t high, int32_t *i0, int32_t *i1, float *f) {
+    float base = floorf(coord);
+    *f = coord - base;
+    int32_t index = INT32(base);
+    *i0 = std::min(std::max(index, low), high - 1);
+    *i1 = std::min(std::max(index + 1, low), high - 1);
+  }
+
+  static void Lerp(float *top, const float *bottom, float f, int32_t count) {
+    for (int32_t i = 0; i < count; i++) {
+      top[i] += (bottom[i] - top[i]) * f;
+    }
+  }
+
+  void Gather(const float *row, float *out, int32_t count) const {
+    const int32_t *x0 = x0_.data(), *x1 = x1_.data();
+    const float *fx = fx_.data();
+    for (int32_t i = 0; i < count; i++) {
+      out[i] = row[x0[i]] + (row[x1[i]] - row[x0[i]]) * fx[i];
+    }
+  }
+
+  const CpuBlitImage &src_;
+  Span src_span_;
+  Span dst_span_;
+  Span draw_;
+  float scale_x_ = 1.0f;
+  float scale_y_ = 1.0f;
+  bool identity_ = true;
+  std::vector<int32_t> x0_;
+  std::vector<int32_t> x1_;
+  std::vector<float> fx_;
+};
+
+// Y'CbCr coefficients of a matrix, with the quantization of the destination range and depth.
+struct YuvTransform {
+  float yr, yg, yb;
+  float cb_scale, cr_scale;
+  float y_scale, y_offset;
+  float c_scale, c_offset;
+  float max;
+
+  YuvTransform(CpuBlitMatrix matrix, bool full_range, bool ten_bit) {
+    float kr = 0.299f, kb = 0.114f;
+    if (matrix == kCpuBlitBT709) {
+      kr = 0.2126f;
+      kb = 0.0722f;
+    } else if (matrix == kCpuBlitBT2020) {
+      kr = 0.2627f;
+      kb = 0.0593f;
+    }
+    yr = kr;
+    yg = 1.0f - kr - kb;
+    yb = kb;
+    cb_scale = 0.5f / (1.0f - kb);
+    cr_scale = 0.5f / (1.0f - kr);
+
+    // Limited range codes scale with the depth, full range ones span all codes.
+    float depth = ten_bit ? 4.0f : 1.0f;
+    max = ten_bit ? 1023.0f : 255.0f;
+    y_scale = full_range ? max : 219.0f * depth;
+    y_offset = full_range ? 0.0f : 16.0f * depth;
+    c_scale = full_range ? max : 224.0f * depth;
+    c_offset = 128.0f * depth;
+  }
+};
+
+inline uint32_t Code(float value, float max) {
+  return static_cast<uint32_t>(std::min(std::max(value, 0.0f), max) + 0.5f);
+}
+
+// Integer requantization of Copy(), exact to the nearest code and free of branches so the row
+// loops below vectorize.
+inline uint32_t Narrow10(uint32_t value) {
+  return (value * 16336 + 32768) >> 16;  // (value * 255 + 511) / 1023
+}
+
+inline uint32_t Widen8(uint32_t value) {
+  return (value * 1023 + 127) / 255;
+}
+
+// Rows of 32 bit pixels are converted through RGBA8888 words, R in the low byte.
+void ToRGBA8888(CpuBlitFormat format, const uint32_t *in, uint32_t *out, uint32_t count) {
+  switch (format) {
+    case kCpuBlitRGBX8888:
+      for (uint32_t i = 0; i < count; i++) {
+        out[i] = in[i] | 0xff000000;
+      }
+      break;
+    case kCpuBlitBGRA8888:
+      for (uint32_t i = 0; i < count; i++) {
+        out[i] = (in[i] & 0xff00ff00) | ((in[i] & 0xff) << 16) | ((in[i] >> 16) & 0xff);
+      }
+      break;
+    case kCpuBlitRGBA1010102:
+      for (uint32_t i = 0; i < count; i++) {
+        out[i] = Narrow10(in[i] & 0x3ff) | (Narrow10((in[i] >> 10) & 0x3ff) << 8) |
+                 (Narrow10((in[i] >> 20) & 0x3ff) << 16) | ((in[i] >> 30) * 85 << 24);
+      }
+      break;
+    default:
+      memcpy(out, in, size_t(count) * 4);
+      break;
+  }
+}
+
+void FromRGBA8888(CpuBlitFormat format, const uint32_t *in, uint32_t *out, uint32_t count) {
+  switch (format) {
+    case kCpuBlitBGRA8888:
+      for (uint32_t i = 0; i < count; i++) {
+        out[i] = (in[i] & 0xff00ff00) | ((in[i] & 0xff) << 16) | ((in[i] >> 16) & 0xff);
+      }
+      break;
+    case kCpuBlitRGBA1010102:
+      for (uint32_t i = 0; i < count; i++) {
+        out[i] = Widen8(in[i] & 0xff) | (Widen8((in[i] >> 8) & 0xff) << 10) |
+                 (Widen8((in[i] >> 16) & 0xff) << 20) | (((in[i] >> 24) * 3 + 127) / 255 << 30);
+      }
+      break;
+    default:
+      memcpy(out, in, size_t(count) * 4);
+      break;
+  }
+}
+
+// count samples of an NV12 plane to P010 and back, the 10 bit codes sit in the MSBs.
+void WidenSamples(const uint8_t *in, uint16_t *out, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    out[i] = UINT16(Widen8(in[i]) << 6);
+  }
+}
+
+void NarrowSamples(const uint16_t *in, uint8_t *out, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    out[i] = UINT8(Narrow10(in[i] >> 6));
+  }
+}
+
+}  // namespace
+
+const uint32_t CpuBlitter::kMaxSharedThreads;
+
+static uint32_t GetOnlineCpuCount() {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);  // NOLINT
+  return (cpus > 0) ? UINT32(cpus) : 1;
+}
+
+CpuBlitter::CpuBlitter(uint32_t thread_count) {
+  if (!thread_count) {
+    thread_count = GetOnlineCpuCount();
+  }
+
+  for (uint32_t i = 1; i < thread_count; i++) {
+    workers_.emplace_back(&CpuBlitter::Worker, this);
+  }
+}
+
+CpuBlitter &CpuBlitter::GetShared() {
+  // Intentionally leaked, a display may still blit while static destructors run.
+  static CpuBlitter *shared = new CpuBlitter(std::min(GetOnlineCpuCount(), kMaxSharedThreads));
+  return *shared;
+}
+
+CpuBlitter::~CpuBlitter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    exit_ = true;
+  }
+  job_cv_.notify_all();
+  for (auto &thread : workers_) {
+    thread.join();
+  }
+}
+
+void CpuBlitter::ParallelFor(uint32_t count, uint32_t grain,
+                             const std::function<void(uint32_t, uint32_t)> &func) {
+  if (!count) {
+    return;
+  }
+
+  grain = std::max(grain, 1U);
+  if (workers_.empty() || count <= grain) {
+    func(0, count);
+    return;
+  }
+
+  // One job at a time, the workers only know about the current one.
+  std::lock_guard<std::mutex> job_lock(job_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    func_ = &func;
+    count_ = count;
+    grain_ = grain;
+    next_ = 0;
+    active_workers_ = workers_.size();
+    job_id_++;
+  }
+  job_cv_.notify_all();
+
+  RunRanges();
+
+  // Workers take part in every job, so none of them can still be reading this one later.
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] { return active_workers_ == 0; });
+  func_ = nullptr;
+}
+
+void CpuBlitter::Worker() {
+  uint64_t seen_job = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    job_cv_.wait(lock, [&] { return exit_ || job_id_ != seen_job; });
+    if (exit_) {
+      return;
+    }
+    seen_job = job_id_;
+
+    lock.unlock();
+    RunRanges();
+    lock.lock();
+
+    if (--active_workers_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+void CpuBlitter::RunRanges() {
+  uint32_t ranges = (count_ + grain_ - 1) / grain_;
+  for (uint32_t range = next_++; range < ranges; range = next_++) {
+    (*func_)(range * grain_, std::min((range + 1) * grain_, count_));
+  }
+}
+
+DisplayError CpuBlitter::ConvertToYUV(const CpuBlitImage &src, const LayerRect &src_rect,
+                                      const CpuBlitImage &dst, const LayerRect &dst_rect,
+                                      CpuBlitMatrix matrix, bool full_range) {
+  if (!IsRGB(src.format) || !IsYUV(dst.format) || !IsMapped(src) || !IsMapped(dst)) {
+    DLOGE("Unsupported conversion of format %d to %d", src.format, dst.format);
+    return kErrorParameters;
+  }
+
+  Span src_bounds = {0, 0, INT32(src.width), INT32(src.height)};
+  Span src_span = IsValid(src_rect) ? Clip(ToSpan(src_rect), src_bounds) : src_bounds;
+
+  // Chroma is written for whole 2x2 blocks.
+  Span dst_span = ToSpan(dst_rect);
+  dst_span.left &= ~1;
+  dst_span.top &= ~1;
+  dst_span.right = (dst_span.right + 1) & ~1;
+  dst_span.bottom = (dst_span.bottom + 1) & ~1;
+  Span draw = Clip(dst_span, {0, 0, INT32(dst.width & ~1U), INT32(dst.height & ~1U)});
+  if (src_span.IsEmpty() || draw.IsEmpty()) {
+    DLOGE("Invalid source %dx%d or destination %dx%d", src_span.Width(), src_span.Height(),
+          draw.Width(), draw.Height());
+    return kErrorParameters;
+  }
+
+  bool ten_bit = (dst.format == kCpuBlitP010);
+  YuvTransform xform(matrix, full_range, ten_bit);
+  Sampler sampler(src, src_span, dst_span, draw);
+  int32_t count = draw.Width();
+
+  ParallelFor(UINT32(draw.Height() / 2), kConvertGrain, [&](uint32_t first, uint32_t last) {
+    Pixels scratch[2];
+    Pixels rgb[2];
+    std::vector<float> luma(count);
+    std::vector<float> cb(count / 2), cr(count / 2);
+    if (!sampler.IsIdentity()) {
+      scratch[0].Resize(src_span.Width());
+      scratch[1].Resize(src_span.Width());
+    }
+    rgb[0].Resize(count);
+    rgb[1].Resize(count);
+
+    for (uint32_t pair = first; pair < last; pair++) {
+      int32_t y = draw.top + INT32(pair) * 2;
+      for (int32_t i = 0; i < 2; i++) {
+        sampler.FetchRow(y + i, scratch, &rgb[i]);
+
+        const float *r = rgb[i].r.data(), *g = rgb[i].g.data(), *b = rgb[i].b.data();
+        float *l = luma.data();
+        for (int32_t x = 0; x < count; x++) {
+          l[x] = (xform.yr * r[x] + xform.yg * g[x] + xform.yb * b[x]) * xform.y_scale +
+                 xform.y_offset;
+        }
+
+        const CpuBlitPlane &plane = dst.planes[0];
+        if (ten_bit) {
+          uint16_t *out = reinterpret_cast<uint16_t *>(plane.base + size_t(y + i) * plane.stride) +
+                          draw.left;
+          for (int32_t x = 0; x < count; x++) {
+            out[x] = UINT16(Code(l[x], xform.max) << 6);
+          }
+        } else {
+          uint8_t *out = plane.base + size_t(y + i) * plane.stride + draw.left;
+          for (int32_t x = 0; x < count; x++) {
+            out[x] = UINT8(Code(l[x], xform.max));
+          }
+        }
+      }
+
+      // Chroma is linear in R'G'B', so converting the block average equals averaging the samples.
+      const float *r0 = rgb[0].r.data(), *g0 = rgb[0].g.data(), *b0 = rgb[0].b.data();
+      const float *r1 = rgb[1].r.data(), *g1 = rgb[1].g.data(), *b1 = rgb[1].b.data();
+      for (int32_t x = 0; x < count / 2; x++) {
+        float r = (r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1]) * 0.25f;
+        float g = (g0[2 * x] + g0[2 * x + 1] + g1[2 * x] + g1[2 * x + 1]) * 0.25f;
+        float b = (b0[2 * x] + b0[2 * x + 1] + b1[2 * x] + b1[2 * x + 1]) * 0.25f;
+        float l = xform.yr * r + xform.yg * g + xform.yb * b;
+        cb[x] = (b - l) * xform.cb_scale * xform.c_scale + xform.c_offset;
+        cr[x] = (r - l) * xform.cr_scale * xform.c_scale + xform.c_offset;
+      }
+
+      const CpuBlitPlane &plane = dst.planes[1];
+      if (ten_bit) {
+        uint16_t *out = reinterpret_cast<uint16_t *>(plane.base + size_t(y / 2) * plane.stride) +
+                        draw.left;
+        for (int32_t x = 0; x < count / 2; x++) {
+          out[2 * x] = UINT16(Code(cb[x], xform.max) << 6);
+          out[2 * x + 1] = UINT16(Code(cr[x], xform.max) << 6);
+        }
+      } else {
+        uint8_t *out = plane.base + size_t(y / 2) * plane.stride + draw.left;
+        for (int32_t x = 0; x < count / 2; x++) {
+          out[2 * x] = UINT8(Code(cb[x], xform.max));
+          out[2 * x + 1] = UINT8(Code(cr[x], xform.max));
+        }
+      }
+    }
+  });
+
+  return kErrorNone;
+}
+
+DisplayError CpuBlitter::Stitch(const CpuBlitImage &src, const LayerRect &src_rect,
+                                const CpuBlitImage &dst, const LayerRect &dst_rect,
+                                const LayerRect &scissor) {
+  if (!IsRGB(src.format) || !IsRGB(dst.format) || !IsMapped(src) || !IsMapped(dst)) {
+    DLOGE("Unsupported stitch of format %d to %d", src.format, dst.format);
+    return kErrorParameters;
+  }
+
+  Span src_bounds = {0, 0, INT32(src.width), INT32(src.height)};
+  Span dst_bounds = {0, 0, INT32(dst.width), INT32(dst.height)};
+  Span src_span = IsValid(src_rect) ? Clip(ToSpan(src_rect), src_bounds) : src_bounds;
+  Span dst_span = ToSpan(dst_rect);
+  if (src_span.IsEmpty() || dst_span.IsEmpty()) {
+    DLOGE("Invalid source %dx%d or destination %dx%d", src_span.Width(), src_span.Height(),
+          dst_span.Width(), dst_span.Height());
+    return kErrorParameters;
+  }
+
+  Span draw = Clip(dst_span, dst_bounds);
+  if (IsValid(scissor)) {
+    Span clear = Clip(ToSpan(scissor), dst_bounds);
+    if (!clear.IsEmpty()) {
+      ParallelFor(UINT32(clear.Height()), kStitchGrain, [&](uint32_t first, uint32_t last) {
+        for (uint32_t i = first; i < last; i++) {
+          uint8_t *row = dst.planes[0].base + size_t(clear.top + INT32(i)) * dst.planes[0].stride;
+          memset(row + clear.left * 4, 0, size_t(clear.Width()) * 4);
+        }
+      });
+    }
+    draw = Clip(draw, clear);
+  }
+
+  if (draw.IsEmpty()) {
+    return kErrorNone;
+  }
+
+  Sampler sampler(src, src_span, dst_span, draw);
+  if (sampler.IsIdentity() && src.format == dst.format) {
+    int32_t sx = draw.left - dst_span.left + src_span.left;
+    int32_t sy = draw.top - dst_span.top + src_span.top;
+    ParallelFor(UINT32(draw.Height()), kStitchGrain, [&](uint32_t first, uint32_t last) {
+      for (uint32_t i = first; i < last; i++) {
+        const uint8_t *in = src.planes[0].base + size_t(sy + INT32(i)) * src.planes[0].stride;
+        uint8_t *out = dst.planes[0].base + size_t(draw.top + INT32(i)) * dst.planes[0].stride;
+        memcpy(out + draw.left * 4, in + sx * 4, size_t(draw.Width()) * 4);
+      }
+    });
+
+    return kErrorNone;
+  }
+
+  ParallelFor(UINT32(draw.Height()), kStitchGrain, [&](uint32_t first, uint32_t last) {
+    Pixels scratch[2];
+    Pixels out;
+    if (!sampler.IsIdentity()) {
+      scratch[0].Resize(src_span.Width());
+      scratch[1].Resize(src_span.Width());
+    }
+    out.Resize(draw.Width());
+
+    for (uint32_t i = first; i < last; i++) {
+      int32_t y = draw.top + INT32(i);
+      sampler.FetchRow(y, scratch, &out);
+      Encode(dst.format, out, draw.Width(), dst.planes[0].base + size_t(y) * dst.planes[0].stride,
+             draw.left);
+    }
+  });
+
+  return kErrorNone;
+}
+
+DisplayError CpuBlitter::Copy(const CpuBlitImage &src, const CpuBlitImage &dst) {
+  bool rgb = IsRGB(src.format) && IsRGB(dst.format);
+  bool yuv = IsYUV(src.format) && IsYUV(dst.format);
+  if ((!rgb && !yuv) || !IsMapped(src) || !IsMapped(dst) || src.width != dst.width ||
+      src.height != dst.height) {
+    DLOGE("Unsupported copy of %dx%d format %d to %dx%d format %d", src.width, src.height,
+          src.format, dst.width, dst.height, dst.format);
+    return kErrorParameters;
+  }
+
+  // Chroma rows of the YUV formats follow the luma ones in the range of rows.
+  uint32_t width = src.width;
+  uint32_t luma_rows = src.height;
+  uint32_t rows = yuv ? luma_rows + (luma_rows + 1) / 2 : luma_rows;
+  bool same_format = (src.format == dst.format) ||
+                     (src.format == kCpuBlitRGBA8888 && dst.format == kCpuBlitRGBX8888);
+
+  ParallelFor(rows, kCopyGrain, [&](uint32_t first, uint32_t last) {
+    // Conversions to or from RGBA8888 run in a single pass.
+    bool direct = (dst.format == kCpuBlitRGBA8888 || dst.format == kCpuBlitRGBX8888 ||
+                   src.format == kCpuBlitRGBA8888);
+    std::vector<uint32_t> scratch;
+    if (rgb && !same_format && !direct) {
+      scratch.resize(width);
+    }
+
+    for (uint32_t i = first; i < last; i++) {
+      uint32_t plane = (i < luma_rows) ? 0 : 1;
+      uint32_t y = i - plane * luma_rows;
+      const uint8_t *in = src.planes[plane].base + size_t(y) * src.planes[plane].stride;
+      uint8_t *out = dst.planes[plane].base + size_t(y) * dst.planes[plane].stride;
+      // Interleaved CbCr rows hold two samples per pair of columns.
+      uint32_t samples = plane ? (width + 1) & ~1U : width;
+
+      if (same_format) {
+        uint32_t bpp = (src.format == kCpuBlitNV12) ? 1 : (src.format == kCpuBlitP010) ? 2 : 4;
+        memcpy(out, in, size_t(samples) * bpp);
+      } else if (rgb && direct) {
+        const uint32_t *words = reinterpret_cast<const uint32_t *>(in);
+        if (dst.format == kCpuBlitRGBA8888 || dst.format == kCpuBlitRGBX8888) {
+          ToRGBA8888(src.format, words, reinterpret_cast<uint32_t *>(out), width);
+        } else {
+          FromRGBA8888(dst.format, words, reinterpret_cast<uint32_t *>(out), width);
+        }
+      } else if (rgb) {
+        ToRGBA8888(src.format, reinterpret_cast<const uint32_t *>(in), scratch.data(), width);
+        FromRGBA8888(dst.format, scratch.data(), reinterpret_cast<uint32_t *>(out), width);
+      } else if (dst.format == kCpuBlitP010) {
+        WidenSamples(in, reinterpret_cast<uint16_t *>(out), samples);
+      } else {
+        NarrowSamples(reinterpret_cast<const uint16_t *>(in), out, samples);
+      }
+    }
+  });
+
+  return kErrorNone;
+}
+
+void CpuBlitter::Clear(void *base, size_t size) {
+  uint8_t *bytes = static_cast<uint8_t *>(base);
+  uint32_t chunks = UINT32((size + kClearChunk - 1) / kClearChunk);
+  ParallelFor(chunks, 1, [&](uint32_t first, uint32_t last) {
+    size_t offset = size_t(first) * kClearChunk;
+    memset(bytes + offset, 0, std::min(size_t(last) * kClearChunk, size) - offset);
+  });
+}
+
+}  // namespace sdm
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <benchmark/benchmark.h>
+#include <utils/cpu_blit.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using sdm::CpuBlitFormat;
+using sdm::CpuBlitImage;
+using sdm::CpuBlitter;
+using sdm::LayerRect;
+
+struct Resolution {
+  uint32_t width;
+  uint32_t height;
+};
+
+const Resolution kResolutions[] = {{1920, 1080}, {3840, 2160}};
+
+struct Buffer {
+  std::vector<uint8_t> data[2];
+  CpuBlitImage image;
+
+  Buffer(CpuBlitFormat format, uint32_t width, uint32_t height) {
+    uint32_t bpp = (format == sdm::kCpuBlitNV12) ? 1 : (format == sdm::kCpuBlitP010) ? 2 : 4;
+    image.format = format;
+    image.width = width;
+    image.height = height;
+    data[0].assign(size_t(width) * bpp * height, 0x5a);
+    image.planes[0] = {data[0].data(), width * bpp};
+    if (format == sdm::kCpuBlitNV12 || format == sdm::kCpuBlitP010) {
+      data[1].assign(size_t(width) * bpp * height / 2, 0);
+      image.planes[1] = {data[1].data(), width * bpp};
+    }
+  }
+};
+
+// Arguments: resolution index, thread count (0 is one per CPU).
+void Convert(benchmark::State &state, CpuBlitFormat format) {
+  Resolution resolution = kResolutions[state.range(0)];
+  CpuBlitter blitter(static_cast<uint32_t>(state.range(1)));
+  Buffer src(sdm::kCpuBlitRGBA8888, resolution.width, resolution.height);
+  Buffer dst(format, resolution.width, resolution.height);
+  LayerRect rect(0, 0, resolution.width, resolution.height);
+
+  for (auto _ : state) {
+    blitter.ConvertToYUV(src.image, {}, dst.image, rect, sdm::kCpuBlitBT601, false);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * resolution.width * resolution.height);
+  state.counters["threads"] = blitter.GetThreadCount();
+}
+
+void BM_ConvertNV12(benchmark::State &state) {
+  Convert(state, sdm::kCpuBlitNV12);
+}
+BENCHMARK(BM_ConvertNV12)->ArgsProduct({{0, 1}, {1, 0}})->UseRealTime();
+
+void BM_ConvertP010(benchmark::State &state) {
+  Convert(state, sdm::kCpuBlitP010);
+}
+BENCHMARK(BM_ConvertP010)->ArgsProduct({{0, 1}, {1, 0}})->UseRealTime();
+
+// Two halves stitched side by side, as for a dual DSC panel, unscaled or from half size sources.
+void Stitch(benchmark::State &state, bool scaled) {
+  Resolution resolution = kResolutions[state.range(0)];
+  CpuBlitter blitter(static_cast<uint32_t>(state.range(1)));
+  uint32_t half = resolution.width / 2;
+  uint32_t scale = scaled ? 2 : 1;
+  Buffer src(sdm::kCpuBlitRGBA8888, half / scale, resolution.height / scale);
+  Buffer dst(sdm::kCpuBlitRGBA8888, resolution.width, resolution.height);
+  LayerRect left(0, 0, half, resolution.height);
+  LayerRect right(half, 0, resolution.width, resolution.height);
+
+  for (auto _ : state) {
+    blitter.Stitch(src.image, {}, dst.image, left, {});
+    blitter.Stitch(src.image, {}, dst.image, right, {});
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * resolution.width * resolution.height);
+  state.counters["threads"] = blitter.GetThreadCount();
+}
+
+void BM_Stitch(benchmark::State &state) {
+  Stitch(state, false);
+}
+BENCHMARK(BM_Stitch)->ArgsProduct({{0, 1}, {1, 0}})->UseRealTime();
+
+void BM_StitchScaled(benchmark::State &state) {
+  Stitch(state, true);
+}
+BENCHMARK(BM_StitchScaled)->ArgsProduct({{0, 1}, {1, 0}})->UseRealTime();
+
+// Readback of a full frame into a client buffer, as is or narrowed to 8 bits.
+void Copy(benchmark::State &state, CpuBlitFormat src_format, CpuBlitFormat dst_format) {
+  Resolution resolution = kResolutions[state.range(0)];
+  CpuBlitter blitter(static_cast<uint32_t>(state.range(1)));
+  Buffer src(src_format, resolution.width, resolution.height);
+  Buffer dst(dst_format, resolution.width, resolution.height);
+
+  for (auto _ : state) {
+    blitter.Copy(src.image, dst.image);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * resolution.width * resolution.height);
+  state.counters["threads"] = blitter.GetThreadCount();
+}
+
+void BM_CopyRGBA8888(benchmark::State &state) {
+  Copy(state, sdm::kCpuBlitRGBA8888, sdm::kCpuBlitRGBA8888);
+}
+BENCHMARK(BM_CopyRGBA8888)->ArgsProduct({{0, 1}, {1, 0}})->UseRealTime();
+
+void BM_CopyRGBA1010102ToRGBA8888(benchmark::State &state) {
+  Copy(state, sdm::kCpuBlitRGBA1010102, sdm::kCpuBlitRGBA8888);
+}
+BENCHMARK(BM_CopyRGBA1010102ToRGBA8888)->ArgsProduct({{0, 1}, {1, 0}})->UseRealTime();
+
+void BM_CopyP010ToNV12(benchmark::State &state) {
+  Copy(state, sdm::kCpuBlitP010, sdm::kCpuBlitNV12);
+}
+BENCHMARK(BM_CopyP010ToNV12)->ArgsProduct({{0, 1}, {1, 0}})->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
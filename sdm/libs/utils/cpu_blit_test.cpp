@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <string.h>
+#include <utils/cpu_blit.h>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+// An image with its own storage; strides are padded to catch stride mistakes.
+struct TestImage {
+  std::vector<uint8_t> data[2];
+  CpuBlitImage image;
+
+  TestImage(CpuBlitFormat format, uint32_t width, uint32_t height, uint8_t fill = 0) {
+    image.format = format;
+    image.width = width;
+    image.height = height;
+    uint32_t bpp = (format == kCpuBlitNV12) ? 1 : (format == kCpuBlitP010) ? 2 : 4;
+    uint32_t stride = width * bpp + 64;
+    data[0].assign(size_t(stride) * height, fill);
+    image.planes[0] = {data[0].data(), stride};
+    if (format == kCpuBlitNV12 || format == kCpuBlitP010) {
+      data[1].assign(size_t(stride) * (height + 1) / 2, fill);
+      image.planes[1] = {data[1].data(), stride};
+    }
+  }
+
+  uint8_t *Pixel(uint32_t x, uint32_t y) {
+    return image.planes[0].base + size_t(y) * image.planes[0].stride + x * 4;
+  }
+
+  uint32_t Luma(uint32_t x, uint32_t y) const {
+    const uint8_t *row = image.planes[0].base + size_t(y) * image.planes[0].stride;
+    return (image.format == kCpuBlitP010) ? (reinterpret_cast<const uint16_t *>(row)[x] >> 6) :
+                                            row[x];
+  }
+
+  // Component 0 is Cb, 1 is Cr of the block containing x, y.
+  uint32_t Chroma(uint32_t x, uint32_t y, int component) const {
+    const uint8_t *row = image.planes[1].base + size_t(y / 2) * image.planes[1].stride;
+    uint32_t index = (x & ~1U) + component;
+    return (image.format == kCpuBlitP010) ? (reinterpret_cast<const uint16_t *>(row)[index] >> 6) :
+                                            row[index];
+  }
+};
+
+void FillRandom(TestImage *image, uint32_t seed) {
+  std::mt19937 rng(seed);
+  for (auto &byte : image->data[0]) {
+    byte = UINT8(rng());
+  }
+}
+
+// Double precision reference of a normalized RGBA8888 channel sampled at texel centres.
+double Sample(TestImage &src, const LayerRect &src_rect, const LayerRect &dst_rect, double x,
+              double y, int channel) {
+  double sx = src_rect.left + (x + 0.5 - dst_rect.left) * (src_rect.right - src_rect.left) /
+              (dst_rect.right - dst_rect.left) - 0.5;
+  double sy = src_rect.top + (y + 0.5 - dst_rect.top) * (src_rect.bottom - src_rect.top) /
+              (dst_rect.bottom - dst_rect.top) - 0.5;
+  auto clamp = [](double v, double low, double high) { return std::min(std::max(v, low), high); };
+  double x0 = floor(sx), y0 = floor(sy);
+  double fx = sx - x0, fy = sy - y0;
+  auto at = [&](double px, double py) {
+    px = clamp(px, src_rect.left, src_rect.right - 1);
+    py = clamp(py, src_rect.top, src_rect.bottom - 1);
+    return src.Pixel(UINT32(px), UINT32(py))[channel] / 255.0;
+  };
+  double top = at(x0, y0) + (at(x0 + 1, y0) - at(x0, y0)) * fx;
+  double bottom = at(x0, y0 + 1) + (at(x0 + 1, y0 + 1) - at(x0, y0 + 1)) * fx;
+  return top + (bottom - top) * fy;
+}
+
+struct Reference {
+  double kr, kb;
+  double y_scale, y_offset, c_scale, c_offset, max;
+
+  Reference(CpuBlitMatrix matrix, bool full_range, bool ten_bit) {
+    kr = (matrix == kCpuBlitBT601) ? 0.299 : (matrix == kCpuBlitBT709) ? 0.2126 : 0.2627;
+    kb = (matrix == kCpuBlitBT601) ? 0.114 : (matrix == kCpuBlitBT709) ? 0.0722 : 0.0593;
+    double depth = ten_bit ? 4.0 : 1.0;
+    max = ten_bit ? 1023.0 : 255.0;
+    y_scale = full_range ? max : 219.0 * depth;
+    y_offset = full_range ? 0.0 : 16.0 * depth;
+    c_scale = full_range ? max : 224.0 * depth;
+    c_offset = 128.0 * depth;
+  }
+
+  double Quantize(double value) const { return std::min(std::max(round(value), 0.0), max); }
+  double Y(double r, double g, double b) const {
+    return Quantize((kr * r + (1 - kr - kb) * g + kb * b) * y_scale + y_offset);
+  }
+  double Cb(double r, double g, double b) const {
+    double y = kr * r + (1 - kr - kb) * g + kb * b;
+    return Quantize((b - y) / (2 * (1 - kb)) * c_scale + c_offset);
+  }
+  double Cr(double r, double g, double b) const {
+    double y = kr * r + (1 - kr - kb) * g + kb * b;
+    return Quantize((r - y) / (2 * (1 - kr)) * c_scale + c_offset);
+  }
+};
+
+// Checks every written sample of dst against the reference, within one code.
+void ExpectConvert(TestImage &src, const LayerRect &src_rect, TestImage &dst,
+                   const LayerRect &dst_rect, CpuBlitMatrix matrix, bool full_range) {
+  Reference ref(matrix, full_range, dst.image.format == kCpuBlitP010);
+  double max_error = 0.0;
+  for (uint32_t y = UINT32(dst_rect.top); y < UINT32(dst_rect.bottom); y += 2) {
+    for (uint32_t x = UINT32(dst_rect.left); x < UINT32(dst_rect.right); x += 2) {
+      double sum[3] = {};
+      for (uint32_t i = 0; i < 4; i++) {
+        double rgb[3];
+        for (int c = 0; c < 3; c++) {
+          rgb[c] = Sample(src, src_rect, dst_rect, x + (i & 1), y + (i >> 1), c);
+          sum[c] += rgb[c] / 4;
+        }
+        double luma = ref.Y(rgb[0], rgb[1], rgb[2]);
+        max_error = std::max(max_error, fabs(luma - dst.Luma(x + (i & 1), y + (i >> 1))));
+      }
+      max_error = std::max(max_error, fabs(ref.Cb(sum[0], sum[1], sum[2]) - dst.Chroma(x, y, 0)));
+      max_error = std::max(max_error, fabs(ref.Cr(sum[0], sum[1], sum[2]) - dst.Chroma(x, y, 1)));
+    }
+  }
+  EXPECT_LE(max_error, 1.0);
+}
+
+const LayerRect kNoRect = {};
+
+TEST(CpuBlitTest, ParallelForCoversEveryIndexOnce) {
+  CpuBlitter blitter(4);
+  std::vector<std::atomic<int>> hits(1000);
+  for (int round = 0; round < 50; round++) {
+    blitter.ParallelFor(UINT32(hits.size()), 7, [&](uint32_t first, uint32_t last) {
+      for (uint32_t i = first; i < last; i++) {
+        hits[i]++;
+      }
+    });
+  }
+  for (auto &hit : hits) {
+    EXPECT_EQ(50, hit.load());
+  }
+}
+
+TEST(CpuBlitTest, SharedPoolIsBoundedAndSerializesCallers) {
+  CpuBlitter &shared = CpuBlitter::GetShared();
+  EXPECT_EQ(&shared, &CpuBlitter::GetShared());
+  EXPECT_LE(shared.GetThreadCount(), CpuBlitter::kMaxSharedThreads);
+
+  // Two displays blitting at once, each job must still cover its own range exactly once.
+  std::vector<std::atomic<int>> hits[2] = {std::vector<std::atomic<int>>(1000),
+                                           std::vector<std::atomic<int>>(1000)};
+  std::vector<std::thread> callers;
+  for (auto &caller_hits : hits) {
+    callers.emplace_back([&shared, &caller_hits] {
+      for (int round = 0; round < 50; round++) {
+        shared.ParallelFor(UINT32(caller_hits.size()), 7, [&](uint32_t first, uint32_t last) {
+          for (uint32_t i = first; i < last; i++) {
+            caller_hits[i]++;
+          }
+        });
+      }
+    });
+  }
+  for (auto &caller : callers) {
+    caller.join();
+  }
+  for (auto &caller_hits : hits) {
+    for (auto &hit : caller_hits) {
+      EXPECT_EQ(50, hit.load());
+    }
+  }
+}
+
+TEST(CpuBlitTest, ConvertKnownColors) {
+  const uint8_t kColors[][3] = {{0, 0, 0}, {255, 255, 255}, {255, 0, 0}, {0, 255, 0}, {0, 0, 255}};
+  // Limited range BT.601: black, white, red, green, blue.
+  const uint32_t kExpected[][3] = {
+      {16, 128, 128}, {235, 128, 128}, {81, 90, 240}, {145, 54, 34}, {41, 240, 110}};
+  CpuBlitter blitter(1);
+  for (size_t i = 0; i < sizeof(kColors) / sizeof(kColors[0]); i++) {
+    TestImage src(kCpuBlitRGBA8888, 4, 4);
+    for (uint32_t y = 0; y < 4; y++) {
+      for (uint32_t x = 0; x < 4; x++) {
+        std::copy(kColors[i], kColors[i] + 3, src.Pixel(x, y));
+      }
+    }
+    TestImage dst(kCpuBlitNV12, 4, 4);
+    ASSERT_EQ(kErrorNone, blitter.ConvertToYUV(src.image, kNoRect, dst.image, {0, 0, 4, 4},
+                                               kCpuBlitBT601, false));
+    EXPECT_EQ(kExpected[i][0], dst.Luma(3, 3)) << i;
+    EXPECT_EQ(kExpected[i][1], dst.Chroma(3, 3, 0)) << i;
+    EXPECT_EQ(kExpected[i][2], dst.Chroma(3, 3, 1)) << i;
+  }
+}
+
+TEST(CpuBlitTest, ConvertFullRangeP010White) {
+  CpuBlitter blitter(1);
+  TestImage src(kCpuBlitRGBA8888, 2, 2, 0xff);
+  TestImage dst(kCpuBlitP010, 2, 2);
+  ASSERT_EQ(kErrorNone, blitter.ConvertToYUV(src.image, kNoRect, dst.image, {0, 0, 2, 2},
+                                             kCpuBlitBT709, true));
+  EXPECT_EQ(1023U, dst.Luma(0, 0));
+  EXPECT_EQ(512U, dst.Chroma(0, 0, 0));
+  EXPECT_EQ(512U, dst.Chroma(0, 0, 1));
+  // The 10 bit value is in the MSBs.
+  EXPECT_EQ(0xffc0, reinterpret_cast<uint16_t *>(dst.image.planes[0].base)[0]);
+}
+
+TEST(CpuBlitTest, ConvertMatchesReference) {
+  CpuBlitter blitter(3);
+  TestImage src(kCpuBlitRGBA8888, 96, 64);
+  FillRandom(&src, 1);
+  for (CpuBlitFormat format : {kCpuBlitNV12, kCpuBlitP010}) {
+    for (CpuBlitMatrix matrix : {kCpuBlitBT601, kCpuBlitBT709, kCpuBlitBT2020}) {
+      for (bool full_range : {false, true}) {
+        TestImage dst(format, 96, 64);
+        ASSERT_EQ(kErrorNone, blitter.ConvertToYUV(src.image, kNoRect, dst.image,
+                                                   {0, 0, 96, 64}, matrix, full_range));
+        SCOPED_TRACE(testing::Message() << format << " " << matrix << " " << full_range);
+        ExpectConvert(src, {0, 0, 96, 64}, dst, {0, 0, 96, 64}, matrix, full_range);
+      }
+    }
+  }
+}
+
+TEST(CpuBlitTest, ConvertScaledMatchesReference) {
+  CpuBlitter blitter(2);
+  TestImage src(kCpuBlitRGBA8888, 90, 50);
+  FillRandom(&src, 2);
+  TestImage dst(kCpuBlitNV12, 128, 96);
+  LayerRect src_rect = {10, 4, 80, 44};
+  LayerRect dst_rect = {8, 6, 120, 90};
+  ASSERT_EQ(kErrorNone, blitter.ConvertToYUV(src.image, src_rect, dst.image, dst_rect,
+                                             kCpuBlitBT709, false));
+  ExpectConvert(src, src_rect, dst, dst_rect, kCpuBlitBT709, false);
+  // Outside of the destination rect is untouched.
+  EXPECT_EQ(0U, dst.Luma(7, 6));
+  EXPECT_EQ(0U, dst.Luma(8, 5));
+  EXPECT_EQ(0U, dst.Luma(120, 89));
+}
+
+TEST(CpuBlitTest, ConvertIsThreadCountIndependent) {
+  TestImage src(kCpuBlitRGBA1010102, 200, 120);
+  FillRandom(&src, 3);
+  TestImage single(kCpuBlitP010, 160, 90);
+  TestImage multi(kCpuBlitP010, 160, 90);
+  CpuBlitter one(1), four(4);
+  ASSERT_EQ(kErrorNone, one.ConvertToYUV(src.image, kNoRect, single.image, {0, 0, 160, 90},
+                                         kCpuBlitBT2020, false));
+  ASSERT_EQ(kErrorNone, four.ConvertToYUV(src.image, kNoRect, multi.image, {0, 0, 160, 90},
+                                          kCpuBlitBT2020, false));
+  EXPECT_EQ(single.data[0], multi.data[0]);
+  EXPECT_EQ(single.data[1], multi.data[1]);
+}
+
+TEST(CpuBlitTest, ConvertRejectsInvalidFormats) {
+  CpuBlitter blitter(1);
+  TestImage rgb(kCpuBlitRGBA8888, 4, 4);
+  TestImage yuv(kCpuBlitNV12, 4, 4);
+  EXPECT_EQ(kErrorParameters, blitter.ConvertToYUV(yuv.image, kNoRect, rgb.image, {0, 0, 4, 4},
+                                                   kCpuBlitBT601, false));
+  EXPECT_EQ(kErrorParameters, blitter.ConvertToYUV(rgb.image, kNoRect, yuv.image, kNoRect,
+                                                   kCpuBlitBT601, false));
+  yuv.image.planes[1].base = nullptr;
+  EXPECT_EQ(kErrorParameters, blitter.ConvertToYUV(rgb.image, kNoRect, yuv.image, {0, 0, 4, 4},
+                                                   kCpuBlitBT601, false));
+}
+
+TEST(CpuBlitTest, StitchUnscaledIsBitExact) {
+  CpuBlitter blitter(4);
+  TestImage src(kCpuBlitRGBA8888, 64, 48);
+  FillRandom(&src, 4);
+  TestImage dst(kCpuBlitRGBA8888, 160, 100);
+  ASSERT_EQ(kErrorNone, blitter.Stitch(src.image, kNoRect, dst.image, {80, 40, 144, 88}, kNoRect));
+  for (uint32_t y = 0; y < 48; y++) {
+    EXPECT_EQ(0, memcmp(src.Pixel(0, y), dst.Pixel(80, 40 + y), 64 * 4)) << y;
+  }
+  EXPECT_EQ(0, dst.Pixel(79, 40)[0] | dst.Pixel(144, 40)[0] | dst.Pixel(80, 39)[0]);
+}
+
+TEST(CpuBlitTest, StitchConvertsRGBFormats) {
+  CpuBlitter blitter(2);
+  TestImage src(kCpuBlitRGBA8888, 16, 8);
+  FillRandom(&src, 5);
+  TestImage bgra(kCpuBlitBGRA8888, 16, 8);
+  TestImage rgbx(kCpuBlitRGBX8888, 16, 8);
+  TestImage rgb10(kCpuBlitRGBA1010102, 16, 8);
+  ASSERT_EQ(kErrorNone, blitter.Stitch(src.image, kNoRect, bgra.image, {0, 0, 16, 8}, kNoRect));
+  ASSERT_EQ(kErrorNone, blitter.Stitch(src.image, kNoRect, rgbx.image, {0, 0, 16, 8}, kNoRect));
+  ASSERT_EQ(kErrorNone, blitter.Stitch(src.image, kNoRect, rgb10.image, {0, 0, 16, 8}, kNoRect));
+  for (uint32_t y = 0; y < 8; y++) {
+    for (uint32_t x = 0; x < 16; x++) {
+      const uint8_t *p = src.Pixel(x, y);
+      const uint8_t *q = bgra.Pixel(x, y);
+      EXPECT_TRUE(p[0] == q[2] && p[1] == q[1] && p[2] == q[0] && p[3] == q[3]);
+      q = rgbx.Pixel(x, y);
+      EXPECT_TRUE(p[0] == q[0] && p[1] == q[1] && p[2] == q[2] && q[3] == 0xff);
+      uint32_t word = *reinterpret_cast<uint32_t *>(rgb10.Pixel(x, y));
+      EXPECT_NEAR(p[0] * 1023.0 / 255.0, word & 0x3ff, 0.5);
+      EXPECT_NEAR(p[3] * 3.0 / 255.0, word >> 30, 0.5);
+    }
+  }
+}
+
+TEST(CpuBlitTest, StitchScaledMatchesReference) {
+  CpuBlitter blitter(3);
+  TestImage src(kCpuBlitRGBA8888, 50, 40);
+  FillRandom(&src, 6);
+  TestImage dst(kCpuBlitRGBA8888, 120, 100);
+  LayerRect src_rect = {5, 5, 45, 35};
+  LayerRect dst_rect = {10, 10, 110, 70};
+  ASSERT_EQ(kErrorNone, blitter.Stitch(src.image, src_rect, dst.image, dst_rect, kNoRect));
+  for (uint32_t y = 10; y < 70; y++) {
+    for (uint32_t x = 10; x < 110; x++) {
+      for (int c = 0; c < 4; c++) {
+        double expected = Sample(src, src_rect, dst_rect, x, y, c) * 255.0;
+        ASSERT_NEAR(expected, dst.Pixel(x, y)[c], 1.0) << x << "," << y << " " << c;
+      }
+    }
+  }
+}
+
+TEST(CpuBlitTest, StitchScissorClearsAndClips) {
+  CpuBlitter blitter(2);
+  TestImage src(kCpuBlitRGBA8888, 40, 40, 0x80);
+  TestImage dst(kCpuBlitRGBA8888, 100, 60, 0xff);
+  LayerRect scissor = {0, 0, 50, 60};
+  ASSERT_EQ(kErrorNone, blitter.Stitch(src.image, kNoRect, dst.image, {30, 10, 70, 50}, scissor));
+  // Drawn inside the scissor, transparent in the rest of it, untouched outside of it.
+  EXPECT_EQ(0x80, dst.Pixel(30, 10)[0]);
+  EXPECT_EQ(0x80, dst.Pixel(49, 49)[3]);
+  EXPECT_EQ(0, dst.Pixel(29, 10)[3]);
+  EXPECT_EQ(0, dst.Pixel(40, 50)[3]);
+  EXPECT_EQ(0xff, dst.Pixel(50, 10)[0]);
+  EXPECT_EQ(0xff, dst.Pixel(99, 59)[3]);
+}
+
+TEST(CpuBlitTest, StitchClipsToDestination) {
+  CpuBlitter blitter(1);
+  TestImage src(kCpuBlitRGBA8888, 20, 20);
+  FillRandom(&src, 7);
+  TestImage dst(kCpuBlitRGBA8888, 30, 30);
+  ASSERT_EQ(kErrorNone, blitter.Stitch(src.image, kNoRect, dst.image, {20, 20, 40, 40}, kNoRect));
+  for (uint32_t y = 0; y < 10; y++) {
+    EXPECT_EQ(0, memcmp(src.Pixel(0, y), dst.Pixel(20, 20 + y), 10 * 4)) << y;
+  }
+}
+
+TEST(CpuBlitTest, CopyKeepsStridePadding) {
+  CpuBlitter blitter(3);
+  TestImage src(kCpuBlitNV12, 101, 77);
+  FillRandom(&src, 8);
+  std::fill(src.data[1].begin(), src.data[1].end(), 0x33);
+  TestImage dst(kCpuBlitNV12, 101, 77, 0xee);
+  ASSERT_EQ(kErrorNone, blitter.Copy(src.image, dst.image));
+  for (uint32_t y = 0; y < 77; y++) {
+    const uint8_t *row = dst.image.planes[0].base + size_t(y) * dst.image.planes[0].stride;
+    EXPECT_EQ(0, memcmp(src.image.planes[0].base + size_t(y) * src.image.planes[0].stride, row,
+                        101)) << y;
+    EXPECT_EQ(0xee, row[101]);
+  }
+  // The odd width still gets a whole CbCr pair for the last column.
+  for (uint32_t y = 0; y < 39; y++) {
+    EXPECT_EQ(0x33, dst.Chroma(100, y * 2, 1));
+    EXPECT_EQ(0xee, dst.image.planes[1].base[size_t(y) * dst.image.planes[1].stride + 102]);
+  }
+}
+
+TEST(CpuBlitTest, CopyConvertsRGBFormats) {
+  CpuBlitter blitter(2);
+  TestImage rgb10(kCpuBlitRGBA1010102, 33, 9);
+  FillRandom(&rgb10, 9);
+  TestImage rgba(kCpuBlitRGBA8888, 33, 9);
+  TestImage bgra(kCpuBlitBGRA8888, 33, 9);
+  TestImage back(kCpuBlitRGBA1010102, 33, 9);
+  ASSERT_EQ(kErrorNone, blitter.Copy(rgb10.image, rgba.image));
+  ASSERT_EQ(kErrorNone, blitter.Copy(rgba.image, bgra.image));
+  ASSERT_EQ(kErrorNone, blitter.Copy(bgra.image, back.image));
+  for (uint32_t y = 0; y < 9; y++) {
+    for (uint32_t x = 0; x < 33; x++) {
+      uint32_t word = *reinterpret_cast<uint32_t *>(rgb10.Pixel(x, y));
+      const uint8_t *p = rgba.Pixel(x, y);
+      for (int c = 0; c < 3; c++) {
+        uint32_t expected = UINT32(((word >> (10 * c)) & 0x3ff) * 255.0 / 1023.0 + 0.5);
+        ASSERT_EQ(expected, p[c]) << x << "," << y << " " << c;
+        ASSERT_EQ(p[c], bgra.Pixel(x, y)[2 - c]);
+      }
+      ASSERT_EQ((word >> 30) * 85, p[3]);
+      // Widening the narrowed codes lands back within half an 8 bit step.
+      uint32_t round_trip = *reinterpret_cast<uint32_t *>(back.Pixel(x, y));
+      EXPECT_NEAR(word & 0x3ff, round_trip & 0x3ff, 2.0);
+      EXPECT_EQ(word >> 30, round_trip >> 30);
+    }
+  }
+}
+
+TEST(CpuBlitTest, CopyRoundTripsNV12ThroughP010) {
+  CpuBlitter blitter(4);
+  TestImage nv12(kCpuBlitNV12, 64, 32);
+  FillRandom(&nv12, 10);
+  std::mt19937 rng(11);
+  for (auto &byte : nv12.data[1]) {
+    byte = UINT8(rng());
+  }
+  TestImage p010(kCpuBlitP010, 64, 32);
+  TestImage back(kCpuBlitNV12, 64, 32);
+  ASSERT_EQ(kErrorNone, blitter.Copy(nv12.image, p010.image));
+  ASSERT_EQ(kErrorNone, blitter.Copy(p010.image, back.image));
+  for (uint32_t y = 0; y < 32; y++) {
+    for (uint32_t x = 0; x < 64; x++) {
+      ASSERT_EQ(UINT32(nv12.Luma(x, y) * 1023.0 / 255.0 + 0.5), p010.Luma(x, y));
+      ASSERT_EQ(nv12.Luma(x, y), back.Luma(x, y));
+      ASSERT_EQ(nv12.Chroma(x, y, x & 1), back.Chroma(x, y, x & 1));
+    }
+  }
+}
+
+TEST(CpuBlitTest, CopyRejectsMismatchedImages) {
+  CpuBlitter blitter(1);
+  TestImage rgba(kCpuBlitRGBA8888, 8, 8);
+  TestImage small(kCpuBlitRGBA8888, 8, 4);
+  TestImage nv12(kCpuBlitNV12, 8, 8);
+  EXPECT_EQ(kErrorParameters, blitter.Copy(rgba.image, small.image));
+  EXPECT_EQ(kErrorParameters, blitter.Copy(rgba.image, nv12.image));
+  EXPECT_EQ(kErrorParameters, blitter.Copy(nv12.image, rgba.image));
+}
+
+TEST(CpuBlitTest, ClearZeroesTheWholeRange) {
+  CpuBlitter blitter(3);
+  // Not a multiple of the chunk size, with guard bytes on both sides.
+  std::vector<uint8_t> buffer((5 << 20) + 1234, 0xa5);
+  blitter.Clear(buffer.data() + 1, buffer.size() - 2);
+  EXPECT_EQ(0xa5, buffer.front());
+  EXPECT_EQ(0xa5, buffer.back());
+  EXPECT_TRUE(std::all_of(buffer.begin() + 1, buffer.end() - 1, [](uint8_t b) { return !b; }));
+}
+
+}  // namespace
+}  // namespace sdm
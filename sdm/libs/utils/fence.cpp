@@ -143,6 +143,16 @@ string Fence::GetStr(const shared_ptr<Fence> &fence) {
   return std::to_string(Fence::Get(fence));
 }
 
+int Fence::GetSignalTime(const shared_ptr<Fence> &fence, int64_t *timestamp_ns) {
+  ASSERT_IF_NO_BUFFER_SYNC(g_buffer_sync_handler_);
+
+  if (!fence) {
+    return -EINVAL;
+  }
+
+  return g_buffer_sync_handler_->GetSignalTime(Fence::Get(fence), timestamp_ns);
+}
+
 void Fence::Dump(std::ostringstream *os) {
   ASSERT_IF_NO_BUFFER_SYNC(g_buffer_sync_handler_);
 
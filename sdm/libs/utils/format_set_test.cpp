@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <private/hw_info_types.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+// One format from each value group of LayerBufferFormat, both ends of the RGB group included.
+const std::vector<LayerBufferFormat> kFormats = {
+    kFormatARGB8888,           kFormatRGBA8888,           kFormatRGBA8888Ubwc,
+    kFormatYCbCr420Planar,     kFormatYCbCr420SemiPlanar, kFormatYCbCr420SPVenusUbwc,
+    kFormatYCbCr420P010Ubwc,   kFormatYCbCr422H2V1Packed,
+};
+
+TEST(FormatSetTest, EmptySetContainsNothing) {
+  FormatSet set;
+  EXPECT_TRUE(set.Empty());
+  EXPECT_EQ(set.Count(), 0u);
+  for (auto format : kFormats) {
+    EXPECT_FALSE(set.Contains(format)) << format;
+  }
+}
+
+TEST(FormatSetTest, InsertOnlyAddsOnce) {
+  FormatSet set;
+  EXPECT_TRUE(set.Insert(kFormatRGBA8888));
+  EXPECT_FALSE(set.Insert(kFormatRGBA8888));
+  EXPECT_FALSE(set.Empty());
+  EXPECT_EQ(set.Count(), 1u);
+  EXPECT_TRUE(set.Contains(kFormatRGBA8888));
+  EXPECT_FALSE(set.Contains(kFormatRGBA8888Ubwc));
+}
+
+// Lookups agree with the std::find the writeback check used to run over the format list.
+TEST(FormatSetTest, MatchesLinearScan) {
+  for (size_t mask = 0; mask < (1u << kFormats.size()); mask++) {
+    std::vector<LayerBufferFormat> list;
+    FormatSet set;
+    for (size_t i = 0; i < kFormats.size(); i++) {
+      if (mask & (1u << i)) {
+        list.push_back(kFormats[i]);
+        set.Insert(kFormats[i]);
+      }
+    }
+    ASSERT_EQ(set.Count(), list.size());
+    for (auto format : kFormats) {
+      bool listed = std::find(list.begin(), list.end(), format) != list.end();
+      ASSERT_EQ(set.Contains(format), listed) << "Mask " << mask << " format " << format;
+    }
+  }
+}
+
+TEST(FormatSetTest, OutOfRangeFormatsAreRejected) {
+  FormatSet set;
+  EXPECT_FALSE(set.Insert(kFormatInvalid));
+  EXPECT_FALSE(set.Insert(static_cast<LayerBufferFormat>(0x800)));
+  EXPECT_FALSE(set.Insert(static_cast<LayerBufferFormat>(0x140)));
+  EXPECT_TRUE(set.Empty());
+  EXPECT_FALSE(set.Contains(kFormatInvalid));
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <utils/lru_cache.h>
+
+#include <memory>
+#include <random>
+#include <string>
+
+namespace sdm {
+namespace {
+
+TEST(LruCacheTest, FindsInsertedValues) {
+  LruCache<std::string> cache(100);
+  EXPECT_EQ(cache.Find(1), nullptr);
+  ASSERT_NE(cache.Insert(1, "srgb", 10), nullptr);
+  ASSERT_NE(cache.Insert(2, "p3", 10), nullptr);
+
+  ASSERT_NE(cache.Find(1), nullptr);
+  EXPECT_EQ(*cache.Find(1), "srgb");
+  EXPECT_EQ(*cache.Find(2), "p3");
+  EXPECT_EQ(cache.GetStats().hits, 3U);
+  EXPECT_EQ(cache.GetStats().misses, 1U);
+  EXPECT_EQ(cache.GetHitRate(), 75U);
+  EXPECT_EQ(cache.GetStats().bytes, 20U);
+  EXPECT_EQ(cache.GetStats().count, 2U);
+}
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+  LruCache<std::string> cache(30);
+  cache.Insert(1, "srgb", 10);
+  cache.Insert(2, "p3", 10);
+  cache.Insert(3, "hdr", 10);
+  cache.Find(1);
+  cache.Insert(4, "native", 15);
+
+  EXPECT_NE(cache.Find(1), nullptr);
+  EXPECT_EQ(cache.Find(2), nullptr);
+  EXPECT_EQ(cache.Find(3), nullptr);
+  EXPECT_NE(cache.Find(4), nullptr);
+  EXPECT_EQ(cache.GetStats().evictions, 2U);
+  EXPECT_EQ(cache.GetStats().bytes, 25U);
+}
+
+TEST(LruCacheTest, ReplacesAndDropsOversized) {
+  LruCache<std::string> cache(30);
+  cache.Insert(1, "srgb", 10);
+  cache.Insert(1, "srgb2", 20);
+  EXPECT_EQ(*cache.Find(1), "srgb2");
+  EXPECT_EQ(cache.GetStats().bytes, 20U);
+
+  EXPECT_EQ(cache.Insert(2, "huge", 31), nullptr);
+  EXPECT_EQ(cache.Find(2), nullptr);
+  EXPECT_NE(cache.Find(1), nullptr);
+
+  cache.SetBudget(15);
+  EXPECT_EQ(cache.Find(1), nullptr);
+  EXPECT_EQ(cache.GetStats().bytes, 0U);
+}
+
+TEST(LruCacheTest, DestroysMoveOnlyValues) {
+  auto counter = std::make_shared<int>(0);
+  {
+    LruCache<std::shared_ptr<int>> cache(2);
+    cache.Insert(1, std::shared_ptr<int>(counter), 1);
+    cache.Insert(2, std::shared_ptr<int>(counter), 1);
+    EXPECT_EQ(counter.use_count(), 3);
+    cache.Insert(3, std::shared_ptr<int>(counter), 1);
+    EXPECT_EQ(counter.use_count(), 3);
+    cache.Erase(3);
+    EXPECT_EQ(counter.use_count(), 2);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+
+  LruCache<std::unique_ptr<int>> cache(4);
+  cache.Insert(1, std::unique_ptr<int>(new int(7)), 4);
+  ASSERT_NE(cache.Find(1), nullptr);
+  EXPECT_EQ(**cache.Find(1), 7);
+  cache.Clear();
+  EXPECT_EQ(cache.Find(1), nullptr);
+}
+
+// Apps switching between a few render intents, now and then with a one-off mode, stay within
+// the budget and mostly hit.
+TEST(LruCacheTest, HitRateOfModeSwitches) {
+  const size_t kModeBytes = 40 * 1024;
+  LruCache<uint64_t> cache(4 * kModeBytes);
+  std::mt19937 rng(3);
+  for (int i = 0; i < 1000; i++) {
+    uint64_t key = (rng() % 10) ? rng() % 3 : 3 + rng() % 20;
+    if (!cache.Find(key)) {
+      cache.Insert(key, key * 2, kModeBytes);
+    }
+    ASSERT_LE(cache.GetStats().bytes, 4 * kModeBytes);
+  }
+  EXPECT_GT(cache.GetHitRate(), 80U);
+}
+
+}  // namespace
+}  // namespace sdm
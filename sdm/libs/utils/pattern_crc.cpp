@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/constants.h>
+#include <utils/pattern_crc.h>
+
+namespace sdm {
+
+// Bit i of F(x) is the parity of (x & kStepMasks[i]).
+static const uint16_t kStepMasks[16] = {0xBFFF, 0x7FFE, 0x4003, 0x8006, 0x000C, 0x0018,
+                                        0x0030, 0x0060, 0x00C0, 0x0180, 0x0300, 0x0600,
+                                        0x0C00, 0x1800, 0x3000, 0xDFFF};
+
+static uint16_t StepBitwise(uint16_t x) {
+  uint16_t out = 0;
+  for (uint32_t bit = 0; bit < 16; bit++) {
+    out |= UINT16((__builtin_parity(x & kStepMasks[bit]) & 1) << bit);
+  }
+  return out;
+}
+
+PatternCRC16::Shift::Shift(uint32_t steps) {
+  // Track where each input bit lands after `steps` applications of F, then expand by linearity.
+  uint16_t basis[16] = {};
+  for (uint32_t bit = 0; bit < 16; bit++) {
+    basis[bit] = UINT16(1 << bit);
+  }
+  const Shift &one = Tables()[0];
+  for (uint32_t step = 0; step < steps; step++) {
+    for (uint32_t bit = 0; bit < 16; bit++) {
+      basis[bit] = one.Apply(basis[bit]);
+    }
+  }
+  Build(basis);
+}
+
+void PatternCRC16::Shift::Build(const uint16_t basis[16]) {
+  for (uint32_t byte = 0; byte < 256; byte++) {
+    uint16_t lo = 0;
+    uint16_t hi = 0;
+    for (uint32_t bit = 0; bit < 8; bit++) {
+      if (byte & (1 << bit)) {
+        lo ^= basis[bit];
+        hi ^= basis[bit + 8];
+      }
+    }
+    lo_[byte] = lo;
+    hi_[byte] = hi;
+  }
+}
+
+const std::array<PatternCRC16::Shift, PatternCRC16::kSlice> &PatternCRC16::Tables() {
+  static const std::array<Shift, kSlice> tables = [] {
+    std::array<Shift, kSlice> out;
+    uint16_t basis[16] = {};
+    for (uint32_t bit = 0; bit < 16; bit++) {
+      basis[bit] = UINT16(1 << bit);
+    }
+    for (uint32_t n = 0; n < kSlice; n++) {
+      for (uint32_t bit = 0; bit < 16; bit++) {
+        basis[bit] = StepBitwise(basis[bit]);
+      }
+      out[n].Build(basis);
+    }
+    return out;
+  }();
+  return tables;
+}
+
+uint16_t PatternCRC16::Update(uint16_t crc, const uint16_t *words, uint32_t count) {
+  // Only the lookup pair on crc sits on the dependency chain, the other words are independent.
+  const std::array<Shift, kSlice> &f = Tables();
+  uint32_t i = 0;
+  for (; i + kSlice <= count; i += kSlice) {
+    crc = f[3].Apply(crc ^ words[i]) ^ f[2].Apply(words[i + 1]) ^ f[1].Apply(words[i + 2]) ^
+          f[0].Apply(words[i + 3]);
+  }
+  for (; i < count; i++) {
+    crc = f[0].Apply(crc ^ words[i]);
+  }
+  return crc;
+}
+
+bool PackPatternRow(LayerBufferFormat format, const uint32_t *red, const uint32_t *green,
+                    const uint32_t *blue, uint32_t width, uint8_t *buffer) {
+  // One loop per format keeps the inner loop branch free so it can be vectorized. The four byte
+  // formats are stored as little endian words, as the display buffers are laid out.
+  switch (format) {
+    case kFormatRGBA8888: {
+      uint32_t *dst = reinterpret_cast<uint32_t *>(buffer);
+      for (uint32_t i = 0; i < width; i++) {
+        dst[i] = (red[i] & 0xFF) | ((green[i] & 0xFF) << 8) | ((blue[i] & 0xFF) << 16);
+      }
+      return true;
+    }
+    case kFormatRGB888:
+      for (uint32_t i = 0; i < width; i++) {
+        buffer[3 * i] = UINT8(red[i] & 0xFF);
+        buffer[3 * i + 1] = UINT8(green[i] & 0xFF);
+        buffer[3 * i + 2] = UINT8(blue[i] & 0xFF);
+      }
+      return true;
+    case kFormatRGBA1010102: {
+      uint32_t *dst = reinterpret_cast<uint32_t *>(buffer);
+      for (uint32_t i = 0; i < width; i++) {
+        dst[i] = (red[i] & 0x3FF) | ((green[i] & 0x3FF) << 10) | ((blue[i] & 0x3FF) << 20);
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+}  // namespace sdm
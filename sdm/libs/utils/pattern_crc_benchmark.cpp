@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <benchmark/benchmark.h>
+#include <utils/constants.h>
+#include <utils/pattern_crc.h>
+
+#include <bitset>
+#include <vector>
+
+namespace {
+
+using sdm::LayerBufferFormat;
+using sdm::kFormatRGBA8888;
+using sdm::kFormatRGB888;
+using sdm::kFormatRGBA1010102;
+using sdm::PackPatternRow;
+using sdm::PatternCRC16;
+
+const uint32_t kWidth = 3840;
+
+// The per bit CRC step HWCDisplayPluggableTest::CalcCRC() ran, on a word already shifted for the
+// panel bpp.
+void CalcCRCBitwise(uint16_t word, std::bitset<16> *crc_data) {
+  std::bitset<16> color = word;
+  std::bitset<16> temp_crc = {};
+
+  temp_crc[15] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^
+                 (*crc_data)[4] ^ (*crc_data)[5] ^ (*crc_data)[6] ^ (*crc_data)[7] ^
+                 (*crc_data)[8] ^ (*crc_data)[9] ^ (*crc_data)[10] ^ (*crc_data)[11] ^
+                 (*crc_data)[12] ^ (*crc_data)[14] ^ (*crc_data)[15] ^ color[0] ^ color[1] ^
+                 color[2] ^ color[3] ^ color[4] ^ color[5] ^ color[6] ^ color[7] ^ color[8] ^
+                 color[9] ^ color[10] ^ color[11] ^ color[12] ^ color[14] ^ color[15];
+
+  temp_crc[14] = (*crc_data)[12] ^ (*crc_data)[13] ^ color[12] ^ color[13];
+  temp_crc[13] = (*crc_data)[11] ^ (*crc_data)[12] ^ color[11] ^ color[12];
+  temp_crc[12] = (*crc_data)[10] ^ (*crc_data)[11] ^ color[10] ^ color[11];
+  temp_crc[11] = (*crc_data)[9] ^ (*crc_data)[10] ^ color[9] ^ color[10];
+  temp_crc[10] = (*crc_data)[8] ^ (*crc_data)[9] ^ color[8] ^ color[9];
+  temp_crc[9] = (*crc_data)[7] ^ (*crc_data)[8] ^ color[7] ^ color[8];
+  temp_crc[8] = (*crc_data)[6] ^ (*crc_data)[7] ^ color[6] ^ color[7];
+  temp_crc[7] = (*crc_data)[5] ^ (*crc_data)[6] ^ color[5] ^ color[6];
+  temp_crc[6] = (*crc_data)[4] ^ (*crc_data)[5] ^ color[4] ^ color[5];
+  temp_crc[5] = (*crc_data)[3] ^ (*crc_data)[4] ^ color[3] ^ color[4];
+  temp_crc[4] = (*crc_data)[2] ^ (*crc_data)[3] ^ color[2] ^ color[3];
+  temp_crc[3] = (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[15] ^ color[1] ^ color[2] ^ color[15];
+  temp_crc[2] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[14] ^ color[0] ^ color[1] ^ color[14];
+
+  temp_crc[1] = (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^ (*crc_data)[4] ^ (*crc_data)[5] ^
+                (*crc_data)[6] ^ (*crc_data)[7] ^ (*crc_data)[8] ^ (*crc_data)[9] ^
+                (*crc_data)[10] ^ (*crc_data)[11] ^ (*crc_data)[12] ^ (*crc_data)[13] ^
+                (*crc_data)[14] ^ color[1] ^ color[2] ^ color[3] ^ color[4] ^ color[5] ^ color[6] ^
+                color[7] ^ color[8] ^ color[9] ^ color[10] ^ color[11] ^ color[12] ^ color[13] ^
+                color[14];
+
+  temp_crc[0] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^ (*crc_data)[4] ^
+                (*crc_data)[5] ^ (*crc_data)[6] ^ (*crc_data)[7] ^ (*crc_data)[8] ^ (*crc_data)[9] ^
+                (*crc_data)[10] ^ (*crc_data)[11] ^ (*crc_data)[12] ^ (*crc_data)[13] ^
+                (*crc_data)[15] ^ color[0] ^ color[1] ^ color[2] ^ color[3] ^ color[4] ^ color[5] ^
+                color[6] ^ color[7] ^ color[8] ^ color[9] ^ color[10] ^ color[11] ^ color[12] ^
+                color[13] ^ color[15];
+
+  (*crc_data) = temp_crc;
+}
+
+// The per pixel HWCDisplayPluggableTest::PixelCopy().
+void PixelCopy(LayerBufferFormat format, uint32_t red, uint32_t green, uint32_t blue,
+               uint32_t alpha, uint8_t **buffer) {
+  switch (format) {
+    case kFormatRGBA8888:
+      *(*buffer)++ = UINT8(red & 0xFF);
+      *(*buffer)++ = UINT8(green & 0xFF);
+      *(*buffer)++ = UINT8(blue & 0xFF);
+      *(*buffer)++ = UINT8(alpha & 0xFF);
+      break;
+    case kFormatRGB888:
+      *(*buffer)++ = UINT8(red & 0xFF);
+      *(*buffer)++ = UINT8(green & 0xFF);
+      *(*buffer)++ = UINT8(blue & 0xFF);
+      break;
+    case kFormatRGBA1010102:
+      *(*buffer)++ = UINT8(red & 0xFF);
+      *(*buffer)++ = UINT8(((green & 0x3F) << 2) | ((red >> 0x8) & 0x3));
+      *(*buffer)++ = UINT8(((blue & 0xF) << 4) | ((green >> 6) & 0xF));
+      *(*buffer)++ = UINT8(((alpha & 0x3) << 6) | ((blue >> 4) & 0x3F));
+      break;
+    default:
+      break;
+  }
+}
+
+std::vector<uint32_t> RampRow() {
+  std::vector<uint32_t> row(kWidth);
+  for (uint32_t i = 0; i < kWidth; i++) {
+    row[i] = (i * 4) & 0x3FF;
+  }
+  return row;
+}
+
+// The CRC of one component over a 4K row.
+void BM_CRCBitwise(benchmark::State &state) {
+  std::vector<uint32_t> row = RampRow();
+  for (auto _ : state) {
+    std::bitset<16> crc = 0;
+    for (auto value : row) {
+      CalcCRCBitwise(UINT16(value << 6), &crc);
+    }
+    benchmark::DoNotOptimize(crc);
+  }
+}
+BENCHMARK(BM_CRCBitwise);
+
+void BM_CRCTable(benchmark::State &state) {
+  std::vector<uint32_t> row = RampRow();
+  std::vector<uint16_t> words(kWidth);
+  for (auto _ : state) {
+    for (uint32_t i = 0; i < kWidth; i++) {
+      words[i] = UINT16(row[i] << 6);
+    }
+    benchmark::DoNotOptimize(PatternCRC16::Update(0, words.data(), kWidth));
+  }
+}
+BENCHMARK(BM_CRCTable);
+
+const LayerBufferFormat kFormats[] = {kFormatRGBA8888, kFormatRGB888, kFormatRGBA1010102};
+
+// One 4K row of each format.
+void BM_PixelCopy(benchmark::State &state) {
+  LayerBufferFormat format = kFormats[state.range(0)];
+  std::vector<uint32_t> row = RampRow();
+  std::vector<uint8_t> buffer(4 * kWidth);
+  for (auto _ : state) {
+    uint8_t *dst = buffer.data();
+    for (uint32_t i = 0; i < kWidth; i++) {
+      PixelCopy(format, row[i], row[i], row[i], 0, &dst);
+    }
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_PixelCopy)->DenseRange(0, 2);
+
+void BM_PackPatternRow(benchmark::State &state) {
+  LayerBufferFormat format = kFormats[state.range(0)];
+  std::vector<uint32_t> row = RampRow();
+  std::vector<uint8_t> buffer(4 * kWidth);
+  for (auto _ : state) {
+    PackPatternRow(format, row.data(), row.data(), row.data(), kWidth, buffer.data());
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_PackPatternRow)->DenseRange(0, 2);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <utils/constants.h>
+#include <utils/pattern_crc.h>
+
+#include <bitset>
+#include <random>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+// The per bit CRC step HWCDisplayPluggableTest::CalcCRC() ran, on a word already shifted for the
+// panel bpp.
+void CalcCRCBitwise(uint16_t word, std::bitset<16> *crc_data) {
+  std::bitset<16> color = word;
+  std::bitset<16> temp_crc = {};
+
+  temp_crc[15] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^
+                 (*crc_data)[4] ^ (*crc_data)[5] ^ (*crc_data)[6] ^ (*crc_data)[7] ^
+                 (*crc_data)[8] ^ (*crc_data)[9] ^ (*crc_data)[10] ^ (*crc_data)[11] ^
+                 (*crc_data)[12] ^ (*crc_data)[14] ^ (*crc_data)[15] ^ color[0] ^ color[1] ^
+                 color[2] ^ color[3] ^ color[4] ^ color[5] ^ color[6] ^ color[7] ^ color[8] ^
+                 color[9] ^ color[10] ^ color[11] ^ color[12] ^ color[14] ^ color[15];
+
+  temp_crc[14] = (*crc_data)[12] ^ (*crc_data)[13] ^ color[12] ^ color[13];
+  temp_crc[13] = (*crc_data)[11] ^ (*crc_data)[12] ^ color[11] ^ color[12];
+  temp_crc[12] = (*crc_data)[10] ^ (*crc_data)[11] ^ color[10] ^ color[11];
+  temp_crc[11] = (*crc_data)[9] ^ (*crc_data)[10] ^ color[9] ^ color[10];
+  temp_crc[10] = (*crc_data)[8] ^ (*crc_data)[9] ^ color[8] ^ color[9];
+  temp_crc[9] = (*crc_data)[7] ^ (*crc_data)[8] ^ color[7] ^ color[8];
+  temp_crc[8] = (*crc_data)[6] ^ (*crc_data)[7] ^ color[6] ^ color[7];
+  temp_crc[7] = (*crc_data)[5] ^ (*crc_data)[6] ^ color[5] ^ color[6];
+  temp_crc[6] = (*crc_data)[4] ^ (*crc_data)[5] ^ color[4] ^ color[5];
+  temp_crc[5] = (*crc_data)[3] ^ (*crc_data)[4] ^ color[3] ^ color[4];
+  temp_crc[4] = (*crc_data)[2] ^ (*crc_data)[3] ^ color[2] ^ color[3];
+  temp_crc[3] = (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[15] ^ color[1] ^ color[2] ^ color[15];
+  temp_crc[2] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[14] ^ color[0] ^ color[1] ^ color[14];
+
+  temp_crc[1] = (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^ (*crc_data)[4] ^ (*crc_data)[5] ^
+                (*crc_data)[6] ^ (*crc_data)[7] ^ (*crc_data)[8] ^ (*crc_data)[9] ^
+                (*crc_data)[10] ^ (*crc_data)[11] ^ (*crc_data)[12] ^ (*crc_data)[13] ^
+                (*crc_data)[14] ^ color[1] ^ color[2] ^ color[3] ^ color[4] ^ color[5] ^ color[6] ^
+                color[7] ^ color[8] ^ color[9] ^ color[10] ^ color[11] ^ color[12] ^ color[13] ^
+                color[14];
+
+  temp_crc[0] = (*crc_data)[0] ^ (*crc_data)[1] ^ (*crc_data)[2] ^ (*crc_data)[3] ^ (*crc_data)[4] ^
+                (*crc_data)[5] ^ (*crc_data)[6] ^ (*crc_data)[7] ^ (*crc_data)[8] ^ (*crc_data)[9] ^
+                (*crc_data)[10] ^ (*crc_data)[11] ^ (*crc_data)[12] ^ (*crc_data)[13] ^
+                (*crc_data)[15] ^ color[0] ^ color[1] ^ color[2] ^ color[3] ^ color[4] ^ color[5] ^
+                color[6] ^ color[7] ^ color[8] ^ color[9] ^ color[10] ^ color[11] ^ color[12] ^
+                color[13] ^ color[15];
+
+  (*crc_data) = temp_crc;
+}
+
+// The per pixel HWCDisplayPluggableTest::PixelCopy().
+void PixelCopy(LayerBufferFormat format, uint32_t red, uint32_t green, uint32_t blue,
+               uint32_t alpha, uint8_t **buffer) {
+  switch (format) {
+    case kFormatRGBA8888:
+      *(*buffer)++ = UINT8(red & 0xFF);
+      *(*buffer)++ = UINT8(green & 0xFF);
+      *(*buffer)++ = UINT8(blue & 0xFF);
+      *(*buffer)++ = UINT8(alpha & 0xFF);
+      break;
+    case kFormatRGB888:
+      *(*buffer)++ = UINT8(red & 0xFF);
+      *(*buffer)++ = UINT8(green & 0xFF);
+      *(*buffer)++ = UINT8(blue & 0xFF);
+      break;
+    case kFormatRGBA1010102:
+      *(*buffer)++ = UINT8(red & 0xFF);
+      *(*buffer)++ = UINT8(((green & 0x3F) << 2) | ((red >> 0x8) & 0x3));
+      *(*buffer)++ = UINT8(((blue & 0xF) << 4) | ((green >> 6) & 0xF));
+      *(*buffer)++ = UINT8(((alpha & 0x3) << 6) | ((blue >> 4) & 0x3F));
+      break;
+    default:
+      break;
+  }
+}
+
+// Words as GetCRCWord() shifts them for 18, 24 and 30 bpp panels.
+uint16_t RandomWord(std::mt19937 *rng) {
+  uint32_t value = UINT32((*rng)());
+  switch (value % 3) {
+    case 0:
+      return UINT16(((value >> 8) & 0xFC) << 8);
+    case 1:
+      return UINT16(((value >> 8) & 0xFF) << 8);
+    default:
+      return UINT16(((value >> 8) & 0x3FF) << 6);
+  }
+}
+
+TEST(PatternCRCTest, UpdateMatchesBitwise) {
+  std::mt19937 rng(1);
+  for (uint32_t count = 0; count <= 67; count++) {
+    std::vector<uint16_t> words(count);
+    for (auto &word : words) {
+      word = RandomWord(&rng);
+    }
+    uint16_t start = UINT16(rng());
+
+    std::bitset<16> expected = start;
+    for (auto word : words) {
+      CalcCRCBitwise(word, &expected);
+    }
+    EXPECT_EQ(PatternCRC16::Update(start, words.data(), count), expected.to_ulong())
+        << "Count " << count;
+  }
+}
+
+// A row repeated down the pattern folds in as Shift(width).Apply(crc) ^ Update(0, row), as the
+// per pixel CRC over the whole pattern.
+TEST(PatternCRCTest, RepeatedRowsMatchBitwise) {
+  std::mt19937 rng(2);
+  for (uint32_t width : {1U, 3U, 4U, 37U, 720U, 1921U}) {
+    std::vector<uint16_t> row(width);
+    for (auto &word : row) {
+      word = RandomWord(&rng);
+    }
+
+    std::bitset<16> expected = 0;
+    uint16_t crc = 0;
+    PatternCRC16::Shift shift(width);
+    uint16_t row_crc = PatternCRC16::Update(0, row.data(), width);
+    for (uint32_t line = 0; line < 5; line++) {
+      for (auto word : row) {
+        CalcCRCBitwise(word, &expected);
+      }
+      crc = shift.Apply(crc) ^ row_crc;
+    }
+    EXPECT_EQ(crc, expected.to_ulong()) << "Width " << width;
+  }
+}
+
+TEST(PatternCRCTest, PackRowMatchesPixelCopy) {
+  const LayerBufferFormat kFormats[] = {kFormatRGBA8888, kFormatRGB888, kFormatRGBA1010102};
+  std::mt19937 rng(3);
+  for (auto format : kFormats) {
+    for (uint32_t width = 1; width <= 67; width++) {
+      std::vector<uint32_t> red(width), green(width), blue(width);
+      for (uint32_t i = 0; i < width; i++) {
+        red[i] = UINT32(rng()) & 0x3FF;
+        green[i] = UINT32(rng()) & 0x3FF;
+        blue[i] = UINT32(rng()) & 0x3FF;
+      }
+
+      std::vector<uint8_t> expected(4 * width + 4, 0xA5);
+      uint8_t *dst = expected.data();
+      for (uint32_t i = 0; i < width; i++) {
+        PixelCopy(format, red[i], green[i], blue[i], 0, &dst);
+      }
+
+      std::vector<uint8_t> packed(4 * width + 4, 0xA5);
+      ASSERT_TRUE(PackPatternRow(format, red.data(), green.data(), blue.data(), width,
+                                 packed.data()));
+      EXPECT_EQ(packed, expected) << "Format " << format << " width " << width;
+    }
+  }
+}
+
+TEST(PatternCRCTest, PackRowRejectsOtherFormats) {
+  uint32_t component = 0;
+  uint8_t buffer[4] = {};
+  EXPECT_FALSE(PackPatternRow(kFormatRGB565, &component, &component, &component, 1, buffer));
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <string.h>
+#include <utils/pp_table.h>
+
+// __builtin_shufflevector is in clang and in GCC from 12, the autotools build may use older GCC.
+#ifndef __has_builtin
+#define __has_builtin(x) 0
+#endif
+
+#if __has_builtin(__builtin_shufflevector)
+#define PP_TABLE_SHUFFLE 1
+#endif
+
+namespace sdm {
+
+#ifdef PP_TABLE_SHUFFLE
+// Four words, a NEON register on arm64 and an SSE one on x86.
+typedef uint32_t Words __attribute__((vector_size(16)));
+
+static inline Words Load(const uint32_t *src) {
+  Words words;
+  memcpy(&words, src, sizeof(words));
+  return words;
+}
+
+static inline void Store(const Words &words, uint32_t *dst) {
+  memcpy(dst, &words, sizeof(words));
+}
+#endif
+
+void InterleavePPTables(const uint32_t *first, const uint32_t *second, uint32_t count,
+                        uint32_t *dst) {
+  uint32_t i = 0;
+#ifdef PP_TABLE_SHUFFLE
+  for (; i + 4 <= count; i += 4) {
+    Words first_words = Load(first + i);
+    Words second_words = Load(second + i);
+    Store(__builtin_shufflevector(first_words, second_words, 0, 4, 1, 5), dst + 2 * i);
+    Store(__builtin_shufflevector(first_words, second_words, 2, 6, 3, 7), dst + 2 * i + 4);
+  }
+#endif
+  // Without the builtin this is the whole table, left to the compiler to vectorize.
+  for (; i < count; i++) {
+    dst[2 * i] = first[i];
+    dst[2 * i + 1] = second[i];
+  }
+}
+
+}  // namespace sdm
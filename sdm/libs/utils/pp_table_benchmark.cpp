@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <benchmark/benchmark.h>
+#include <utils/pp_table.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using sdm::InterleavePPTables;
+
+const uint32_t kGamutTableNum = 4;
+const uint32_t kGamutMode17Size = 1229;
+
+// The SDM and DRM gamut layouts, tables behind pointers on one side and interleaved on the other.
+struct SdeGamut {
+  uint32_t *c0_data[kGamutTableNum];
+  uint32_t *c1_c2_data[kGamutTableNum];
+};
+
+struct DrmGamut {
+  struct {
+    uint32_t c0;
+    uint32_t c2_c1;
+  } col[kGamutTableNum][kGamutMode17Size];
+};
+
+class GamutTables {
+ public:
+  GamutTables() : words_(2 * kGamutTableNum * kGamutMode17Size) {
+    for (size_t i = 0; i < words_.size(); i++) {
+      words_[i] = uint32_t(uint64_t(i) * 2654435761U);
+    }
+    for (uint32_t row = 0; row < kGamutTableNum; row++) {
+      gamut_.c0_data[row] = &words_[2 * row * kGamutMode17Size];
+      gamut_.c1_c2_data[row] = &words_[(2 * row + 1) * kGamutMode17Size];
+    }
+  }
+
+  SdeGamut *Get() { return &gamut_; }
+
+ private:
+  std::vector<uint32_t> words_;
+  SdeGamut gamut_ = {};
+};
+
+// The element wise loop GetDrmGamut() ran, over a table length only known at runtime.
+void BM_GamutScalar(benchmark::State &state) {
+  GamutTables tables;
+  std::unique_ptr<DrmGamut> gamut(new DrmGamut());
+  SdeGamut *sde_gamut = tables.Get();
+  uint32_t size = uint32_t(state.range(0));
+  for (auto _ : state) {
+    for (uint32_t row = 0; row < kGamutTableNum; row++) {
+      for (uint32_t col = 0; col < size; col++) {
+        gamut->col[row][col].c0 = sde_gamut->c0_data[row][col];
+        gamut->col[row][col].c2_c1 = sde_gamut->c1_c2_data[row][col];
+      }
+    }
+    benchmark::DoNotOptimize(gamut.get());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * kGamutTableNum * 8);
+}
+BENCHMARK(BM_GamutScalar)->Arg(kGamutMode17Size)->Arg(550)->Arg(32);
+
+void BM_GamutInterleave(benchmark::State &state) {
+  GamutTables tables;
+  std::unique_ptr<DrmGamut> gamut(new DrmGamut());
+  SdeGamut *sde_gamut = tables.Get();
+  uint32_t size = uint32_t(state.range(0));
+  for (auto _ : state) {
+    for (uint32_t row = 0; row < kGamutTableNum; row++) {
+      InterleavePPTables(sde_gamut->c0_data[row], sde_gamut->c1_c2_data[row], size,
+                         &gamut->col[row][0].c0);
+    }
+    benchmark::DoNotOptimize(gamut.get());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * kGamutTableNum * 8);
+}
+BENCHMARK(BM_GamutInterleave)->Arg(kGamutMode17Size)->Arg(550)->Arg(32);
+
+}  // namespace
+
+BENCHMARK_MAIN();
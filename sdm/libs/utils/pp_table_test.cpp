@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <utils/constants.h>
+#include <utils/pp_table.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+// drm_msm_3d_gamut from msm_drm_pp.h, with the table sizes of each gamut mode.
+const uint32_t kGamutTableNum = 4;
+const uint32_t kGamutMode17Size = 1229;
+const uint32_t kGamutModeSizes[] = {kGamutMode17Size, 550, 32};
+
+struct DrmGamut {
+  uint32_t mode;
+  uint32_t flags;
+  uint32_t scale_off[3][16];
+  struct {
+    uint32_t c0;
+    uint32_t c2_c1;
+  } col[kGamutTableNum][kGamutMode17Size];
+};
+
+std::vector<uint32_t> RandomTable(std::mt19937 *rng, size_t count) {
+  std::vector<uint32_t> table(count);
+  for (auto &word : table) {
+    word = UINT32((*rng)());
+  }
+  return table;
+}
+
+// Output with guard words around it, to catch writes past the table.
+class GuardedTable {
+ public:
+  explicit GuardedTable(size_t count) : words_(count + 2 * kGuard, kPattern) {}
+
+  uint32_t *Get() { return &words_[kGuard]; }
+  bool IsIntact() const {
+    for (size_t i = 0; i < kGuard; i++) {
+      if (words_[i] != kPattern || words_[words_.size() - 1 - i] != kPattern) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  static const size_t kGuard = 8;
+  static const uint32_t kPattern = 0xDEADBEEF;
+  std::vector<uint32_t> words_;
+};
+
+// Every gamut mode, against the element wise loop GetDrmGamut() ran.
+TEST(PPTableTest, GamutMatchesScalarInEveryMode) {
+  std::mt19937 rng(1);
+  for (auto size : kGamutModeSizes) {
+    std::vector<uint32_t> c0_data[kGamutTableNum];
+    std::vector<uint32_t> c1_c2_data[kGamutTableNum];
+    for (uint32_t row = 0; row < kGamutTableNum; row++) {
+      c0_data[row] = RandomTable(&rng, size);
+      c1_c2_data[row] = RandomTable(&rng, size);
+    }
+
+    std::unique_ptr<DrmGamut> expected(new DrmGamut());
+    for (uint32_t row = 0; row < kGamutTableNum; row++) {
+      for (uint32_t col = 0; col < size; col++) {
+        expected->col[row][col].c0 = c0_data[row][col];
+        expected->col[row][col].c2_c1 = c1_c2_data[row][col];
+      }
+    }
+
+    std::unique_ptr<DrmGamut> gamut(new DrmGamut());
+    for (uint32_t row = 0; row < kGamutTableNum; row++) {
+      InterleavePPTables(c0_data[row].data(), c1_c2_data[row].data(), size,
+                         &gamut->col[row][0].c0);
+    }
+    EXPECT_EQ(memcmp(gamut.get(), expected.get(), sizeof(DrmGamut)), 0) << "Size " << size;
+  }
+}
+
+// Lengths around the vector width, for the loop tail, from unaligned tables.
+TEST(PPTableTest, OddLengthsStayInBounds) {
+  std::mt19937 rng(2);
+  for (uint32_t count = 0; count <= 37; count++) {
+    std::vector<uint32_t> first = RandomTable(&rng, count + 1);
+    std::vector<uint32_t> second = RandomTable(&rng, count + 1);
+    GuardedTable table(2 * count);
+    InterleavePPTables(&first[1], &second[1], count, table.Get());
+    EXPECT_TRUE(table.IsIntact()) << "Count " << count;
+    for (uint32_t i = 0; i < count; i++) {
+      ASSERT_EQ(table.Get()[2 * i], first[1 + i]) << "Count " << count;
+      ASSERT_EQ(table.Get()[2 * i + 1], second[1 + i]) << "Count " << count;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/refresh_rate_arbiter.h>
+#include <algorithm>
+
+#define __CLASS__ "RefreshRateArbiter"
+
+namespace sdm {
+
+uint32_t RefreshRateArbiter::GetMultipleInRange(uint32_t rate, uint32_t min_rate,
+                                                uint32_t max_rate) {
+  if (!rate) {
+    return max_rate;
+  }
+  if (rate < min_rate) {
+    rate *= (min_rate + rate - 1) / rate;
+  }
+  return std::min(rate, max_rate);
+}
+
+uint32_t RefreshRateArbiter::Select(const RefreshRateInputs &inputs, uint64_t timestamp_ns) {
+  uint32_t target = inputs.default_rate;
+  bool hold_lower = false;
+  if (inputs.forced_rate) {
+    target = inputs.forced_rate;
+  } else if (inputs.idle) {
+    target = inputs.min_rate;
+  } else if (inputs.metadata_rate) {
+    target = inputs.metadata_rate;
+  } else if (inputs.content_rate && !inputs.qsync) {
+    target = GetMultipleInRange(inputs.content_rate, inputs.min_rate, inputs.max_rate);
+    // Content at a lower cadence than the default gains nothing from a faster panel.
+    target = std::min(target, std::max(inputs.default_rate, inputs.min_rate));
+    hold_lower = true;
+  }
+
+  if (hold_lower && current_rate_ && target < current_rate_) {
+    if (target != pending_rate_) {
+      pending_rate_ = target;
+      pending_since_ns_ = timestamp_ns;
+    }
+    if (timestamp_ns - pending_since_ns_ < kLowerHoldNs) {
+      return current_rate_;
+    }
+  }
+
+  pending_rate_ = 0;
+  if (target != current_rate_) {
+    switch_count_++;
+    current_rate_ = target;
+  }
+
+  return current_rate_;
+}
+
+}  // namespace sdm
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/constants.h>
+#include <utils/region.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#define __CLASS__ "Region"
+
+namespace sdm {
+
+// Round out to whole pixels, false for empty rects.
+static bool ToPixels(const LayerRect &rect, int32_t *left, int32_t *top, int32_t *right,
+                     int32_t *bottom) {
+  *left = INT32(floorf(rect.left));
+  *top = INT32(floorf(rect.top));
+  *right = INT32(ceilf(rect.right));
+  *bottom = INT32(ceilf(rect.bottom));
+  return (*right > *left) && (*bottom > *top);
+}
+
+// Merge two sorted lists of span edges, keeping x where the op holds for the spans covering it.
+template <typename Keep>
+static void CombineSpans(const int32_t *a, uint32_t a_edges, const int32_t *b, uint32_t b_edges,
+                         Keep keep, std::vector<int32_t> *out) {
+  const int32_t kEnd = std::numeric_limits<int32_t>::max();
+  uint32_t i = 0, j = 0;
+  bool in_a = false, in_b = false, inside = false;
+  while (i < a_edges || j < b_edges) {
+    int32_t x = std::min((i < a_edges) ? a[i] : kEnd, (j < b_edges) ? b[j] : kEnd);
+    if (i < a_edges && a[i] == x) {
+      in_a = !in_a;
+      i++;
+    }
+    if (j < b_edges && b[j] == x) {
+      in_b = !in_b;
+      j++;
+    }
+    bool now = keep(in_a, in_b);
+    if (now != inside) {
+      out->push_back(x);
+      inside = now;
+    }
+  }
+}
+
+Region::Region(const LayerRect &rect) {
+  int32_t left, top, right, bottom;
+  if (ToPixels(rect, &left, &top, &right, &bottom)) {
+    bands_.push_back({top, bottom, 0, 1});
+    spans_ = {left, right};
+  }
+}
+
+Region::Region(const std::vector<LayerRect> &rects) {
+  std::vector<std::pair<int32_t, size_t>> order;
+  order.reserve(rects.size());
+  int32_t left, top, right, bottom;
+  for (size_t i = 0; i < rects.size(); i++) {
+    if (ToPixels(rects[i], &left, &top, &right, &bottom)) {
+      order.push_back(std::make_pair(left, i));
+    }
+  }
+  if (order.empty()) {
+    return;
+  }
+
+  // Sorted by left edge once, so the spans of every band come out in order. Kept as separate
+  // arrays so the per band coverage test runs over whole batches of rects.
+  std::sort(order.begin(), order.end());
+  size_t count = order.size();
+  std::vector<int32_t> lefts(count), tops(count), rights(count), bottoms(count);
+  std::vector<int32_t> edges(2 * count);
+  for (size_t i = 0; i < count; i++) {
+    ToPixels(rects[order[i].second], &lefts[i], &tops[i], &rights[i], &bottoms[i]);
+    edges[2 * i] = tops[i];
+    edges[2 * i + 1] = bottoms[i];
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  std::vector<uint8_t> covers(count);
+  std::vector<int32_t> merged;
+  for (size_t k = 0; k + 1 < edges.size(); k++) {
+    int32_t y0 = edges[k];
+    int32_t y1 = edges[k + 1];
+    for (size_t i = 0; i < count; i++) {
+      covers[i] = UINT8((tops[i] <= y0) & (bottoms[i] >= y1));
+    }
+
+    merged.clear();
+    for (size_t i = 0; i < count; i++) {
+      if (!covers[i]) {
+        continue;
+      }
+      if (!merged.empty() && lefts[i] <= merged.back()) {
+        merged.back() = std::max(merged.back(), rights[i]);
+      } else {
+        merged.push_back(lefts[i]);
+        merged.push_back(rights[i]);
+      }
+    }
+    AddBand(y0, y1, merged.data(), UINT32(merged.size() / 2));
+  }
+}
+
+void Region::AddBand(int32_t top, int32_t bottom, const int32_t *spans, uint32_t span_count) {
+  if (!span_count) {
+    return;
+  }
+
+  // Join with the band above when it ends here with the same spans.
+  if (!bands_.empty()) {
+    Band &last = bands_.back();
+    if (last.bottom == top && last.span_count == span_count &&
+        !memcmp(&spans_[2 * last.first_span], spans, 2 * span_count * sizeof(int32_t))) {
+      last.bottom = bottom;
+      return;
+    }
+  }
+
+  bands_.push_back({top, bottom, UINT32(spans_.size() / 2), span_count});
+  spans_.insert(spans_.end(), spans, spans + 2 * span_count);
+}
+
+Region Region::Combine(const Region &other, Op op) const {
+  std::vector<int32_t> edges;
+  edges.reserve(2 * (bands_.size() + other.bands_.size()));
+  for (auto &band : bands_) {
+    edges.push_back(band.top);
+    edges.push_back(band.bottom);
+  }
+  for (auto &band : other.bands_) {
+    edges.push_back(band.top);
+    edges.push_back(band.bottom);
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  Region result;
+  std::vector<int32_t> spans;
+  size_t a = 0, b = 0;
+  for (size_t k = 0; k + 1 < edges.size(); k++) {
+    int32_t y0 = edges[k];
+    int32_t y1 = edges[k + 1];
+    while (a < bands_.size() && bands_[a].bottom <= y0) {
+      a++;
+    }
+    while (b < other.bands_.size() && other.bands_[b].bottom <= y0) {
+      b++;
+    }
+
+    // Band edges are all in the list, so a band covering y0 covers up to y1.
+    const Band *band_a = (a < bands_.size() && bands_[a].top <= y0) ? &bands_[a] : nullptr;
+    const Band *band_b =
+        (b < other.bands_.size() && other.bands_[b].top <= y0) ? &other.bands_[b] : nullptr;
+    if (!band_a && !band_b) {
+      continue;
+    }
+
+    const int32_t *a_spans = band_a ? &spans_[2 * band_a->first_span] : nullptr;
+    const int32_t *b_spans = band_b ? &other.spans_[2 * band_b->first_span] : nullptr;
+    uint32_t a_edges = band_a ? 2 * band_a->span_count : 0;
+    uint32_t b_edges = band_b ? 2 * band_b->span_count : 0;
+    spans.clear();
+    switch (op) {
+      case kOpUnion:
+        CombineSpans(a_spans, a_edges, b_spans, b_edges,
+                     [](bool in_a, bool in_b) { return in_a || in_b; }, &spans);
+        break;
+      case kOpIntersect:
+        CombineSpans(a_spans, a_edges, b_spans, b_edges,
+                     [](bool in_a, bool in_b) { return in_a && in_b; }, &spans);
+        break;
+      case kOpSubtract:
+        CombineSpans(a_spans, a_edges, b_spans, b_edges,
+                     [](bool in_a, bool in_b) { return in_a && !in_b; }, &spans);
+        break;
+    }
+    result.AddBand(y0, y1, spans.data(), UINT32(spans.size() / 2));
+  }
+
+  return result;
+}
+
+Region Region::Union(const Region &other) const {
+  if (other.IsEmpty()) {
+    return *this;
+  }
+  if (IsEmpty()) {
+    return other;
+  }
+  return Combine(other, kOpUnion);
+}
+
+Region Region::Intersect(const Region &other) const {
+  if (IsEmpty() || other.IsEmpty()) {
+    return Region();
+  }
+  return Combine(other, kOpIntersect);
+}
+
+Region Region::Subtract(const Region &other) const {
+  if (IsEmpty() || other.IsEmpty()) {
+    return *this;
+  }
+  return Combine(other, kOpSubtract);
+}
+
+uint64_t Region::Area() const {
+  uint64_t area = 0;
+  for (auto &band : bands_) {
+    const int32_t *spans = &spans_[2 * band.first_span];
+    int64_t width = 0;
+    for (uint32_t i = 0; i < band.span_count; i++) {
+      width += int64_t(spans[2 * i + 1]) - spans[2 * i];
+    }
+    area += UINT64(width) * UINT64(int64_t(band.bottom) - band.top);
+  }
+  return area;
+}
+
+LayerRect Region::Bounds() const {
+  if (IsEmpty()) {
+    return LayerRect();
+  }
+
+  int32_t left = std::numeric_limits<int32_t>::max();
+  int32_t right = std::numeric_limits<int32_t>::min();
+  for (auto &band : bands_) {
+    left = std::min(left, spans_[2 * band.first_span]);
+    right = std::max(right, spans_[2 * (band.first_span + band.span_count) - 1]);
+  }
+  return LayerRect(FLOAT(left), FLOAT(bands_.front().top), FLOAT(right),
+                   FLOAT(bands_.back().bottom));
+}
+
+bool Region::Contains(const LayerRect &rect) const {
+  return Region(rect).Subtract(*this).IsEmpty();
+}
+
+std::vector<LayerRect> Region::GetRects() const {
+  std::vector<LayerRect> rects;
+  rects.reserve(spans_.size() / 2);
+  for (auto &band : bands_) {
+    const int32_t *spans = &spans_[2 * band.first_span];
+    for (uint32_t i = 0; i < band.span_count; i++) {
+      rects.push_back(LayerRect(FLOAT(spans[2 * i]), FLOAT(band.top), FLOAT(spans[2 * i + 1]),
+                                FLOAT(band.bottom)));
+    }
+  }
+  return rects;
+}
+
+}  // namespace sdm
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <benchmark/benchmark.h>
+#include <utils/region.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+using sdm::LayerRect;
+using sdm::Region;
+
+// Damage spread over a 1080x2400 panel, from a cursor blink up to a busy launcher.
+std::vector<LayerRect> RandomDamage(size_t count, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<LayerRect> rects(count);
+  for (auto &rect : rects) {
+    float left = static_cast<float>(rng() % 1000);
+    float top = static_cast<float>(rng() % 2300);
+    rect = LayerRect(left, top, left + static_cast<float>(8 + rng() % 200),
+                     top + static_cast<float>(8 + rng() % 200));
+  }
+  return rects;
+}
+
+// Argument: rect count.
+void BM_BuildBatch(benchmark::State &state) {
+  std::vector<LayerRect> rects = RandomDamage(static_cast<size_t>(state.range(0)), 1);
+  for (auto _ : state) {
+    Region region(rects);
+    benchmark::DoNotOptimize(region);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BuildBatch)->RangeMultiplier(4)->Range(1, 256);
+
+void BM_BuildIncremental(benchmark::State &state) {
+  std::vector<LayerRect> rects = RandomDamage(static_cast<size_t>(state.range(0)), 1);
+  for (auto _ : state) {
+    Region region;
+    for (auto &rect : rects) {
+      region = region.Union(Region(rect));
+    }
+    benchmark::DoNotOptimize(region);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BuildIncremental)->RangeMultiplier(4)->Range(1, 256);
+
+// Set operations between two regions built from the given number of rects each.
+void Combine(benchmark::State &state, Region (Region::*op)(const Region &) const) {
+  Region a(RandomDamage(static_cast<size_t>(state.range(0)), 1));
+  Region b(RandomDamage(static_cast<size_t>(state.range(0)), 2));
+  for (auto _ : state) {
+    Region result = (a.*op)(b);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Union(benchmark::State &state) {
+  Combine(state, &Region::Union);
+}
+BENCHMARK(BM_Union)->RangeMultiplier(4)->Range(1, 256);
+
+void BM_Intersect(benchmark::State &state) {
+  Combine(state, &Region::Intersect);
+}
+BENCHMARK(BM_Intersect)->RangeMultiplier(4)->Range(1, 256);
+
+void BM_Subtract(benchmark::State &state) {
+  Combine(state, &Region::Subtract);
+}
+BENCHMARK(BM_Subtract)->RangeMultiplier(4)->Range(1, 256);
+
+void BM_Area(benchmark::State &state) {
+  Region region(RandomDamage(static_cast<size_t>(state.range(0)), 1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(region.Area());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Area)->RangeMultiplier(4)->Range(1, 256);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <utils/rect.h>
+#include <utils/region.h>
+
+#include <bitset>
+#include <random>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+// Regions are checked pixel by pixel against a bitmap of this size. Random rects reach a little
+// beyond it on every side to cover negative and clipped coordinates.
+const int kSize = 48;
+const int kMargin = 4;
+const int kSpan = kSize + 2 * kMargin;
+
+typedef std::bitset<kSpan * kSpan> Bitmap;
+
+bool Covers(const LayerRect &rect, int x, int y) {
+  return x >= INT(floorf(rect.left)) && x < INT(ceilf(rect.right)) &&
+         y >= INT(floorf(rect.top)) && y < INT(ceilf(rect.bottom));
+}
+
+Bitmap Rasterize(const std::vector<LayerRect> &rects) {
+  Bitmap bitmap;
+  for (int y = -kMargin; y < kSize + kMargin; y++) {
+    for (int x = -kMargin; x < kSize + kMargin; x++) {
+      for (auto &rect : rects) {
+        if (Covers(rect, x, y)) {
+          bitmap.set(size_t((y + kMargin) * kSpan + x + kMargin));
+          break;
+        }
+      }
+    }
+  }
+  return bitmap;
+}
+
+Bitmap Rasterize(const Region &region) {
+  return Rasterize(region.GetRects());
+}
+
+LayerRect RandomRect(std::mt19937 *rng) {
+  auto coordinate = [rng]() { return FLOAT(INT((*rng)() % kSpan) - kMargin); };
+  float left = coordinate(), right = coordinate();
+  float top = coordinate(), bottom = coordinate();
+  // A few rects have fractional edges, which are rounded out.
+  if ((*rng)() % 4 == 0) {
+    left += 0.25f;
+    bottom += 0.5f;
+  }
+  return LayerRect(std::min(left, right), std::min(top, bottom), std::max(left, right),
+                   std::max(top, bottom));
+}
+
+std::vector<LayerRect> RandomRects(std::mt19937 *rng, uint32_t max_count) {
+  std::vector<LayerRect> rects((*rng)() % (max_count + 1));
+  for (auto &rect : rects) {
+    rect = RandomRect(rng);
+  }
+  return rects;
+}
+
+// The rects of a region are disjoint and rebuilding from them gives the same region.
+void ExpectCanonical(const Region &region) {
+  std::vector<LayerRect> rects = region.GetRects();
+  uint64_t area = 0;
+  for (auto &rect : rects) {
+    area += UINT64(rect.right - rect.left) * UINT64(rect.bottom - rect.top);
+  }
+  EXPECT_EQ(area, region.Area());
+  EXPECT_EQ(Region(rects), region);
+}
+
+TEST(RegionTest, EmptyRegions) {
+  Region empty;
+  Region rect(LayerRect(0, 0, 10, 10));
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_TRUE(Region(LayerRect(5, 5, 5, 10)).IsEmpty());
+  EXPECT_TRUE(Region(std::vector<LayerRect>()).IsEmpty());
+  EXPECT_EQ(empty.Area(), 0U);
+  EXPECT_EQ(empty.Union(rect), rect);
+  EXPECT_EQ(rect.Union(empty), rect);
+  EXPECT_TRUE(empty.Intersect(rect).IsEmpty());
+  EXPECT_EQ(rect.Subtract(empty), rect);
+  EXPECT_TRUE(rect.Subtract(rect).IsEmpty());
+}
+
+TEST(RegionTest, JoinsTouchingRects) {
+  Region region({LayerRect(0, 0, 10, 10), LayerRect(10, 0, 20, 10), LayerRect(0, 10, 20, 30)});
+  ASSERT_EQ(region.GetRects().size(), 1U);
+  EXPECT_EQ(region, Region(LayerRect(0, 0, 20, 30)));
+}
+
+TEST(RegionTest, SubtractLeavesFrame) {
+  Region frame = Region(LayerRect(0, 0, 30, 30)).Subtract(Region(LayerRect(10, 10, 20, 20)));
+  EXPECT_EQ(frame.Area(), 800U);
+  EXPECT_EQ(frame.GetRects().size(), 4U);
+  EXPECT_TRUE(frame.Contains(LayerRect(0, 0, 30, 10)));
+  EXPECT_FALSE(frame.Contains(LayerRect(5, 5, 15, 15)));
+  EXPECT_TRUE(IsCongruent(frame.Bounds(), LayerRect(0, 0, 30, 30)));
+}
+
+TEST(RegionTest, RandomOperationsMatchBitmap) {
+  std::mt19937 rng(1234);
+  for (uint32_t iteration = 0; iteration < 400; iteration++) {
+    std::vector<LayerRect> rects_a = RandomRects(&rng, 12);
+    std::vector<LayerRect> rects_b = RandomRects(&rng, 12);
+    Region a(rects_a);
+    Region b(rects_b);
+    Bitmap bitmap_a = Rasterize(rects_a);
+    Bitmap bitmap_b = Rasterize(rects_b);
+
+    ASSERT_EQ(Rasterize(a), bitmap_a) << "Iteration " << iteration;
+    ASSERT_EQ(a.Area(), bitmap_a.count()) << "Iteration " << iteration;
+
+    Region incremental;
+    for (auto &rect : rects_a) {
+      incremental = incremental.Union(Region(rect));
+    }
+    ASSERT_EQ(incremental, a) << "Iteration " << iteration;
+
+    Region united = a.Union(b);
+    Region intersected = a.Intersect(b);
+    Region subtracted = a.Subtract(b);
+    ASSERT_EQ(Rasterize(united), bitmap_a | bitmap_b) << "Iteration " << iteration;
+    ASSERT_EQ(Rasterize(intersected), bitmap_a & bitmap_b) << "Iteration " << iteration;
+    ASSERT_EQ(Rasterize(subtracted), bitmap_a & ~bitmap_b) << "Iteration " << iteration;
+    ExpectCanonical(united);
+    ExpectCanonical(intersected);
+    ExpectCanonical(subtracted);
+
+    LayerRect probe = RandomRect(&rng);
+    Bitmap bitmap_probe = Rasterize(std::vector<LayerRect>{probe});
+    ASSERT_EQ(a.Contains(probe), (bitmap_probe & ~bitmap_a).none()) << "Iteration " << iteration;
+
+    if (!a.IsEmpty()) {
+      LayerRect bounds = a.Bounds();
+      Bitmap outside = bitmap_a & ~Rasterize(std::vector<LayerRect>{bounds});
+      ASSERT_TRUE(outside.none()) << "Iteration " << iteration;
+      ASSERT_EQ(Rasterize(a.Intersect(Region(bounds))), bitmap_a);
+    }
+    if (HasFailure()) {
+      FAIL() << "Iteration " << iteration;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace sdm
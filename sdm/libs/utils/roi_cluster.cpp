@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/constants.h>
+#include <utils/rect.h>
+#include <utils/roi_cluster.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#define __CLASS__ "RoiCluster"
+
+namespace sdm {
+
+static int64_t AlignDown(int64_t value, int64_t align) {
+  return (align > 1) ? (value / align) * align : value;
+}
+
+static int64_t AlignUp(int64_t value, int64_t align) {
+  return (align > 1) ? ((value + align - 1) / align) * align : value;
+}
+
+static uint64_t GetArea(const LayerRect &rect) {
+  return UINT64(rect.right - rect.left) * UINT64(rect.bottom - rect.top);
+}
+
+// Grow rect to the panel alignment and minimum size, staying within bounds.
+static LayerRect Align(const LayerRect &rect, const LayerRect &bounds,
+                       const RoiClusterConfig &config) {
+  int64_t bounds_left = static_cast<int64_t>(bounds.left);
+  int64_t bounds_top = static_cast<int64_t>(bounds.top);
+  int64_t bounds_right = static_cast<int64_t>(bounds.right);
+  int64_t bounds_bottom = static_cast<int64_t>(bounds.bottom);
+
+  int64_t left = AlignDown(std::max(static_cast<int64_t>(floorf(rect.left)), bounds_left),
+                           config.left_align);
+  int64_t top = AlignDown(std::max(static_cast<int64_t>(floorf(rect.top)), bounds_top),
+                          config.top_align);
+  int64_t right = std::min(static_cast<int64_t>(ceilf(rect.right)), bounds_right);
+  int64_t bottom = std::min(static_cast<int64_t>(ceilf(rect.bottom)), bounds_bottom);
+  int64_t width = AlignUp(std::max(right - left, int64_t(config.min_width)), config.width_align);
+  int64_t height = AlignUp(std::max(bottom - top, int64_t(config.min_height)),
+                           config.height_align);
+
+  // Near the far edges keep the size and move back in rather than losing the alignment of the
+  // size, the panel dimensions are multiples of it.
+  right = left + width;
+  if (right > bounds_right) {
+    right = bounds_right;
+    left = std::max(bounds_left, right - width);
+  }
+  bottom = top + height;
+  if (bottom > bounds_bottom) {
+    bottom = bounds_bottom;
+    top = std::max(bounds_top, bottom - height);
+  }
+
+  return LayerRect(FLOAT(left), FLOAT(top), FLOAT(right), FLOAT(bottom));
+}
+
+uint64_t GetRoiCost(const std::vector<LayerRect> &rois, const RoiClusterConfig &config) {
+  uint64_t cost = 0;
+  for (auto &roi : rois) {
+    cost += GetArea(roi) + config.roi_overhead;
+  }
+  return cost;
+}
+
+void ClusterDirtyRegions(const std::vector<LayerRect> &dirty_regions, const LayerRect &bounds,
+                         const RoiClusterConfig &config, std::vector<LayerRect> *rois) {
+  rois->clear();
+  for (auto &dirty : dirty_regions) {
+    LayerRect rect = Intersection(dirty, bounds);
+    if (IsValid(rect)) {
+      rois->push_back(Align(rect, bounds, config));
+    }
+  }
+
+  size_t max_rois = std::max(config.max_rois, 1U);
+  auto by_top = [](const LayerRect &a, const LayerRect &b) { return a.top < b.top; };
+  while (rois->size() > 1) {
+    std::sort(rois->begin(), rois->end(), by_top);
+
+    // ROIs sharing rows are merged unconditionally. Sorted by top, any overlap shows up between
+    // neighbours. Otherwise merge the neighbours that are cheapest to merge, as long as that
+    // saves cost or there are more ROIs than the panel takes. Only neighbours are considered,
+    // merging across an ROI would swallow its rows.
+    size_t merge_index = rois->size();
+    int64_t best_delta = INT64_MAX;
+    for (size_t i = 0; i + 1 < rois->size(); i++) {
+      const LayerRect &upper = rois->at(i);
+      const LayerRect &lower = rois->at(i + 1);
+      if (lower.top < upper.bottom) {
+        merge_index = i;
+        best_delta = INT64_MIN;
+        break;
+      }
+
+      LayerRect merged = Align(Union(upper, lower), bounds, config);
+      int64_t delta = int64_t(GetArea(merged)) - int64_t(GetArea(upper)) -
+                      int64_t(GetArea(lower)) - int64_t(config.roi_overhead);
+      if (delta < best_delta) {
+        best_delta = delta;
+        merge_index = i;
+      }
+    }
+
+    if (best_delta > 0 && rois->size() <= max_rois) {
+      break;
+    }
+
+    LayerRect merged = Align(Union(rois->at(merge_index), rois->at(merge_index + 1)), bounds,
+                             config);
+    rois->at(merge_index) = merged;
+    rois->erase(rois->begin() + INT(merge_index) + 1);
+  }
+}
+
+}  // namespace sdm
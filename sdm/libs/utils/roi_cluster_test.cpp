@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <utils/rect.h>
+#include <utils/roi_cluster.h>
+
+#include <random>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+const LayerRect kPanel(0, 0, 1080, 2400);
+
+RoiClusterConfig MultiRoiPanel() {
+  RoiClusterConfig config;
+  config.max_rois = 2;
+  config.left_align = 4;
+  config.width_align = 4;
+  config.top_align = 2;
+  config.height_align = 2;
+  config.min_width = 8;
+  config.min_height = 8;
+  config.roi_overhead = 1080 * 8;
+  return config;
+}
+
+bool IsAligned(const LayerRect &roi, const RoiClusterConfig &config) {
+  return (INT(roi.left) % INT(config.left_align) == 0) &&
+         (INT(roi.top) % INT(config.top_align) == 0) &&
+         (INT(roi.right - roi.left) % INT(config.width_align) == 0) &&
+         (INT(roi.bottom - roi.top) % INT(config.height_align) == 0) &&
+         (roi.right - roi.left >= FLOAT(config.min_width)) &&
+         (roi.bottom - roi.top >= FLOAT(config.min_height));
+}
+
+void ExpectValidRois(const std::vector<LayerRect> &dirty, const std::vector<LayerRect> &rois,
+                     const RoiClusterConfig &config) {
+  ASSERT_LE(rois.size(), config.max_rois);
+  for (size_t i = 0; i < rois.size(); i++) {
+    EXPECT_TRUE(IsAligned(rois[i], config));
+    EXPECT_TRUE(Contains(kPanel, rois[i]));
+    if (i > 0) {
+      EXPECT_LE(rois[i - 1].bottom, rois[i].top) << "ROIs " << i - 1 << " and " << i;
+    }
+  }
+  for (auto &rect : dirty) {
+    LayerRect remaining = Intersection(rect, kPanel);
+    for (auto &roi : rois) {
+      if (Contains(roi, remaining)) {
+        remaining = LayerRect();
+        break;
+      }
+    }
+    EXPECT_FALSE(IsValid(remaining)) << "Dirty rect " << rect.left << "," << rect.top
+                                     << " is not covered by a single ROI";
+  }
+}
+
+TEST(RoiClusterTest, NoDirtyRegionGivesNoRoi) {
+  std::vector<LayerRect> rois;
+  ClusterDirtyRegions({}, kPanel, MultiRoiPanel(), &rois);
+  EXPECT_TRUE(rois.empty());
+
+  ClusterDirtyRegions({LayerRect(2000, 3000, 2100, 3100)}, kPanel, MultiRoiPanel(), &rois);
+  EXPECT_TRUE(rois.empty());
+}
+
+TEST(RoiClusterTest, AlignsSingleRegion) {
+  std::vector<LayerRect> rois;
+  ClusterDirtyRegions({LayerRect(5, 3, 7, 4)}, kPanel, MultiRoiPanel(), &rois);
+  ASSERT_EQ(rois.size(), 1U);
+  EXPECT_TRUE(IsCongruent(rois[0], LayerRect(4, 2, 12, 10)));
+}
+
+TEST(RoiClusterTest, KeepsAlignedSizeAtFarEdges) {
+  std::vector<LayerRect> rois;
+  ClusterDirtyRegions({LayerRect(1078, 2399, 1080, 2400)}, kPanel, MultiRoiPanel(), &rois);
+  ASSERT_EQ(rois.size(), 1U);
+  EXPECT_TRUE(IsCongruent(rois[0], LayerRect(1072, 2392, 1080, 2400)));
+}
+
+// A status bar clock and a cursor in the opposite corner stay two ROIs.
+TEST(RoiClusterTest, SplitsDistantRegions) {
+  std::vector<LayerRect> dirty = {LayerRect(40, 20, 200, 80), LayerRect(900, 2200, 932, 2232)};
+  std::vector<LayerRect> rois;
+  RoiClusterConfig config = MultiRoiPanel();
+  ClusterDirtyRegions(dirty, kPanel, config, &rois);
+  ASSERT_EQ(rois.size(), 2U);
+  ExpectValidRois(dirty, rois, config);
+  EXPECT_LT(GetRoiCost(rois, config), GetRoiCost({Union(rois[0], rois[1])}, config));
+}
+
+// Two regions a few rows apart are cheaper to send as one ROI than to pay the overhead twice.
+TEST(RoiClusterTest, MergesWhenOverheadDominates) {
+  std::vector<LayerRect> dirty = {LayerRect(100, 100, 300, 140), LayerRect(100, 144, 300, 180)};
+  std::vector<LayerRect> rois;
+  RoiClusterConfig config = MultiRoiPanel();
+  ClusterDirtyRegions(dirty, kPanel, config, &rois);
+  ASSERT_EQ(rois.size(), 1U);
+  EXPECT_TRUE(IsCongruent(rois[0], LayerRect(100, 100, 300, 180)));
+
+  config.roi_overhead = 0;
+  ClusterDirtyRegions(dirty, kPanel, config, &rois);
+  EXPECT_EQ(rois.size(), 2U);
+}
+
+// Side by side regions share rows, which the panel can not take as separate ROIs.
+TEST(RoiClusterTest, MergesRegionsSharingRows) {
+  std::vector<LayerRect> dirty = {LayerRect(0, 500, 100, 600), LayerRect(900, 550, 1000, 650)};
+  std::vector<LayerRect> rois;
+  RoiClusterConfig config = MultiRoiPanel();
+  config.roi_overhead = 0;
+  ClusterDirtyRegions(dirty, kPanel, config, &rois);
+  ASSERT_EQ(rois.size(), 1U);
+  EXPECT_TRUE(IsCongruent(rois[0], LayerRect(0, 500, 1000, 650)));
+}
+
+TEST(RoiClusterTest, LimitsToPanelRoiCount) {
+  std::vector<LayerRect> dirty = {LayerRect(0, 0, 64, 64), LayerRect(0, 1000, 64, 1064),
+                                  LayerRect(0, 1200, 64, 1264), LayerRect(0, 2300, 64, 2364)};
+  std::vector<LayerRect> rois;
+  RoiClusterConfig config = MultiRoiPanel();
+  config.roi_overhead = 0;
+  ClusterDirtyRegions(dirty, kPanel, config, &rois);
+  ASSERT_EQ(rois.size(), 2U);
+  ExpectValidRois(dirty, rois, config);
+  // The two middle regions are the closest pair, the top one is closer to them than the bottom.
+  EXPECT_TRUE(IsCongruent(rois[0], LayerRect(0, 0, 64, 1264)));
+  EXPECT_TRUE(IsCongruent(rois[1], LayerRect(0, 2300, 64, 2364)));
+
+  config.max_rois = 4;
+  ClusterDirtyRegions(dirty, kPanel, config, &rois);
+  EXPECT_EQ(rois.size(), 4U);
+
+  config.max_rois = 1;
+  ClusterDirtyRegions(dirty, kPanel, config, &rois);
+  ASSERT_EQ(rois.size(), 1U);
+  EXPECT_TRUE(IsCongruent(rois[0], LayerRect(0, 0, 64, 2364)));
+}
+
+TEST(RoiClusterTest, RandomDamageStaysWithinPanelRules) {
+  std::mt19937 rng(7);
+  for (uint32_t iteration = 0; iteration < 500; iteration++) {
+    RoiClusterConfig config = MultiRoiPanel();
+    config.max_rois = 1 + UINT32(rng() % 4);
+    config.roi_overhead = UINT32(rng() % (1080 * 64));
+    std::vector<LayerRect> dirty;
+    uint32_t count = 1 + UINT32(rng() % 12);
+    for (uint32_t i = 0; i < count; i++) {
+      float left = FLOAT(rng() % 1100);
+      float top = FLOAT(rng() % 2450);
+      dirty.push_back(LayerRect(left, top, left + FLOAT(1 + rng() % 300),
+                                top + FLOAT(1 + rng() % 300)));
+    }
+
+    std::vector<LayerRect> rois;
+    ClusterDirtyRegions(dirty, kPanel, config, &rois);
+    ExpectValidRois(dirty, rois, config);
+    if (HasFailure()) {
+      FAIL() << "Iteration " << iteration;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/stage_latency.h>
+#include <utils/constants.h>
+#include <time.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sdm {
+
+std::atomic<bool> StageLatency::enabled_(true);
+
+namespace {
+
+const char *kStageNames[kStageMax] = {
+  "BuildLayerStack", "Prepare", "Validate", "SetupAtomic", "AtomicCommit", "PostCommit",
+};
+
+// Values below 2^kSubBucketBits are exact, every power of two range above that is split into
+// 2^(kSubBucketBits - 1) equal buckets, which bounds the error to 1/64 of the value.
+constexpr uint32_t kSubBucketBits = 7;
+constexpr uint32_t kSubBucketHalf = 1 << (kSubBucketBits - 1);
+constexpr uint32_t kMaxValueBits = 24;  // ~16.7s in us
+constexpr uint64_t kMaxValue = (UINT64(1) << kMaxValueBits) - 1;
+constexpr uint32_t kBucketCount = (kMaxValueBits - kSubBucketBits + 2) * kSubBucketHalf;
+
+class LatencyHistogram {
+ public:
+  void Add(uint64_t value) {
+    value = std::min(value, kMaxValue);
+    counts_[Index(value)]++;
+    count_++;
+    sum_ += value;
+    max_ = std::max(max_, value);
+  }
+
+  uint64_t Percentile(double percentile) const {
+    uint64_t target = std::max(UINT64(1), UINT64(std::ceil(percentile / 100.0 * count_)));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kBucketCount; i++) {
+      seen += counts_[i];
+      if (seen >= target) {
+        return std::min(HighestEquivalent(i), max_);
+      }
+    }
+    return max_;
+  }
+
+  uint64_t Count() const { return count_; }
+  uint64_t Mean() const { return count_ ? sum_ / count_ : 0; }
+  uint64_t Max() const { return max_; }
+
+ private:
+  static uint32_t Index(uint64_t value) {
+    if (value < 2 * kSubBucketHalf) {
+      return UINT32(value);
+    }
+    uint32_t shift = UINT32(63 - __builtin_clzll(value)) - (kSubBucketBits - 1);
+    return shift * kSubBucketHalf + UINT32(value >> shift);
+  }
+
+  static uint64_t HighestEquivalent(uint32_t index) {
+    if (index < 2 * kSubBucketHalf) {
+      return index;
+    }
+    uint32_t shift = index / kSubBucketHalf - 1;
+    uint64_t mantissa = index - shift * kSubBucketHalf;
+    return ((mantissa + 1) << shift) - 1;
+  }
+
+  std::array<uint64_t, kBucketCount> counts_ = {};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t max_ = 0;
+};
+
+struct Sample {
+  int32_t display_id;
+  uint32_t stage;
+  uint64_t duration_ns;
+};
+
+// Single producer (the owning thread), single consumer (whoever holds the aggregator lock).
+class ThreadRing {
+ public:
+  static constexpr uint32_t kSize = 256;
+
+  // Returns the number of pending samples, or kSize + 1 when the ring was full.
+  uint32_t Push(const Sample &sample) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint32_t pending = UINT32(head - tail_.load(std::memory_order_acquire));
+    if (pending == kSize) {
+      return kSize + 1;
+    }
+    samples_[head % kSize] = sample;
+    head_.store(head + 1, std::memory_order_release);
+    return pending + 1;
+  }
+
+  template <class Fn>
+  void Drain(Fn fn) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+      fn(samples_[tail % kSize]);
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  std::atomic<bool> retired{false};
+
+ private:
+  std::array<Sample, kSize> samples_;
+  // Running counts of pushed and drained samples. 64 bit so that they never wrap, as 32 bit ones
+  // would after 2^32 samples of a thread, which traps in the integer overflow sanitizer.
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+};
+
+class Aggregator {
+ public:
+  // Intentionally leaked, threads may record while static destructors run.
+  static Aggregator &Get() {
+    static Aggregator *aggregator = new Aggregator();
+    return *aggregator;
+  }
+
+  Aggregator() { rings_.reserve(kReservedRings); }
+
+  void AddDisplay(int32_t display_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    displays_[display_id];
+  }
+
+  std::shared_ptr<ThreadRing> Register() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rings_.push_back(std::make_shared<ThreadRing>());
+    return rings_.back();
+  }
+
+  void TryFlush() {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      FlushLocked();
+    }
+  }
+
+  void Dropped() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+
+  void Dump(std::ostringstream *os) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushLocked();
+
+    *os << "\n------------Stage Latency (us)---------";
+    for (auto &display : displays_) {
+      *os << "\nDisplay " << display.first << ":";
+      *os << "\n  " << std::left << std::setw(16) << "Stage" << std::right;
+      for (const char *column : {"Count", "Mean", "p50", "p90", "p99", "p99.9", "Max"}) {
+        *os << std::setw(10) << column;
+      }
+      for (uint32_t stage = 0; stage < kStageMax; stage++) {
+        const LatencyHistogram &histogram = display.second[stage];
+        if (!histogram.Count()) {
+          continue;
+        }
+        *os << "\n  " << std::left << std::setw(16) << kStageNames[stage] << std::right;
+        *os << std::setw(10) << histogram.Count() << std::setw(10) << histogram.Mean();
+        for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+          *os << std::setw(10) << histogram.Percentile(percentile);
+        }
+        *os << std::setw(10) << histogram.Max();
+      }
+    }
+    *os << "\nDropped samples: " << dropped_.load(std::memory_order_relaxed);
+    *os << "\n---------------------------------------\n";
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushLocked();
+    for (auto &display : displays_) {
+      display.second.fill(LatencyHistogram());
+    }
+    dropped_.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  // Composition threads beyond this only cost a reallocation when they first record.
+  static constexpr size_t kReservedRings = 16;
+
+  // Runs on the composition thread from TryFlush(), so it only looks up existing histograms.
+  void FlushLocked() {
+    for (auto it = rings_.begin(); it != rings_.end();) {
+      bool retired = (*it)->retired.load(std::memory_order_acquire);
+      (*it)->Drain([this](const Sample &sample) {
+        auto display = displays_.find(sample.display_id);
+        if (display == displays_.end()) {
+          Dropped();
+          return;
+        }
+        display->second[sample.stage].Add(sample.duration_ns / 1000);
+      });
+      it = retired ? rings_.erase(it) : it + 1;
+    }
+  }
+
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadRing>> rings_;
+  std::map<int32_t, std::array<LatencyHistogram, kStageMax>> displays_;
+  std::atomic<uint64_t> dropped_{0};
+};
+
+struct ThreadRingRef {
+  ThreadRingRef() : ring(Aggregator::Get().Register()) { }
+  ~ThreadRingRef() { ring->retired.store(true, std::memory_order_release); }
+
+  std::shared_ptr<ThreadRing> ring;
+};
+
+}  // namespace
+
+void StageLatency::AddDisplay(int32_t display_id) {
+  Aggregator::Get().AddDisplay(display_id);
+}
+
+void StageLatency::Record(int32_t display_id, LatencyStage stage, uint64_t start_ns,
+                          uint64_t end_ns) {
+  if (!IsEnabled() || stage >= kStageMax || end_ns < start_ns) {
+    return;
+  }
+
+  thread_local ThreadRingRef ring_ref;
+  uint32_t pending = ring_ref.ring->Push({display_id, stage, end_ns - start_ns});
+  if (pending > ThreadRing::kSize) {
+    Aggregator::Get().Dropped();
+  }
+  if (pending >= ThreadRing::kSize / 2) {
+    Aggregator::Get().TryFlush();
+  }
+}
+
+uint64_t StageLatency::Now() {
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return UINT64(ts.tv_sec) * 1000000000 + UINT64(ts.tv_nsec);
+}
+
+void StageLatency::Dump(std::ostringstream *os) {
+  Aggregator::Get().Dump(os);
+}
+
+void StageLatency::Reset() {
+  Aggregator::Get().Reset();
+}
+
+}  // namespace sdm
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <utils/stage_latency.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+const uint64_t kUs = 1000;
+
+// Count, Mean, p50, p90, p99, p99.9 and Max of a stage, empty when the stage has no samples.
+std::vector<uint64_t> StageRow(int32_t display_id, const std::string &stage) {
+  std::ostringstream os;
+  StageLatency::Dump(&os);
+  std::istringstream dump(os.str());
+  std::string header = "Display " + std::to_string(display_id) + ":";
+  std::string line;
+  bool in_display = false;
+  while (std::getline(dump, line)) {
+    if (line.compare(0, 8, "Display ") == 0) {
+      in_display = (line == header);
+      continue;
+    }
+    std::istringstream columns(line);
+    std::string name;
+    if (!in_display || !(columns >> name) || name != stage) {
+      continue;
+    }
+    std::vector<uint64_t> row;
+    uint64_t value = 0;
+    while (columns >> value) {
+      row.push_back(value);
+    }
+    return row;
+  }
+  return {};
+}
+
+uint64_t DroppedSamples() {
+  std::ostringstream os;
+  StageLatency::Dump(&os);
+  std::string dump = os.str();
+  const std::string label = "Dropped samples: ";
+  size_t pos = dump.find(label);
+  return pos == std::string::npos ? 0 : std::stoull(dump.substr(pos + label.size()));
+}
+
+class StageLatencyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    StageLatency::SetEnabled(true);
+    StageLatency::Reset();
+  }
+};
+
+TEST_F(StageLatencyTest, RecordsPercentilesInMicroseconds) {
+  StageLatency::AddDisplay(1);
+  for (uint64_t us = 1; us <= 1000; us++) {
+    StageLatency::Record(1, kStageValidate, 0, us * kUs);
+  }
+
+  std::vector<uint64_t> row = StageRow(1, "Validate");
+  ASSERT_EQ(row.size(), 7u);
+  EXPECT_EQ(row[0], 1000u);
+  EXPECT_EQ(row[1], 500u);
+  // Log-linear buckets report the top of the bucket, at most 1/64 above the exact value.
+  EXPECT_GE(row[2], 500u);
+  EXPECT_LE(row[2], 500u + 500u / 64);
+  EXPECT_GE(row[4], 990u);
+  EXPECT_LE(row[4], 990u + 990u / 64);
+  EXPECT_EQ(row[6], 1000u);
+  EXPECT_TRUE(StageRow(1, "Prepare").empty());
+}
+
+TEST_F(StageLatencyTest, FlushesRingsOfExitedThreads) {
+  StageLatency::AddDisplay(2);
+  // More than a ring holds, so the recording thread has to flush on its own.
+  std::thread worker([] {
+    for (uint32_t i = 0; i < 1000; i++) {
+      StageLatency::Record(2, kStageAtomicCommit, 0, 16 * kUs);
+    }
+  });
+  worker.join();
+
+  std::vector<uint64_t> row = StageRow(2, "AtomicCommit");
+  ASSERT_EQ(row.size(), 7u);
+  EXPECT_EQ(row[0], 1000u);
+  EXPECT_EQ(row[6], 16u);
+  EXPECT_EQ(DroppedSamples(), 0u);
+}
+
+TEST_F(StageLatencyTest, UnknownDisplayIsDropped) {
+  for (uint32_t i = 0; i < 10; i++) {
+    StageLatency::Record(3, kStagePrepare, 0, kUs);
+  }
+  EXPECT_EQ(DroppedSamples(), 10u);
+  EXPECT_TRUE(StageRow(3, "Prepare").empty());
+}
+
+TEST_F(StageLatencyTest, DisabledRecordsNothing) {
+  StageLatency::AddDisplay(4);
+  StageLatency::SetEnabled(false);
+  StageLatency::Record(4, kStagePostCommit, 0, kUs);
+  { ScopedStageLatency scoped(4, kStagePostCommit); }
+  StageLatency::SetEnabled(true);
+  EXPECT_TRUE(StageRow(4, "PostCommit").empty());
+}
+
+TEST_F(StageLatencyTest, ResetKeepsDisplays) {
+  StageLatency::AddDisplay(5);
+  StageLatency::Record(5, kStageSetupAtomic, 0, kUs);
+  StageLatency::Reset();
+  EXPECT_TRUE(StageRow(5, "SetupAtomic").empty());
+
+  StageLatency::Record(5, kStageSetupAtomic, 0, 2 * kUs);
+  std::vector<uint64_t> row = StageRow(5, "SetupAtomic");
+  ASSERT_EQ(row.size(), 7u);
+  EXPECT_EQ(row[0], 1u);
+  EXPECT_EQ(row[6], 2u);
+  EXPECT_EQ(DroppedSamples(), 0u);
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/startup_timeline.h>
+#include <utils/constants.h>
+#include <utils/debug.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+#define __CLASS__ "StartupTimeline"
+
+namespace sdm {
+
+namespace {
+
+// Startup records a few stages per display, anything beyond this is not startup any more.
+const size_t kMaxStages = 64;
+
+struct Stage {
+  std::string name;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  pid_t tid;
+};
+
+std::mutex stages_lock;
+std::vector<Stage> stages;
+std::string finish_event;
+uint64_t finish_ns = 0;
+std::atomic<bool> finished(false);
+
+void DumpLocked(std::ostringstream *os) {
+  if (stages.empty()) {
+    *os << "  No startup stages recorded\n";
+    return;
+  }
+
+  std::vector<Stage> sorted = stages;
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const Stage &a, const Stage &b) { return a.start_ns < b.start_ns; });
+
+  uint64_t origin = sorted.front().start_ns;
+  *os << std::fixed << std::setprecision(1);
+  *os << "  " << std::setw(10) << "boot(ms)" << std::setw(10) << "+(ms)" << std::setw(10)
+      << "took(ms)" << std::setw(8) << "tid" << "  stage\n";
+  for (auto &stage : sorted) {
+    *os << "  " << std::setw(10) << DOUBLE(stage.start_ns) / 1e6 << std::setw(10)
+        << DOUBLE(stage.start_ns - origin) / 1e6 << std::setw(10)
+        << DOUBLE(stage.end_ns - stage.start_ns) / 1e6 << std::setw(8) << stage.tid << "  "
+        << stage.name << "\n";
+  }
+  if (finish_ns) {
+    *os << "  " << std::setw(10) << DOUBLE(finish_ns) / 1e6 << std::setw(10)
+        << DOUBLE(finish_ns - origin) / 1e6 << std::setw(10) << "" << std::setw(8) << "" << "  "
+        << finish_event << "\n";
+  }
+}
+
+}  // namespace
+
+void StartupTimeline::Record(const std::string &stage, uint64_t start_ns, uint64_t end_ns) {
+  std::lock_guard<std::mutex> lock(stages_lock);
+  if (finished.load(std::memory_order_relaxed) || stages.size() >= kMaxStages) {
+    return;
+  }
+
+  stages.push_back({stage, start_ns, end_ns, static_cast<pid_t>(syscall(SYS_gettid))});
+}
+
+void StartupTimeline::Finish(const char *event) {
+  if (finished.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  std::ostringstream os;
+  {
+    std::lock_guard<std::mutex> lock(stages_lock);
+    if (finished.load(std::memory_order_relaxed)) {
+      return;
+    }
+    finish_event = event;
+    finish_ns = Now();
+    finished.store(true, std::memory_order_relaxed);
+    DumpLocked(&os);
+  }
+
+  // One line per stage, logcat truncates long messages.
+  std::istringstream lines(os.str());
+  std::string line;
+  while (std::getline(lines, line)) {
+    DLOGI("%s", line.c_str());
+  }
+}
+
+bool StartupTimeline::IsFinished() {
+  return finished.load(std::memory_order_relaxed);
+}
+
+uint64_t StartupTimeline::Now() {
+  struct timespec ts = {};
+  clock_gettime(CLOCK_BOOTTIME, &ts);
+  return UINT64(ts.tv_sec) * 1000000000 + UINT64(ts.tv_nsec);
+}
+
+void StartupTimeline::Dump(std::ostringstream *os) {
+  std::lock_guard<std::mutex> lock(stages_lock);
+  DumpLocked(os);
+}
+
+}  // namespace sdm
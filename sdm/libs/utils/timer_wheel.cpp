@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/timer_wheel.h>
+#include <utils/constants.h>
+#include <utils/debug.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#define __CLASS__ "TimerWheel"
+
+namespace sdm {
+
+class MonotonicTimerClock : public TimerClock {
+ public:
+  uint64_t GetTimeNs() override {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return UINT64(now.tv_sec) * 1000000000 + UINT64(now.tv_nsec);
+  }
+};
+
+static MonotonicTimerClock g_monotonic_clock;
+
+TimerWheel::TimerWheel(TimerClock *clock) : clock_(clock ? clock : &g_monotonic_clock) {
+  for (uint32_t level = 0; level < kLevels; level++) {
+    for (uint32_t slot = 0; slot < kSlots; slot++) {
+      heads_[level][slot] = kNone;
+    }
+  }
+  current_tick_ = Now() / kTickNs;
+}
+
+TimerWheel::~TimerWheel() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+int TimerWheel::CreateFd() {
+  std::lock_guard<std::mutex> guard(lock_);
+  if (fd_ >= 0) {
+    return fd_;
+  }
+
+  fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd_ < 0) {
+    int error = errno;
+    DLOGE("timerfd_create failed, error = %s", strerror(error));
+    return -error;
+  }
+  ProgramFd();
+
+  return fd_;
+}
+
+uint64_t TimerWheel::Now() {
+  return clock_->GetTimeNs();
+}
+
+uint32_t TimerWheel::Create(const TimerCallback &callback) {
+  std::lock_guard<std::mutex> guard(lock_);
+  Timer timer;
+  timer.callback = callback;
+  timers_.push_back(timer);
+
+  return UINT32(timers_.size() - 1);
+}
+
+void TimerWheel::Arm(uint32_t id, uint32_t timeout_ms) {
+  std::lock_guard<std::mutex> guard(lock_);
+  Timer &timer = timers_.at(id);
+  uint64_t deadline_ns = Now() + UINT64(timeout_ms) * kTickNs;
+  if (timer.state == kTimerPending) {
+    // Left in its slot, it is moved to the new deadline when the slot comes due.
+    if (deadline_ns >= timer.deadline_ns) {
+      timer.deadline_ns = deadline_ns;
+      return;
+    }
+    Unlink(id);
+  }
+
+  // Nothing is due before the current tick when the wheel is empty, it can skip ahead.
+  if (!linked_count_) {
+    current_tick_ = Now() / kTickNs;
+  }
+  timer.state = kTimerPending;
+  timer.deadline_ns = deadline_ns;
+  Link(id, current_tick_ + 1);
+  if (fd_ >= 0 && (!programmed_ns_ || deadline_ns < programmed_ns_)) {
+    ProgramFd();
+  }
+}
+
+void TimerWheel::Cancel(uint32_t id) {
+  std::lock_guard<std::mutex> guard(lock_);
+  Timer &timer = timers_.at(id);
+  if (timer.state == kTimerPending) {
+    // The timerfd may still wake up for it, Advance() then finds nothing due.
+    Unlink(id);
+  }
+  timer.state = kTimerIdle;
+}
+
+bool TimerWheel::IsPending(uint32_t id) {
+  std::lock_guard<std::mutex> guard(lock_);
+  const Timer &timer = timers_.at(id);
+  return timer.state == kTimerPending && timer.deadline_ns > Now();
+}
+
+bool TimerWheel::HasExpired(uint32_t id) {
+  std::lock_guard<std::mutex> guard(lock_);
+  const Timer &timer = timers_.at(id);
+  return timer.state == kTimerExpired ||
+         (timer.state == kTimerPending && timer.deadline_ns <= Now());
+}
+
+void TimerWheel::Link(uint32_t id, uint64_t min_tick) {
+  Timer &timer = timers_[id];
+  uint64_t tick = (timer.deadline_ns + kTickNs - 1) / kTickNs;
+  tick = (tick > min_tick) ? tick : min_tick;
+
+  // The lowest level whose slots reach the tick, the top one comes back to a timer beyond it.
+  uint64_t delta = tick - current_tick_;
+  uint32_t level = 0;
+  while (level < kLevels - 1 && delta >= (UINT64(1) << (kSlotBits * (level + 1)))) {
+    level++;
+  }
+  uint64_t span = UINT64(1) << (kSlotBits * kLevels);
+  if (delta >= span) {
+    tick = current_tick_ + span - 1;
+  }
+
+  uint32_t slot = UINT32(tick >> (kSlotBits * level)) & (kSlots - 1);
+  timer.level = level;
+  timer.slot = slot;
+  timer.prev = kNone;
+  timer.next = heads_[level][slot];
+  if (timer.next != kNone) {
+    timers_[UINT32(timer.next)].prev = INT32(id);
+  }
+  heads_[level][slot] = INT32(id);
+  occupied_[level] |= UINT64(1) << slot;
+  linked_count_++;
+}
+
+void TimerWheel::Unlink(uint32_t id) {
+  Timer &timer = timers_[id];
+  if (timer.prev != kNone) {
+    timers_[UINT32(timer.prev)].next = timer.next;
+  } else {
+    heads_[timer.level][timer.slot] = timer.next;
+  }
+  if (timer.next != kNone) {
+    timers_[UINT32(timer.next)].prev = timer.prev;
+  }
+  if (heads_[timer.level][timer.slot] == kNone) {
+    occupied_[timer.level] &= ~(UINT64(1) << timer.slot);
+  }
+  timer.prev = kNone;
+  timer.next = kNone;
+  linked_count_--;
+}
+
+// Moves the timers of the slot starting at the current tick down to the lower levels.
+void TimerWheel::Cascade(uint32_t level) {
+  uint32_t slot = UINT32(current_tick_ >> (kSlotBits * level)) & (kSlots - 1);
+  int32_t id = heads_[level][slot];
+  heads_[level][slot] = kNone;
+  occupied_[level] &= ~(UINT64(1) << slot);
+  while (id != kNone) {
+    int32_t next = timers_[UINT32(id)].next;
+    linked_count_--;
+    Link(UINT32(id), current_tick_);
+    id = next;
+  }
+}
+
+void TimerWheel::Step(std::vector<uint32_t> *due) {
+  current_tick_++;
+  for (uint32_t level = kLevels - 1; level > 0; level--) {
+    if (!(current_tick_ & ((UINT64(1) << (kSlotBits * level)) - 1))) {
+      Cascade(level);
+    }
+  }
+
+  uint32_t slot = UINT32(current_tick_) & (kSlots - 1);
+  int32_t id = heads_[0][slot];
+  heads_[0][slot] = kNone;
+  occupied_[0] &= ~(UINT64(1) << slot);
+  while (id != kNone) {
+    Timer &timer = timers_[UINT32(id)];
+    int32_t next = timer.next;
+    linked_count_--;
+    if ((timer.deadline_ns + kTickNs - 1) / kTickNs > current_tick_) {
+      // Armed again for later since it was linked.
+      Link(UINT32(id), current_tick_ + 1);
+    } else {
+      timer.state = kTimerExpired;
+      due->push_back(UINT32(id));
+    }
+    id = next;
+  }
+}
+
+uint32_t TimerWheel::Advance() {
+  std::vector<TimerCallback> callbacks;
+  uint32_t due_count = 0;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (fd_ >= 0) {
+      uint64_t expirations = 0;
+      if (read(fd_, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+        DLOGW("Failed to read timerfd, error = %s", strerror(errno));
+      }
+    }
+
+    // Ticks without a slot due are skipped over.
+    std::vector<uint32_t> due;
+    uint64_t target = Now() / kTickNs;
+    while (current_tick_ < target) {
+      uint64_t next_tick = GetNextExpiryLocked() / kTickNs;
+      if (!next_tick || next_tick > target) {
+        current_tick_ = target;
+        break;
+      }
+      current_tick_ = next_tick - 1;
+      Step(&due);
+    }
+
+    for (auto id : due) {
+      if (timers_[id].callback) {
+        callbacks.push_back(timers_[id].callback);
+      }
+    }
+    due_count = UINT32(due.size());
+    ProgramFd();
+  }
+
+  for (auto &callback : callbacks) {
+    callback();
+  }
+
+  return due_count;
+}
+
+uint64_t TimerWheel::GetNextExpiry() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return GetNextExpiryLocked();
+}
+
+// Tick of the first occupied slot on each level after the current one, the earliest of them.
+uint64_t TimerWheel::GetNextExpiryLocked() {
+  uint64_t next_tick = 0;
+  for (uint32_t level = 0; level < kLevels; level++) {
+    uint64_t occupied = occupied_[level];
+    if (!occupied) {
+      continue;
+    }
+
+    uint32_t shift = kSlotBits * level;
+    uint64_t base = (current_tick_ >> shift) + 1;
+    uint32_t start = UINT32(base) & (kSlots - 1);
+    uint64_t rotated = start ? ((occupied >> start) | (occupied << (kSlots - start))) : occupied;
+    uint64_t tick = (base + UINT64(__builtin_ctzll(rotated))) << shift;
+    next_tick = (!next_tick || tick < next_tick) ? tick : next_tick;
+  }
+
+  return next_tick * kTickNs;
+}
+
+void TimerWheel::ProgramFd() {
+  if (fd_ < 0) {
+    return;
+  }
+
+  uint64_t next_ns = GetNextExpiryLocked();
+  if (next_ns == programmed_ns_) {
+    return;
+  }
+
+  // An expiry of zero disarms the timerfd.
+  struct itimerspec spec = {};
+  spec.it_value.tv_sec = static_cast<time_t>(next_ns / 1000000000);
+  spec.it_value.tv_nsec = static_cast<long>(next_ns % 1000000000);  // NOLINT
+  if (timerfd_settime(fd_, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+    DLOGW("timerfd_settime failed, error = %s", strerror(errno));
+    return;
+  }
+  programmed_ns_ = next_ns;
+}
+
+}  // namespace sdm
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <utils/timer_wheel.h>
+
+#include <random>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+const uint64_t kMs = 1000000;
+
+class FakeClock : public TimerClock {
+ public:
+  uint64_t GetTimeNs() override { return now_ns_; }
+  void Set(uint64_t now_ns) { now_ns_ = now_ns; }
+
+ private:
+  uint64_t now_ns_ = 5000 * kMs + 123;
+};
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  // Creates a timer recording the times it fires at.
+  uint32_t CreateTimer() {
+    uint32_t id = wheel_.Create([this, id = fired_.size()] {
+      fired_[id].push_back(clock_.GetTimeNs());
+    });
+    fired_.resize(fired_.size() + 1);
+    return id;
+  }
+
+  // Advances the clock by step_ns at a time up to time_ns, as the timerfd would wake up.
+  void RunUntil(uint64_t time_ns, uint64_t step_ns = kMs / 4) {
+    while (clock_.GetTimeNs() < time_ns) {
+      uint64_t next = clock_.GetTimeNs() + step_ns;
+      clock_.Set(next < time_ns ? next : time_ns);
+      wheel_.Advance();
+    }
+  }
+
+  FakeClock clock_;
+  TimerWheel wheel_{&clock_};
+  std::vector<std::vector<uint64_t>> fired_;
+};
+
+TEST_F(TimerWheelTest, FiresOnceAtDeadline) {
+  uint32_t id = CreateTimer();
+  uint64_t start = clock_.GetTimeNs();
+  wheel_.Arm(id, 10);
+  EXPECT_TRUE(wheel_.IsPending(id));
+
+  RunUntil(start + 10 * kMs - 1);
+  EXPECT_TRUE(fired_[id].empty());
+  EXPECT_FALSE(wheel_.HasExpired(id));
+
+  RunUntil(start + 20 * kMs);
+  ASSERT_EQ(fired_[id].size(), 1U);
+  EXPECT_GE(fired_[id][0], start + 10 * kMs);
+  EXPECT_LE(fired_[id][0], start + 11 * kMs);
+  EXPECT_TRUE(wheel_.HasExpired(id));
+  EXPECT_FALSE(wheel_.IsPending(id));
+}
+
+TEST_F(TimerWheelTest, CancelStopsTimer) {
+  uint32_t id = CreateTimer();
+  uint64_t start = clock_.GetTimeNs();
+  wheel_.Arm(id, 10);
+  wheel_.Cancel(id);
+  EXPECT_FALSE(wheel_.IsPending(id));
+  EXPECT_EQ(wheel_.GetNextExpiry(), 0U);
+
+  RunUntil(start + 50 * kMs);
+  EXPECT_TRUE(fired_[id].empty());
+  EXPECT_FALSE(wheel_.HasExpired(id));
+}
+
+// An idle timer armed again on every frame only fires once the frames stop.
+TEST_F(TimerWheelTest, RearmOnEveryFrameDefersTimer) {
+  uint32_t id = CreateTimer();
+  uint64_t last_frame = 0;
+  for (int frame = 0; frame < 500; frame++) {
+    last_frame = clock_.GetTimeNs();
+    wheel_.Arm(id, 100);
+    RunUntil(last_frame + 16 * kMs + kMs / 2);
+  }
+  EXPECT_TRUE(fired_[id].empty());
+
+  RunUntil(last_frame + 200 * kMs);
+  ASSERT_EQ(fired_[id].size(), 1U);
+  EXPECT_GE(fired_[id][0], last_frame + 100 * kMs);
+  EXPECT_LE(fired_[id][0], last_frame + 101 * kMs);
+}
+
+TEST_F(TimerWheelTest, ArmEarlierMovesTimer) {
+  uint32_t id = CreateTimer();
+  uint64_t start = clock_.GetTimeNs();
+  wheel_.Arm(id, 5000);
+  wheel_.Arm(id, 20);
+  RunUntil(start + 100 * kMs);
+  ASSERT_EQ(fired_[id].size(), 1U);
+  EXPECT_LE(fired_[id][0], start + 21 * kMs);
+}
+
+// Timeouts on the upper levels cascade down and still fire on their tick, including one longer
+// than the whole wheel.
+TEST_F(TimerWheelTest, LongTimeoutsCascade) {
+  const uint32_t kTimeouts[] = {63, 64, 65, 4095, 4096, 5000, 262144, 300000, 20000000};
+  uint64_t start = clock_.GetTimeNs();
+  std::vector<uint32_t> ids;
+  for (auto timeout : kTimeouts) {
+    ids.push_back(CreateTimer());
+    wheel_.Arm(ids.back(), timeout);
+  }
+
+  // Sleeps until the next expiry, as the timer thread does.
+  while (wheel_.GetNextExpiry()) {
+    uint64_t next = wheel_.GetNextExpiry();
+    clock_.Set(next > clock_.GetTimeNs() ? next : clock_.GetTimeNs());
+    wheel_.Advance();
+  }
+
+  for (size_t i = 0; i < ids.size(); i++) {
+    ASSERT_EQ(fired_[ids[i]].size(), 1U) << "Timeout " << kTimeouts[i];
+    EXPECT_GE(fired_[ids[i]][0], start + kTimeouts[i] * kMs) << "Timeout " << kTimeouts[i];
+    EXPECT_LE(fired_[ids[i]][0], start + (kTimeouts[i] + 1) * kMs) << "Timeout " << kTimeouts[i];
+  }
+}
+
+// A wakeup late by more than the timeout still fires the timer, once.
+TEST_F(TimerWheelTest, LateAdvanceFiresDueTimers) {
+  uint32_t first = CreateTimer();
+  uint32_t second = CreateTimer();
+  uint64_t start = clock_.GetTimeNs();
+  wheel_.Arm(first, 3);
+  wheel_.Arm(second, 700);
+  clock_.Set(start + 10000 * kMs);
+  EXPECT_EQ(wheel_.Advance(), 2U);
+  EXPECT_EQ(fired_[first].size(), 1U);
+  EXPECT_EQ(fired_[second].size(), 1U);
+  EXPECT_EQ(wheel_.Advance(), 0U);
+}
+
+TEST_F(TimerWheelTest, CallbackCanArmTimer) {
+  uint64_t start = clock_.GetTimeNs();
+  uint32_t count = 0;
+  uint32_t id = 0;
+  id = wheel_.Create([&] {
+    if (++count < 3) {
+      wheel_.Arm(id, 10);
+    }
+  });
+  wheel_.Arm(id, 10);
+  RunUntil(start + 100 * kMs);
+  EXPECT_EQ(count, 3U);
+}
+
+TEST_F(TimerWheelTest, TimerWithoutCallbackIsQueried) {
+  uint32_t id = wheel_.Create(TimerCallback());
+  uint64_t start = clock_.GetTimeNs();
+  wheel_.Arm(id, 0);
+  EXPECT_TRUE(wheel_.HasExpired(id));
+  wheel_.Arm(id, 50);
+  clock_.Set(start + 49 * kMs);
+  EXPECT_FALSE(wheel_.HasExpired(id));
+  clock_.Set(start + 50 * kMs);
+  EXPECT_TRUE(wheel_.HasExpired(id));
+}
+
+// Random arming and canceling of many timers against the deadlines they were given.
+TEST_F(TimerWheelTest, MatchesReferenceModel) {
+  const uint32_t kTimers = 32;
+  std::mt19937 rng(11);
+  std::vector<uint32_t> ids;
+  std::vector<uint64_t> deadlines(kTimers, 0);
+  for (uint32_t i = 0; i < kTimers; i++) {
+    ids.push_back(CreateTimer());
+  }
+
+  std::vector<size_t> seen(kTimers, 0);
+  for (int round = 0; round < 20000; round++) {
+    uint32_t i = uint32_t(rng() % kTimers);
+    uint32_t action = uint32_t(rng() % 8);
+    bool advanced = false;
+    if (action < 4) {
+      uint32_t timeout = uint32_t((rng() % 4) ? rng() % 200 : rng() % 20000);
+      deadlines[i] = clock_.GetTimeNs() + timeout * kMs;
+      wheel_.Arm(ids[i], timeout);
+    } else if (action == 4) {
+      wheel_.Cancel(ids[i]);
+      deadlines[i] = 0;
+    } else {
+      clock_.Set(clock_.GetTimeNs() + (rng() % 3000) * kMs / 100);
+      wheel_.Advance();
+      advanced = true;
+    }
+
+    for (uint32_t t = 0; t < kTimers; t++) {
+      if (fired_[ids[t]].size() == seen[t]) {
+        // Everything due a tick before the last wakeup has fired.
+        ASSERT_FALSE(advanced && deadlines[t] && deadlines[t] + kMs <= clock_.GetTimeNs())
+            << "Timer " << t << " missed in round " << round;
+        continue;
+      }
+      ASSERT_EQ(fired_[ids[t]].size(), seen[t] + 1) << "Timer " << t;
+      ASSERT_NE(deadlines[t], 0U) << "Canceled timer " << t << " fired in round " << round;
+      ASSERT_GE(fired_[ids[t]].back(), deadlines[t]) << "Timer " << t << " fired early";
+      seen[t]++;
+      deadlines[t] = 0;
+    }
+  }
+}
+
+TEST(TimerWheelFdTest, FdWakesUpForExpiry) {
+  TimerWheel wheel;
+  ASSERT_GE(wheel.CreateFd(), 0);
+  bool fired = false;
+  uint32_t id = wheel.Create([&] { fired = true; });
+  wheel.Arm(id, 5);
+
+  struct pollfd fd = {wheel.GetFd(), POLLIN, 0};
+  while (!fired) {
+    ASSERT_EQ(poll(&fd, 1, 1000), 1);
+    wheel.Advance();
+  }
+  EXPECT_EQ(wheel.GetNextExpiry(), 0U);
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/uevent_parser.h>
+#include <utils/constants.h>
+#include <utils/debug.h>
+#include <ctype.h>
+#include <errno.h>
+#include <linux/filter.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+
+#define __CLASS__ "UEventParser"
+
+namespace sdm {
+
+namespace {
+
+struct KeyName {
+  const char *name;
+  uint32_t length;
+};
+
+const KeyName kKeyNames[UEventParser::kKeyMax] = {
+    {"status", 6}, {"HOTPLUG", 7}, {"MST_HOTPLUG", 11}, {"bpp", 3}, {"pattern", 7},
+};
+
+const uint32_t kHashSize = 16;
+
+// Perfect for the keys above, and cheap enough to compute for every field.
+uint32_t Hash(const char *key, uint32_t length) {
+  return (length + UINT32(UINT8(key[0]))) & (kHashSize - 1);
+}
+
+class KeyTable {
+ public:
+  KeyTable() {
+    for (auto &key : keys_) {
+      key = UEventParser::kKeyMax;
+    }
+    for (uint32_t key = 0; key < UEventParser::kKeyMax; key++) {
+      keys_[Hash(kKeyNames[key].name, kKeyNames[key].length)] = UEventParser::Key(key);
+    }
+  }
+
+  UEventParser::Key Find(const char *key, uint32_t length) const {
+    UEventParser::Key found = keys_[Hash(key, length)];
+    if (found == UEventParser::kKeyMax || kKeyNames[found].length != length ||
+        memcmp(kKeyNames[found].name, key, length)) {
+      return UEventParser::kKeyMax;
+    }
+    return found;
+  }
+
+ private:
+  UEventParser::Key keys_[kHashSize];
+};
+
+const KeyTable kKeyTable;
+
+}  // namespace
+
+bool UEventParser::MatchDevPath(const char *data, int length, const char *path) {
+  if (!data || length <= 0 || !path) {
+    return false;
+  }
+
+  size_t header_length = strnlen(data, size_t(length));
+  const char *devpath = static_cast<const char *>(memchr(data, '@', header_length));
+  if (!devpath) {
+    return false;
+  }
+
+  size_t path_length = strlen(path);
+  int first = tolower(path[0]);
+  const char *end = data + header_length;
+  for (const char *start = devpath + 1; size_t(end - start) >= path_length; start++) {
+    if (tolower(*start) == first && !strncasecmp(start, path, path_length)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+int UEventParser::AttachChangeFilter(int fd) {
+  // Accepts the messages starting with "change@/", the rest are dropped in the kernel.
+  struct sock_filter code[] = {
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 0),
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x6368616e, 0, 3),  // "chan"
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 4),
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x6765402f, 0, 1),  // "ge@/"
+      BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+      BPF_STMT(BPF_RET | BPF_K, 0),
+  };
+  struct sock_fprog program = {};
+  program.len = sizeof(code) / sizeof(code[0]);
+  program.filter = code;
+
+  if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) < 0) {
+    int error = errno;
+    DLOGW("Failed to attach uevent filter, error = %s", strerror(error));
+    return -error;
+  }
+
+  return 0;
+}
+
+uint32_t UEventParser::Parse(const char *data, int length) {
+  header_ = nullptr;
+  for (auto &value : values_) {
+    value = nullptr;
+  }
+  if (!data || length <= 0) {
+    return 0;
+  }
+
+  uint32_t count = 0;
+  const char *field = data;
+  const char *end = data + length;
+  // Fields run up to an empty one or the end of the data.
+  while (field < end && *field) {
+    size_t field_length = strnlen(field, size_t(end - field));
+    const char *equals = static_cast<const char *>(memchr(field, '=', field_length));
+    if (!equals) {
+      if (field == data) {
+        header_ = field;
+      }
+    } else {
+      Key key = kKeyTable.Find(field, UINT32(equals - field));
+      // The first of repeated keys is kept.
+      if (key != kKeyMax && !values_[key]) {
+        values_[key] = equals + 1;
+        count++;
+      }
+    }
+    field += field_length + 1;
+  }
+
+  return count;
+}
+
+int UEventParser::GetIntValue(Key key) const {
+  return values_[key] ? atoi(values_[key]) : -1;
+}
+
+}  // namespace sdm
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+#include <utils/uevent_parser.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using sdm::UEventParser;
+
+const char kDrmCard[] = "mdss_mdp/drm/card";
+
+// Uevents recorded on a phone attached to an MST dock, with the fields separated by '|'. The DP
+// hotplugs come in among the power supply, USB and thermal events the dock keeps producing.
+const char *kRecorded[] = {
+    "change@/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0|ACTION=change|"
+    "DEVPATH=/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0|SUBSYSTEM=drm|"
+    "status=connected|MST_HOTPLUG=1|DEVNAME=dri/card0|DEVTYPE=drm_minor|SEQNUM=18231|MAJOR=226|"
+    "MINOR=0",
+    "change@/devices/platform/soc/a600000.ssusb/power_supply/usb|ACTION=change|"
+    "DEVPATH=/devices/platform/soc/a600000.ssusb/power_supply/usb|SUBSYSTEM=power_supply|"
+    "POWER_SUPPLY_NAME=usb|POWER_SUPPLY_TYPE=USB|POWER_SUPPLY_ONLINE=1|"
+    "POWER_SUPPLY_VOLTAGE_MAX=9000000|POWER_SUPPLY_CURRENT_MAX=3000000|POWER_SUPPLY_USB_TYPE=PD|"
+    "SEQNUM=18232",
+    "change@/devices/platform/soc/soc:qcom,pmic_glink/power_supply/battery|ACTION=change|"
+    "DEVPATH=/devices/platform/soc/soc:qcom,pmic_glink/power_supply/battery|"
+    "SUBSYSTEM=power_supply|POWER_SUPPLY_NAME=battery|POWER_SUPPLY_TYPE=Battery|"
+    "POWER_SUPPLY_STATUS=Charging|POWER_SUPPLY_HEALTH=Good|POWER_SUPPLY_PRESENT=1|"
+    "POWER_SUPPLY_CAPACITY=57|POWER_SUPPLY_VOLTAGE_NOW=3934000|POWER_SUPPLY_CURRENT_NOW=-1820000|"
+    "POWER_SUPPLY_TEMP=312|SEQNUM=18233",
+    "add@/devices/platform/soc/a600000.ssusb/a600000.dwc3/xhci-hcd.0.auto/usb2/2-1/2-1.3|"
+    "ACTION=add|DEVPATH=/devices/platform/soc/a600000.ssusb/a600000.dwc3/xhci-hcd.0.auto/usb2/"
+    "2-1/2-1.3|SUBSYSTEM=usb|MAJOR=189|MINOR=131|DEVNAME=bus/usb/002/004|DEVTYPE=usb_device|"
+    "PRODUCT=bda/8153/3100|TYPE=0/0/0|BUSNUM=002|DEVNUM=004|SEQNUM=18234",
+    "change@/devices/virtual/thermal/thermal_zone41|ACTION=change|"
+    "DEVPATH=/devices/virtual/thermal/thermal_zone41|SUBSYSTEM=thermal|NAME=skin-msm-therm|"
+    "TEMP=41250|TRIP=1|EVENT=4|SEQNUM=18235",
+    "change@/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0|ACTION=change|"
+    "DEVPATH=/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0|SUBSYSTEM=drm|HOTPLUG=1|"
+    "DEVNAME=dri/card0|DEVTYPE=drm_minor|SEQNUM=18236|MAJOR=226|MINOR=0",
+};
+
+std::vector<std::string> Recorded() {
+  std::vector<std::string> events;
+  for (auto recorded : kRecorded) {
+    std::string event = recorded;
+    for (auto &c : event) {
+      c = (c == '|') ? '\0' : c;
+    }
+    events.push_back(event + '\0' + '\0');
+  }
+  return events;
+}
+
+// Scan of the whole event per key, as the uevent thread did before the parser.
+const char *ScanToken(const char *data, int length, const char *token) {
+  const char *field = data;
+  while (((field - data) <= length) && (*field)) {
+    const char *value = strstr(field, token);
+    if (value) {
+      return value + strlen(token);
+    }
+    field += strlen(field) + 1;
+  }
+  return nullptr;
+}
+
+void BM_ScanPerKey(benchmark::State &state) {
+  std::vector<std::string> events = Recorded();
+  const char *kTokens[] = {"status=", "HOTPLUG=", "MST_HOTPLUG=", "bpp=", "pattern="};
+  for (auto _ : state) {
+    for (auto &event : events) {
+      int length = int(event.size()) - 2;
+      for (auto token : kTokens) {
+        benchmark::DoNotOptimize(ScanToken(event.data(), length, token));
+      }
+      benchmark::DoNotOptimize(strcasestr(event.data(), kDrmCard));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * int64_t(events.size()));
+}
+BENCHMARK(BM_ScanPerKey);
+
+void BM_Parse(benchmark::State &state) {
+  std::vector<std::string> events = Recorded();
+  UEventParser parser;
+  for (auto _ : state) {
+    for (auto &event : events) {
+      int length = int(event.size()) - 2;
+      if (UEventParser::MatchDevPath(event.data(), length, kDrmCard)) {
+        benchmark::DoNotOptimize(parser.Parse(event.data(), length));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * int64_t(events.size()));
+}
+BENCHMARK(BM_Parse);
+
+// Parsing alone, for a DP hotplug that passes the filters.
+void BM_ParseHotplug(benchmark::State &state) {
+  std::string event = Recorded()[0];
+  UEventParser parser;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(parser.Parse(event.data(), int(event.size()) - 2));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseHotplug);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utils/uevent_parser.h>
+
+#include <string>
+
+namespace sdm {
+namespace {
+
+const char kDrmCard[] = "mdss_mdp/drm/card";
+
+// Builds a uevent buffer from its fields, with the trailing double NUL the uevent thread keeps.
+std::string UEvent(std::initializer_list<const char *> fields) {
+  std::string data;
+  for (auto field : fields) {
+    data += field;
+    data += '\0';
+  }
+  return data + '\0';
+}
+
+TEST(UEventParserTest, ParsesDpHotplug) {
+  std::string data =
+      UEvent({"change@/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0", "ACTION=change",
+              "DEVPATH=/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0", "SUBSYSTEM=drm",
+              "status=connected", "HOTPLUG=1", "bpp=24", "pattern=3", "SEQNUM=4211"});
+  EXPECT_TRUE(UEventParser::MatchDevPath(data.data(), int(data.size()), kDrmCard));
+
+  UEventParser parser;
+  EXPECT_EQ(parser.Parse(data.data(), int(data.size())), 4U);
+  EXPECT_STREQ(parser.GetHeader(), "change@/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0");
+  EXPECT_STREQ(parser.GetValue(UEventParser::kKeyStatus), "connected");
+  EXPECT_STREQ(parser.GetValue(UEventParser::kKeyHotplug), "1");
+  EXPECT_EQ(parser.GetValue(UEventParser::kKeyMstHotplug), nullptr);
+  EXPECT_EQ(parser.GetIntValue(UEventParser::kKeyBpp), 24);
+  EXPECT_EQ(parser.GetIntValue(UEventParser::kKeyPattern), 3);
+}
+
+TEST(UEventParserTest, KeysMatchWhole) {
+  std::string data = UEvent({"change@/devices/virtual/drm/card0", "MST_HOTPLUG=1", "xbpp=8",
+                             "STATUS=connected", "statu=x", "patterns=2"});
+  UEventParser parser;
+  EXPECT_EQ(parser.Parse(data.data(), int(data.size())), 1U);
+  EXPECT_STREQ(parser.GetValue(UEventParser::kKeyMstHotplug), "1");
+  EXPECT_EQ(parser.GetValue(UEventParser::kKeyHotplug), nullptr);
+  EXPECT_EQ(parser.GetValue(UEventParser::kKeyStatus), nullptr);
+  EXPECT_EQ(parser.GetIntValue(UEventParser::kKeyBpp), -1);
+  EXPECT_EQ(parser.GetIntValue(UEventParser::kKeyPattern), -1);
+}
+
+TEST(UEventParserTest, StopsAtEndOfData) {
+  std::string data = UEvent({"change@/devices/virtual/drm/card0", "status=connected", "bpp=30"});
+  UEventParser parser;
+  // Fields past the given length are not looked at.
+  EXPECT_EQ(parser.Parse(data.data(), int(data.find("bpp"))), 1U);
+  EXPECT_STREQ(parser.GetValue(UEventParser::kKeyStatus), "connected");
+  EXPECT_EQ(parser.GetIntValue(UEventParser::kKeyBpp), -1);
+
+  // Nor those after an empty one.
+  std::string fields = UEvent({"change@/devices/virtual/drm/card0", "", "status=connected"});
+  EXPECT_EQ(parser.Parse(fields.data(), int(fields.size())), 0U);
+  EXPECT_EQ(parser.Parse(nullptr, 10), 0U);
+  EXPECT_EQ(parser.GetHeader(), nullptr);
+}
+
+TEST(UEventParserTest, MatchesDevPathOnly) {
+  std::string dp = UEvent({"change@/devices/platform/soc/AE00000.QCOM,MDSS_MDP/DRM/CARD0"});
+  EXPECT_TRUE(UEventParser::MatchDevPath(dp.data(), int(dp.size()), kDrmCard));
+
+  // The path in a value or another event's header does not count.
+  std::string usb = UEvent({"change@/devices/platform/soc/a600000.ssusb/power_supply/usb",
+                            "DEVPATH=/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0"});
+  EXPECT_FALSE(UEventParser::MatchDevPath(usb.data(), int(usb.size()), kDrmCard));
+  std::string short_header = UEvent({"change@/mdss_mdp/drm/car"});
+  EXPECT_FALSE(UEventParser::MatchDevPath(short_header.data(), int(short_header.size()),
+                                          kDrmCard));
+  EXPECT_FALSE(UEventParser::MatchDevPath(nullptr, 0, kDrmCard));
+}
+
+TEST(UEventParserTest, FilterDropsOtherActions) {
+  int fds[2] = {};
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_DGRAM, 0, fds), 0);
+  ASSERT_EQ(UEventParser::AttachChangeFilter(fds[1]), 0);
+
+  const std::string kEvents[] = {
+      UEvent({"add@/devices/virtual/drm/card0/card0-DP-2", "ACTION=add"}),
+      UEvent({"change@/devices/virtual/drm/card0", "HOTPLUG=1"}),
+      UEvent({"bind@/devices/platform/soc/a600000.ssusb", "ACTION=bind"}),
+      UEvent({"chang"}),
+      UEvent({"change@/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0", "status=connected"}),
+  };
+  for (auto &event : kEvents) {
+    ASSERT_EQ(send(fds[0], event.data(), event.size(), 0), ssize_t(event.size()));
+  }
+
+  char buffer[256] = {};
+  ASSERT_EQ(recv(fds[1], buffer, sizeof(buffer), MSG_DONTWAIT), ssize_t(kEvents[1].size()));
+  EXPECT_STREQ(buffer, "change@/devices/virtual/drm/card0");
+  ASSERT_EQ(recv(fds[1], buffer, sizeof(buffer), MSG_DONTWAIT), ssize_t(kEvents[4].size()));
+  EXPECT_STREQ(buffer, "change@/devices/platform/soc/ae00000.qcom,mdss_mdp/drm/card0");
+  EXPECT_LT(recv(fds[1], buffer, sizeof(buffer), MSG_DONTWAIT), 0);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+}  // namespace
+}  // namespace sdm
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <utils/vsync_model.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#define __CLASS__ "VSyncModel"
+
+namespace sdm {
+
+// Fewer vsyncs than this are not enough to fit the period, the nominal one is used.
+static const uint32_t kMinFitSamples = 8;
+// After a gap of this many periods the index of the next vsync may be off by one from drift of the
+// estimate, so the history starts over.
+static const int64_t kMaxGapPeriods = 120;
+// A fitted period further than this from the nominal one belongs to a mode change that has not
+// been reported yet.
+static const double kMaxPeriodDeviation = 0.05;
+// Timestamps further from the fit than this many times the median distance are left out of it,
+// but never ones within the fraction of the period below. Late handled events would otherwise
+// pull the fit, most of all at the ends of the window.
+static const double kOutlierMedians = 4.0;
+static const double kInlierFraction = 0.005;
+static const uint32_t kFitPasses = 3;
+// The latency is estimated once this many presents have been measured.
+static const uint32_t kMinLatencies = 4;
+
+void VSyncModel::SetNominalPeriod(int64_t period_ns) {
+  if (period_ns == nominal_period_ns_) {
+    return;
+  }
+
+  Reset();
+  nominal_period_ns_ = period_ns;
+}
+
+void VSyncModel::Reset() {
+  *this = VSyncModel();
+}
+
+void VSyncModel::AddVSync(int64_t timestamp_ns) {
+  if (nominal_period_ns_ <= 0) {
+    return;
+  }
+
+  int64_t index = 0;
+  if (sample_count_) {
+    const Sample &last = samples_[(sample_count_ - 1) % kMaxSamples];
+    double period = fitted_ ? period_ns_ : double(nominal_period_ns_);
+    double delta = double(timestamp_ns - last.timestamp_ns);
+    // Repeated or spurious events carry no new vsync.
+    if (delta < period / 2) {
+      return;
+    }
+    if (delta > double(kMaxGapPeriods) * period) {
+      sample_count_ = 0;
+      fitted_ = false;
+    } else {
+      index = last.index + llround(delta / period);
+    }
+  }
+
+  samples_[sample_count_ % kMaxSamples] = {timestamp_ns, index};
+  sample_count_++;
+  Fit();
+}
+
+void VSyncModel::Fit() {
+  const Sample &newest = samples_[(sample_count_ - 1) % kMaxSamples];
+  uint32_t count = (sample_count_ < kMaxSamples) ? sample_count_ : kMaxSamples;
+  fitted_ = false;
+  period_ns_ = double(nominal_period_ns_);
+  anchor_ns_ = newest.timestamp_ns;
+  if (count < kMinFitSamples) {
+    return;
+  }
+
+  // Relative to the oldest sample, so the sums stay well within double precision.
+  const Sample &base = samples_[(sample_count_ - count) % kMaxSamples];
+  double x[kMaxSamples];
+  double y[kMaxSamples];
+  bool keep[kMaxSamples];
+  for (uint32_t i = 0; i < count; i++) {
+    const Sample &sample = samples_[(sample_count_ - count + i) % kMaxSamples];
+    x[i] = double(sample.index - base.index);
+    y[i] = double(sample.timestamp_ns - base.timestamp_ns);
+    keep[i] = true;
+  }
+
+  // Every pass after the first leaves out the timestamps furthest from the fit before it.
+  double slope = 0;
+  double intercept = 0;
+  double residuals[kMaxSamples];
+  for (uint32_t pass = 0; pass < kFitPasses; pass++) {
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      if (keep[i]) {
+        n += 1;
+        sx += x[i];
+        sy += y[i];
+        sxx += x[i] * x[i];
+        sxy += x[i] * y[i];
+      }
+    }
+    double denominator = n * sxx - sx * sx;
+    if (n < kMinFitSamples || denominator <= 0) {
+      return;
+    }
+    slope = (n * sxy - sx * sy) / denominator;
+    intercept = (sy - slope * sx) / n;
+
+    double distances[kMaxSamples];
+    for (uint32_t i = 0; i < count; i++) {
+      residuals[i] = fabs(y[i] - (intercept + slope * x[i]));
+      distances[i] = residuals[i];
+    }
+    std::nth_element(distances, distances + count / 2, distances + count);
+    double limit = std::max(kOutlierMedians * distances[count / 2], kInlierFraction * slope);
+    for (uint32_t i = 0; i < count; i++) {
+      keep[i] = residuals[i] <= limit;
+    }
+  }
+
+  double nominal = double(nominal_period_ns_);
+  if (fabs(slope - nominal) > kMaxPeriodDeviation * nominal) {
+    return;
+  }
+
+  fitted_ = true;
+  period_ns_ = slope;
+  anchor_ns_ = base.timestamp_ns + llround(intercept + slope * double(newest.index - base.index));
+}
+
+void VSyncModel::AddPresent(int64_t commit_ns, int64_t present_ns) {
+  int64_t latency = present_ns - commit_ns;
+  // A present long after the commit is a frame held back, not the time the commit takes.
+  if (latency <= 0 || (nominal_period_ns_ && latency > 4 * nominal_period_ns_)) {
+    return;
+  }
+
+  latencies_[latency_count_ % kMaxLatencies] = latency;
+  latency_count_++;
+}
+
+int64_t VSyncModel::GetPeriod() const {
+  return fitted_ ? llround(period_ns_) : nominal_period_ns_;
+}
+
+int64_t VSyncModel::GetPresentLatency() const {
+  uint32_t count = (latency_count_ < kMaxLatencies) ? latency_count_ : kMaxLatencies;
+  if (count < kMinLatencies) {
+    return 0;
+  }
+
+  // Presents land on vsyncs, so the latencies spread over a period above the real one. A commit
+  // can not go through faster than it, the shortest seen is the closest.
+  return *std::min_element(latencies_, latencies_ + count);
+}
+
+int64_t VSyncModel::NextVSync(int64_t timestamp_ns) const {
+  double vsyncs = floor(double(timestamp_ns - anchor_ns_) / period_ns_) + 1;
+  return anchor_ns_ + llround(vsyncs * period_ns_);
+}
+
+void VSyncModel::PredictVSyncs(int64_t timestamp_ns, uint32_t count,
+                               std::vector<int64_t> *vsyncs) const {
+  vsyncs->clear();
+  if (!IsValid()) {
+    return;
+  }
+
+  int64_t next = NextVSync(timestamp_ns);
+  for (uint32_t i = 0; i < count; i++) {
+    vsyncs->push_back(next + llround(double(i) * period_ns_));
+  }
+}
+
+int64_t VSyncModel::GetExpectedPresentTime(int64_t timestamp_ns) const {
+  if (!IsValid()) {
+    return 0;
+  }
+
+  // The first vsync the frame can make once the commit has gone through.
+  int64_t latency = GetPresentLatency();
+  return latency ? NextVSync(timestamp_ns + latency - 1) : NextVSync(timestamp_ns);
+}
+
+}  // namespace sdm
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <utils/vsync_model.h>
+
+#include <random>
+#include <vector>
+
+namespace sdm {
+namespace {
+
+const int64_t kNominalPeriod = 16666666;
+
+// Vsyncs of a 60 Hz panel whose clock runs slightly fast, with timestamp jitter and an event now
+// and then handled late.
+class VSyncStream {
+ public:
+  explicit VSyncStream(uint32_t seed, double drift_ppm = 120.0, double jitter_ns = 50000.0)
+      : rng_(seed), jitter_(0.0, jitter_ns),
+        period_(double(kNominalPeriod) * (1.0 - drift_ppm / 1e6)) {}
+
+  double GetPeriod() const { return period_; }
+  int64_t GetVSync(int64_t index) const { return kStart + llround(double(index) * period_); }
+
+  int64_t GetTimestamp(int64_t index) {
+    double late = (rng_() % 20 == 0) ? 2e6 : 0.0;
+    return GetVSync(index) + llround(jitter_(rng_) + late);
+  }
+
+ private:
+  static const int64_t kStart = 1000000000000;
+
+  std::mt19937 rng_;
+  std::normal_distribution<double> jitter_;
+  double period_;
+};
+
+TEST(VSyncModelTest, NotValidWithoutVSyncs) {
+  VSyncModel model;
+  std::vector<int64_t> vsyncs;
+  model.PredictVSyncs(0, 4, &vsyncs);
+  EXPECT_TRUE(vsyncs.empty());
+  EXPECT_EQ(model.GetExpectedPresentTime(0), 0);
+
+  model.AddVSync(1000);
+  EXPECT_FALSE(model.IsValid());
+}
+
+TEST(VSyncModelTest, UsesNominalPeriodUntilFitted) {
+  VSyncModel model;
+  model.SetNominalPeriod(kNominalPeriod);
+  model.AddVSync(1000000000);
+  EXPECT_TRUE(model.IsValid());
+  EXPECT_FALSE(model.IsFitted());
+  EXPECT_EQ(model.GetPeriod(), kNominalPeriod);
+
+  std::vector<int64_t> vsyncs;
+  model.PredictVSyncs(1000000000, 3, &vsyncs);
+  ASSERT_EQ(vsyncs.size(), 3U);
+  EXPECT_EQ(vsyncs[0], 1000000000 + kNominalPeriod);
+  EXPECT_EQ(vsyncs[2], 1000000000 + 3 * kNominalPeriod);
+}
+
+TEST(VSyncModelTest, FitsJitteryStream) {
+  for (uint32_t seed = 1; seed <= 20; seed++) {
+    VSyncStream stream(seed);
+    VSyncModel model;
+    model.SetNominalPeriod(kNominalPeriod);
+    for (int64_t index = 0; index < 100; index++) {
+      model.AddVSync(stream.GetTimestamp(index));
+    }
+    ASSERT_TRUE(model.IsFitted());
+    EXPECT_NEAR(double(model.GetPeriod()), stream.GetPeriod(), 3000.0) << "Seed " << seed;
+
+    std::vector<int64_t> vsyncs;
+    model.PredictVSyncs(stream.GetVSync(99) + 1000000, 10, &vsyncs);
+    ASSERT_EQ(vsyncs.size(), 10U);
+    for (int64_t i = 0; i < 10; i++) {
+      EXPECT_NEAR(double(vsyncs[size_t(i)]), double(stream.GetVSync(100 + i)), 100000.0)
+          << "Seed " << seed << " vsync " << i;
+    }
+  }
+}
+
+// Vsync events are turned off while the screen is static, the index carries across the gap.
+TEST(VSyncModelTest, KeepsPhaseAcrossMissedVSyncs) {
+  VSyncStream stream(7);
+  VSyncModel model;
+  model.SetNominalPeriod(kNominalPeriod);
+  for (int64_t index = 0; index < 40; index++) {
+    model.AddVSync(stream.GetTimestamp(index));
+  }
+  for (int64_t index = 100; index < 110; index++) {
+    model.AddVSync(stream.GetTimestamp(index));
+  }
+  ASSERT_TRUE(model.IsFitted());
+  EXPECT_NEAR(double(model.GetPeriod()), stream.GetPeriod(), 3000.0);
+
+  std::vector<int64_t> vsyncs;
+  model.PredictVSyncs(stream.GetVSync(109) + 1000000, 1, &vsyncs);
+  ASSERT_EQ(vsyncs.size(), 1U);
+  EXPECT_NEAR(double(vsyncs[0]), double(stream.GetVSync(110)), 100000.0);
+}
+
+TEST(VSyncModelTest, LongGapStartsOver) {
+  VSyncStream stream(9);
+  VSyncModel model;
+  model.SetNominalPeriod(kNominalPeriod);
+  for (int64_t index = 0; index < 40; index++) {
+    model.AddVSync(stream.GetTimestamp(index));
+  }
+  EXPECT_TRUE(model.IsFitted());
+  model.AddVSync(stream.GetVSync(1000) + 5000000);
+  EXPECT_FALSE(model.IsFitted());
+  EXPECT_TRUE(model.IsValid());
+
+  std::vector<int64_t> vsyncs;
+  model.PredictVSyncs(stream.GetVSync(1000) + 6000000, 1, &vsyncs);
+  ASSERT_EQ(vsyncs.size(), 1U);
+  EXPECT_EQ(vsyncs[0], stream.GetVSync(1000) + 5000000 + kNominalPeriod);
+}
+
+TEST(VSyncModelTest, ModeChangeDropsHistory) {
+  VSyncStream stream(3);
+  VSyncModel model;
+  model.SetNominalPeriod(kNominalPeriod);
+  for (int64_t index = 0; index < 40; index++) {
+    model.AddVSync(stream.GetTimestamp(index));
+  }
+  model.SetNominalPeriod(kNominalPeriod / 2);
+  EXPECT_FALSE(model.IsValid());
+  EXPECT_EQ(model.GetPeriod(), kNominalPeriod / 2);
+}
+
+// A 120 Hz stream reported while the nominal period is still the one of 60 Hz is not fitted.
+TEST(VSyncModelTest, RejectsPeriodFarFromNominal) {
+  VSyncModel model;
+  model.SetNominalPeriod(kNominalPeriod);
+  for (int64_t index = 0; index < 40; index++) {
+    model.AddVSync(1000000000 + index * kNominalPeriod * 3 / 2);
+  }
+  EXPECT_FALSE(model.IsFitted());
+  EXPECT_EQ(model.GetPeriod(), kNominalPeriod);
+}
+
+// Frames committed at random times make the first vsync at least 3 ms after their commit.
+TEST(VSyncModelTest, PredictsPresentFromMeasuredLatency) {
+  const int64_t kLatency = 3000000;
+  VSyncStream stream(5, 0.0, 20000.0);
+  VSyncModel model;
+  model.SetNominalPeriod(kNominalPeriod);
+  std::mt19937 rng(5);
+  for (int64_t index = 0; index < 100; index++) {
+    model.AddVSync(stream.GetTimestamp(index));
+    int64_t commit = stream.GetVSync(index) + int64_t(rng() % uint32_t(kNominalPeriod));
+    int64_t present = stream.GetVSync(index + 1);
+    if (present - commit < kLatency) {
+      present = stream.GetVSync(index + 2);
+    }
+    model.AddPresent(commit, present);
+  }
+  EXPECT_NEAR(double(model.GetPresentLatency()), double(kLatency), 1000000.0);
+
+  int64_t vsync = stream.GetVSync(100);
+  EXPECT_NEAR(double(model.GetExpectedPresentTime(vsync - 8000000)), double(vsync), 100000.0);
+  EXPECT_NEAR(double(model.GetExpectedPresentTime(vsync - 1000000)),
+              double(stream.GetVSync(101)), 100000.0);
+}
+
+}  // namespace
+}  // namespace sdm